@@ -24,19 +24,52 @@
 #ifndef IGRAPH_BENCH_H
 #define IGRAPH_BENCH_H
 
+/* Benchmark harness. BENCH() runs a piece of code once and prints its
+   CPU time. The benchmark suite uses BENCH_RUN() instead: it repeats
+   the code, and records the median and the variance of the wall
+   clock and CPU times, and the peak memory use of the process, both
+   as text and as JSON, see bench_init() for the options.
+
+   The JSON output has the form
+
+   { "suite": "...", "igraph_version": "...", "repetitions": 5,
+     "results": [ { "name": "...", "graph": "er", "scale": 1,
+                    "vertices": 1000, "edges": 5000,
+                    "wall_median": 0.0012, "wall_variance": 1e-9,
+                    "cpu_median": 0.0012, "cpu_variance": 1e-9,
+                    "peak_rss_kb": 10240 }, ... ] }
+
+   BENCH_RUN_OPS() also divides the times by the number of operations
+   the code performs, and counts the memory allocations of igraph's
+   containers per operation, in an extra run before the timed ones.
+   Its records have the additional fields "ops", "ns_per_op" and
+   "allocs_per_op".
+
+   compare.py compares two such files and flags the regressions. */
+
+#include <igraph.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <time.h>
+
 static inline void igraph_get_cpu_time(igraph_real_t *data) {
 
     struct rusage self, children;
     getrusage(RUSAGE_SELF, &self);
     getrusage(RUSAGE_CHILDREN, &children);
     data[0] = (double) self.ru_utime.tv_sec +
-              1e-3 * (self.ru_utime.tv_usec / 1000);
+              1e-6 * self.ru_utime.tv_usec;
     data[1] = (double) self.ru_stime.tv_sec +
-              1e-3 * (self.ru_stime.tv_usec / 1000);
+              1e-6 * self.ru_stime.tv_usec;
     data[2] = (double) children.ru_utime.tv_sec +
-              1e-3 * (children.ru_utime.tv_usec / 1000);
+              1e-6 * children.ru_utime.tv_usec;
     data[3] = (double) children.ru_stime.tv_sec +
-              1e-3 * (children.ru_stime.tv_usec / 1000);
+              1e-6 * children.ru_stime.tv_usec;
 }
 
 #define BENCH(NAME, ...)    do {                                                         \
@@ -49,5 +82,260 @@ static inline void igraph_get_cpu_time(igraph_real_t *data) {
                start[0]-start[1]-start[2]-start[3]);                       \
     } while (0)
 
+/* Wall clock time in seconds, from an arbitrary starting point */
+
+static inline double bench_wall_time(void) {
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + 1e-9 * ts.tv_nsec;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (double) tv.tv_sec + 1e-6 * tv.tv_usec;
 #endif
+}
+
+/* CPU time of the process in seconds */
+
+static inline double bench_cpu_time(void) {
+    double t[4];
+    igraph_get_cpu_time(t);
+    return t[0] + t[1];
+}
+
+/* The largest resident set size of the process so far, in kilobytes */
+
+static inline long int bench_peak_rss_kb(void) {
+    struct rusage self;
+    getrusage(RUSAGE_SELF, &self);
+#if defined(__APPLE__)
+    return (long int) (self.ru_maxrss / 1024);
+#else
+    return (long int) self.ru_maxrss;
+#endif
+}
+
+#define BENCH_MAX_REPEAT 100
+
+static struct {
+    FILE *json;
+    int first;
+    int repeat;
+    int max_scale;
+    const char *filter;
+    const char *graph;
+    int scale;
+    long int vertices, edges;
+    igraph_memstat_t memstat;   /* of the extra run of BENCH_RUN_OPS() */
+} bench_state = { 0, 1, 5, 2, 0, "", 0, 0, 0, { 0 } };
+
+static inline void bench_usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--json FILE] [--repeat N] [--max-scale N] [--filter TEXT]\n"
+            "  --json FILE     write the results to FILE, as JSON\n"
+            "  --repeat N      run every benchmark N times, default 5\n"
+            "  --max-scale N   largest graph scale, 1 to 3, default 2\n"
+            "  --filter TEXT   only run benchmarks whose name contains TEXT\n",
+            prog);
+}
+
+static inline void bench_json_string(const char *str) {
+    fputc('"', bench_state.json);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', bench_state.json);
+        }
+        fputc(*str, bench_state.json);
+    }
+    fputc('"', bench_state.json);
+}
+
+/* Parses the command line and opens the JSON output. Returns zero on
+   success, and prints the usage otherwise. */
+
+static inline int bench_init(int argc, char **argv, const char *suite) {
+    int i;
+    const char *json = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+            json = argv[++i];
+        } else if (!strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            bench_state.repeat = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-scale") && i + 1 < argc) {
+            bench_state.max_scale = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            bench_state.filter = argv[++i];
+        } else {
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (bench_state.repeat < 1 || bench_state.repeat > BENCH_MAX_REPEAT) {
+        fprintf(stderr, "Number of repetitions must be between 1 and %d\n",
+                BENCH_MAX_REPEAT);
+        return 1;
+    }
+
+    /* Warnings, e.g. about disconnected graphs, would only clutter
+       the output */
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    if (json) {
+        const char *version;
+        bench_state.json = fopen(json, "w");
+        if (!bench_state.json) {
+            fprintf(stderr, "Cannot open %s\n", json);
+            return 1;
+        }
+        igraph_version(&version, 0, 0, 0);
+        fprintf(bench_state.json, "{\n  \"suite\": ");
+        bench_json_string(suite);
+        fprintf(bench_state.json, ",\n  \"igraph_version\": ");
+        bench_json_string(version);
+        fprintf(bench_state.json, ",\n  \"repetitions\": %d,\n  \"results\": [",
+                bench_state.repeat);
+    }
+
+    return 0;
+}
+
+/* Closes the JSON output */
+
+static inline void bench_finish(void) {
+    if (bench_state.json) {
+        fprintf(bench_state.json, "\n  ]\n}\n");
+        fclose(bench_state.json);
+        bench_state.json = 0;
+    }
+}
 
+/* Sets the input of the following benchmarks, for the report */
+
+static inline void bench_set_input(const char *name, int scale,
+                                   long int vertices, long int edges) {
+    bench_state.graph = name;
+    bench_state.scale = scale;
+    bench_state.vertices = vertices;
+    bench_state.edges = edges;
+}
+
+static inline void bench_set_graph(const char *graph, int scale, const igraph_t *g) {
+    bench_set_input(graph, scale, (long int) igraph_vcount(g),
+                    (long int) igraph_ecount(g));
+}
+
+static inline int bench_selected(const char *name) {
+    return !bench_state.filter || strstr(name, bench_state.filter) != 0;
+}
+
+static inline int bench_cmp_double(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/* Median and sample variance, sorts the data */
+
+static inline void bench_stats(double *data, int n, double *median, double *variance) {
+    double mean = 0.0, sq = 0.0;
+    int i;
+    qsort(data, (size_t) n, sizeof(double), bench_cmp_double);
+    *median = n % 2 ? data[n / 2] : (data[n / 2 - 1] + data[n / 2]) / 2;
+    for (i = 0; i < n; i++) {
+        mean += data[i];
+    }
+    mean /= n;
+    for (i = 0; i < n; i++) {
+        sq += (data[i] - mean) * (data[i] - mean);
+    }
+    *variance = n > 1 ? sq / (n - 1) : 0.0;
+}
+
+/* Reports a benchmark, ops is the number of operations in one run,
+   or zero if the times are not reported per operation */
+
+static inline void bench_report(const char *name, double *wall, double *cpu,
+                                int n, long int ops, size_t allocations) {
+    double wall_median, wall_variance, cpu_median, cpu_variance;
+    long int rss = bench_peak_rss_kb();
+
+    bench_stats(wall, n, &wall_median, &wall_variance);
+    bench_stats(cpu, n, &cpu_median, &cpu_variance);
+
+    if (ops > 0) {
+        printf("%-40s %-6s %d %10.2f ns/op %8.3f allocs/op  sd %8.2f ns/op\n",
+               name, bench_state.graph, bench_state.scale,
+               1e9 * wall_median / ops, (double) allocations / ops,
+               wall_variance > 0 ? 1e9 * sqrt(wall_variance) / ops : 0.0);
+    } else {
+        printf("%-40s %-5s %d %10.4fs %10.4fs cpu  sd %8.4fs  %8ld kB\n", name,
+               bench_state.graph, bench_state.scale, wall_median, cpu_median,
+               wall_variance > 0 ? sqrt(wall_variance) : 0.0, rss);
+    }
+    fflush(stdout);
+
+    if (bench_state.json) {
+        fprintf(bench_state.json, "%s\n    { \"name\": ",
+                bench_state.first ? "" : ",");
+        bench_json_string(name);
+        fprintf(bench_state.json, ", \"graph\": ");
+        bench_json_string(bench_state.graph);
+        fprintf(bench_state.json,
+                ", \"scale\": %d, \"vertices\": %ld, \"edges\": %ld,\n"
+                "      \"wall_median\": %.6g, \"wall_variance\": %.6g,"
+                " \"cpu_median\": %.6g, \"cpu_variance\": %.6g,"
+                " \"peak_rss_kb\": %ld",
+                bench_state.scale, bench_state.vertices, bench_state.edges,
+                wall_median, wall_variance, cpu_median, cpu_variance, rss);
+        if (ops > 0) {
+            fprintf(bench_state.json,
+                    ",\n      \"ops\": %ld, \"ns_per_op\": %.6g,"
+                    " \"allocs_per_op\": %.6g", ops,
+                    1e9 * wall_median / ops, (double) allocations / ops);
+        }
+        fprintf(bench_state.json, " }");
+        bench_state.first = 0;
+    }
+}
+
+/* Runs the code the configured number of times, and reports it.
+   Anything that the code allocates must be freed by the code itself,
+   so that every repetition does the same work. */
+
+#define BENCH_RUN(NAME, ...)    do {                                       \
+        if (bench_selected(NAME)) {                                        \
+            double wall[BENCH_MAX_REPEAT], cpu[BENCH_MAX_REPEAT];          \
+            int bench_i;                                                   \
+            for (bench_i = 0; bench_i < bench_state.repeat; bench_i++) {   \
+                double wall0 = bench_wall_time(), cpu0 = bench_cpu_time(); \
+                { __VA_ARGS__; };                                          \
+                wall[bench_i] = bench_wall_time() - wall0;                 \
+                cpu[bench_i] = bench_cpu_time() - cpu0;                    \
+            }                                                              \
+            bench_report(NAME, wall, cpu, bench_state.repeat, 0, 0);       \
+        }                                                                  \
+    } while (0)
+
+/* Like BENCH_RUN(), for code that performs OPS operations. An extra,
+   untimed run counts the allocations, and warms up the caches. */
+
+#define BENCH_RUN_OPS(NAME, OPS, ...)    do {                              \
+        if (bench_selected(NAME)) {                                        \
+            double wall[BENCH_MAX_REPEAT], cpu[BENCH_MAX_REPEAT];          \
+            int bench_i;                                                   \
+            igraph_memstat_begin(&bench_state.memstat, 0);                       \
+            { __VA_ARGS__; };                                              \
+            igraph_memstat_end(&bench_state.memstat);                            \
+            for (bench_i = 0; bench_i < bench_state.repeat; bench_i++) {   \
+                double wall0 = bench_wall_time(), cpu0 = bench_cpu_time(); \
+                { __VA_ARGS__; };                                          \
+                wall[bench_i] = bench_wall_time() - wall0;                 \
+                cpu[bench_i] = bench_cpu_time() - cpu0;                    \
+            }                                                              \
+            bench_report(NAME, wall, cpu, bench_state.repeat, (OPS),       \
+                         bench_state.memstat.allocations);                       \
+        }                                                                  \
+    } while (0)
+
+#endif
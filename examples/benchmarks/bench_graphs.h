@@ -0,0 +1,158 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_BENCH_GRAPHS_H
+#define IGRAPH_BENCH_GRAPHS_H
+
+/* Graph generators of the benchmark suite. Every graph type has three
+   scales, with about 1000, 10000 and 100000 vertices, and an average
+   degree of about ten. The random number generator is seeded before
+   generating a graph, so the graphs are the same in every run. */
+
+#include <igraph.h>
+#include <string.h>
+
+#define BENCH_SEED 42
+
+static const char *bench_graph_types[] = { "er", "ba", "rmat", "grid", "sbm", 0 };
+
+static inline igraph_integer_t bench_graph_size(int scale) {
+    return scale <= 1 ? 1000 : (scale == 2 ? 10000 : 100000);
+}
+
+/* R-MAT graph: every edge falls into one of the four quadrants of the
+   adjacency matrix, recursively, with probabilities a, b, c and d.
+   Multi-edges and loops are removed. */
+
+static inline int bench_rmat(igraph_t *graph, int log_n, long int m) {
+    igraph_vector_t edges;
+    const double a = 0.57, b = 0.19, c = 0.19;
+    long int i;
+    int j;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&edges, 2 * m);
+    RNG_BEGIN();
+    for (i = 0; i < m; i++) {
+        long int from = 0, to = 0;
+        for (j = 0; j < log_n; j++) {
+            double r = RNG_UNIF01();
+            from <<= 1; to <<= 1;
+            if (r < a) {
+                /* top left */
+            } else if (r < a + b) {
+                to |= 1;
+            } else if (r < a + b + c) {
+                from |= 1;
+            } else {
+                from |= 1; to |= 1;
+            }
+        }
+        VECTOR(edges)[2 * i] = from;
+        VECTOR(edges)[2 * i + 1] = to;
+    }
+    RNG_END();
+
+    IGRAPH_CHECK(igraph_create(graph, &edges, 1 << log_n, IGRAPH_UNDIRECTED));
+    igraph_vector_destroy(&edges);
+    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FINALLY(igraph_destroy, graph);
+    IGRAPH_CHECK(igraph_simplify(graph, /*multiple=*/ 1, /*loops=*/ 1,
+                                 /*edge_comb=*/ 0));
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* Stochastic block model with ten equal blocks, with ten times more
+   edges within the blocks than between them */
+
+static inline int bench_sbm(igraph_t *graph, igraph_integer_t n) {
+    igraph_matrix_t pref;
+    igraph_vector_int_t sizes;
+    const int blocks = 10;
+    double p_in, p_out;
+    int i, j;
+
+    /* Average degree 10: (n/k) p_in + (n - n/k) p_out = 10, p_in = 10 p_out */
+    p_out = 10.0 / (n / blocks * 10.0 + (n - n / blocks));
+    p_in = 10 * p_out;
+
+    IGRAPH_CHECK(igraph_matrix_init(&pref, blocks, blocks));
+    IGRAPH_FINALLY(igraph_matrix_destroy, &pref);
+    IGRAPH_CHECK(igraph_vector_int_init(&sizes, blocks));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &sizes);
+    for (i = 0; i < blocks; i++) {
+        VECTOR(sizes)[i] = n / blocks;
+        for (j = 0; j < blocks; j++) {
+            MATRIX(pref, i, j) = i == j ? p_in : p_out;
+        }
+    }
+
+    IGRAPH_CHECK(igraph_sbm_game(graph, n, &pref, &sizes, IGRAPH_UNDIRECTED,
+                                 IGRAPH_NO_LOOPS));
+
+    igraph_vector_int_destroy(&sizes);
+    igraph_matrix_destroy(&pref);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/* Creates a benchmark graph of the given type and scale, the types
+   are listed in bench_graph_types */
+
+static inline int bench_make_graph(igraph_t *graph, const char *type, int scale) {
+    igraph_integer_t n = bench_graph_size(scale);
+
+    igraph_rng_seed(igraph_rng_default(), BENCH_SEED);
+
+    if (!strcmp(type, "er")) {
+        return igraph_erdos_renyi_game(graph, IGRAPH_ERDOS_RENYI_GNM, n, 5 * n,
+                                       IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    } else if (!strcmp(type, "ba")) {
+        return igraph_barabasi_game(graph, n, /*power=*/ 1, /*m=*/ 5,
+                                    /*outseq=*/ 0, /*outpref=*/ 0, /*A=*/ 1,
+                                    IGRAPH_UNDIRECTED, IGRAPH_BARABASI_PSUMTREE,
+                                    /*start_from=*/ 0);
+    } else if (!strcmp(type, "rmat")) {
+        int log_n = scale <= 1 ? 10 : (scale == 2 ? 13 : 17);
+        return bench_rmat(graph, log_n, 6L << log_n);
+    } else if (!strcmp(type, "grid")) {
+        /* A square lattice with the second neighbours connected as
+           well, the degree is 12, except on the border */
+        igraph_vector_t dim;
+        igraph_integer_t side = (igraph_integer_t) sqrt((double) n);
+        int ret;
+        IGRAPH_CHECK(igraph_vector_init(&dim, 2));
+        VECTOR(dim)[0] = VECTOR(dim)[1] = side;
+        ret = igraph_lattice(graph, &dim, /*nei=*/ 2, IGRAPH_UNDIRECTED,
+                             /*mutual=*/ 0, /*circular=*/ 0);
+        igraph_vector_destroy(&dim);
+        return ret;
+    } else if (!strcmp(type, "sbm")) {
+        return bench_sbm(graph, n);
+    }
+
+    IGRAPH_ERROR("Unknown benchmark graph type", IGRAPH_EINVAL);
+}
+
+#endif
@@ -0,0 +1,96 @@
+#! /usr/bin/env python3
+#
+#   IGraph library.
+#   Copyright (C) 2020  The igraph development team
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program; if not, write to the Free Software
+#   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+#   02110-1301 USA
+
+"""Compares two JSON outputs of the benchmark suite.
+
+A benchmark is a regression if its median time grew by more than the
+threshold, and the difference is also larger than what the noise of
+the two runs explains, i.e. larger than SIGMAS times the standard
+error of the difference. Very short benchmarks are ignored, their
+timings are not reliable. Exits with status 1 if there were
+regressions, so it can be used in scripts.
+"""
+
+import argparse
+import json
+import math
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        doc = json.load(f)
+    reps = doc.get("repetitions", 1)
+    results = {}
+    for r in doc["results"]:
+        results[(r["name"], r["graph"], r["scale"])] = r
+    return reps, results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline", help="JSON output of the baseline run")
+    parser.add_argument("current", help="JSON output of the current run")
+    parser.add_argument("--metric", choices=["wall", "cpu"], default="cpu",
+                        help="compare wall clock or CPU times, default cpu")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown that counts, default 0.10")
+    parser.add_argument("--sigmas", type=float, default=3.0,
+                        help="required significance, default 3")
+    parser.add_argument("--min-time", type=float, default=0.001,
+                        help="ignore benchmarks faster than this, in seconds")
+    args = parser.parse_args()
+
+    base_reps, base = load(args.baseline)
+    cur_reps, cur = load(args.current)
+    median = args.metric + "_median"
+    variance = args.metric + "_variance"
+
+    regressions = 0
+    for key in sorted(cur):
+        if key not in base:
+            continue
+        b, c = base[key], cur[key]
+        old, new = b[median], c[median]
+        if max(old, new) < args.min_time:
+            continue
+        stderr = math.sqrt(b[variance] / base_reps + c[variance] / cur_reps)
+        ratio = new / old if old > 0 else float("inf")
+        status = ""
+        if ratio > 1 + args.threshold and new - old > args.sigmas * stderr:
+            status = "REGRESSION"
+            regressions += 1
+        elif ratio < 1 - args.threshold and old - new > args.sigmas * stderr:
+            status = "improvement"
+        print("%-40s %-5s %d %10.4fs %10.4fs %+7.1f%% %s" %
+              (key[0], key[1], key[2], old, new, 100 * (ratio - 1), status))
+
+    missing = len(set(base) - set(cur))
+    if missing:
+        print("\n%d benchmark(s) of the baseline were not run" % missing)
+
+    if regressions:
+        print("\n%d regression(s)" % regressions)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,296 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+/* Microbenchmarks of the primitives that the algorithms are built on:
+   neighbor and incident edge queries, vertex and edge iterators,
+   double ended queues, heaps, partial prefix sum trees and ordering.
+   Every benchmark reports the time and the number of memory
+   allocations per operation; the operation is given in the comment
+   of each benchmark. The graph primitives are measured on the graphs
+   of bench_graphs.h, the data structures on the same sizes. Run it
+   with "make microbenchmark". */
+
+#include <igraph.h>
+
+#include "igraph_types_internal.h"
+
+#include "bench.h"
+#include "bench_graphs.h"
+
+/* Results are summed here, so that the compiler cannot drop the
+   measured code */
+static volatile double bench_sink;
+
+/* Graph queries, one operation is one vertex */
+
+static void bench_neighbors(const igraph_t *graph, igraph_neimode_t mode) {
+    igraph_vector_t neis;
+    long int i, n = igraph_vcount(graph);
+    double sum = 0;
+    igraph_vector_init(&neis, 0);
+    for (i = 0; i < n; i++) {
+        igraph_neighbors(graph, &neis, (igraph_integer_t) i, mode);
+        sum += igraph_vector_size(&neis);
+    }
+    igraph_vector_destroy(&neis);
+    bench_sink += sum;
+}
+
+static void bench_incident(const igraph_t *graph, igraph_neimode_t mode) {
+    igraph_vector_t eids;
+    long int i, n = igraph_vcount(graph);
+    double sum = 0;
+    igraph_vector_init(&eids, 0);
+    for (i = 0; i < n; i++) {
+        igraph_incident(graph, &eids, (igraph_integer_t) i, mode);
+        sum += igraph_vector_size(&eids);
+    }
+    igraph_vector_destroy(&eids);
+    bench_sink += sum;
+}
+
+static void bench_degree(const igraph_t *graph) {
+    igraph_vector_t deg;
+    igraph_vector_init(&deg, 0);
+    igraph_degree(graph, &deg, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+    bench_sink += VECTOR(deg)[0];
+    igraph_vector_destroy(&deg);
+}
+
+/* Iterators, one operation is one vertex or edge visited */
+
+static void bench_vit_all(const igraph_t *graph) {
+    igraph_vit_t vit;
+    double sum = 0;
+    igraph_vit_create(graph, igraph_vss_all(), &vit);
+    while (!IGRAPH_VIT_END(vit)) {
+        sum += IGRAPH_VIT_GET(vit);
+        IGRAPH_VIT_NEXT(vit);
+    }
+    igraph_vit_destroy(&vit);
+    bench_sink += sum;
+}
+
+/* Creates an iterator over the neighbors of every vertex, one
+   operation is one vertex */
+
+static void bench_vit_adj(const igraph_t *graph) {
+    igraph_vs_t vs;
+    igraph_vit_t vit;
+    long int i, n = igraph_vcount(graph);
+    double sum = 0;
+    for (i = 0; i < n; i++) {
+        igraph_vs_adj(&vs, (igraph_integer_t) i, IGRAPH_ALL);
+        igraph_vit_create(graph, vs, &vit);
+        sum += IGRAPH_VIT_SIZE(vit);
+        igraph_vit_destroy(&vit);
+        igraph_vs_destroy(&vs);
+    }
+    bench_sink += sum;
+}
+
+static void bench_eit_all(const igraph_t *graph) {
+    igraph_eit_t eit;
+    double sum = 0;
+    igraph_eit_create(graph, igraph_ess_all(IGRAPH_EDGEORDER_ID), &eit);
+    while (!IGRAPH_EIT_END(eit)) {
+        sum += IGRAPH_EIT_GET(eit);
+        IGRAPH_EIT_NEXT(eit);
+    }
+    igraph_eit_destroy(&eit);
+    bench_sink += sum;
+}
+
+static void bench_eit_incident(const igraph_t *graph) {
+    igraph_es_t es;
+    igraph_eit_t eit;
+    long int i, n = igraph_vcount(graph);
+    double sum = 0;
+    for (i = 0; i < n; i++) {
+        igraph_es_incident(&es, (igraph_integer_t) i, IGRAPH_ALL);
+        igraph_eit_create(graph, es, &eit);
+        sum += IGRAPH_EIT_SIZE(eit);
+        igraph_eit_destroy(&eit);
+        igraph_es_destroy(&es);
+    }
+    bench_sink += sum;
+}
+
+/* Data structures, one operation is one element pushed and popped */
+
+static void bench_dqueue(long int n) {
+    igraph_dqueue_t q;
+    long int i, j;
+    double sum = 0;
+    igraph_dqueue_init(&q, 16);
+    /* In BFS order: pop one, push a few */
+    igraph_dqueue_push(&q, 0);
+    for (i = 1; i < n; i += 4) {
+        sum += igraph_dqueue_pop(&q);
+        for (j = i; j < i + 4 && j < n; j++) {
+            igraph_dqueue_push(&q, j);
+        }
+    }
+    while (!igraph_dqueue_empty(&q)) {
+        sum += igraph_dqueue_pop(&q);
+    }
+    igraph_dqueue_destroy(&q);
+    bench_sink += sum;
+}
+
+static void bench_heap(const igraph_vector_t *keys) {
+    igraph_heap_t h;
+    long int i, n = igraph_vector_size(keys);
+    double sum = 0;
+    igraph_heap_init(&h, 0);
+    for (i = 0; i < n; i++) {
+        igraph_heap_push(&h, VECTOR(*keys)[i]);
+    }
+    while (!igraph_heap_empty(&h)) {
+        sum += igraph_heap_delete_top(&h);
+    }
+    igraph_heap_destroy(&h);
+    bench_sink += sum;
+}
+
+/* Indexed heap, as in Dijkstra's algorithm: every element is pushed,
+   its key is modified once, and it is removed */
+
+static void bench_2wheap(const igraph_vector_t *keys) {
+    igraph_2wheap_t h;
+    long int i, n = igraph_vector_size(keys);
+    double sum = 0;
+    igraph_2wheap_init(&h, n);
+    for (i = 0; i < n; i++) {
+        igraph_2wheap_push_with_index(&h, i, -VECTOR(*keys)[i]);
+    }
+    for (i = 0; i < n; i++) {
+        igraph_2wheap_modify(&h, i, -VECTOR(*keys)[i] / 2);
+    }
+    while (!igraph_2wheap_empty(&h)) {
+        sum += igraph_2wheap_delete_max(&h);
+    }
+    igraph_2wheap_destroy(&h);
+    bench_sink += sum;
+}
+
+/* Partial prefix sum tree, as in preferential attachment: one
+   operation is an update and a search */
+
+static void bench_psumtree(const igraph_vector_t *keys) {
+    igraph_psumtree_t t;
+    long int i, idx, n = igraph_vector_size(keys);
+    double sum = 0;
+    igraph_psumtree_init(&t, n);
+    for (i = 0; i < n; i++) {
+        igraph_psumtree_update(&t, i, VECTOR(*keys)[i]);
+    }
+    for (i = 0; i < n; i++) {
+        igraph_psumtree_search(&t, &idx,
+                               igraph_psumtree_sum(&t) * VECTOR(*keys)[n - 1 - i]);
+        igraph_psumtree_update(&t, idx, VECTOR(*keys)[i]);
+        sum += idx;
+    }
+    igraph_psumtree_destroy(&t);
+    bench_sink += sum;
+}
+
+/* Ordering the edges of a graph by their endpoints, as when building
+   the indices of a graph, one operation is one edge */
+
+static void bench_vector_order(const igraph_vector_t *from,
+                               const igraph_vector_t *to, igraph_real_t nodes) {
+    igraph_vector_t res;
+    igraph_vector_init(&res, 0);
+    igraph_vector_order(from, to, &res, nodes);
+    bench_sink += VECTOR(res)[0];
+    igraph_vector_destroy(&res);
+}
+
+int main(int argc, char **argv) {
+    igraph_t graph;
+    igraph_vector_t keys, from, to;
+    long int i, n, m;
+    int t, scale;
+
+    if (bench_init(argc, argv, "igraph-micro")) {
+        return 1;
+    }
+
+    for (scale = 1; scale <= bench_state.max_scale && scale <= 3; scale++) {
+        /* Graph primitives on graphs with different degree distributions */
+        for (t = 0; bench_graph_types[t]; t++) {
+            bench_make_graph(&graph, bench_graph_types[t], scale);
+            bench_set_graph(bench_graph_types[t], scale, &graph);
+            n = igraph_vcount(&graph);
+            m = igraph_ecount(&graph);
+
+            BENCH_RUN_OPS("graph/neighbors_out", n,
+                          bench_neighbors(&graph, IGRAPH_OUT));
+            BENCH_RUN_OPS("graph/neighbors_all", n,
+                          bench_neighbors(&graph, IGRAPH_ALL));
+            BENCH_RUN_OPS("graph/incident_out", n,
+                          bench_incident(&graph, IGRAPH_OUT));
+            BENCH_RUN_OPS("graph/incident_all", n,
+                          bench_incident(&graph, IGRAPH_ALL));
+            BENCH_RUN_OPS("graph/degree", n, bench_degree(&graph));
+            BENCH_RUN_OPS("iterators/vit_all", n, bench_vit_all(&graph));
+            BENCH_RUN_OPS("iterators/vit_adj", n, bench_vit_adj(&graph));
+            BENCH_RUN_OPS("iterators/eit_all", m, bench_eit_all(&graph));
+            BENCH_RUN_OPS("iterators/eit_incident", n,
+                          bench_eit_incident(&graph));
+
+            igraph_vector_init(&from, m);
+            igraph_vector_init(&to, m);
+            for (i = 0; i < m; i++) {
+                VECTOR(from)[i] = IGRAPH_FROM(&graph, i);
+                VECTOR(to)[i] = IGRAPH_TO(&graph, i);
+            }
+            BENCH_RUN_OPS("sort/vector_order", m,
+                          bench_vector_order(&from, &to, n));
+            igraph_vector_destroy(&to);
+            igraph_vector_destroy(&from);
+
+            igraph_destroy(&graph);
+        }
+
+        /* Data structures, with as many elements as vertices */
+        n = bench_graph_size(scale);
+        bench_set_input("random", scale, n, 0);
+        igraph_vector_init(&keys, n);
+        igraph_rng_seed(igraph_rng_default(), BENCH_SEED);
+        for (i = 0; i < n; i++) {
+            VECTOR(keys)[i] = RNG_UNIF01();
+        }
+
+        BENCH_RUN_OPS("struct/dqueue", n, bench_dqueue(n));
+        BENCH_RUN_OPS("struct/heap", n, bench_heap(&keys));
+        BENCH_RUN_OPS("struct/2wheap", n, bench_2wheap(&keys));
+        BENCH_RUN_OPS("struct/psumtree", n, bench_psumtree(&keys));
+
+        igraph_vector_destroy(&keys);
+    }
+
+    bench_finish();
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+/* The benchmark suite: runs the main algorithm families on the graphs
+   of bench_graphs.h, see bench.h for the options and the output.
+   The algorithms that are superlinear in the number of vertices are
+   only run on the smallest graphs. Run it with "make benchmark". */
+
+#include <igraph.h>
+
+#include "bench.h"
+#include "bench_graphs.h"
+
+/* Construction: creating a graph from its edge list */
+
+static void bench_create(const igraph_t *graph) {
+    igraph_vector_t edges;
+    igraph_t copy;
+    igraph_vector_init(&edges, 0);
+    igraph_get_edgelist(graph, &edges, 0);
+    igraph_create(&copy, &edges, igraph_vcount(graph), IGRAPH_UNDIRECTED);
+    igraph_destroy(&copy);
+    igraph_vector_destroy(&edges);
+}
+
+static void bench_generate(const char *type, int scale) {
+    igraph_t graph;
+    bench_make_graph(&graph, type, scale);
+    igraph_destroy(&graph);
+}
+
+/* Paths */
+
+static void bench_bfs(const igraph_t *graph) {
+    igraph_vector_t order;
+    igraph_vector_init(&order, 0);
+    igraph_bfs(graph, 0, 0, IGRAPH_ALL, /*unreachable=*/ 1, 0, &order,
+               0, 0, 0, 0, 0, 0, 0);
+    igraph_vector_destroy(&order);
+}
+
+static void bench_dijkstra(const igraph_t *graph, const igraph_vector_t *weights) {
+    igraph_matrix_t res;
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths_dijkstra(graph, &res, igraph_vss_1(0),
+                                   igraph_vss_all(), weights, IGRAPH_ALL);
+    igraph_matrix_destroy(&res);
+}
+
+static void bench_all_pairs(const igraph_t *graph) {
+    igraph_matrix_t res;
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths(graph, &res, igraph_vss_all(), igraph_vss_all(),
+                          IGRAPH_ALL);
+    igraph_matrix_destroy(&res);
+}
+
+static void bench_components(const igraph_t *graph) {
+    igraph_vector_t membership;
+    igraph_integer_t no;
+    igraph_vector_init(&membership, 0);
+    igraph_clusters(graph, &membership, 0, &no, IGRAPH_WEAK);
+    igraph_vector_destroy(&membership);
+}
+
+/* Centrality */
+
+static void bench_pagerank(const igraph_t *graph) {
+    igraph_vector_t res;
+    igraph_vector_init(&res, 0);
+    igraph_pagerank(graph, IGRAPH_PAGERANK_ALGO_PRPACK, &res, 0,
+                    igraph_vss_all(), IGRAPH_UNDIRECTED, 0.85, 0, 0);
+    igraph_vector_destroy(&res);
+}
+
+static void bench_betweenness(const igraph_t *graph) {
+    igraph_vector_t res;
+    igraph_vector_init(&res, 0);
+    igraph_betweenness(graph, &res, igraph_vss_all(), IGRAPH_UNDIRECTED, 0,
+                       /*nobigint=*/ 1);
+    igraph_vector_destroy(&res);
+}
+
+static void bench_closeness(const igraph_t *graph) {
+    igraph_vector_t res;
+    igraph_vector_init(&res, 0);
+    igraph_closeness(graph, &res, igraph_vss_all(), IGRAPH_ALL, 0,
+                     /*normalized=*/ 0);
+    igraph_vector_destroy(&res);
+}
+
+static void bench_coreness(const igraph_t *graph) {
+    igraph_vector_t res;
+    igraph_vector_init(&res, 0);
+    igraph_coreness(graph, &res, IGRAPH_ALL);
+    igraph_vector_destroy(&res);
+}
+
+/* Community detection */
+
+static void bench_multilevel(const igraph_t *graph) {
+    igraph_vector_t membership;
+    igraph_vector_init(&membership, 0);
+    igraph_community_multilevel(graph, 0, &membership, 0, 0);
+    igraph_vector_destroy(&membership);
+}
+
+static void bench_leiden(const igraph_t *graph) {
+    igraph_vector_t membership;
+    igraph_integer_t nb_clusters;
+    igraph_real_t quality;
+    igraph_vector_init(&membership, 0);
+    igraph_community_leiden(graph, 0, 0, 1.0 / (2 * igraph_ecount(graph)),
+                            0.01, /*start=*/ 0, &membership, &nb_clusters,
+                            &quality);
+    igraph_vector_destroy(&membership);
+}
+
+static void bench_label_propagation(const igraph_t *graph) {
+    igraph_vector_t membership;
+    igraph_vector_init(&membership, 0);
+    igraph_community_label_propagation(graph, &membership, 0, 0, 0, 0);
+    igraph_vector_destroy(&membership);
+}
+
+/* Cliques and triangles */
+
+static void bench_maximal_cliques(const igraph_t *graph) {
+    igraph_integer_t count;
+    igraph_maximal_cliques_count(graph, &count, 0, 0);
+}
+
+static void bench_transitivity(const igraph_t *graph) {
+    igraph_vector_t res;
+    igraph_vector_init(&res, 0);
+    igraph_transitivity_local_undirected(graph, &res, igraph_vss_all(),
+                                         IGRAPH_TRANSITIVITY_NAN);
+    igraph_vector_destroy(&res);
+}
+
+/* Layout */
+
+static void bench_layout_fr(const igraph_t *graph) {
+    igraph_matrix_t res;
+    igraph_matrix_init(&res, 0, 0);
+    igraph_layout_fruchterman_reingold(graph, &res, /*use_seed=*/ 0,
+                                       /*niter=*/ 100, /*start_temp=*/ 0,
+                                       IGRAPH_LAYOUT_AUTOGRID, 0, 0, 0, 0, 0);
+    igraph_matrix_destroy(&res);
+}
+
+/* Flows */
+
+static void bench_maxflow(const igraph_t *graph) {
+    igraph_real_t value;
+    igraph_maxflow_value(graph, &value, 0, igraph_vcount(graph) - 1, 0, 0);
+}
+
+/* I/O: writing and reading back an edge list */
+
+static void bench_edgelist_io(const igraph_t *graph) {
+    igraph_t copy;
+    FILE *file = tmpfile();
+    if (!file) {
+        return;
+    }
+    igraph_write_graph_edgelist(graph, file);
+    rewind(file);
+    igraph_read_graph_edgelist(&copy, file, igraph_vcount(graph),
+                               IGRAPH_UNDIRECTED);
+    igraph_destroy(&copy);
+    fclose(file);
+}
+
+int main(int argc, char **argv) {
+    igraph_t graph;
+    igraph_vector_t weights;
+    long int i;
+    int t, scale;
+
+    if (bench_init(argc, argv, "igraph")) {
+        return 1;
+    }
+
+    for (scale = 1; scale <= bench_state.max_scale && scale <= 3; scale++) {
+        for (t = 0; bench_graph_types[t]; t++) {
+            const char *type = bench_graph_types[t];
+
+            bench_make_graph(&graph, type, scale);
+            bench_set_graph(type, scale, &graph);
+
+            igraph_vector_init(&weights, igraph_ecount(&graph));
+            igraph_rng_seed(igraph_rng_default(), BENCH_SEED);
+            for (i = 0; i < igraph_vector_size(&weights); i++) {
+                VECTOR(weights)[i] = RNG_UNIF(1, 100);
+            }
+
+            BENCH_RUN("construction/generate", bench_generate(type, scale));
+            BENCH_RUN("construction/create", bench_create(&graph));
+
+            BENCH_RUN("paths/bfs", bench_bfs(&graph));
+            BENCH_RUN("paths/dijkstra", bench_dijkstra(&graph, &weights));
+            BENCH_RUN("paths/components", bench_components(&graph));
+            if (scale == 1) {
+                BENCH_RUN("paths/all_pairs", bench_all_pairs(&graph));
+            }
+
+            BENCH_RUN("centrality/pagerank", bench_pagerank(&graph));
+            BENCH_RUN("centrality/coreness", bench_coreness(&graph));
+            if (scale == 1) {
+                BENCH_RUN("centrality/betweenness", bench_betweenness(&graph));
+                BENCH_RUN("centrality/closeness", bench_closeness(&graph));
+            }
+
+            BENCH_RUN("community/multilevel", bench_multilevel(&graph));
+            BENCH_RUN("community/leiden", bench_leiden(&graph));
+            BENCH_RUN("community/label_propagation",
+                      bench_label_propagation(&graph));
+
+            BENCH_RUN("cliques/maximal_cliques", bench_maximal_cliques(&graph));
+            BENCH_RUN("cliques/transitivity", bench_transitivity(&graph));
+
+            if (scale == 1) {
+                BENCH_RUN("layout/fruchterman_reingold", bench_layout_fr(&graph));
+            }
+
+            BENCH_RUN("flow/maxflow", bench_maxflow(&graph));
+
+            BENCH_RUN("io/edgelist", bench_edgelist_io(&graph));
+
+            igraph_vector_destroy(&weights);
+            igraph_destroy(&graph);
+        }
+    }
+
+    bench_finish();
+
+    return 0;
+}
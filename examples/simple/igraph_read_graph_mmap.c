@@ -0,0 +1,163 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+void print_vector(igraph_vector_t *v) {
+    long int i;
+    for (i = 0; i < igraph_vector_size(v); i++) {
+        printf(" %li", (long int) VECTOR(*v)[i]);
+    }
+    printf("\n");
+}
+
+/* Writes a snapshot of 'graph', overwrites the integer at 'pos' in
+   the data after the header with 'value', and reads it back. The
+   header is whatever precedes the 4|E|+2(|V|+1) integers, negative
+   positions are in the header. */
+int read_corrupt(const igraph_t *graph, long int pos, int value,
+                 igraph_bool_t verify) {
+    igraph_t g;
+    FILE *file;
+    long int size, data;
+    int ret;
+
+    file = fopen("snapshot.bin", "w+b");
+    if (!file) {
+        return -1;
+    }
+    igraph_write_graph_snapshot(graph, file);
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    data = size - (long int) sizeof(int) *
+           (4 * igraph_ecount(graph) + 2 * (igraph_vcount(graph) + 1));
+    fseek(file, data + pos * (long int) sizeof(int), SEEK_SET);
+    fwrite(&value, sizeof(int), 1, file);
+    fflush(file);
+    fseek(file, 0, SEEK_SET);
+    ret = igraph_read_graph_mmap(&g, file, verify);
+    fclose(file);
+    if (ret == 0) {
+        igraph_destroy(&g);
+    }
+    return ret;
+}
+
+int main() {
+
+    igraph_t g, g2, g3;
+    igraph_vector_t v;
+    igraph_bool_t iso;
+    FILE *file;
+    int ret;
+
+    /* Write a snapshot */
+    igraph_small(&g, 6, IGRAPH_DIRECTED,
+                 0, 1, 1, 2, 2, 0, 3, 4, 4, 5, 5, 3, 0, 3, 3, 0, 2, 2, -1);
+    file = fopen("snapshot.bin", "wb");
+    if (!file) {
+        return 1;
+    }
+    igraph_write_graph_snapshot(&g, file);
+    fclose(file);
+
+    /* Map it, the stream can be closed right away */
+    file = fopen("snapshot.bin", "rb");
+    if (!file) {
+        return 2;
+    }
+    igraph_read_graph_mmap(&g2, file, /*verify=*/ 0);
+    fclose(file);
+
+    printf("vertices: %li, edges: %li, directed: %i\n",
+           (long int) igraph_vcount(&g2), (long int) igraph_ecount(&g2),
+           (int) igraph_is_directed(&g2));
+    igraph_vector_init(&v, 0);
+    igraph_get_edgelist(&g2, &v, 0);
+    print_vector(&v);
+    igraph_neighbors(&g2, &v, 3, IGRAPH_ALL);
+    print_vector(&v);
+    igraph_isomorphic(&g, &g2, &iso);
+    printf("isomorphic: %i\n", (int) iso);
+
+    /* Copies and modifications use private memory */
+    igraph_copy(&g3, &g2);
+    igraph_add_edge(&g2, 5, 1);
+    igraph_delete_edges(&g3, igraph_ess_1(0));
+    printf("edges: %li %li\n", (long int) igraph_ecount(&g2),
+           (long int) igraph_ecount(&g3));
+    igraph_neighbors(&g2, &v, 1, IGRAPH_IN);
+    print_vector(&v);
+    igraph_destroy(&g3);
+    igraph_destroy(&g2);
+
+    /* Not a snapshot */
+    file = fopen("snapshot.bin", "wb");
+    if (!file) {
+        return 3;
+    }
+    igraph_write_graph_edgelist(&g, file);
+    fclose(file);
+    file = fopen("snapshot.bin", "rb");
+    if (!file) {
+        return 4;
+    }
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_read_graph_mmap(&g2, file, /*verify=*/ 0);
+    fclose(file);
+    if (ret != IGRAPH_PARSEERROR) {
+        return 5;
+    }
+
+    /* Damaged snapshots, the graph has 9 edges and 6 vertices: 'from'
+       starts at 0, 'to' at 9, 'oi' at 18, 'ii' at 27, 'os' at 36
+       and 'is' at 43 */
+    if (read_corrupt(&g, 0, 6, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 10, -1, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 20, 9, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 27, 1000000, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 18, 1, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 36, 1, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 38, 0, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 39, 1000000, 1) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 49, 8, 1) != IGRAPH_PARSEERROR) {
+        return 6;
+    }
+    /* The same value is accepted */
+    if (read_corrupt(&g, 0, 0, 1) != 0) {
+        return 7;
+    }
+    /* Without verification only the header is checked: its last
+       fields are the directedness, the number of vertices and edges
+       and the checksum */
+    if (read_corrupt(&g, -4, 0, 0) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, -1, 12345, 0) != IGRAPH_PARSEERROR ||
+        read_corrupt(&g, 20, 9, 0) != 0) {
+        return 8;
+    }
+
+    igraph_vector_destroy(&v);
+    igraph_destroy(&g);
+    remove("snapshot.bin");
+
+    return 0;
+}
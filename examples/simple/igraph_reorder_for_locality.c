@@ -0,0 +1,122 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+
+#include <igraph.h>
+#include <stdlib.h>
+
+/* The bandwidth of the adjacency matrix: the largest difference
+   between the ids of two adjacent vertices. */
+long int bandwidth(const igraph_t *graph) {
+    long int e, res = 0;
+    for (e = 0; e < igraph_ecount(graph); e++) {
+        long int d = labs((long int) IGRAPH_FROM(graph, e) -
+                          (long int) IGRAPH_TO(graph, e));
+        if (d > res) {
+            res = d;
+        }
+    }
+    return res;
+}
+
+int check_permutation(const igraph_vector_t *perm) {
+    igraph_vector_t sorted;
+    long int i, n = igraph_vector_size(perm);
+    igraph_vector_copy(&sorted, perm);
+    igraph_vector_sort(&sorted);
+    for (i = 0; i < n; i++) {
+        if (VECTOR(sorted)[i] != i) {
+            return 1;
+        }
+    }
+    igraph_vector_destroy(&sorted);
+    return 0;
+}
+
+int main() {
+    igraph_t grid, shuffled, res;
+    igraph_vector_t dim, perm, shuffle;
+    igraph_reorder_algorithm_t algos[] = { IGRAPH_REORDER_RCM,
+                                           IGRAPH_REORDER_DEGREE,
+                                           IGRAPH_REORDER_GORDER
+                                         };
+    const char *names[] = { "rcm", "degree", "gorder" };
+    long int i, a;
+
+    igraph_i_set_attribute_table(&igraph_cattribute_table);
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* A 20x20 grid with randomly shuffled vertex ids */
+    igraph_vector_init(&dim, 2);
+    VECTOR(dim)[0] = 20; VECTOR(dim)[1] = 20;
+    igraph_lattice(&grid, &dim, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_vector_init_seq(&shuffle, 0, igraph_vcount(&grid) - 1);
+    igraph_vector_shuffle(&shuffle);
+    igraph_permute_vertices(&grid, &shuffled, &shuffle);
+    for (i = 0; i < igraph_vcount(&shuffled); i++) {
+        SETVAN(&shuffled, "id", i, i);
+    }
+    printf("shuffled bandwidth large: %d\n", bandwidth(&shuffled) > 100);
+
+    igraph_vector_init(&perm, 0);
+    for (a = 0; a < 3; a++) {
+        igraph_reorder_for_locality(&shuffled, &res, &perm, algos[a]);
+        if (check_permutation(&perm)) {
+            printf("%s: invalid permutation\n", names[a]);
+            return 1;
+        }
+        /* The attributes are permuted with the vertices */
+        for (i = 0; i < igraph_vcount(&shuffled); i++) {
+            if (VAN(&res, "id", (long int) VECTOR(perm)[i]) != i) {
+                printf("%s: vertex attributes were not permuted\n", names[a]);
+                return 2;
+            }
+        }
+        if (igraph_ecount(&res) != igraph_ecount(&shuffled)) {
+            return 3;
+        }
+        printf("%s bandwidth: %li\n", names[a], bandwidth(&res));
+        igraph_destroy(&res);
+    }
+
+    /* Permutation only, on a small directed graph */
+    igraph_destroy(&grid);
+    igraph_small(&grid, 8, IGRAPH_DIRECTED,
+                 0, 1, 0, 2, 0, 3, 1, 2, 2, 4, 3, 4, 4, 5, 5, 6, 5, 7, 6, 7,
+                 -1);
+    for (a = 0; a < 3; a++) {
+        igraph_reorder_for_locality(&grid, 0, &perm, algos[a]);
+        printf("%s:", names[a]);
+        for (i = 0; i < igraph_vector_size(&perm); i++) {
+            printf(" %li", (long int) VECTOR(perm)[i]);
+        }
+        printf("\n");
+    }
+
+    igraph_vector_destroy(&perm);
+    igraph_vector_destroy(&shuffle);
+    igraph_vector_destroy(&dim);
+    igraph_destroy(&shuffled);
+    igraph_destroy(&grid);
+
+    return 0;
+}
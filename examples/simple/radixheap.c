@@ -0,0 +1,182 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include "igraph_types_internal.h"
+#include <math.h>
+
+/* The smallest active key of the reference, -1 if there is none */
+long int ref_min(const igraph_vector_t *keys, const igraph_vector_long_t *state) {
+    long int i, min = -1;
+    for (i = 0; i < igraph_vector_size(keys); i++) {
+        if (VECTOR(*state)[i] == 1 &&
+            (min < 0 || VECTOR(*keys)[i] < VECTOR(*keys)[min])) {
+            min = i;
+        }
+    }
+    return min;
+}
+
+/* Weighted shortest paths and diameter with integer weights, these
+   use the radix heap */
+int check_dijkstra(igraph_integer_t n, igraph_integer_t m,
+                   igraph_real_t maxweight, igraph_bool_t directed) {
+    igraph_t g;
+    igraph_vector_t weights;
+    igraph_matrix_t res, ref;
+    igraph_real_t diameter, expected = 0;
+    long int i, j;
+    int ok;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, n, m, directed,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, maxweight);
+    }
+
+    igraph_matrix_init(&res, 0, 0);
+    igraph_matrix_init(&ref, 0, 0);
+    igraph_shortest_paths_dijkstra(&g, &res, igraph_vss_all(), igraph_vss_all(),
+                                   &weights, IGRAPH_OUT);
+    igraph_shortest_paths_bellman_ford(&g, &ref, igraph_vss_all(),
+                                       igraph_vss_all(), &weights, IGRAPH_OUT);
+    ok = igraph_matrix_all_e(&res, &ref);
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            if (MATRIX(ref, i, j) != IGRAPH_INFINITY && MATRIX(ref, i, j) > expected) {
+                expected = MATRIX(ref, i, j);
+            }
+        }
+    }
+    igraph_diameter_dijkstra(&g, &weights, &diameter, 0, 0, 0, directed,
+                             /*unconn=*/ 1);
+    ok = ok && diameter == expected;
+
+    igraph_matrix_destroy(&ref);
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+    return ok;
+}
+
+int main() {
+    igraph_radixheap_t Q;
+    igraph_vector_t keys;
+    igraph_vector_long_t state;   /* 0: never added, 1: active, 2: removed */
+    long int n = 200, i, j, step;
+    igraph_real_t last = 0;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_radixheap_init(&Q, n);
+    igraph_vector_init(&keys, n);
+    igraph_vector_long_init(&state, n);
+
+    if (!igraph_radixheap_empty(&Q) || igraph_radixheap_size(&Q) != 0) {
+        return 1;
+    }
+
+    /* Random monotone operations, like in Dijkstra's algorithm: new
+       and decreased keys are never smaller than the last minimum. The
+       increments have very different magnitudes. */
+    for (step = 0; step < 5000; step++) {
+        long int op = RNG_INTEGER(0, 2);
+        igraph_real_t key = last +
+                            RNG_INTEGER(0, 1) * ldexp(1.0, (int) RNG_INTEGER(0, 40)) +
+                            RNG_INTEGER(0, 3);
+        i = RNG_INTEGER(0, n - 1);
+
+        if (op == 0 && VECTOR(state)[i] != 1) {
+            VECTOR(keys)[i] = key;
+            VECTOR(state)[i] = 1;
+            igraph_radixheap_push_with_index(&Q, i, key);
+        } else if (op == 1 && VECTOR(state)[i] == 1 && key < VECTOR(keys)[i]) {
+            VECTOR(keys)[i] = key;
+            igraph_radixheap_modify(&Q, i, key);
+        } else if (op == 2 && ref_min(&keys, &state) >= 0) {
+            igraph_real_t min = igraph_radixheap_deactivate_min_index(&Q, &j);
+            if (min != VECTOR(keys)[ref_min(&keys, &state)] ||
+                min != VECTOR(keys)[j] || VECTOR(state)[j] != 1) {
+                return 2;
+            }
+            VECTOR(state)[j] = 2;
+            last = min;
+        }
+
+        for (j = 0; j < n; j++) {
+            if (igraph_radixheap_has_elem(&Q, j) != (VECTOR(state)[j] != 0) ||
+                igraph_radixheap_has_active(&Q, j) != (VECTOR(state)[j] == 1)) {
+                return 3;
+            }
+            if (VECTOR(state)[j] == 1 &&
+                igraph_radixheap_get(&Q, j) != VECTOR(keys)[j]) {
+                return 4;
+            }
+        }
+    }
+
+    /* Deleting every element in order */
+    while (!igraph_radixheap_empty(&Q)) {
+        igraph_real_t min = igraph_radixheap_delete_min_index(&Q, &j);
+        if (min != VECTOR(keys)[ref_min(&keys, &state)] || min < last) {
+            return 5;
+        }
+        if (igraph_radixheap_has_elem(&Q, j)) {
+            return 6;
+        }
+        VECTOR(state)[j] = 0;
+        last = min;
+    }
+    if (ref_min(&keys, &state) >= 0 || igraph_radixheap_size(&Q) != 0) {
+        return 7;
+    }
+
+    /* Reuse after clearing */
+    igraph_radixheap_push_with_index(&Q, 3, 10);
+    igraph_radixheap_clear(&Q);
+    if (!igraph_radixheap_empty(&Q) || igraph_radixheap_has_elem(&Q, 3)) {
+        return 8;
+    }
+    igraph_radixheap_push_with_index(&Q, 5, 7);
+    igraph_radixheap_push_with_index(&Q, 2, 3);
+    igraph_radixheap_push_with_index(&Q, 8, 3);
+    if (igraph_radixheap_delete_min_index(&Q, &i) != 3 ||
+        igraph_radixheap_delete_min_index(&Q, &j) != 3 || i + j != 10 ||
+        igraph_radixheap_delete_min_index(&Q, &i) != 7 || i != 5) {
+        return 9;
+    }
+
+    igraph_vector_long_destroy(&state);
+    igraph_vector_destroy(&keys);
+    igraph_radixheap_destroy(&Q);
+
+    /* Through Dijkstra's algorithm */
+    if (!check_dijkstra(60, 200, 10, IGRAPH_DIRECTED) ||
+        !check_dijkstra(60, 60, 1000000, IGRAPH_UNDIRECTED) ||
+        !check_dijkstra(40, 300, 0, IGRAPH_DIRECTED)) {
+        return 10;
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* Adding edges in small batches only appends them to the edge list,
+   and they are merged into the existing indices when the graph is
+   queried. The result must be the same as creating the graph with
+   all edges at once, whether the graph is queried after a batch or
+   not, and also if vertices are added or the graph is copied while
+   it has edges that are not indexed yet. */
+
+int check_same(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t v1, v2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, m;
+
+    if (igraph_vcount(g1) != igraph_vcount(g2) ||
+        igraph_ecount(g1) != igraph_ecount(g2)) {
+        return 1;
+    }
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+
+    igraph_get_edgelist(g1, &v1, 0);
+    igraph_get_edgelist(g2, &v2, 0);
+    if (!igraph_vector_all_e(&v1, &v2)) {
+        return 2;
+    }
+
+    for (m = 0; m < 3; m++) {
+        for (i = 0; i < igraph_vcount(g1); i++) {
+            igraph_incident(g1, &v1, (igraph_integer_t) i, modes[m]);
+            igraph_incident(g2, &v2, (igraph_integer_t) i, modes[m]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                return 3;
+            }
+            igraph_neighbors(g1, &v1, (igraph_integer_t) i, modes[m]);
+            igraph_neighbors(g2, &v2, (igraph_integer_t) i, modes[m]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                return 4;
+            }
+        }
+    }
+
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g1, g2, g3;
+    igraph_vector_t edges, batch, neis;
+    long int no_of_nodes = 50, no_of_edges = 400;
+    long int i, pos;
+    int ret;
+
+    igraph_vector_init(&edges, 2 * no_of_edges);
+    for (i = 0; i < 2 * no_of_edges; i++) {
+        VECTOR(edges)[i] = RNG_INTEGER(0, no_of_nodes - 1);
+    }
+    /* some multi-edges and self-loops */
+    VECTOR(edges)[2] = VECTOR(edges)[0];
+    VECTOR(edges)[3] = VECTOR(edges)[1];
+    VECTOR(edges)[2 * no_of_edges - 1] = VECTOR(edges)[2 * no_of_edges - 2];
+
+    igraph_create(&g1, &edges, (igraph_integer_t) no_of_nodes + 3, directed);
+
+    igraph_empty(&g2, (igraph_integer_t) no_of_nodes, directed);
+    igraph_vector_init(&batch, 0);
+    igraph_vector_init(&neis, 0);
+    for (pos = 0; pos < no_of_edges; ) {
+        long int size = RNG_INTEGER(0, 7);
+        if (pos + size > no_of_edges) {
+            size = no_of_edges - pos;
+        }
+        igraph_vector_resize(&batch, 2 * size);
+        for (i = 0; i < 2 * size; i++) {
+            VECTOR(batch)[i] = VECTOR(edges)[2 * pos + i];
+        }
+        igraph_add_edges(&g2, &batch, 0);
+        pos += size;
+        if (RNG_INTEGER(0, 2) == 0) {
+            igraph_neighbors(&g2, &neis, 0, IGRAPH_ALL);
+        }
+        if (pos >= no_of_edges / 2 && igraph_vcount(&g2) == no_of_nodes) {
+            igraph_add_vertices(&g2, 3, 0);
+        }
+    }
+
+    /* the copy shares the indices, so it must index the new edges */
+    igraph_add_edges(&g2, &batch, 0);
+    igraph_add_edges(&g1, &batch, 0);
+    igraph_copy(&g3, &g2);
+
+    ret = check_same(&g1, &g2);
+    if (ret == 0) {
+        ret = check_same(&g1, &g3);
+    }
+
+    igraph_vector_destroy(&neis);
+    igraph_destroy(&g3);
+    igraph_vector_destroy(&batch);
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&g2);
+    igraph_destroy(&g1);
+
+    return ret;
+}
+
+int main() {
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    printf("directed: %d\n", ret);
+    ret = test(IGRAPH_UNDIRECTED);
+    printf("undirected: %d\n", ret);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* Flat adjacency and incidence lists must contain the same vectors as
+   the ones created by igraph_adjlist_init() and igraph_inclist_init(). */
+
+int same_lists(const igraph_vector_int_t *l1, const igraph_vector_int_t *l2,
+               long int n) {
+    long int i;
+    for (i = 0; i < n; i++) {
+        if (!igraph_vector_int_all_e(&l1[i], &l2[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int test(const igraph_t *graph) {
+    igraph_adjlist_t al1, al2;
+    igraph_inclist_t il1, il2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int n = igraph_vcount(graph);
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        igraph_adjlist_init(graph, &al1, modes[i]);
+        igraph_adjlist_init_flat(graph, &al2, modes[i]);
+        if (igraph_adjlist_size(&al2) != n || !same_lists(al1.adjs, al2.adjs, n)) {
+            return 1;
+        }
+        /* Shrinking the vectors is allowed */
+        igraph_adjlist_simplify(&al1);
+        igraph_adjlist_simplify(&al2);
+        if (!same_lists(al1.adjs, al2.adjs, n)) {
+            return 2;
+        }
+        igraph_adjlist_destroy(&al2);
+        igraph_adjlist_destroy(&al1);
+
+        igraph_inclist_init(graph, &il1, modes[i]);
+        igraph_inclist_init_flat(graph, &il2, modes[i]);
+        if (!same_lists(il1.incs, il2.incs, n)) {
+            return 3;
+        }
+        igraph_inclist_destroy(&il2);
+        igraph_inclist_destroy(&il1);
+    }
+
+    return 0;
+}
+
+int main() {
+    igraph_t graph;
+    igraph_vector_t edges;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Multiple edges, loops and isolated vertices */
+    igraph_vector_init(&edges, 400);
+    for (i = 0; i < 400; i++) {
+        VECTOR(edges)[i] = RNG_INTEGER(0, 59);
+    }
+    VECTOR(edges)[1] = VECTOR(edges)[0];
+
+    igraph_create(&graph, &edges, 70, IGRAPH_DIRECTED);
+    printf("directed: %d\n", test(&graph));
+    igraph_destroy(&graph);
+
+    igraph_create(&graph, &edges, 70, IGRAPH_UNDIRECTED);
+    printf("undirected: %d\n", test(&graph));
+    igraph_destroy(&graph);
+
+    igraph_empty(&graph, 0, IGRAPH_DIRECTED);
+    printf("empty: %d\n", test(&graph));
+    igraph_destroy(&graph);
+
+    igraph_vector_destroy(&edges);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* Computations inside an arena must give the same results as outside
+   of it, and repeated rounds must reuse the memory of the arena.
+   Objects created before the arena must survive it. */
+
+igraph_real_t compute(igraph_integer_t seed, igraph_vector_t *degree) {
+    igraph_t graph;
+    igraph_vector_t order;
+    igraph_dqueue_t q;
+    igraph_real_t trans;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), seed);
+    igraph_erdos_renyi_game(&graph, IGRAPH_ERDOS_RENYI_GNM, 50, 120,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_transitivity_undirected(&graph, &trans, IGRAPH_TRANSITIVITY_ZERO);
+
+    /* Growing and shrinking vectors and queues */
+    igraph_vector_init(&order, 0);
+    igraph_dqueue_init(&q, 1);
+    for (i = 0; i < 1000; i++) {
+        igraph_dqueue_push(&q, i);
+        igraph_vector_push_back(&order, i);
+        if (i % 3 == 0) {
+            igraph_dqueue_pop(&q);
+        }
+    }
+    trans += igraph_dqueue_size(&q) + igraph_vector_sum(&order);
+    igraph_dqueue_destroy(&q);
+    igraph_vector_destroy(&order);
+
+    /* Result vector created outside of the arena */
+    igraph_degree(&graph, degree, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+
+    igraph_destroy(&graph);
+    return trans;
+}
+
+int main() {
+    igraph_arena_t arena, other;
+    igraph_vector_t degree1, degree2;
+    igraph_real_t t1, t2;
+    size_t size = 0;
+    int i, same = 1, reused = 1, ret;
+
+    igraph_vector_init(&degree1, 0);
+    igraph_vector_init(&degree2, 0);
+
+    igraph_arena_init(&arena, 1024);
+    for (i = 0; i < 20; i++) {
+        t1 = compute(i, &degree1);
+
+        igraph_arena_begin(&arena);
+        t2 = compute(i, &degree2);
+        igraph_arena_end(&arena);
+
+        if (t1 != t2 || !igraph_vector_all_e(&degree1, &degree2)) {
+            same = 0;
+        }
+        if (i == 1) {
+            size = igraph_arena_size(&arena);
+        } else if (i > 1 && igraph_arena_size(&arena) != size) {
+            reused = 0;
+        }
+    }
+    printf("same results: %d\n", same);
+    printf("memory reused: %d\n", reused);
+
+    /* Nested arenas */
+    igraph_arena_init(&other, 0);
+    igraph_arena_begin(&arena);
+    igraph_vector_resize(&degree1, 10000);
+    igraph_arena_begin(&other);
+    t1 = compute(42, &degree2);
+    igraph_arena_end(&other);
+    t2 = compute(42, &degree2);
+    igraph_arena_end(&arena);
+    printf("nested: %d %d\n", t1 == t2, (int) igraph_vector_size(&degree1));
+
+    /* Only the current arena can be ended */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_arena_begin(&arena);
+    igraph_arena_begin(&other);
+    ret = igraph_arena_end(&arena) == IGRAPH_EINVAL;
+    igraph_arena_end(&other);
+    igraph_arena_end(&arena);
+    printf("errors: %d\n", ret);
+
+    igraph_arena_destroy(&other);
+    igraph_arena_destroy(&arena);
+    igraph_vector_destroy(&degree2);
+    igraph_vector_destroy(&degree1);
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* The direction-optimizing search must give the same distances as a
+   plain breadth-first search, and a valid search tree. The graphs
+   are large enough for the bottom-up steps. */
+
+int check_tree(const igraph_t *graph, const igraph_vector_t *dist,
+               const igraph_vector_t *father, igraph_integer_t root,
+               igraph_neimode_t mode) {
+    long int i, n = igraph_vcount(graph);
+    igraph_integer_t eid;
+
+    for (i = 0; i < n; i++) {
+        long int f = (long int) VECTOR(*father)[i];
+        if (i == root || VECTOR(*dist)[i] == IGRAPH_INFINITY) {
+            if (f != -1) {
+                return 0;
+            }
+            continue;
+        }
+        if (f < 0 || VECTOR(*dist)[f] != VECTOR(*dist)[i] - 1) {
+            return 0;
+        }
+        if (mode == IGRAPH_IN) {
+            igraph_get_eid(graph, &eid, i, f, IGRAPH_DIRECTED, /*error=*/ 0);
+        } else {
+            igraph_get_eid(graph, &eid, f, i, mode == IGRAPH_OUT, /*error=*/ 0);
+        }
+        if (eid < 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void check(const char *name, const igraph_t *graph, igraph_integer_t root,
+           igraph_neimode_t mode) {
+    igraph_vector_t ref, dist, father;
+    long int i, n = igraph_vcount(graph), reached = 0;
+    int ok_topdown = 1, ok_optimizing = 1;
+
+    igraph_vector_init(&ref, 0);
+    igraph_vector_init(&dist, 0);
+    igraph_vector_init(&father, 0);
+
+    igraph_bfs(graph, root, 0, mode, /*unreachable=*/ 0, 0, 0, 0, 0, 0, 0,
+               &ref, 0, 0);
+    for (i = 0; i < n; i++) {
+        if (isnan(VECTOR(ref)[i])) {
+            VECTOR(ref)[i] = IGRAPH_INFINITY;
+        } else {
+            reached++;
+        }
+    }
+
+    igraph_bfs_distances(graph, &dist, &father, root, mode, IGRAPH_BFS_TOPDOWN);
+    ok_topdown = igraph_vector_all_e(&dist, &ref) &&
+                 check_tree(graph, &dist, &father, root, mode);
+    igraph_bfs_distances(graph, &dist, &father, root, mode,
+                         IGRAPH_BFS_DIRECTION_OPTIMIZING);
+    ok_optimizing = igraph_vector_all_e(&dist, &ref) &&
+                    check_tree(graph, &dist, &father, root, mode);
+
+    printf("%s: reached %ld, top-down %d, direction-optimizing %d\n", name,
+           reached, ok_topdown, ok_optimizing);
+
+    igraph_vector_destroy(&father);
+    igraph_vector_destroy(&dist);
+    igraph_vector_destroy(&ref);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t dist;
+    igraph_matrix_t res;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Small world, undirected */
+    igraph_barabasi_game(&g, 3000, /*power=*/ 1, /*m=*/ 5, 0, /*outpref=*/ 0,
+                         /*A=*/ 1, IGRAPH_UNDIRECTED, IGRAPH_BARABASI_PSUMTREE,
+                         0);
+    check("ba", &g, 0, IGRAPH_ALL);
+    check("ba leaf", &g, 2999, IGRAPH_ALL);
+    igraph_destroy(&g);
+
+    /* Directed, several components, loops and multi-edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 2000, 12000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_add_vertices(&g, 100, 0);
+    igraph_add_edge(&g, 5, 5);
+    igraph_add_edge(&g, 5, 6);
+    igraph_add_edge(&g, 5, 6);
+    check("gnm out", &g, 5, IGRAPH_OUT);
+    check("gnm in", &g, 5, IGRAPH_IN);
+    check("gnm all", &g, 5, IGRAPH_ALL);
+    check("gnm isolated", &g, 2050, IGRAPH_OUT);
+    igraph_destroy(&g);
+
+    /* Large diameter */
+    igraph_ring(&g, 1000, IGRAPH_UNDIRECTED, 0, /*circular=*/ 1);
+    check("ring", &g, 10, IGRAPH_ALL);
+    igraph_destroy(&g);
+
+    igraph_empty(&g, 1, IGRAPH_DIRECTED);
+    check("singleton", &g, 0, IGRAPH_OUT);
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_vector_init(&dist, 0);
+    printf("invalid root: %d\n",
+           igraph_bfs_distances(&g, &dist, 0, 1, IGRAPH_OUT,
+                                IGRAPH_BFS_TOPDOWN) == IGRAPH_EINVVID);
+    printf("invalid mode: %d\n",
+           igraph_bfs_distances(&g, &dist, 0, 0, (igraph_neimode_t) 42,
+                                IGRAPH_BFS_TOPDOWN) == IGRAPH_EINVMODE);
+    igraph_vector_destroy(&dist);
+    igraph_destroy(&g);
+    igraph_set_error_handler(igraph_error_handler_abort);
+
+    /* igraph_shortest_paths() from one vertex uses the search too */
+    igraph_small(&g, 5, IGRAPH_DIRECTED, 0, 1, 1, 2, 2, 0, 3, 4, -1);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths(&g, &res, igraph_vss_1(1), igraph_vss_all(), IGRAPH_OUT);
+    igraph_matrix_print(&res);
+    igraph_shortest_paths(&g, &res, igraph_vss_1(4), igraph_vss_all(), IGRAPH_ALL);
+    igraph_matrix_print(&res);
+    igraph_matrix_destroy(&res);
+    igraph_destroy(&g);
+
+    return 0;
+}
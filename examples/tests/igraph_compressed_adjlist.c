@@ -0,0 +1,221 @@
+#include <igraph.h>
+#include <math.h>
+#include "test_utilities.inc"
+
+/* The compressed adjacency list must decode to the same neighbors as
+   igraph_neighbors(), and the algorithms running on it must give the
+   same results as their igraph_t counterparts. */
+
+int same_vector(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+    long int i, n = igraph_vector_size(v1);
+    if (igraph_vector_size(v2) != n) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_real_t a = VECTOR(*v1)[i], b = VECTOR(*v2)[i];
+        if (!(a == b || (igraph_is_nan(a) && igraph_is_nan(b)))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int check_neighbors(const igraph_t *graph, igraph_neimode_t mode) {
+    igraph_compressed_adjlist_t al;
+    igraph_vector_t neis;
+    igraph_vector_int_t cneis;
+    long int i, j, n = igraph_vcount(graph);
+    int ret = 0;
+
+    igraph_compressed_adjlist_init(graph, &al, mode);
+    igraph_vector_init(&neis, 0);
+    igraph_vector_int_init(&cneis, 0);
+    if (igraph_compressed_adjlist_size(&al) != n) {
+        ret = 1;
+    }
+    for (i = 0; i < n && !ret; i++) {
+        igraph_neighbors(graph, &neis, i, mode);
+        igraph_compressed_adjlist_get(&al, i, &cneis);
+        if (igraph_vector_int_size(&cneis) != igraph_vector_size(&neis) ||
+            igraph_compressed_adjlist_degree(&al, i) != igraph_vector_size(&neis)) {
+            ret = 2;
+        }
+        for (j = 0; j < igraph_vector_size(&neis) && !ret; j++) {
+            if (VECTOR(cneis)[j] != VECTOR(neis)[j]) {
+                ret = 3;
+            }
+        }
+    }
+
+    igraph_vector_int_destroy(&cneis);
+    igraph_vector_destroy(&neis);
+    igraph_compressed_adjlist_destroy(&al);
+    return ret;
+}
+
+int check_bfs(const igraph_t *graph, igraph_neimode_t mode) {
+    igraph_compressed_adjlist_t al;
+    igraph_vector_t order1, order2, dist1, dist2;
+    long int root;
+    int ret = 0;
+
+    igraph_compressed_adjlist_init(graph, &al, mode);
+    igraph_vector_init(&order1, 0);
+    igraph_vector_init(&order2, 0);
+    igraph_vector_init(&dist1, 0);
+    igraph_vector_init(&dist2, 0);
+    for (root = 0; root < igraph_vcount(graph) && !ret; root += 7) {
+        igraph_bfs(graph, root, 0, mode, /*unreachable=*/ 0, 0, &order1, 0, 0,
+                   0, 0, &dist1, 0, 0);
+        igraph_compressed_adjlist_bfs(&al, root, &order2, &dist2);
+        if (!same_vector(&order1, &order2) || !same_vector(&dist1, &dist2)) {
+            ret = 1;
+        }
+    }
+
+    igraph_vector_destroy(&dist2);
+    igraph_vector_destroy(&dist1);
+    igraph_vector_destroy(&order2);
+    igraph_vector_destroy(&order1);
+    igraph_compressed_adjlist_destroy(&al);
+    return ret;
+}
+
+int check_clusters(const igraph_t *graph) {
+    igraph_compressed_adjlist_t al;
+    igraph_vector_t membership1, membership2, csize1, csize2;
+    igraph_integer_t no1, no2;
+    int ret = 0;
+
+    igraph_compressed_adjlist_init(graph, &al, IGRAPH_ALL);
+    igraph_vector_init(&membership1, 0);
+    igraph_vector_init(&membership2, 0);
+    igraph_vector_init(&csize1, 0);
+    igraph_vector_init(&csize2, 0);
+    igraph_clusters(graph, &membership1, &csize1, &no1, IGRAPH_WEAK);
+    igraph_compressed_adjlist_clusters(&al, &membership2, &csize2, &no2);
+    if (no1 != no2 || !same_vector(&membership1, &membership2) ||
+        !same_vector(&csize1, &csize2)) {
+        ret = 1;
+    }
+
+    igraph_vector_destroy(&csize2);
+    igraph_vector_destroy(&csize1);
+    igraph_vector_destroy(&membership2);
+    igraph_vector_destroy(&membership1);
+    igraph_compressed_adjlist_destroy(&al);
+    return ret;
+}
+
+int check_pagerank(const igraph_t *graph) {
+    igraph_compressed_adjlist_t al;
+    igraph_vector_t pr1, pr2;
+    long int i;
+    int ret = 0;
+
+    igraph_compressed_adjlist_init(graph, &al, IGRAPH_IN);
+    igraph_vector_init(&pr1, 0);
+    igraph_vector_init(&pr2, 0);
+    igraph_pagerank(graph, IGRAPH_PAGERANK_ALGO_PRPACK, &pr1, 0, igraph_vss_all(),
+                    igraph_is_directed(graph), 0.85, 0, 0);
+    igraph_compressed_adjlist_pagerank(&al, &pr2, 0.85);
+    for (i = 0; i < igraph_vcount(graph); i++) {
+        if (fabs(VECTOR(pr1)[i] - VECTOR(pr2)[i]) > 1e-8) {
+            ret = 1;
+        }
+    }
+
+    igraph_vector_destroy(&pr2);
+    igraph_vector_destroy(&pr1);
+    igraph_compressed_adjlist_destroy(&al);
+    return ret;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t graph;
+    igraph_vector_t edges;
+    long int no_of_nodes = 300, no_of_edges = 400, i;
+    int ret;
+
+    /* Sparse, so that there are several components and dangling
+       vertices, with some far away neighbors */
+    igraph_vector_init(&edges, 2 * no_of_edges);
+    for (i = 0; i < no_of_edges; i++) {
+        long int from = RNG_INTEGER(0, no_of_nodes - 1), to;
+        do {
+            to = (i % 10 == 0) ? RNG_INTEGER(0, no_of_nodes - 1) :
+                 from + RNG_INTEGER(-5, 5);
+        } while (to < 0 || to >= no_of_nodes || to == from);
+        VECTOR(edges)[2 * i] = from;
+        VECTOR(edges)[2 * i + 1] = to;
+    }
+    igraph_create(&graph, &edges, (igraph_integer_t) no_of_nodes, directed);
+    igraph_vector_destroy(&edges);
+
+    if ((ret = check_neighbors(&graph, IGRAPH_OUT)) != 0 ||
+        (ret = check_neighbors(&graph, IGRAPH_IN)) != 0 ||
+        (ret = check_neighbors(&graph, IGRAPH_ALL)) != 0) {
+        return ret;
+    }
+    if (check_bfs(&graph, IGRAPH_OUT) || check_bfs(&graph, IGRAPH_ALL)) {
+        return 4;
+    }
+    if (check_clusters(&graph)) {
+        return 5;
+    }
+    if (check_pagerank(&graph)) {
+        return 6;
+    }
+
+    igraph_destroy(&graph);
+    return 0;
+}
+
+int main() {
+    igraph_t graph;
+    igraph_compressed_adjlist_t al;
+    igraph_vector_t dims, pr;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    printf("directed: %d\n", ret);
+    ret = test(IGRAPH_UNDIRECTED);
+    printf("undirected: %d\n", ret);
+
+    /* Loops and multiple edges are kept */
+    igraph_small(&graph, 4, IGRAPH_UNDIRECTED, 0, 1, 0, 1, 1, 1, 3, 0, -1);
+    ret = check_neighbors(&graph, IGRAPH_ALL);
+    printf("multigraph: %d\n", ret);
+
+    /* Most gaps in a lattice fit into one byte, every undirected edge
+       is stored in the lists of both endpoints */
+    igraph_destroy(&graph);
+    igraph_vector_init(&dims, 2);
+    VECTOR(dims)[0] = VECTOR(dims)[1] = 100;
+    igraph_lattice(&graph, &dims, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_vector_destroy(&dims);
+    igraph_compressed_adjlist_init(&graph, &al, IGRAPH_ALL);
+    printf("lattice bytes per edge: %.2f\n",
+           (double) (igraph_compressed_adjlist_bytes(&al) -
+                     sizeof(size_t) * (igraph_vcount(&graph) + 1)) /
+           igraph_ecount(&graph));
+    igraph_compressed_adjlist_destroy(&al);
+    igraph_destroy(&graph);
+
+    /* Empty graph, and errors */
+    igraph_empty(&graph, 0, IGRAPH_DIRECTED);
+    igraph_compressed_adjlist_init(&graph, &al, IGRAPH_OUT);
+    igraph_vector_init(&pr, 0);
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_compressed_adjlist_clusters(&al, 0, 0, 0) != IGRAPH_EINVMODE ||
+          igraph_compressed_adjlist_pagerank(&al, &pr, 0.85) != IGRAPH_EINVMODE ||
+          igraph_compressed_adjlist_bfs(&al, 0, 0, 0) != IGRAPH_EINVVID;
+    printf("errors: %d\n", ret);
+    igraph_vector_destroy(&pr);
+    igraph_compressed_adjlist_destroy(&al);
+    igraph_destroy(&graph);
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* igraph_copy() shares the structure of the graphs until one of them
+   is modified, modifying one graph must never change the other. */
+
+int same_graph(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t e1, e2;
+    igraph_bool_t iso;
+    int ret;
+
+    igraph_vector_init(&e1, 0);
+    igraph_vector_init(&e2, 0);
+    igraph_get_edgelist(g1, &e1, 0);
+    igraph_get_edgelist(g2, &e2, 0);
+    ret = igraph_vcount(g1) == igraph_vcount(g2) && igraph_vector_all_e(&e1, &e2);
+    igraph_vector_destroy(&e2);
+    igraph_vector_destroy(&e1);
+
+    /* The indices must be consistent, too */
+    if (ret) {
+        igraph_isomorphic(g1, g2, &iso);
+        ret = iso;
+    }
+    return ret;
+}
+
+int main() {
+    igraph_t g, orig, c1, c2, c3;
+    igraph_vector_t edges;
+
+    igraph_small(&g, 6, IGRAPH_DIRECTED, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 0, 0, 3, -1);
+    igraph_copy(&orig, &g);
+
+    /* Copies of copies share the same structure */
+    igraph_copy(&c1, &g);
+    igraph_copy(&c2, &c1);
+    igraph_copy(&c3, &c2);
+    printf("copies: %d %d %d\n", same_graph(&c1, &g), same_graph(&c2, &g),
+           same_graph(&c3, &g));
+
+    /* Modifying a copy does not modify the others */
+    igraph_vector_init(&edges, 2);
+    VECTOR(edges)[0] = 2;
+    VECTOR(edges)[1] = 5;
+    igraph_add_edges(&c1, &edges, 0);
+    igraph_delete_edges(&c2, igraph_ess_1(0));
+    igraph_delete_vertices(&c3, igraph_vss_1(3));
+    printf("modified copies: %d %d %d %d\n", (int) igraph_ecount(&c1),
+           (int) igraph_ecount(&c2), (int) igraph_vcount(&c3),
+           same_graph(&g, &orig));
+
+    /* Modifying the original does not modify the copy */
+    igraph_destroy(&c1);
+    igraph_copy(&c1, &g);
+    igraph_add_vertices(&g, 2, 0);
+    printf("modified original: %d %d\n", (int) igraph_vcount(&c1),
+           same_graph(&c1, &orig));
+
+    /* The last user of the structure can modify it */
+    igraph_destroy(&g);
+    igraph_copy(&g, &c1);
+    igraph_destroy(&c1);
+    igraph_add_edges(&g, &edges, 0);
+    printf("last user: %d\n", (int) igraph_ecount(&g));
+
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&c3);
+    igraph_destroy(&c2);
+    igraph_destroy(&orig);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <igraph.h>
+#include <pthread.h>
+
+/* Several threads copy the same graph at the same time, the first
+   copy indexes the edges added last and makes the graph shareable.
+   The copies must be correct, and destroying the copies and the graph
+   must free everything once. */
+
+#define THREADS 4
+
+typedef struct {
+    const igraph_t *graph;
+    pthread_mutex_t *mutex;
+    pthread_cond_t *cond;
+    int *go;
+    igraph_t copies[8];
+} thread_data_t;
+
+void *copy_graph(void *arg) {
+    thread_data_t *data = arg;
+    int i;
+
+    /* Start together with the other threads */
+    pthread_mutex_lock(data->mutex);
+    while (!*data->go) {
+        pthread_cond_wait(data->cond, data->mutex);
+    }
+    pthread_mutex_unlock(data->mutex);
+
+    for (i = 0; i < 8; i++) {
+        igraph_copy(&data->copies[i], data->graph);
+    }
+    /* Some copies are destroyed while the others still copy */
+    for (i = 0; i < 4; i++) {
+        igraph_destroy(&data->copies[i]);
+    }
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    pthread_t threads[THREADS];
+    thread_data_t data[THREADS];
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+    int round, t, i, go;
+
+    /* Skip if igraph is not thread-safe */
+    if (!IGRAPH_THREAD_SAFE) {
+        return 77;
+    }
+
+    for (round = 0; round < 200; round++) {
+        igraph_vector_t edges, copy_edges, deg, copy_deg;
+        igraph_real_t newedges[] = { 0, 50, 50, 0, 0, 0 };
+
+        igraph_ring(&g, 100 + round, IGRAPH_DIRECTED, 0, /*circular=*/ 1);
+        igraph_vector_view(&edges, newedges, 2 + 2 * (round % 3));
+        igraph_add_edges(&g, &edges, 0);
+        go = 0;
+        for (t = 0; t < THREADS; t++) {
+            data[t].graph = &g;
+            data[t].mutex = &mutex;
+            data[t].cond = &cond;
+            data[t].go = &go;
+            pthread_create(&threads[t], NULL, copy_graph, &data[t]);
+        }
+        pthread_mutex_lock(&mutex);
+        go = 1;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mutex);
+        for (t = 0; t < THREADS; t++) {
+            pthread_join(threads[t], NULL);
+        }
+
+        igraph_vector_init(&edges, 0);
+        igraph_vector_init(&copy_edges, 0);
+        igraph_vector_init(&deg, 0);
+        igraph_vector_init(&copy_deg, 0);
+        igraph_get_edgelist(&g, &edges, 0);
+        igraph_degree(&g, &deg, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+        for (t = 0; t < THREADS; t++) {
+            for (i = 4; i < 8; i++) {
+                igraph_get_edgelist(&data[t].copies[i], &copy_edges, 0);
+                if (!igraph_vector_all_e(&edges, &copy_edges)) {
+                    return 1;
+                }
+                igraph_degree(&data[t].copies[i], &copy_deg, igraph_vss_all(),
+                              IGRAPH_ALL, IGRAPH_LOOPS);
+                if (!igraph_vector_all_e(&deg, &copy_deg)) {
+                    return 2;
+                }
+            }
+        }
+        igraph_vector_destroy(&copy_deg);
+        igraph_vector_destroy(&deg);
+        igraph_vector_destroy(&copy_edges);
+        igraph_vector_destroy(&edges);
+
+        /* The original first, then the copies */
+        igraph_destroy(&g);
+        for (t = 0; t < THREADS; t++) {
+            for (i = 4; i < 8; i++) {
+                igraph_destroy(&data[t].copies[i]);
+            }
+        }
+    }
+
+    return 0;
+}
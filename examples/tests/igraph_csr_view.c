@@ -0,0 +1,96 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* The neighbor view must list the same neighbors in the same order
+   as igraph_neighbors(), and the same edges as igraph_incident(). */
+
+int check_view(const igraph_t *g) {
+    igraph_vector_t neis, eids;
+    igraph_csr_view_t view;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, j, m;
+
+    igraph_vector_init(&neis, 0);
+    igraph_vector_init(&eids, 0);
+
+    for (m = 0; m < 3; m++) {
+        for (i = 0; i < igraph_vcount(g); i++) {
+            igraph_neighbors(g, &neis, (igraph_integer_t) i, modes[m]);
+            igraph_csr_view(g, &view, (igraph_integer_t) i, modes[m]);
+            if (IGRAPH_CSR_VIEW_SIZE(view) != igraph_vector_size(&neis)) {
+                return 1;
+            }
+            for (j = 0; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view), j++) {
+                long int edge = IGRAPH_CSR_VIEW_EDGE(view);
+                if (IGRAPH_CSR_VIEW_NEIGHBOR(view) != VECTOR(neis)[j] ||
+                    IGRAPH_OTHER(g, edge, i) != VECTOR(neis)[j]) {
+                    return 2;
+                }
+            }
+
+            igraph_incident(g, &eids, (igraph_integer_t) i, modes[m]);
+            igraph_csr_view(g, &view, (igraph_integer_t) i, modes[m]);
+            view.merge = 0;
+            for (j = 0; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view), j++) {
+                if (IGRAPH_CSR_VIEW_EDGE(view) != VECTOR(eids)[j]) {
+                    return 3;
+                }
+            }
+            if (j != igraph_vector_size(&eids)) {
+                return 4;
+            }
+        }
+    }
+
+    igraph_vector_destroy(&eids);
+    igraph_vector_destroy(&neis);
+    return 0;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g;
+    igraph_vector_t edges;
+    long int no_of_nodes = 30, no_of_edges = 200;
+    long int i;
+    int ret;
+
+    igraph_vector_init(&edges, 2 * no_of_edges);
+    for (i = 0; i < 2 * no_of_edges; i++) {
+        VECTOR(edges)[i] = RNG_INTEGER(0, no_of_nodes - 1);
+    }
+    /* some multi-edges and self-loops, and an isolated vertex */
+    VECTOR(edges)[2] = VECTOR(edges)[0];
+    VECTOR(edges)[3] = VECTOR(edges)[1];
+    VECTOR(edges)[5] = VECTOR(edges)[4];
+    igraph_create(&g, &edges, (igraph_integer_t) no_of_nodes + 1, directed);
+
+    ret = check_view(&g);
+
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&g);
+    return ret;
+}
+
+int main() {
+    igraph_t g;
+    igraph_csr_view_t view;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    printf("directed: %d\n", ret);
+    ret = test(IGRAPH_UNDIRECTED);
+    printf("undirected: %d\n", ret);
+
+    /* Invalid arguments */
+    igraph_small(&g, 3, IGRAPH_DIRECTED, 0, 1, 1, 2, -1);
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_csr_view(&g, &view, 3, IGRAPH_OUT);
+    printf("invalid vertex: %d\n", ret == IGRAPH_EINVVID);
+    ret = igraph_csr_view(&g, &view, 0, (igraph_neimode_t) 42);
+    printf("invalid mode: %d\n", ret == IGRAPH_EINVMODE);
+    igraph_destroy(&g);
+
+    return 0;
+}
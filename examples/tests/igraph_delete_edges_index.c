@@ -0,0 +1,91 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* Deleting edges and vertices compacts the indices in place. The
+   result must be the same as creating the graph from the remaining
+   edges. */
+
+int check_index(const igraph_t *graph) {
+    igraph_t g2;
+    igraph_vector_t v1, v2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, m;
+    int ret = 0;
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+
+    igraph_get_edgelist(graph, &v1, 0);
+    igraph_create(&g2, &v1, igraph_vcount(graph), igraph_is_directed(graph));
+
+    for (m = 0; m < 3 && ret == 0; m++) {
+        for (i = 0; i < igraph_vcount(graph) && ret == 0; i++) {
+            igraph_incident(graph, &v1, (igraph_integer_t) i, modes[m]);
+            igraph_incident(&g2, &v2, (igraph_integer_t) i, modes[m]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                ret = 1;
+            }
+            igraph_neighbors(graph, &v1, (igraph_integer_t) i, modes[m]);
+            igraph_neighbors(&g2, &v2, (igraph_integer_t) i, modes[m]);
+            if (!igraph_vector_all_e(&v1, &v2)) {
+                ret = 2;
+            }
+        }
+    }
+
+    igraph_destroy(&g2);
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+    return ret;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t graph;
+    igraph_vector_t edges, todel;
+    long int i;
+    int ret;
+
+    igraph_vector_init(&edges, 600);
+    for (i = 0; i < 600; i++) {
+        VECTOR(edges)[i] = RNG_INTEGER(0, 39);
+    }
+    igraph_create(&graph, &edges, 40, directed);
+
+    igraph_vector_init(&todel, 0);
+    while (igraph_ecount(&graph) > 20) {
+        igraph_vector_clear(&todel);
+        for (i = 0; i < 15; i++) {
+            igraph_vector_push_back(&todel, RNG_INTEGER(0, igraph_ecount(&graph) - 1));
+        }
+        igraph_delete_edges(&graph, igraph_ess_vector(&todel));
+        if ((ret = check_index(&graph)) != 0) {
+            return ret;
+        }
+    }
+
+    igraph_vector_clear(&todel);
+    for (i = 0; i < 10; i++) {
+        igraph_vector_push_back(&todel, RNG_INTEGER(0, 39));
+    }
+    igraph_delete_vertices(&graph, igraph_vss_vector(&todel));
+    ret = check_index(&graph);
+
+    igraph_vector_destroy(&todel);
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&graph);
+
+    return ret;
+}
+
+int main() {
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+
+    ret = test(IGRAPH_DIRECTED);
+    printf("directed: %d\n", ret);
+    ret = test(IGRAPH_UNDIRECTED);
+    printf("undirected: %d\n", ret);
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* igraph_shortest_paths_dijkstra() and
+   igraph_get_shortest_paths_dijkstra() use parallel delta-stepping
+   on graphs with at least 50000 vertices, if the distances to all
+   vertices are needed. The distances must be the same as with
+   Dijkstra's algorithm, the predecessors must form a shortest path
+   tree, and they must not depend on the number of threads. */
+
+int check_tree(const igraph_t *graph, const igraph_vector_t *weights,
+               const igraph_matrix_t *dist, igraph_integer_t from,
+               const igraph_vector_long_t *pred,
+               const igraph_vector_long_t *inbound) {
+    long int i, n = igraph_vcount(graph);
+    for (i = 0; i < n; i++) {
+        long int p = VECTOR(*pred)[i], e = VECTOR(*inbound)[i];
+        if (i == from) {
+            if (p != i || e != -1) {
+                return 0;
+            }
+        } else if (MATRIX(*dist, 0, i) == IGRAPH_INFINITY) {
+            if (p != -1 || e != -1) {
+                return 0;
+            }
+        } else if (e < 0 || IGRAPH_OTHER(graph, e, i) != p ||
+                   MATRIX(*dist, 0, p) + VECTOR(*weights)[e] !=
+                   MATRIX(*dist, 0, i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void check(const char *name, const igraph_t *graph,
+           const igraph_vector_t *weights, igraph_neimode_t mode) {
+    igraph_matrix_t ref, res1, res4;
+    igraph_vector_t from;
+    igraph_vector_long_t pred1, inbound1, pred4, inbound4;
+    igraph_integer_t source = 17, n = igraph_vcount(graph);
+    int paths_ok, tree_ok, same_ok;
+
+    igraph_matrix_init(&ref, 0, 0);
+    igraph_matrix_init(&res1, 0, 0);
+    igraph_matrix_init(&res4, 0, 0);
+    igraph_vector_init_seq(&from, 17, 19);
+    igraph_vector_long_init(&pred1, 0);
+    igraph_vector_long_init(&inbound1, 0);
+    igraph_vector_long_init(&pred4, 0);
+    igraph_vector_long_init(&inbound4, 0);
+
+    /* Dijkstra's algorithm, the targets are not given as all vertices */
+    igraph_shortest_paths_dijkstra(graph, &ref, igraph_vss_vector(&from),
+                                   igraph_vss_seq(0, n - 1), weights, mode);
+
+    igraph_set_num_threads(1);
+    igraph_shortest_paths_dijkstra(graph, &res1, igraph_vss_vector(&from),
+                                   igraph_vss_all(), weights, mode);
+    igraph_get_shortest_paths_dijkstra(graph, 0, 0, source, igraph_vss_all(),
+                                       weights, mode, &pred1, &inbound1);
+    igraph_set_num_threads(4);
+    igraph_shortest_paths_dijkstra(graph, &res4, igraph_vss_vector(&from),
+                                   igraph_vss_all(), weights, mode);
+    igraph_get_shortest_paths_dijkstra(graph, 0, 0, source, igraph_vss_all(),
+                                       weights, mode, &pred4, &inbound4);
+
+    paths_ok = igraph_matrix_all_e(&ref, &res1) && igraph_matrix_all_e(&ref, &res4);
+    tree_ok = check_tree(graph, weights, &ref, source, &pred1, &inbound1);
+    same_ok = igraph_vector_long_all_e(&pred1, &pred4) &&
+              igraph_vector_long_all_e(&inbound1, &inbound4);
+
+    printf("%s: distances %d, tree %d, same paths %d\n", name, paths_ok,
+           tree_ok, same_ok);
+
+    igraph_vector_long_destroy(&inbound4);
+    igraph_vector_long_destroy(&pred4);
+    igraph_vector_long_destroy(&inbound1);
+    igraph_vector_long_destroy(&pred1);
+    igraph_vector_destroy(&from);
+    igraph_matrix_destroy(&res4);
+    igraph_matrix_destroy(&res1);
+    igraph_matrix_destroy(&ref);
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t dims, weights;
+    long int i;
+
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* A road-like grid with real weights */
+    igraph_vector_init_int(&dims, 2, 250, 250);
+    igraph_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(0.5, 10);
+    }
+    check("grid", &g, &weights, IGRAPH_ALL);
+
+    /* Small integer weights with many ties, and zero weights */
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 3);
+    }
+    check("grid integer", &g, &weights, IGRAPH_ALL);
+    igraph_destroy(&g);
+
+    /* Directed, not strongly connected, few heavy edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 60000, 150000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF01() < 0.01 ? 1000 : RNG_UNIF01();
+    }
+    check("directed out", &g, &weights, IGRAPH_OUT);
+    check("directed in", &g, &weights, IGRAPH_IN);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&weights);
+    igraph_vector_destroy(&dims);
+
+    return 0;
+}
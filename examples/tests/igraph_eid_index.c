@@ -0,0 +1,133 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* The edge id index must give the same results as the binary
+   search, also for multiple edges and loops, and it must be dropped
+   when the graph is modified. */
+
+int check_all_pairs(const igraph_t *g1, const igraph_t *g2) {
+    igraph_integer_t eid1, eid2;
+    long int i, j, n = igraph_vcount(g1);
+    igraph_bool_t directed;
+
+    for (directed = 0; directed <= 1; directed++) {
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < n; j++) {
+                igraph_get_eid(g1, &eid1, i, j, directed, /*error=*/ 0);
+                igraph_get_eid(g2, &eid2, i, j, directed, /*error=*/ 0);
+                if (eid1 != eid2) {
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int check_eids(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t pairs, path, eids1, eids2;
+    long int i, n = igraph_vcount(g1);
+    int ret = 0;
+
+    igraph_vector_init(&pairs, 200);
+    igraph_vector_init(&path, 50);
+    for (i = 0; i < 200; i++) {
+        VECTOR(pairs)[i] = RNG_INTEGER(0, n - 1);
+    }
+    for (i = 0; i < 50; i++) {
+        VECTOR(path)[i] = RNG_INTEGER(0, n - 1);
+    }
+    igraph_vector_init(&eids1, 0);
+    igraph_vector_init(&eids2, 0);
+    igraph_get_eids(g1, &eids1, &pairs, &path, IGRAPH_DIRECTED, /*error=*/ 0);
+    igraph_get_eids(g2, &eids2, &pairs, &path, IGRAPH_DIRECTED, /*error=*/ 0);
+    if (!igraph_vector_all_e(&eids1, &eids2)) {
+        ret = 1;
+    }
+
+    igraph_vector_destroy(&eids2);
+    igraph_vector_destroy(&eids1);
+    igraph_vector_destroy(&path);
+    igraph_vector_destroy(&pairs);
+    return ret;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t g1, g2;
+    igraph_vector_t edges;
+    long int no_of_nodes = 40, no_of_edges = 300;
+    long int i;
+    int ret;
+
+    igraph_vector_init(&edges, 2 * no_of_edges);
+    for (i = 0; i < 2 * no_of_edges; i++) {
+        VECTOR(edges)[i] = RNG_INTEGER(0, no_of_nodes - 1);
+    }
+    /* some multi-edges and self-loops */
+    VECTOR(edges)[2] = VECTOR(edges)[0];
+    VECTOR(edges)[3] = VECTOR(edges)[1];
+    VECTOR(edges)[6] = VECTOR(edges)[1];
+    VECTOR(edges)[7] = VECTOR(edges)[0];
+    VECTOR(edges)[9] = VECTOR(edges)[8];
+
+    igraph_create(&g1, &edges, (igraph_integer_t) no_of_nodes, directed);
+    igraph_copy(&g2, &g1);
+    igraph_build_eid_index(&g2);
+    /* building it again is a no-op */
+    igraph_build_eid_index(&g2);
+
+    if ((ret = check_all_pairs(&g1, &g2)) != 0) {
+        return ret;
+    }
+    if (check_eids(&g1, &g2)) {
+        return 2;
+    }
+
+    /* The index is dropped when the graph is modified */
+    igraph_vector_resize(&edges, 20);
+    igraph_add_edges(&g1, &edges, 0);
+    igraph_add_edges(&g2, &edges, 0);
+    if (check_all_pairs(&g1, &g2)) {
+        return 3;
+    }
+    igraph_build_eid_index(&g2);
+    igraph_delete_vertices(&g1, igraph_vss_1(0));
+    igraph_delete_vertices(&g2, igraph_vss_1(0));
+    if (check_all_pairs(&g1, &g2)) {
+        return 4;
+    }
+    igraph_build_eid_index(&g2);
+    igraph_delete_edges(&g1, igraph_ess_1(5));
+    igraph_delete_edges(&g2, igraph_ess_1(5));
+    if (check_all_pairs(&g1, &g2)) {
+        return 5;
+    }
+    igraph_drop_eid_index(&g2);
+    igraph_drop_eid_index(&g2);
+
+    igraph_vector_destroy(&edges);
+    igraph_destroy(&g2);
+    igraph_destroy(&g1);
+    return 0;
+}
+
+int main() {
+    igraph_t g;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    ret = test(IGRAPH_DIRECTED);
+    printf("directed: %d\n", ret);
+    ret = test(IGRAPH_UNDIRECTED);
+    printf("undirected: %d\n", ret);
+
+    /* Empty graph */
+    igraph_empty(&g, 3, IGRAPH_UNDIRECTED);
+    igraph_build_eid_index(&g);
+    ret = check_all_pairs(&g, &g);
+    printf("empty: %d\n", ret);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include <igraph.h>
+#include <math.h>
+#include "test_utilities.inc"
+
+/* igraph_get_shortest_path() and igraph_get_shortest_path_dijkstra()
+   search from both ends, igraph_get_shortest_path_astar() uses a
+   distance estimate. The paths must be valid and as long as the
+   distances of igraph_shortest_paths_dijkstra(). */
+
+/* The length of the path, or -1 if it is not a path from 'from' to
+   'to' in 'graph' */
+igraph_real_t path_length(const igraph_t *graph, const igraph_vector_t *vertices,
+                          const igraph_vector_t *edges,
+                          const igraph_vector_t *weights,
+                          igraph_integer_t from, igraph_integer_t to,
+                          igraph_neimode_t mode) {
+    long int i, n = igraph_vector_size(edges);
+    igraph_real_t len = 0;
+
+    if (igraph_vector_size(vertices) != n + 1 || VECTOR(*vertices)[0] != from ||
+        VECTOR(*vertices)[n] != to) {
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_integer_t e = (igraph_integer_t) VECTOR(*edges)[i];
+        igraph_integer_t u = (igraph_integer_t) VECTOR(*vertices)[i];
+        igraph_integer_t v = (igraph_integer_t) VECTOR(*vertices)[i + 1];
+        igraph_integer_t efrom = IGRAPH_FROM(graph, e), eto = IGRAPH_TO(graph, e);
+        if (!igraph_is_directed(graph) || mode == IGRAPH_ALL) {
+            if (!((efrom == u && eto == v) || (efrom == v && eto == u))) {
+                return -1;
+            }
+        } else if (mode == IGRAPH_OUT ? (efrom != u || eto != v) :
+                   (efrom != v || eto != u)) {
+            return -1;
+        }
+        len += weights ? VECTOR(*weights)[e] : 1;
+    }
+    return len;
+}
+
+/* An admissible, but not consistent, estimate: a random fraction of
+   the real distance */
+int random_fraction(igraph_real_t *result, igraph_integer_t from,
+                    igraph_integer_t to, void *extra) {
+    igraph_matrix_t *dist = extra;
+    *result = MATRIX(*dist, from, 0) * RNG_UNIF01();
+    return 0;
+}
+
+int negative(igraph_real_t *result, igraph_integer_t from,
+             igraph_integer_t to, void *extra) {
+    *result = -1;
+    return 0;
+}
+
+/* Straight line distance in a layout, counting the calls */
+typedef struct {
+    const igraph_matrix_t *layout;
+    long int calls;
+} euclid_data_t;
+
+int euclid(igraph_real_t *result, igraph_integer_t from,
+           igraph_integer_t to, void *extra) {
+    euclid_data_t *data = extra;
+    igraph_real_t dx = MATRIX(*data->layout, from, 0) - MATRIX(*data->layout, to, 0);
+    igraph_real_t dy = MATRIX(*data->layout, from, 1) - MATRIX(*data->layout, to, 1);
+    *result = sqrt(dx * dx + dy * dy);
+    data->calls++;
+    return 0;
+}
+
+int zero(igraph_real_t *result, igraph_integer_t from,
+         igraph_integer_t to, void *extra) {
+    euclid_data_t *data = extra;
+    *result = 0;
+    data->calls++;
+    return 0;
+}
+
+/* All pairs of vertices with all three functions, 'weights' may be a
+   null pointer */
+int check(const igraph_t *graph, const igraph_vector_t *weights,
+          igraph_neimode_t mode) {
+    igraph_vector_t vertices, edges;
+    igraph_matrix_t dist, todist;
+    long int n = igraph_vcount(graph), i, j, k;
+    igraph_neimode_t rmode = mode == IGRAPH_OUT ? IGRAPH_IN :
+                             mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
+    int ok = 1;
+
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_matrix_init(&todist, 0, 0);
+    igraph_shortest_paths_dijkstra(graph, &dist, igraph_vss_all(), igraph_vss_all(),
+                                   weights, mode);
+
+    for (j = 0; j < n; j++) {
+        igraph_shortest_paths_dijkstra(graph, &todist, igraph_vss_1(j),
+                                       igraph_vss_all(), weights, rmode);
+        igraph_matrix_transpose(&todist);
+        for (i = 0; i < n; i++) {
+            for (k = 0; k < 3; k++) {
+                igraph_real_t len;
+                if (k == 0 && !weights) {
+                    igraph_get_shortest_path(graph, &vertices, &edges, i, j, mode);
+                } else if (k == 0) {
+                    igraph_get_shortest_path_dijkstra(graph, &vertices, &edges, i, j,
+                                                      weights, mode);
+                } else if (k == 1) {
+                    igraph_get_shortest_path_astar(graph, &vertices, &edges, i, j,
+                                                   weights, mode, 0, 0);
+                } else {
+                    igraph_get_shortest_path_astar(graph, &vertices, &edges, i, j,
+                                                   weights, mode, random_fraction,
+                                                   &todist);
+                }
+                if (MATRIX(dist, i, j) == IGRAPH_INFINITY) {
+                    len = igraph_vector_size(&vertices) == 0 &&
+                          igraph_vector_size(&edges) == 0 ? IGRAPH_INFINITY : -1;
+                } else {
+                    len = path_length(graph, &vertices, &edges, weights, i, j, mode);
+                }
+                if (len != MATRIX(dist, i, j)) {
+                    ok = 0;
+                }
+            }
+        }
+    }
+
+    igraph_matrix_destroy(&todist);
+    igraph_matrix_destroy(&dist);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    return ok;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, vertices, edges, x, y;
+    igraph_matrix_t layout, dist;
+    euclid_data_t data, zero_data;
+    long int i;
+    int ret;
+
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Several components, multi-edges and loops */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 40, 60,
+                            IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 5) / 2.0;
+    }
+    igraph_add_edge(&g, 0, 1);
+    igraph_add_edge(&g, 0, 1);
+    igraph_vector_push_back(&weights, 1);
+    igraph_vector_push_back(&weights, 0.5);
+    printf("%d %d\n", check(&g, 0, IGRAPH_OUT), check(&g, &weights, IGRAPH_OUT));
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 40, 120,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(0, 3);
+    }
+    printf("%d %d %d %d %d %d\n",
+           check(&g, 0, IGRAPH_OUT), check(&g, 0, IGRAPH_IN), check(&g, 0, IGRAPH_ALL),
+           check(&g, &weights, IGRAPH_OUT), check(&g, &weights, IGRAPH_IN),
+           check(&g, &weights, IGRAPH_ALL));
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Random points in the unit square, the weights are the lengths
+       of the edges, so the straight line distance is a good
+       estimate. A* must visit much fewer vertices than Dijkstra's
+       algorithm, which is A* with zero estimates. */
+    igraph_vector_init(&x, 0);
+    igraph_vector_init(&y, 0);
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_grg_game(&g, 2000, 0.06, /*torus=*/ 0, &x, &y);
+    igraph_matrix_init(&layout, 2000, 2);
+    igraph_matrix_set_col(&layout, &x, 0);
+    igraph_matrix_set_col(&layout, &y, 1);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        igraph_real_t dx = VECTOR(x)[IGRAPH_FROM(&g, i)] - VECTOR(x)[IGRAPH_TO(&g, i)];
+        igraph_real_t dy = VECTOR(y)[IGRAPH_FROM(&g, i)] - VECTOR(y)[IGRAPH_TO(&g, i)];
+        VECTOR(weights)[i] = sqrt(dx * dx + dy * dy);
+    }
+    igraph_shortest_paths_dijkstra(&g, &dist, igraph_vss_1(0), igraph_vss_1(1999),
+                                   &weights, IGRAPH_OUT);
+    data.layout = &layout;
+    data.calls = 0;
+    igraph_get_shortest_path_astar(&g, &vertices, &edges, 0, 1999, &weights,
+                                   IGRAPH_OUT, euclid, &data);
+    zero_data.calls = 0;
+    igraph_get_shortest_path_astar(&g, 0, 0, 0, 1999, &weights,
+                                   IGRAPH_OUT, zero, &zero_data);
+    printf("%d %d\n", fabs(path_length(&g, &vertices, &edges, &weights, 0, 1999,
+                                       IGRAPH_OUT) - MATRIX(dist, 0, 0)) < 1e-12,
+           data.calls * 2 < zero_data.calls);
+
+    /* Invalid estimate */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_get_shortest_path_astar(&g, &vertices, &edges, 0, 1999, &weights,
+                                         IGRAPH_OUT, negative, 0);
+    printf("%d\n", ret == IGRAPH_EINVAL);
+
+    igraph_matrix_destroy(&dist);
+    igraph_matrix_destroy(&layout);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    igraph_vector_destroy(&weights);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+    igraph_destroy(&g);
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* The lazy adjacency cache must return the same neighbors as the lazy
+   adjacency list, no matter how small its budget is, and it must never
+   use more memory than its budget. */
+
+int test(const igraph_t *graph, igraph_neimode_t mode,
+         igraph_lazy_adlist_simplify_t simplify, size_t budget) {
+    igraph_lazy_adjlist_t al;
+    igraph_lazy_adjcache_t cache;
+    igraph_vector_int_t neis;
+    igraph_vector_t *v;
+    long int i, j, n = igraph_vcount(graph);
+    int ret = 0;
+
+    igraph_lazy_adjlist_init(graph, &al, mode, simplify);
+    igraph_lazy_adjcache_init(graph, &cache, mode, simplify, budget);
+    igraph_vector_int_init(&neis, 0);
+
+    /* Visit the vertices in random order, with repetitions */
+    for (i = 0; i < 10 * n && !ret; i++) {
+        long int vid = RNG_INTEGER(0, n - 1);
+        igraph_lazy_adjcache_get(&cache, vid, &neis);
+        v = igraph_lazy_adjlist_get(&al, vid);
+        if (igraph_vector_int_size(&neis) != igraph_vector_size(v)) {
+            ret = 1;
+        }
+        for (j = 0; j < igraph_vector_size(v) && !ret; j++) {
+            if (VECTOR(neis)[j] != VECTOR(*v)[j]) {
+                ret = 2;
+            }
+        }
+        if (igraph_lazy_adjcache_used(&cache) > budget) {
+            ret = 3;
+        }
+    }
+
+    igraph_vector_int_destroy(&neis);
+    igraph_lazy_adjcache_destroy(&cache);
+    igraph_lazy_adjlist_destroy(&al);
+    return ret;
+}
+
+int test_all(const igraph_t *graph) {
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    size_t budgets[] = { 0, 200, 2000, 1000000 };
+    int i, j, ret;
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 4; j++) {
+            if ((ret = test(graph, modes[i], IGRAPH_DONT_SIMPLIFY, budgets[j])) != 0 ||
+                (ret = test(graph, modes[i], IGRAPH_SIMPLIFY, budgets[j])) != 0) {
+                return ret;
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    igraph_t graph;
+    igraph_vector_t edges;
+    igraph_lazy_adjcache_t cache;
+    igraph_vector_int_t neis;
+    long int i;
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Multiple edges, loops and isolated vertices */
+    igraph_vector_init(&edges, 600);
+    for (i = 0; i < 600; i++) {
+        VECTOR(edges)[i] = RNG_INTEGER(0, 89);
+    }
+    VECTOR(edges)[1] = VECTOR(edges)[0];
+
+    igraph_create(&graph, &edges, 100, IGRAPH_DIRECTED);
+    printf("directed: %d\n", test_all(&graph));
+    igraph_destroy(&graph);
+
+    igraph_create(&graph, &edges, 100, IGRAPH_UNDIRECTED);
+    printf("undirected: %d\n", test_all(&graph));
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_vector_int_init(&neis, 0);
+    igraph_lazy_adjcache_init(&graph, &cache, IGRAPH_ALL, IGRAPH_SIMPLIFY, 1000);
+    ret = igraph_lazy_adjcache_get(&cache, 100, &neis) != IGRAPH_EINVVID ||
+          igraph_lazy_adjcache_get(&cache, -1, &neis) != IGRAPH_EINVVID ||
+          igraph_lazy_adjcache_init(&graph, &cache, (igraph_neimode_t) 42,
+                                    IGRAPH_SIMPLIFY, 1000) != IGRAPH_EINVMODE;
+    printf("errors: %d\n", ret);
+    igraph_lazy_adjcache_destroy(&cache);
+    igraph_vector_int_destroy(&neis);
+
+    igraph_destroy(&graph);
+    igraph_vector_destroy(&edges);
+    return 0;
+}
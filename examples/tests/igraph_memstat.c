@@ -0,0 +1,76 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* Memory statistics count the live and peak memory of vectors and
+   matrices, and make allocations fail above the limit. */
+
+int main() {
+    igraph_memstat_t stat, inner;
+    igraph_vector_t v, old;
+    igraph_matrix_t res;
+    igraph_t graph;
+    int ret;
+
+    igraph_vector_init(&old, 100);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_ring(&graph, 1000, IGRAPH_UNDIRECTED, 0, 1);
+
+    /* Live and peak memory */
+    igraph_memstat_begin(&stat, 0);
+    igraph_vector_init(&v, 1000);
+    printf("live: %d\n", stat.live == 1000 * sizeof(igraph_real_t));
+    igraph_vector_resize(&v, 2000);
+    printf("resized: %d\n", stat.live == 2000 * sizeof(igraph_real_t));
+    igraph_vector_destroy(&v);
+    printf("freed: %d %d\n", stat.live == 0,
+           stat.peak == 2000 * sizeof(igraph_real_t));
+    /* Freeing old memory is not counted */
+    igraph_vector_destroy(&old);
+    printf("old: %d\n", stat.live == 0);
+    igraph_memstat_end(&stat);
+
+    /* Nested statistics, inner allocations are counted by both, and
+       memory that survives the inner one is still subtracted from the
+       outer one when it is freed */
+    igraph_memstat_begin(&stat, 0);
+    igraph_vector_init(&old, 10);
+    igraph_memstat_begin(&inner, 0);
+    igraph_vector_init(&v, 100);
+    printf("nested: %d %d\n", inner.live == 100 * sizeof(igraph_real_t),
+           stat.live == 110 * sizeof(igraph_real_t));
+    igraph_vector_destroy(&old);
+    printf("outer free: %d %d\n", inner.live == 100 * sizeof(igraph_real_t),
+           stat.live == 100 * sizeof(igraph_real_t));
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_memstat_end(&stat);
+    igraph_set_error_handler(igraph_error_handler_abort);
+    printf("wrong order: %d\n", ret == IGRAPH_EINVAL);
+    igraph_memstat_end(&inner);
+    igraph_vector_destroy(&v);
+    printf("after inner: %d %d\n", stat.live == 0, stat.allocations == 2);
+    igraph_memstat_end(&stat);
+
+    /* A computation within the limit */
+    igraph_memstat_begin(&stat, 100 * 1000 * 1000);
+    ret = igraph_shortest_paths(&graph, &res, igraph_vss_all(), igraph_vss_all(),
+                                IGRAPH_OUT);
+    igraph_memstat_end(&stat);
+    printf("within limit: %d %d %d\n", ret, stat.limit_reached,
+           stat.peak >= 1000 * 1000 * sizeof(igraph_real_t));
+
+    /* The same above the limit */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_matrix_destroy(&res);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_memstat_begin(&stat, 1000 * 1000);
+    ret = igraph_shortest_paths(&graph, &res, igraph_vss_all(), igraph_vss_all(),
+                                IGRAPH_OUT);
+    igraph_memstat_end(&stat);
+    printf("above limit: %d %d %d\n", ret == IGRAPH_ENOMEM, stat.limit_reached,
+           stat.live == 0);
+
+    igraph_destroy(&graph);
+    igraph_matrix_destroy(&res);
+
+    return 0;
+}
@@ -0,0 +1,264 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* igraph_shortest_paths(), igraph_average_path_length(),
+   igraph_path_length_hist() and igraph_closeness() run many
+   breadth-first searches at the same time, in batches of 64 sources.
+   The results must be the same as those of separate searches from
+   each source, whatever the number of threads is. Progress is
+   reported while the searches run. */
+
+/* Distances from every vertex, one search at a time */
+void reference_paths(const igraph_t *graph, igraph_matrix_t *dist,
+                     igraph_neimode_t mode) {
+    igraph_matrix_t row;
+    long int i, j, n = igraph_vcount(graph);
+    igraph_matrix_init(&row, 0, 0);
+    igraph_matrix_resize(dist, n, n);
+    for (i = 0; i < n; i++) {
+        igraph_shortest_paths(graph, &row, igraph_vss_1(i), igraph_vss_all(), mode);
+        for (j = 0; j < n; j++) {
+            MATRIX(*dist, i, j) = MATRIX(row, 0, j);
+        }
+    }
+    igraph_matrix_destroy(&row);
+}
+
+int check_paths(const igraph_t *graph, const igraph_matrix_t *ref,
+                igraph_neimode_t mode) {
+    igraph_matrix_t res;
+    igraph_vector_t from, to;
+    long int i, j, n = igraph_vcount(graph);
+    int ok;
+
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths(graph, &res, igraph_vss_all(), igraph_vss_all(), mode);
+    ok = igraph_matrix_all_e(&res, ref);
+
+    /* Repeated sources, and some of the targets */
+    igraph_vector_init(&from, 0);
+    igraph_vector_init(&to, 0);
+    for (i = 0; i < n; i += 3) {
+        igraph_vector_push_back(&from, n - 1 - i);
+        igraph_vector_push_back(&from, i / 2);
+    }
+    for (i = 0; i < n; i += 7) {
+        igraph_vector_push_back(&to, i);
+    }
+    igraph_shortest_paths(graph, &res, igraph_vss_vector(&from),
+                          igraph_vss_vector(&to), mode);
+    for (i = 0; i < igraph_vector_size(&from); i++) {
+        for (j = 0; j < igraph_vector_size(&to); j++) {
+            if (MATRIX(res, i, j) != MATRIX(*ref, (long int) VECTOR(from)[i],
+                                            (long int) VECTOR(to)[j])) {
+                ok = 0;
+            }
+        }
+    }
+
+    igraph_vector_destroy(&to);
+    igraph_vector_destroy(&from);
+    igraph_matrix_destroy(&res);
+    return ok;
+}
+
+int check_average(const igraph_t *graph, const igraph_matrix_t *ref,
+                  igraph_bool_t directed) {
+    long int i, j, n = igraph_vcount(graph);
+    igraph_real_t sum = 0, count = 0, unreachable = 0, res, exp;
+    int ok = 1;
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            if (i != j && MATRIX(*ref, i, j) != IGRAPH_INFINITY) {
+                sum += MATRIX(*ref, i, j);
+                count++;
+            } else if (i != j) {
+                unreachable++;
+            }
+        }
+    }
+
+    igraph_average_path_length(graph, &res, directed, /*unconn=*/ 1);
+    exp = sum / count;
+    ok = ok && (res == exp || (isnan(res) && isnan(exp)));
+    igraph_average_path_length(graph, &res, directed, /*unconn=*/ 0);
+    exp = (sum + n * unreachable) / (count + unreachable);
+    ok = ok && (res == exp || (isnan(res) && isnan(exp)));
+
+    return ok;
+}
+
+int check_hist(const igraph_t *graph, const igraph_matrix_t *ref,
+               igraph_bool_t undirected) {
+    igraph_vector_t hist, exp;
+    igraph_real_t unconn, exp_unconn = 0;
+    long int i, j, n = igraph_vcount(graph);
+    int ok;
+
+    igraph_vector_init(&hist, 0);
+    igraph_vector_init(&exp, 0);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            igraph_real_t d = MATRIX(*ref, i, j);
+            if (i == j) {
+                continue;
+            } else if (d == IGRAPH_INFINITY) {
+                exp_unconn++;
+            } else {
+                while (igraph_vector_size(&exp) < d) {
+                    igraph_vector_push_back(&exp, 0);
+                }
+                VECTOR(exp)[(long int) d - 1] += 1;
+            }
+        }
+    }
+    if (undirected) {
+        igraph_vector_scale(&exp, 0.5);
+        exp_unconn /= 2;
+    }
+
+    igraph_path_length_hist(graph, &hist, &unconn, IGRAPH_DIRECTED);
+    ok = igraph_vector_all_e(&hist, &exp) && unconn == exp_unconn;
+
+    igraph_vector_destroy(&exp);
+    igraph_vector_destroy(&hist);
+    return ok;
+}
+
+int check_closeness(const igraph_t *graph, const igraph_matrix_t *ref,
+                    igraph_neimode_t mode, igraph_real_t cutoff) {
+    igraph_vector_t res;
+    long int i, j, n = igraph_vcount(graph);
+    int ok = 1;
+
+    igraph_vector_init(&res, 0);
+    igraph_closeness_estimate(graph, &res, igraph_vss_all(), mode, cutoff, 0,
+                              /*normalized=*/ 0);
+    for (i = 0; i < n; i++) {
+        igraph_real_t sum = 0, reached = 0, exp;
+        for (j = 0; j < n; j++) {
+            igraph_real_t d = MATRIX(*ref, i, j);
+            if (d != IGRAPH_INFINITY && (cutoff <= 0 || d < cutoff + 1)) {
+                sum += d;
+                reached++;
+            }
+        }
+        sum += (igraph_real_t) n * (n - reached);
+        exp = (n - 1) / sum / (n - 1);
+        if (VECTOR(res)[i] != exp && !(isnan(VECTOR(res)[i]) && isnan(exp))) {
+            ok = 0;
+        }
+    }
+
+    igraph_vector_destroy(&res);
+    return ok;
+}
+
+void check(const char *name, const igraph_t *graph) {
+    igraph_matrix_t ref;
+    igraph_bool_t directed = igraph_is_directed(graph);
+
+    igraph_matrix_init(&ref, 0, 0);
+    reference_paths(graph, &ref, IGRAPH_OUT);
+    printf("%s: paths %d, average %d, hist %d, closeness %d %d\n", name,
+           check_paths(graph, &ref, IGRAPH_OUT),
+           check_average(graph, &ref, IGRAPH_DIRECTED),
+           check_hist(graph, &ref, !directed),
+           check_closeness(graph, &ref, IGRAPH_OUT, 0),
+           check_closeness(graph, &ref, IGRAPH_OUT, 2));
+    if (directed) {
+        reference_paths(graph, &ref, IGRAPH_IN);
+        printf("%s in: paths %d, closeness %d\n", name,
+               check_paths(graph, &ref, IGRAPH_IN),
+               check_closeness(graph, &ref, IGRAPH_IN, 0));
+    }
+    igraph_matrix_destroy(&ref);
+}
+
+/* Counts the progress reports, and checks that they increase */
+int progress_calls;
+igraph_real_t progress_last;
+int progress_ok;
+
+int record_progress(const char *message, igraph_real_t percent, void *data) {
+    IGRAPH_UNUSED(message);
+    IGRAPH_UNUSED(data);
+    if (percent < progress_last) {
+        progress_ok = 0;
+    }
+    progress_last = percent;
+    progress_calls++;
+    return IGRAPH_SUCCESS;
+}
+
+void reset_progress(void) {
+    progress_calls = 0;
+    progress_last = 0;
+    progress_ok = 1;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t hist, closeness;
+    igraph_memstat_t stat;
+    int threads[] = { 1, 4 };
+    int t, ret;
+
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    for (t = 0; t < 2; t++) {
+        igraph_set_num_threads(threads[t]);
+        printf("%d threads\n", threads[t]);
+
+        /* Several components, isolated vertices, more than one batch */
+        igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 320,
+                                IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+        check("gnm", &g);
+        igraph_destroy(&g);
+
+        igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 600,
+                                IGRAPH_DIRECTED, IGRAPH_LOOPS);
+        check("directed", &g);
+        igraph_destroy(&g);
+
+        /* A long path, many levels */
+        igraph_ring(&g, 150, IGRAPH_UNDIRECTED, 0, /*circular=*/ 0);
+        igraph_add_vertices(&g, 5, 0);
+        igraph_add_edge(&g, 150, 151);
+        check("path", &g);
+        igraph_destroy(&g);
+
+        igraph_empty(&g, 1, IGRAPH_UNDIRECTED);
+        check("singleton", &g);
+        igraph_destroy(&g);
+    }
+
+    /* Progress during the searches, and the memory of the workers is
+       counted: only the grown result is alive at the end */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 3000, 6000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&hist, 0);
+    igraph_vector_init(&closeness, 0);
+    /* the first query indexes the edges of the new graph */
+    igraph_neighbors(&g, &closeness, 0, IGRAPH_ALL);
+    igraph_set_progress_handler(record_progress);
+    reset_progress();
+    igraph_memstat_begin(&stat, 0);
+    ret = igraph_path_length_hist(&g, &hist, 0, IGRAPH_UNDIRECTED);
+    igraph_memstat_end(&stat);
+    printf("hist progress: %d %d %d, memory %d\n", ret == 0,
+           progress_calls > 2, progress_ok && progress_last == 100,
+           stat.live == igraph_vector_capacity(&hist) * sizeof(igraph_real_t));
+    reset_progress();
+    igraph_closeness(&g, &closeness, igraph_vss_all(), IGRAPH_ALL, 0, 1);
+    printf("closeness progress: %d %d\n", progress_calls > 3,
+           progress_ok && progress_last == 100);
+    igraph_set_progress_handler(0);
+    igraph_vector_destroy(&closeness);
+    igraph_vector_destroy(&hist);
+    igraph_destroy(&g);
+
+    return 0;
+}
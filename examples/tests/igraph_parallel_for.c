@@ -0,0 +1,175 @@
+#include <igraph.h>
+#include <string.h>
+#include "igraph_threads_internal.h"
+#include "igraph_interrupt_internal.h"
+#include "test_utilities.inc"
+
+/* The parallel loops give the same results with any number of
+   threads, errors and interruptions in the workers reach the calling
+   thread, and the workers allocate from the arena and are counted by
+   the memory statistics of the calling thread. */
+
+char last_error[256];
+
+void record_error(const char *reason, const char *file, int line,
+                  int igraph_errno) {
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    IGRAPH_UNUSED(igraph_errno);
+    if (last_error[0] == '\0') {
+        strncpy(last_error, reason, sizeof(last_error) - 1);
+    }
+    IGRAPH_FINALLY_FREE();
+}
+
+int interrupt_now(void *data) {
+    IGRAPH_UNUSED(data);
+    return IGRAPH_INTERRUPTED;
+}
+
+int squares(void *arg, long int from, long int to, igraph_real_t *result) {
+    long int i;
+    IGRAPH_UNUSED(arg);
+    *result = 0;
+    for (i = from; i < to; i++) {
+        *result += 1.0 / ((igraph_real_t) i + 1) / ((igraph_real_t) i + 1);
+    }
+    return 0;
+}
+
+int failing(void *arg, long int from, long int to) {
+    igraph_vector_t tmp;
+    IGRAPH_UNUSED(arg);
+    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 100);
+    if (from <= 5000 && 5000 < to) {
+        IGRAPH_ERROR("Range failed", IGRAPH_EINVAL);
+    }
+    igraph_vector_destroy(&tmp);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+int slow(void *arg, long int from, long int to) {
+    long int i, j;
+    volatile igraph_real_t x = 0;
+    for (i = from; i < to; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        for (j = 0; j < 1000000; j++) {
+            x += 1;
+        }
+    }
+    IGRAPH_UNUSED(arg);
+    return 0;
+}
+
+/* Grows the vectors of the range, which were created by the calling
+   thread */
+int grow(void *arg, long int from, long int to) {
+    igraph_vector_t *vectors = arg;
+    long int i, j;
+    for (i = from; i < to; i++) {
+        for (j = 0; j < 100; j++) {
+            IGRAPH_CHECK(igraph_vector_push_back(&vectors[i], j));
+        }
+    }
+    return 0;
+}
+
+/* Grows 1000 vectors in parallel inside an arena, with memory
+   statistics. Returns whether all of them were grown. */
+int grow_shared(igraph_memstat_t *stat, size_t limit) {
+    igraph_arena_t arena;
+    igraph_vector_t vectors[1000];
+    long int i;
+    int ok;
+
+    igraph_arena_init(&arena, 0);
+    igraph_arena_begin(&arena);
+    igraph_memstat_begin(stat, limit);
+    for (i = 0; i < 1000; i++) {
+        igraph_vector_init(&vectors[i], 0);
+    }
+    ok = igraph_i_parallel_for(1000, 10, grow, vectors) == 0;
+    for (i = 0; i < 1000; i++) {
+        ok = ok && igraph_vector_size(&vectors[i]) == 100 &&
+             VECTOR(vectors[i])[99] == 99;
+        igraph_vector_destroy(&vectors[i]);
+    }
+    igraph_memstat_end(stat);
+    igraph_arena_end(&arena);
+    igraph_arena_destroy(&arena);
+    return ok;
+}
+
+int main() {
+    igraph_t graph;
+    igraph_vector_t pairs, res1, res4;
+    igraph_real_t sum1, sum4;
+    long int i;
+    igraph_memstat_t stat;
+    int ret;
+
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    printf("negative: %d\n", igraph_set_num_threads(-1) == IGRAPH_EINVAL);
+    igraph_set_num_threads(4);
+    printf("set: %d\n", igraph_get_num_threads() == 4 ||
+           igraph_get_num_threads() == 1);
+
+    /* Reductions do not depend on the number of threads */
+    igraph_set_num_threads(1);
+    igraph_i_parallel_reduce(1000000, 1000, squares, 0, &sum1);
+    igraph_set_num_threads(4);
+    igraph_i_parallel_reduce(1000000, 1000, squares, 0, &sum4);
+    printf("reduce: %d\n", sum1 == sum4);
+
+    /* Errors */
+    igraph_set_error_handler(record_error);
+    ret = igraph_i_parallel_for(100000, 100, failing, 0);
+    printf("error: %d %d %s\n", ret == IGRAPH_EINVAL,
+           IGRAPH_FINALLY_STACK_SIZE(), last_error);
+
+    /* Interruption */
+    igraph_set_interruption_handler(interrupt_now);
+    ret = igraph_i_parallel_for(10000, 1, slow, 0);
+    igraph_set_interruption_handler(0);
+    printf("interrupted: %d %d\n", ret == IGRAPH_INTERRUPTED,
+           IGRAPH_FINALLY_STACK_SIZE());
+
+    /* Allocations of the workers */
+    ret = grow_shared(&stat, 0);
+    printf("shared memory: %d %d %d\n", ret, stat.live == 0,
+           stat.peak >= 1000 * 100 * sizeof(igraph_real_t));
+    last_error[0] = '\0';
+    ret = grow_shared(&stat, 100000);
+    printf("memory limit: %d %d %d\n", ret, stat.limit_reached,
+           IGRAPH_FINALLY_STACK_SIZE());
+
+    /* Jaccard similarity of many pairs */
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_erdos_renyi_game(&graph, IGRAPH_ERDOS_RENYI_GNM, 1000, 10000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&pairs, 100000);
+    for (i = 0; i < 100000; i++) {
+        VECTOR(pairs)[i] = RNG_INTEGER(0, 999);
+    }
+    igraph_vector_init(&res1, 0);
+    igraph_vector_init(&res4, 0);
+    igraph_set_num_threads(1);
+    igraph_similarity_jaccard_pairs(&graph, &res1, &pairs, IGRAPH_ALL, 1);
+    igraph_set_num_threads(4);
+    igraph_similarity_jaccard_pairs(&graph, &res4, &pairs, IGRAPH_ALL, 1);
+    printf("jaccard: %d\n", igraph_vector_all_e(&res1, &res4));
+
+    VECTOR(pairs)[77777] = 1000;
+    last_error[0] = '\0';
+    ret = igraph_similarity_jaccard_pairs(&graph, &res4, &pairs, IGRAPH_ALL, 1);
+    printf("invalid vertex: %d %d %s\n", ret == IGRAPH_EINVVID,
+           IGRAPH_FINALLY_STACK_SIZE(), last_error);
+
+    igraph_vector_destroy(&res4);
+    igraph_vector_destroy(&res1);
+    igraph_vector_destroy(&pairs);
+    igraph_destroy(&graph);
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <igraph.h>
+#include <pthread.h>
+
+/* Every thread has its own default random number generator, seeding
+   and using it in one thread does not change it in the others. */
+
+#define LEN 10000
+
+igraph_real_t expected[LEN];
+
+void *thread_function(void *arg) {
+    long int i;
+    int *ok = arg;
+    igraph_rng_seed(igraph_rng_default(), 42);
+    for (i = 0; i < LEN; i++) {
+        if (RNG_UNIF01() != expected[i]) {
+            *ok = 0;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    pthread_t threads[4];
+    int ok[4] = { 1, 1, 1, 1 };
+    long int i;
+    int main_ok = 1;
+
+    /* Skip if igraph is not thread-safe */
+    if (!IGRAPH_THREAD_SAFE) {
+        return 77;
+    }
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    for (i = 0; i < LEN; i++) {
+        expected[i] = RNG_UNIF01();
+    }
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    for (i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, thread_function, &ok[i]);
+    }
+    for (i = 0; i < LEN; i++) {
+        if (RNG_UNIF01() != expected[i]) {
+            main_ok = 0;
+        }
+    }
+    for (i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (!main_ok || !ok[0] || !ok[1] || !ok[2] || !ok[3]) {
+        printf("Default RNG is shared between threads\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <igraph.h>
+#include "test_utilities.inc"
+
+/* The Philox generator must give the published known answer, jumping
+   ahead must give the same numbers as generating them, and split
+   streams must only depend on the seed and the stream number. */
+
+#define LEN 100
+
+void generate(igraph_rng_t *rng, unsigned long int *res, int n) {
+    int i;
+    for (i = 0; i < n; i++) {
+        res[i] = (unsigned long int) igraph_rng_get_integer(rng, 0, 0xffffffffL);
+    }
+}
+
+int same(const unsigned long int *a, const unsigned long int *b, int n) {
+    int i;
+    for (i = 0; i < n; i++) {
+        if (a[i] != b[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int check_jump(const igraph_rng_type_t *type) {
+    igraph_rng_t rng1, rng2;
+    unsigned long int a[LEN], b[LEN];
+    unsigned long int skip;
+    int ret = 0;
+
+    igraph_rng_init(&rng1, type);
+    igraph_rng_init(&rng2, type);
+    for (skip = 0; skip < 10 && !ret; skip++) {
+        igraph_rng_seed(&rng1, 123);
+        igraph_rng_seed(&rng2, 123);
+        generate(&rng1, a, LEN);
+        igraph_rng_jump(&rng2, skip);
+        generate(&rng2, b, LEN - (int) skip);
+        ret = !same(a + skip, b, LEN - (int) skip);
+    }
+    igraph_rng_destroy(&rng2);
+    igraph_rng_destroy(&rng1);
+    return ret;
+}
+
+int main() {
+    igraph_rng_t rng, s1, s2, s3, s11;
+    unsigned long int a[LEN], b[LEN], c[LEN];
+    int ret;
+
+    /* Known answer of the reference implementation for a zero key and
+       counter */
+    igraph_rng_init(&rng, &igraph_rngtype_philox);
+    igraph_rng_seed(&rng, 0);
+    generate(&rng, a, 4);
+    printf("%s: %08lx %08lx %08lx %08lx\n", igraph_rng_name(&rng),
+           a[0], a[1], a[2], a[3]);
+
+    printf("jump philox: %d\n", check_jump(&igraph_rngtype_philox));
+    printf("jump mt19937: %d\n", check_jump(&igraph_rngtype_mt19937));
+
+    /* Splitting: the same stream number gives the same stream, others
+       give different ones, and the parent does not change */
+    igraph_rng_seed(&rng, 42);
+    igraph_rng_get_integer(&rng, 0, 10);
+    igraph_rng_split(&rng, &s1, 1);
+    igraph_rng_split(&rng, &s2, 2);
+    generate(&s1, a, LEN);
+    generate(&s2, b, LEN);
+    printf("different streams: %d\n", !same(a, b, LEN));
+    igraph_rng_destroy(&s1);
+    igraph_rng_seed(&rng, 42);
+    igraph_rng_split(&rng, &s1, 1);
+    generate(&s1, c, LEN);
+    printf("same stream: %d\n", same(a, c, LEN));
+
+    generate(&rng, c, LEN);
+    igraph_rng_init(&s3, &igraph_rngtype_philox);
+    igraph_rng_seed(&s3, 42);
+    generate(&s3, a, LEN);
+    printf("parent unchanged: %d %d\n", same(a, c, LEN), !same(b, c, LEN));
+
+    /* Streams of streams */
+    igraph_rng_split(&s1, &s11, 1);
+    generate(&s11, a, LEN);
+    igraph_rng_seed(&s1, 42);
+    generate(&s1, b, LEN);
+    generate(&s2, c, LEN);
+    printf("nested: %d %d\n", !same(a, b, LEN), !same(a, c, LEN));
+
+    igraph_rng_destroy(&s11);
+    igraph_rng_destroy(&s3);
+    igraph_rng_destroy(&s2);
+    igraph_rng_destroy(&s1);
+    igraph_rng_destroy(&rng);
+
+    /* Other generators cannot be split */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    ret = igraph_rng_split(igraph_rng_default(), &s1, 1);
+    printf("mt19937 split: %d\n", ret == IGRAPH_UNIMPLEMENTED);
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <igraph.h>
+#include <string.h>
+#include "config.h"
+#include "test_utilities.inc"
+
+/* The core algorithms report their work to the trace handler if
+   igraph was configured with tracing, and the counters stay zero
+   otherwise. */
+
+#ifdef IGRAPH_TRACING
+#define ENABLED 1
+#else
+#define ENABLED 0
+#endif
+
+int calls;
+char last_function[100];
+igraph_trace_counters_t last;
+
+void handler(const char *function, const igraph_trace_counters_t *counters) {
+    calls++;
+    strncpy(last_function, function, sizeof(last_function) - 1);
+    last = *counters;
+}
+
+void reset() {
+    calls = 0;
+    last_function[0] = '\0';
+    memset(&last, 0, sizeof(last));
+}
+
+int reported(const char *function) {
+    return ENABLED ? calls == 1 && !strcmp(last_function, function) : calls == 0;
+}
+
+int main() {
+    igraph_t ring, cliques;
+    igraph_vector_t order, weights, membership, vector;
+    igraph_matrix_t res;
+    igraph_arpack_options_t options;
+    igraph_trace_counters_t counters;
+    igraph_integer_t nb_clusters;
+    igraph_real_t quality;
+
+    igraph_ring(&ring, 10, IGRAPH_UNDIRECTED, 0, 1);
+    /* Two cliques of five vertices, connected by an edge */
+    igraph_small(&cliques, 10, IGRAPH_UNDIRECTED,
+                 0, 1, 0, 2, 0, 3, 0, 4, 1, 2, 1, 3, 1, 4, 2, 3, 2, 4, 3, 4,
+                 5, 6, 5, 7, 5, 8, 5, 9, 6, 7, 6, 8, 6, 9, 7, 8, 7, 9, 8, 9,
+                 0, 5, -1);
+    igraph_vector_init(&order, 0);
+    igraph_vector_init(&weights, 10);
+    igraph_vector_fill(&weights, 1);
+    igraph_vector_init(&membership, 0);
+    igraph_vector_init(&vector, 0);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_set_trace_handler(handler);
+
+    reset();
+    igraph_bfs(&ring, 0, 0, IGRAPH_ALL, 1, 0, &order, 0, 0, 0, 0, 0, 0, 0);
+    printf("bfs: %d %d\n", reported("igraph_bfs"),
+           last.visited_vertices == 10 * ENABLED &&
+           last.scanned_edges == 20 * ENABLED);
+
+    reset();
+    igraph_dfs(&ring, 0, IGRAPH_ALL, 1, &order, 0, 0, 0, 0, 0, 0);
+    printf("dfs: %d %d\n", reported("igraph_dfs"),
+           last.visited_vertices == 10 * ENABLED &&
+           last.scanned_edges == 20 * ENABLED);
+
+    reset();
+    igraph_shortest_paths_dijkstra(&ring, &res, igraph_vss_1(0), igraph_vss_all(),
+                                   &weights, IGRAPH_ALL);
+    printf("dijkstra: %d %d\n", reported("igraph_shortest_paths_dijkstra"),
+           last.visited_vertices == 10 * ENABLED &&
+           last.relaxed_edges == 20 * ENABLED);
+
+    reset();
+    igraph_arpack_options_init(&options);
+    igraph_eigenvector_centrality(&cliques, &vector, 0, 0, 1, 0, &options);
+    printf("arpack: %d %d\n", reported("igraph_arpack_rssolve"),
+           ENABLED ? last.arpack_matvecs > 0 : last.arpack_matvecs == 0);
+
+    reset();
+    igraph_community_multilevel(&cliques, 0, &membership, 0, 0);
+    printf("multilevel: %d %d\n", reported("igraph_community_multilevel"),
+           ENABLED ? last.community_moves > 0 && last.community_levels > 0 :
+           last.community_moves == 0);
+
+    reset();
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_community_leiden(&cliques, 0, 0, 0.05, 0.01, 0, &membership,
+                            &nb_clusters, &quality);
+    printf("leiden: %d %d\n", reported("igraph_community_leiden"),
+           ENABLED ? last.community_moves > 0 && last.community_levels > 0 :
+           last.community_moves == 0);
+
+    /* Without a handler the counters add up */
+    igraph_set_trace_handler(0);
+    igraph_trace_counters_reset();
+    igraph_bfs(&ring, 0, 0, IGRAPH_ALL, 1, 0, &order, 0, 0, 0, 0, 0, 0, 0);
+    igraph_bfs(&ring, 0, 0, IGRAPH_ALL, 1, 0, &order, 0, 0, 0, 0, 0, 0, 0);
+    igraph_trace_counters(&counters);
+    printf("counters: %d\n", counters.visited_vertices == 20 * ENABLED);
+    igraph_trace_counters_reset();
+    igraph_trace_counters(&counters);
+    printf("reset: %d\n", counters.visited_vertices == 0);
+
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&vector);
+    igraph_vector_destroy(&membership);
+    igraph_vector_destroy(&weights);
+    igraph_vector_destroy(&order);
+    igraph_destroy(&cliques);
+    igraph_destroy(&ring);
+
+    return 0;
+}
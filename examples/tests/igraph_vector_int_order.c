@@ -0,0 +1,70 @@
+#include <igraph.h>
+#include <stdlib.h>
+#include "test_utilities.inc"
+
+/* igraph_vector_int_order() sorts by the primary key, then by the
+   secondary key, then by decreasing index. Long vectors are sorted
+   in parallel, this must give the same order, whatever the number of
+   threads is. */
+
+igraph_vector_int_t *key1, *key2;
+
+int cmp(const void *a, const void *b) {
+    int i = *(const int *) a, j = *(const int *) b;
+    if (VECTOR(*key1)[i] != VECTOR(*key1)[j]) {
+        return VECTOR(*key1)[i] < VECTOR(*key1)[j] ? -1 : 1;
+    }
+    if (VECTOR(*key2)[i] != VECTOR(*key2)[j]) {
+        return VECTOR(*key2)[i] < VECTOR(*key2)[j] ? -1 : 1;
+    }
+    return i > j ? -1 : (i < j ? 1 : 0);
+}
+
+int test(long int n, int nodes) {
+    igraph_vector_int_t v, v2, res, ref;
+    long int i;
+    int ret;
+
+    igraph_vector_int_init(&v, n);
+    igraph_vector_int_init(&v2, n);
+    igraph_vector_int_init(&res, 0);
+    igraph_vector_int_init(&ref, n);
+    for (i = 0; i < n; i++) {
+        VECTOR(v)[i] = RNG_INTEGER(0, nodes);
+        VECTOR(v2)[i] = RNG_INTEGER(0, nodes);
+        VECTOR(ref)[i] = (int) i;
+    }
+    /* Many equal keys */
+    for (i = 0; i < n / 4; i++) {
+        VECTOR(v)[i] = VECTOR(v2)[i] = 1;
+    }
+
+    igraph_vector_int_order(&v, &v2, &res, nodes);
+    key1 = &v; key2 = &v2;
+    qsort(VECTOR(ref), (size_t) n, sizeof(int), cmp);
+    ret = !igraph_vector_int_all_e(&res, &ref);
+
+    igraph_vector_int_destroy(&ref);
+    igraph_vector_int_destroy(&res);
+    igraph_vector_int_destroy(&v2);
+    igraph_vector_int_destroy(&v);
+    return ret;
+}
+
+int main() {
+    int threads[] = { 1, 3, 8 };
+    int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    for (i = 0; i < 3; i++) {
+        igraph_set_num_threads(threads[i]);
+        printf("%d threads\n", threads[i]);
+        printf("short: %d\n", test(1000, 100));
+        printf("long: %d\n", test(1500000, 100000));
+        printf("few keys: %d\n", test(1500000, 3));
+        printf("many keys: %d\n", test(1200000, 10000000));
+    }
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include <igraph.h>
+#include <math.h>
+#include "igraph_simd_internal.h"
+#include "test_utilities.inc"
+
+/* The vectorized vector operations must give exactly the same results
+   with every implementation, and the same results as plain loops,
+   apart from the rounding of the sums. */
+
+#define MAXLEN 70
+
+igraph_real_t data[MAXLEN], data2[MAXLEN];
+
+/* Fills 'data' and 'data2', with a NaN in data at position 'nan' */
+void fill(long int n, long int nan) {
+    long int i;
+    for (i = 0; i < n; i++) {
+        data[i] = RNG_UNIF(-100, 100);
+        data2[i] = RNG_UNIF(1, 10);
+    }
+    if (nan >= 0 && nan < n) {
+        data[nan] = IGRAPH_NAN;
+    }
+}
+
+int same(igraph_real_t a, igraph_real_t b) {
+    return a == b || (igraph_is_nan(a) && igraph_is_nan(b));
+}
+
+/* Compares the vector functions with plain loops, results that depend
+   on the summation order are stored in 'sums' */
+int check_real(long int n, long int nan, igraph_real_t *sums) {
+    igraph_vector_t v, w;
+    igraph_real_t min, max, sum = 0.0;
+    long int i, which_min, which_max, plain_min = 0, plain_max = 0;
+
+    fill(n, nan);
+    igraph_vector_init_copy(&v, data, n);
+    igraph_vector_init_copy(&w, data2, n);
+
+    if (n > 0) {
+        /* The first smallest and largest elements, comparisons with
+           NaN are false, so it is ignored, unless it is the first */
+        for (i = 1; i < n; i++) {
+            if (data[i] < data[plain_min]) {
+                plain_min = i;
+            }
+            if (data[i] > data[plain_max]) {
+                plain_max = i;
+            }
+        }
+        igraph_vector_minmax(&v, &min, &max);
+        if (!same(min, data[plain_min]) || !same(max, data[plain_max]) ||
+            !same(min, igraph_vector_min(&v)) || !same(max, igraph_vector_max(&v))) {
+            return 1;
+        }
+        igraph_vector_which_minmax(&v, &which_min, &which_max);
+        if (which_min != plain_min || which_max != plain_max ||
+            igraph_vector_which_min(&v) != plain_min ||
+            igraph_vector_which_max(&v) != plain_max) {
+            return 2;
+        }
+        for (i = 0; i < n; i++) {
+            if (igraph_is_nan(data[0])) {
+                break;
+            }
+            if (data[i] < min || data[i] > max) {
+                return 3;
+            }
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        sum += data[i];
+    }
+    sums[0] = igraph_vector_sum(&v);
+    sums[1] = igraph_vector_sumsq(&v);
+    if (!(same(sum, sums[0]) || fabs(sum - sums[0]) < 1e-10 * n * 100)) {
+        return 4;
+    }
+
+    igraph_vector_add(&v, &w);
+    igraph_vector_mul(&v, &w);
+    igraph_vector_scale(&v, 3.0);
+    igraph_vector_add_constant(&v, -2.0);
+    igraph_vector_div(&v, &w);
+    igraph_vector_sub(&v, &w);
+    for (i = 0; i < n; i++) {
+        igraph_real_t x = ((data[i] + data2[i]) * data2[i] * 3.0 - 2.0) / data2[i] - data2[i];
+        if (!same(x, VECTOR(v)[i])) {
+            return 5;
+        }
+    }
+
+    igraph_vector_destroy(&w);
+    igraph_vector_destroy(&v);
+    return 0;
+}
+
+int check_int(long int n) {
+    igraph_vector_int_t v, w, w0;
+    igraph_vector_bool_t b;
+    long int i, sum = 0, bsum = 0;
+    int min = 0, max = 0;
+
+    igraph_vector_int_init(&v, n);
+    igraph_vector_int_init(&w, n);
+    igraph_vector_int_init(&w0, n);
+    igraph_vector_bool_init(&b, n);
+    for (i = 0; i < n; i++) {
+        VECTOR(v)[i] = RNG_INTEGER(-1000, 1000);
+        VECTOR(w)[i] = RNG_INTEGER(-10, 10);
+        VECTOR(b)[i] = RNG_INTEGER(0, 1);
+        sum += VECTOR(v)[i];
+        bsum += VECTOR(b)[i];
+        if (i == 0 || VECTOR(v)[i] < min) {
+            min = VECTOR(v)[i];
+        }
+        if (i == 0 || VECTOR(v)[i] > max) {
+            max = VECTOR(v)[i];
+        }
+    }
+
+    if (igraph_vector_int_sum(&v) != sum || igraph_vector_bool_sum(&b) != bsum) {
+        return 1;
+    }
+    if (n > 0 && (igraph_vector_int_min(&v) != min || igraph_vector_int_max(&v) != max ||
+                  VECTOR(v)[igraph_vector_int_which_min(&v)] != min ||
+                  VECTOR(v)[igraph_vector_int_which_max(&v)] != max)) {
+        return 2;
+    }
+
+    igraph_vector_int_update(&w0, &w);
+    igraph_vector_int_add(&w, &v);
+    igraph_vector_int_mul(&w, &v);
+    igraph_vector_int_scale(&w, -3);
+    igraph_vector_int_add_constant(&w, 7);
+    igraph_vector_int_sub(&w, &v);
+    for (i = 0; i < n; i++) {
+        int x = VECTOR(v)[i];
+        if (VECTOR(w)[i] != (VECTOR(w0)[i] + x) * x * -3 + 7 - x) {
+            return 3;
+        }
+    }
+
+    igraph_vector_bool_destroy(&b);
+    igraph_vector_int_destroy(&w0);
+    igraph_vector_int_destroy(&w);
+    igraph_vector_int_destroy(&v);
+    return 0;
+}
+
+int main() {
+    igraph_real_t sums[3][MAXLEN + 1][2];
+    int level, ret = 0, levels_ok = 1;
+    long int n;
+
+    for (level = 0; level <= 2; level++) {
+        igraph_i_simd_set_level(level);
+        igraph_rng_seed(igraph_rng_default(), 42);
+        for (n = 0; n <= MAXLEN && !ret; n++) {
+            ret = check_real(n, -1, sums[level][n]);
+            if (!ret) {
+                ret = check_real(n, n / 3, sums[level][n]) ? 10 : 0;
+            }
+            if (!ret) {
+                ret = check_real(n, 0, sums[level][n]) ? 20 : 0;
+            }
+            if (!ret) {
+                ret = check_real(n, -1, sums[level][n]);
+            }
+            if (!ret) {
+                ret = check_int(n) ? 30 : 0;
+            }
+        }
+        if (ret) {
+            printf("level %d, length %ld: %d\n", level, n - 1, ret);
+            return 1;
+        }
+    }
+    printf("plain loops: 0\n");
+
+    /* The sums must not depend on the implementation */
+    for (level = 1; level <= 2; level++) {
+        for (n = 0; n <= MAXLEN; n++) {
+            if (sums[level][n][0] != sums[0][n][0] || sums[level][n][1] != sums[0][n][1]) {
+                levels_ok = 0;
+            }
+        }
+    }
+    printf("same sums: %d\n", levels_ok);
+
+    return 0;
+}
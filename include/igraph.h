@@ -34,6 +34,7 @@
 #include "igraph_random.h"
 #include "igraph_progress.h"
 #include "igraph_statusbar.h"
+#include "igraph_trace.h"
 
 #include "igraph_types.h"
 #include "igraph_complex.h"
@@ -34,10 +34,13 @@ __BEGIN_DECLS
 typedef struct igraph_adjlist_t {
     igraph_integer_t length;
     igraph_vector_int_t *adjs;
+    int *flat;
 } igraph_adjlist_t;
 
 DECLDIR int igraph_adjlist_init(const igraph_t *graph, igraph_adjlist_t *al,
                                 igraph_neimode_t mode);
+DECLDIR int igraph_adjlist_init_flat(const igraph_t *graph, igraph_adjlist_t *al,
+                                     igraph_neimode_t mode);
 DECLDIR int igraph_adjlist_init_empty(igraph_adjlist_t *al, igraph_integer_t no_of_nodes);
 DECLDIR igraph_integer_t igraph_adjlist_size(const igraph_adjlist_t *al);
 DECLDIR int igraph_adjlist_init_complementer(const igraph_t *graph,
@@ -78,11 +81,15 @@ DECLDIR int igraph_adjlist(igraph_t *graph, const igraph_adjlist_t *adjlist,
 typedef struct igraph_inclist_t {
     igraph_integer_t length;
     igraph_vector_int_t *incs;
+    int *flat;
 } igraph_inclist_t;
 
 DECLDIR int igraph_inclist_init(const igraph_t *graph,
                                 igraph_inclist_t *il,
                                 igraph_neimode_t mode);
+DECLDIR int igraph_inclist_init_flat(const igraph_t *graph,
+                                     igraph_inclist_t *il,
+                                     igraph_neimode_t mode);
 DECLDIR int igraph_inclist_init_empty(igraph_inclist_t *il, igraph_integer_t n);
 DECLDIR void igraph_inclist_destroy(igraph_inclist_t *il);
 DECLDIR void igraph_inclist_clear(igraph_inclist_t *il);
@@ -179,6 +186,60 @@ DECLDIR void igraph_lazy_inclist_clear(igraph_lazy_inclist_t *il);
 DECLDIR igraph_vector_t *igraph_lazy_inclist_get_real(igraph_lazy_inclist_t *al,
         igraph_integer_t no);
 
+typedef struct igraph_lazy_adjcache_t {
+    const igraph_t *graph;
+    igraph_integer_t length;
+    igraph_neimode_t mode;
+    igraph_lazy_adlist_simplify_t simplify;
+    size_t budget, used;
+    int *slot_of;
+    struct igraph_i_adjcache_entry_s *entries;
+    long int size, capacity, hand;
+    void *lock;
+} igraph_lazy_adjcache_t;
+
+DECLDIR int igraph_lazy_adjcache_init(const igraph_t *graph,
+                                      igraph_lazy_adjcache_t *cache,
+                                      igraph_neimode_t mode,
+                                      igraph_lazy_adlist_simplify_t simplify,
+                                      size_t budget);
+DECLDIR void igraph_lazy_adjcache_destroy(igraph_lazy_adjcache_t *cache);
+DECLDIR int igraph_lazy_adjcache_get(igraph_lazy_adjcache_t *cache,
+                                     igraph_integer_t no,
+                                     igraph_vector_int_t *neis);
+DECLDIR size_t igraph_lazy_adjcache_used(const igraph_lazy_adjcache_t *cache);
+
+typedef struct igraph_compressed_adjlist_t {
+    igraph_integer_t length;
+    igraph_integer_t maxdegree;
+    igraph_neimode_t mode;
+    size_t *offsets;
+    unsigned char *data;
+} igraph_compressed_adjlist_t;
+
+DECLDIR int igraph_compressed_adjlist_init(const igraph_t *graph,
+        igraph_compressed_adjlist_t *al,
+        igraph_neimode_t mode);
+DECLDIR void igraph_compressed_adjlist_destroy(igraph_compressed_adjlist_t *al);
+DECLDIR igraph_integer_t igraph_compressed_adjlist_size(const igraph_compressed_adjlist_t *al);
+DECLDIR size_t igraph_compressed_adjlist_bytes(const igraph_compressed_adjlist_t *al);
+DECLDIR igraph_integer_t igraph_compressed_adjlist_degree(const igraph_compressed_adjlist_t *al,
+        igraph_integer_t no);
+DECLDIR int igraph_compressed_adjlist_get(const igraph_compressed_adjlist_t *al,
+        igraph_integer_t no,
+        igraph_vector_int_t *neis);
+DECLDIR int igraph_compressed_adjlist_bfs(const igraph_compressed_adjlist_t *al,
+        igraph_integer_t root,
+        igraph_vector_t *order,
+        igraph_vector_t *dist);
+DECLDIR int igraph_compressed_adjlist_clusters(const igraph_compressed_adjlist_t *al,
+        igraph_vector_t *membership,
+        igraph_vector_t *csize,
+        igraph_integer_t *no);
+DECLDIR int igraph_compressed_adjlist_pagerank(const igraph_compressed_adjlist_t *al,
+        igraph_vector_t *vector,
+        igraph_real_t damping);
+
 /*************************************************************************
  * DEPRECATED TYPES AND FUNCTIONS
  */
@@ -171,6 +171,15 @@ typedef enum { IGRAPH_IMITATE_AUGMENTED = 0,
                IGRAPH_IMITATE_CONTRACTED
              } igraph_imitate_algorithm_t;
 
+typedef enum { IGRAPH_REORDER_RCM = 0,
+               IGRAPH_REORDER_DEGREE,
+               IGRAPH_REORDER_GORDER
+             } igraph_reorder_algorithm_t;
+
+typedef enum { IGRAPH_BFS_TOPDOWN = 0,
+               IGRAPH_BFS_DIRECTION_OPTIMIZING
+             } igraph_bfs_algorithm_t;
+
 typedef igraph_real_t  igraph_scalar_function_t(const igraph_vector_t *var,
         const igraph_vector_t *par,
         void* extra);
@@ -30,6 +30,9 @@
 
 __BEGIN_DECLS
 
+struct igraph_i_storage_s;
+struct igraph_i_eid_index_s;
+
 /**
  * \ingroup internal
  * \struct igraph_t
@@ -43,17 +46,19 @@ __BEGIN_DECLS
  * - <b>oi</b> The index of the edge list by the first column. Thus
  *   the first edge according to this order goes from
  *   \c from[oi[0]] to \c to[oi[0]]. The length of
- *   this vector is the same as the number of edges in the graph.
+ *   this vector is the same as the number of indexed edges, see
+ *   <b>pending</b> below.
  * - <b>ii</b> The index of the edge list by the second column.
- *   The length of this vector is the same as the number of edges.
+ *   The length of this vector is the same as the number of indexed
+ *   edges.
  * - <b>os</b> Contains pointers to the edgelist (\c from
  *   and \c to for every vertex. The first edge \em from
  *   vertex \c v is edge no. \c from[oi[os[v]]] if
  *   \c os[v]<os[v+1]. If \c os[v]==os[v+1] then
  *   there are no edges \em from node \c v. Its length is
  *   the number of vertices plus one, the last element is always the
- *   same as the number of edges and is contained only to ease the
- *   queries.
+ *   same as the number of indexed edges and is contained only to ease
+ *   the queries.
  * - <b>is</b> This is basically the same as <b>os</b>, but this time
  *   for the incoming edges.
  *
@@ -63,19 +68,42 @@ __BEGIN_DECLS
  * should search for both \c from=v1, \c to=v2 and
  * \c from=v2, \c to=v1.
  *
+ * - <b>storage</b> Normally a null pointer. Otherwise the six vectors
+ *   above do not own their memory, e.g. they point into a memory
+ *   mapped snapshot file, or they are shared with copies of the graph,
+ *   and they are copied to their own memory before the graph is
+ *   modified.
+ * - <b>eid_index</b> Normally a null pointer. Otherwise a hash table
+ *   from the end points of the edges to the edge ids, see \ref
+ *   igraph_build_eid_index(). It is dropped when the graph is
+ *   modified.
+ * - <b>pending</b> The number of edges at the end of the edge list
+ *   that are not in the four indices yet. \ref igraph_add_edges()
+ *   only appends to the edge list, and the new edges are merged into
+ *   the indices before these are used next time, so it is zero for a
+ *   graph that was queried since its last modification.
+ *
+ * All six vectors are integer vectors (\type igraph_vector_int_t),
+ * so the vertex and edge ids are stored with the width of
+ * \type igraph_integer_t, and no floating point conversion is needed
+ * when the indices are traversed.
+ *
  * The storage requirements for a graph with \c |V| vertices
  * and \c |E| edges is \c O(|E|+|V|).
  */
 typedef struct igraph_s {
     igraph_integer_t n;
     igraph_bool_t directed;
-    igraph_vector_t from;
-    igraph_vector_t to;
-    igraph_vector_t oi;
-    igraph_vector_t ii;
-    igraph_vector_t os;
-    igraph_vector_t is;
+    igraph_vector_int_t from;
+    igraph_vector_int_t to;
+    igraph_vector_int_t oi;
+    igraph_vector_int_t ii;
+    igraph_vector_int_t os;
+    igraph_vector_int_t is;
     void *attr;
+    struct igraph_i_storage_s *storage;
+    struct igraph_i_eid_index_s *eid_index;
+    igraph_integer_t pending;
 } igraph_t;
 
 __END_DECLS
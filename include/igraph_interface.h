@@ -67,6 +67,8 @@ DECLDIR int igraph_get_eids(const igraph_t *graph, igraph_vector_t *eids,
                             const igraph_vector_t *pairs,
                             const igraph_vector_t *path,
                             igraph_bool_t directed, igraph_bool_t error);
+DECLDIR int igraph_build_eid_index(igraph_t *graph);
+DECLDIR void igraph_drop_eid_index(igraph_t *graph);
 DECLDIR int igraph_get_eids_multi(const igraph_t *graph, igraph_vector_t *eids,
                                   const igraph_vector_t *pairs,
                                   const igraph_vector_t *path,
@@ -76,6 +78,85 @@ DECLDIR int igraph_adjacent(const igraph_t *graph, igraph_vector_t *eids, igraph
 DECLDIR int igraph_incident(const igraph_t *graph, igraph_vector_t *eids, igraph_integer_t vid,
                             igraph_neimode_t mode);
 
+/* -------------------------------------------------- */
+/* Neighbor views                                     */
+/* -------------------------------------------------- */
+
+typedef struct igraph_csr_view_t {
+    const int *out, *out_end;
+    const int *in, *in_end;
+    const int *to, *from;
+    igraph_bool_t merge;
+} igraph_csr_view_t;
+
+DECLDIR int igraph_csr_view(const igraph_t *graph, igraph_csr_view_t *view,
+                            igraph_integer_t vid, igraph_neimode_t mode);
+
+/* True if the current element of the view comes from the out-list */
+#define IGRAPH_I_CSR_VIEW_AT_OUT(view) \
+    ((view).in == (view).in_end || ((view).out != (view).out_end && \
+      (!(view).merge || (view).to[*(view).out] <= (view).from[*(view).in])))
+
+/**
+ * \define IGRAPH_CSR_VIEW_END
+ * \brief Are we at the end of the view?
+ *
+ * \param view The neighbor view to check.
+ * \return Logical value, if true there are no more neighbors to step
+ * to.
+ *
+ * Time complexity: O(1).
+ */
+#define IGRAPH_CSR_VIEW_END(view) \
+    ((view).out == (view).out_end && (view).in == (view).in_end)
+/**
+ * \define IGRAPH_CSR_VIEW_NEXT
+ * \brief Step to the next neighbor.
+ *
+ * Only call this macro if \ref IGRAPH_CSR_VIEW_END() returns false.
+ * \param view The neighbor view to step.
+ *
+ * Time complexity: O(1).
+ */
+#define IGRAPH_CSR_VIEW_NEXT(view) \
+    (IGRAPH_I_CSR_VIEW_AT_OUT(view) ? ++(view).out : ++(view).in)
+/**
+ * \define IGRAPH_CSR_VIEW_SIZE
+ * \brief The number of neighbors that are not yet visited.
+ *
+ * Right after \ref igraph_csr_view() this is the degree of the vertex,
+ * loop edges counted twice if both directions are included.
+ * \param view The neighbor view.
+ * \return The number of remaining neighbors.
+ *
+ * Time complexity: O(1).
+ */
+#define IGRAPH_CSR_VIEW_SIZE(view) \
+    (((view).out_end - (view).out) + ((view).in_end - (view).in))
+/**
+ * \define IGRAPH_CSR_VIEW_EDGE
+ * \brief The edge leading to the current neighbor.
+ *
+ * \param view The neighbor view.
+ * \return The id of the edge, as an <type>int</type>.
+ *
+ * Time complexity: O(1).
+ */
+#define IGRAPH_CSR_VIEW_EDGE(view) \
+    (IGRAPH_I_CSR_VIEW_AT_OUT(view) ? *(view).out : *(view).in)
+/**
+ * \define IGRAPH_CSR_VIEW_NEIGHBOR
+ * \brief The current neighbor.
+ *
+ * \param view The neighbor view.
+ * \return The id of the neighbor vertex, as an <type>int</type>.
+ *
+ * Time complexity: O(1).
+ */
+#define IGRAPH_CSR_VIEW_NEIGHBOR(view) \
+    (IGRAPH_I_CSR_VIEW_AT_OUT(view) ? (view).to[*(view).out] : \
+     (view).from[*(view).in])
+
 #define IGRAPH_FROM(g,e) ((igraph_integer_t)(VECTOR((g)->from)[(long int)(e)]))
 #define IGRAPH_TO(g,e)   ((igraph_integer_t)(VECTOR((g)->to)  [(long int)(e)]))
 #define IGRAPH_OTHER(g,e,v) \
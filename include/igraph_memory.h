@@ -42,6 +42,55 @@ __BEGIN_DECLS
 DECLDIR int igraph_free(void *p);
 DECLDIR void *igraph_malloc(size_t n);
 
+/* -------------------------------------------------- */
+/* Pluggable allocators                               */
+/* -------------------------------------------------- */
+
+typedef struct igraph_allocator_t {
+    void *(*alloc)(void *data, size_t size);
+    void *(*realloc)(void *data, void *ptr, size_t size);
+    void (*free)(void *data, void *ptr);
+    int (*owns)(void *data, const void *ptr);
+    void *data;
+    struct igraph_allocator_t *prev;
+} igraph_allocator_t;
+
+DECLDIR void igraph_allocator_push(igraph_allocator_t *allocator);
+DECLDIR igraph_allocator_t *igraph_allocator_pop(void);
+
+/* -------------------------------------------------- */
+/* Arena allocator                                    */
+/* -------------------------------------------------- */
+
+typedef struct igraph_arena_t {
+    igraph_allocator_t allocator;
+    struct igraph_i_arena_chunk_s *chunks;
+    size_t chunk_size;
+    void *last;
+} igraph_arena_t;
+
+DECLDIR int igraph_arena_init(igraph_arena_t *arena, size_t chunk_size);
+DECLDIR void igraph_arena_destroy(igraph_arena_t *arena);
+DECLDIR void igraph_arena_begin(igraph_arena_t *arena);
+DECLDIR int igraph_arena_end(igraph_arena_t *arena);
+DECLDIR size_t igraph_arena_size(const igraph_arena_t *arena);
+
+/* -------------------------------------------------- */
+/* Memory usage statistics                            */
+/* -------------------------------------------------- */
+
+typedef struct igraph_memstat_t {
+    size_t live, peak, limit, allocations;
+    int limit_reached;
+    void **ptrs;
+    size_t *sizes;
+    size_t capacity, used;
+    struct igraph_memstat_t *prev;
+} igraph_memstat_t;
+
+DECLDIR void igraph_memstat_begin(igraph_memstat_t *stat, size_t limit);
+DECLDIR int igraph_memstat_end(igraph_memstat_t *stat);
+
 __END_DECLS
 
 #endif
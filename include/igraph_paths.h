@@ -97,6 +97,44 @@ DECLDIR int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
         igraph_integer_t to,
         const igraph_vector_t *weights,
         igraph_neimode_t mode);
+
+/**
+ * \typedef igraph_astar_heuristic_func_t
+ * Distance estimate for the A* algorithm
+ *
+ * \ref igraph_get_shortest_path_astar() calls a function of this
+ * type to get a lower bound of the distance from a vertex to the
+ * target vertex. For example, if the vertices have coordinates in a
+ * layout matrix and the weights are the lengths of the edges, then
+ * the straight line distance of the two vertices can be used.
+ * \param result Pointer to a real number, the estimate must be stored
+ *    here. It must be non-negative, and it must not be larger than
+ *    the real distance, otherwise the path found may be longer than
+ *    the shortest one.
+ * \param from The id of the vertex whose distance is estimated.
+ * \param to The id of the target vertex.
+ * \param extra The \c extra argument that was passed to \ref
+ *    igraph_get_shortest_path_astar().
+ * \return Error code, if it is not \c IGRAPH_SUCCESS, then the
+ *    search stops with this error.
+ *
+ * \sa \ref igraph_get_shortest_path_astar()
+ */
+
+typedef int igraph_astar_heuristic_func_t(igraph_real_t *result,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        void *extra);
+
+DECLDIR int igraph_get_shortest_path_astar(const igraph_t *graph,
+        igraph_vector_t *vertices,
+        igraph_vector_t *edges,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        igraph_astar_heuristic_func_t *heuristic,
+        void *extra);
 DECLDIR int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
         igraph_vector_ptr_t *res,
         igraph_vector_t *nrgeo,
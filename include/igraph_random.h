@@ -51,6 +51,8 @@ typedef struct igraph_rng_type_t {
     igraph_real_t (*get_exp)(void *state, igraph_real_t rate);
     igraph_real_t (*get_gamma)(void *state, igraph_real_t shape,
                                igraph_real_t scale);
+    int (*jump)(void *state, unsigned long int n);
+    int (*split)(const void *state, void *child, unsigned long int stream);
 } igraph_rng_type_t;
 
 typedef struct igraph_rng_t {
@@ -68,6 +70,9 @@ DECLDIR int igraph_rng_seed(igraph_rng_t *rng, unsigned long int seed);
 DECLDIR unsigned long int igraph_rng_max(igraph_rng_t *rng);
 DECLDIR unsigned long int igraph_rng_min(igraph_rng_t *rng);
 DECLDIR const char *igraph_rng_name(igraph_rng_t *rng);
+DECLDIR int igraph_rng_jump(igraph_rng_t *rng, unsigned long int n);
+DECLDIR int igraph_rng_split(igraph_rng_t *rng, igraph_rng_t *child,
+                             unsigned long int stream);
 
 DECLDIR long int igraph_rng_get_integer(igraph_rng_t *rng,
                                         long int l, long int h);
@@ -92,6 +97,7 @@ DECLDIR int igraph_rng_get_dirichlet(igraph_rng_t *rng,
 extern const igraph_rng_type_t igraph_rngtype_glibc2;
 extern const igraph_rng_type_t igraph_rngtype_rand;
 extern const igraph_rng_type_t igraph_rngtype_mt19937;
+extern const igraph_rng_type_t igraph_rngtype_philox;
 
 DECLDIR igraph_rng_t *igraph_rng_default(void);
 DECLDIR void igraph_rng_set_default(igraph_rng_t *rng);
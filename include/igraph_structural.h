@@ -128,6 +128,10 @@ DECLDIR int igraph_feedback_arc_set(const igraph_t *graph, igraph_vector_t *resu
 DECLDIR int igraph_diversity(igraph_t *graph, const igraph_vector_t *weights,
                              igraph_vector_t *res, const igraph_vs_t vs);
 
+DECLDIR int igraph_reorder_for_locality(const igraph_t *graph, igraph_t *res,
+                                        igraph_vector_t *permutation,
+                                        igraph_reorder_algorithm_t algo);
+
 /* -------------------------------------------------- */
 /* Spectral Properties                                */
 /* -------------------------------------------------- */
@@ -0,0 +1,81 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+
+#ifndef IGRAPH_TRACE_H
+#define IGRAPH_TRACE_H
+
+#include "igraph_decls.h"
+
+__BEGIN_DECLS
+
+/**
+ * \struct igraph_trace_counters_t
+ * \brief Work counters of the core algorithms.
+ *
+ * The counters measure the work done by the traversals, the shortest
+ * path, eigenvector and community detection algorithms, see \ref
+ * about_trace for the functions that update them.
+ * \member visited_vertices The number of vertices taken from the
+ *    queue, stack or heap of breadth-first search, depth-first search
+ *    and Dijkstra's algorithm.
+ * \member scanned_edges The number of edges examined by breadth-first
+ *    and depth-first search.
+ * \member relaxed_edges The number of edges relaxed by Dijkstra's
+ *    algorithm.
+ * \member arpack_matvecs The number of matrix-vector products computed
+ *    for ARPACK.
+ * \member community_moves The number of times a vertex was moved to
+ *    another community by the Louvain and Leiden algorithms.
+ * \member community_levels The number of aggregation levels of the
+ *    Louvain and Leiden algorithms.
+ */
+
+typedef struct igraph_trace_counters_t {
+    long int visited_vertices;
+    long int scanned_edges;
+    long int relaxed_edges;
+    long int arpack_matvecs;
+    long int community_moves;
+    long int community_levels;
+} igraph_trace_counters_t;
+
+/**
+ * \typedef igraph_trace_handler_t
+ * \brief The type of trace handler functions.
+ *
+ * \param function The name of the igraph function that returned.
+ * \param counters The work done since the previous call of the
+ *    handler, or since the counters were reset, on the calling
+ *    thread.
+ */
+
+typedef void igraph_trace_handler_t(const char *function,
+                                    const igraph_trace_counters_t *counters);
+
+DECLDIR igraph_trace_handler_t *igraph_set_trace_handler(igraph_trace_handler_t *new_handler);
+DECLDIR void igraph_trace_counters(igraph_trace_counters_t *counters);
+DECLDIR void igraph_trace_counters_reset(void);
+
+__END_DECLS
+
+#endif
@@ -171,6 +171,9 @@ DECLDIR int igraph_vector_zapsmall(igraph_vector_t *v, igraph_real_t tol);
 /* These are for internal use only */
 int igraph_vector_order(const igraph_vector_t* v, const igraph_vector_t *v2,
                         igraph_vector_t* res, igraph_real_t maxval);
+int igraph_vector_int_order(const igraph_vector_int_t* v,
+                            const igraph_vector_int_t *v2,
+                            igraph_vector_int_t* res, igraph_integer_t maxval);
 int igraph_vector_order1(const igraph_vector_t* v,
                          igraph_vector_t* res, igraph_real_t maxval);
 int igraph_vector_order1_int(const igraph_vector_t* v,
@@ -85,6 +85,11 @@ DECLDIR int igraph_bfs(const igraph_t *graph,
                igraph_vector_t *dist, igraph_bfshandler_t *callback,
                void *extra);
 
+DECLDIR int igraph_bfs_distances(const igraph_t *graph, igraph_vector_t *dist,
+                                 igraph_vector_t *father, igraph_integer_t root,
+                                 igraph_neimode_t mode,
+                                 igraph_bfs_algorithm_t algo);
+
 int igraph_i_bfs(igraph_t *graph, igraph_integer_t vid, igraph_neimode_t mode,
                  igraph_vector_t *vids, igraph_vector_t *layers,
                  igraph_vector_t *parents);
@@ -25,6 +25,7 @@
 #include "igraph_memory.h"
 #include "igraph_interface.h"
 #include "igraph_interrupt_internal.h"
+#include "igraph_threads_internal.h"
 #include "config.h"
 
 #include <string.h>   /* memset */
@@ -66,6 +67,12 @@
  * during the computation.
  * </para>
  *
+ * <para>A lazy adjacency list keeps every neighbor list it has queried
+ * until it is destroyed. Lazy adjacency caches keep only as many of
+ * them as fit into a given memory budget, and they can be shared by
+ * several threads, see \ref igraph_lazy_adjcache_init().
+ * </para>
+ *
  * <para>
  * \example examples/simple/adjlist.c
  * </para>
@@ -109,6 +116,7 @@ int igraph_adjlist_init(const igraph_t *graph, igraph_adjlist_t *al,
     }
 
     al->length = igraph_vcount(graph);
+    al->flat = 0;
     al->adjs = igraph_Calloc(al->length, igraph_vector_int_t);
     if (al->adjs == 0) {
         IGRAPH_ERROR("Cannot create adjlist view", IGRAPH_ENOMEM);
@@ -131,6 +139,104 @@ int igraph_adjlist_init(const igraph_t *graph, igraph_adjlist_t *al,
     return 0;
 }
 
+/* Fills 'vectors' with views into a single array of all neighbors
+   (or incident edges), in the same order as igraph_neighbors() (or
+   igraph_incident()). The array is stored in '*flat'. */
+
+static int igraph_i_adjlist_init_flat(const igraph_t *graph,
+                                      igraph_vector_int_t *vectors,
+                                      int **flat, igraph_neimode_t mode,
+                                      igraph_bool_t edges) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int i, total = 0;
+    igraph_csr_view_t view;
+    int *p;
+
+    for (i = 0; i < no_of_nodes; i++) {
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) i, mode));
+        total += IGRAPH_CSR_VIEW_SIZE(view);
+    }
+
+    *flat = igraph_Calloc(total > 0 ? total : 1, int);
+    if (*flat == 0) {
+        IGRAPH_ERROR("Cannot create flat adjlist view", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, *flat);
+
+    for (p = *flat, i = 0; i < no_of_nodes; i++) {
+        long int n;
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) i, mode));
+        n = IGRAPH_CSR_VIEW_SIZE(view);
+        igraph_vector_int_view(&vectors[i], p, n);
+        if (edges) {
+            view.merge = 0;
+            for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                *p++ = IGRAPH_CSR_VIEW_EDGE(view);
+            }
+        } else {
+            for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                *p++ = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+            }
+        }
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/**
+ * \function igraph_adjlist_init_flat
+ * Initialize a flat adjacency list of vertices from a given graph
+ *
+ * Creates the same adjacency list as \ref igraph_adjlist_init(), but
+ * all neighbor vectors are views into a single array, so only two
+ * memory allocations are needed instead of one per vertex, and the
+ * neighbors of consecutive vertices are next to each other in
+ * memory. This is much faster for large graphs, and it should be
+ * preferred whenever the adjacency list is only read.
+ *
+ * </para><para>
+ * The elements of the vectors can be modified, the vectors can be
+ * sorted and shrunk, e.g. with \ref igraph_adjlist_simplify(), but
+ * they must not grow: functions like \ref igraph_vector_int_push_back()
+ * or \ref igraph_vector_int_resize() with a larger size must not be
+ * called on them. The adjacency list must be destroyed with \ref
+ * igraph_adjlist_destroy(), as usual.
+ * \param graph The input graph.
+ * \param al Pointer to an uninitialized <type>igraph_adjlist_t</type> object.
+ * \param mode Constant specifying whether outgoing
+ *   (<code>IGRAPH_OUT</code>), incoming (<code>IGRAPH_IN</code>),
+ *   or both (<code>IGRAPH_ALL</code>) types of neighbors to include
+ *   in the adjacency list. It is ignored for undirected networks.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+
+int igraph_adjlist_init_flat(const igraph_t *graph, igraph_adjlist_t *al,
+                             igraph_neimode_t mode) {
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create flat adjlist view", IGRAPH_EINVMODE);
+    }
+
+    al->length = igraph_vcount(graph);
+    al->flat = 0;
+    al->adjs = igraph_Calloc(al->length > 0 ? al->length : 1, igraph_vector_int_t);
+    if (al->adjs == 0) {
+        IGRAPH_ERROR("Cannot create flat adjlist view", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, al->adjs);
+
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, al->adjs, &al->flat, mode,
+                                            /* edges= */ 0));
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
 /**
  * \function igraph_adjlist_init_empty
  * Initialize an empty adjacency list
@@ -149,6 +255,7 @@ int igraph_adjlist_init_empty(igraph_adjlist_t *al, igraph_integer_t no_of_nodes
     long int i;
 
     al->length = no_of_nodes;
+    al->flat = 0;
     al->adjs = igraph_Calloc(al->length, igraph_vector_int_t);
     if (al->adjs == 0) {
         IGRAPH_ERROR("Cannot create adjlist view", IGRAPH_ENOMEM);
@@ -201,6 +308,7 @@ int igraph_adjlist_init_complementer(const igraph_t *graph,
     }
 
     al->length = igraph_vcount(graph);
+    al->flat = 0;
     al->adjs = igraph_Calloc(al->length, igraph_vector_int_t);
     if (al->adjs == 0) {
         IGRAPH_ERROR("Cannot create complementer adjlist view", IGRAPH_ENOMEM);
@@ -258,9 +366,14 @@ int igraph_adjlist_init_complementer(const igraph_t *graph,
 
 void igraph_adjlist_destroy(igraph_adjlist_t *al) {
     long int i;
-    for (i = 0; i < al->length; i++) {
-        if (&al->adjs[i]) {
-            igraph_vector_int_destroy(&al->adjs[i]);
+    if (al->flat) {
+        /* The vectors are views into al->flat */
+        igraph_Free(al->flat);
+    } else {
+        for (i = 0; i < al->length; i++) {
+            if (&al->adjs[i]) {
+                igraph_vector_int_destroy(&al->adjs[i]);
+            }
         }
     }
     igraph_Free(al->adjs);
@@ -581,6 +694,7 @@ int igraph_inclist_init(const igraph_t *graph,
     }
 
     il->length = igraph_vcount(graph);
+    il->flat = 0;
     il->incs = igraph_Calloc(il->length, igraph_vector_int_t);
     if (il->incs == 0) {
         IGRAPH_ERROR("Cannot create incidence list view", IGRAPH_ENOMEM);
@@ -603,6 +717,48 @@ int igraph_inclist_init(const igraph_t *graph,
     return 0;
 }
 
+/**
+ * \function igraph_inclist_init_flat
+ * Initialize a flat incidence list of edges
+ *
+ * Creates the same incidence list as \ref igraph_inclist_init(), but
+ * all vectors are views into a single array, see \ref
+ * igraph_adjlist_init_flat() for the advantages and the restrictions.
+ * \param graph The input graph.
+ * \param il Pointer to an uninitialized incidence list.
+ * \param mode Constant specifying whether incoming edges
+ *   (<code>IGRAPH_IN</code>), outgoing edges (<code>IGRAPH_OUT</code>) or
+ *   both (<code>IGRAPH_ALL</code>) to include in the incidence lists
+ *   of directed graphs. It is ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+
+int igraph_inclist_init_flat(const igraph_t *graph,
+                             igraph_inclist_t *il,
+                             igraph_neimode_t mode) {
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create flat incidence list view", IGRAPH_EINVMODE);
+    }
+
+    il->length = igraph_vcount(graph);
+    il->flat = 0;
+    il->incs = igraph_Calloc(il->length > 0 ? il->length : 1, igraph_vector_int_t);
+    if (il->incs == 0) {
+        IGRAPH_ERROR("Cannot create flat incidence list view", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, il->incs);
+
+    IGRAPH_CHECK(igraph_i_adjlist_init_flat(graph, il->incs, &il->flat, mode,
+                                            /* edges= */ 1));
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
 /**
  * \function igraph_inclist_init_empty
  * \brief Initialize an incidence list corresponding to an empty graph.
@@ -622,6 +778,7 @@ int igraph_inclist_init_empty(igraph_inclist_t *il, igraph_integer_t n) {
     long int i;
 
     il->length = n;
+    il->flat = 0;
     il->incs = igraph_Calloc(il->length, igraph_vector_int_t);
     if (il->incs == 0) {
         IGRAPH_ERROR("Cannot create incidence list view", IGRAPH_ENOMEM);
@@ -647,10 +804,15 @@ int igraph_inclist_init_empty(igraph_inclist_t *il, igraph_integer_t n) {
 
 void igraph_inclist_destroy(igraph_inclist_t *il) {
     long int i;
-    for (i = 0; i < il->length; i++) {
-        /* This works if some igraph_vector_int_t's are 0,
-           because igraph_vector_destroy can handle this. */
-        igraph_vector_int_destroy(&il->incs[i]);
+    if (il->flat) {
+        /* The vectors are views into il->flat */
+        igraph_Free(il->flat);
+    } else {
+        for (i = 0; i < il->length; i++) {
+            /* This works if some igraph_vector_int_t's are 0,
+               because igraph_vector_destroy can handle this. */
+            igraph_vector_int_destroy(&il->incs[i]);
+        }
     }
     igraph_Free(il->incs);
 }
@@ -787,6 +949,308 @@ igraph_vector_t *igraph_lazy_adjlist_get_real(igraph_lazy_adjlist_t *al,
     return al->adjs[no];
 }
 
+/* An entry of a lazy adjacency cache. 'ref' is the reference bit of
+   the CLOCK eviction: it is set when the entry is used, and cleared
+   when the clock hand passes the entry, the entry is only evicted if
+   the bit is already clear. */
+
+typedef struct igraph_i_adjcache_entry_s {
+    int vid;
+    int ref;
+    long int size;
+    int *neis;
+} igraph_i_adjcache_entry_t;
+
+#define IGRAPH_I_ADJCACHE_COST(n) \
+    ((size_t) (n) * sizeof(int) + sizeof(igraph_i_adjcache_entry_t))
+
+/**
+ * \function igraph_lazy_adjcache_init
+ * Create a lazy adjacency cache with a memory budget
+ *
+ * A lazy adjacency cache is like a lazy adjacency list (see \ref
+ * igraph_lazy_adjlist_init()), the neighbors of the vertices are only
+ * queried when they are first needed. Unlike a lazy adjacency list,
+ * the cache does not keep all queried neighbor lists forever: the
+ * total size of the stored lists is kept below \p budget bytes, and
+ * when a new list does not fit, the least recently used lists are
+ * dropped, using the CLOCK approximation of the LRU policy. Lists
+ * that are larger than the whole budget are never stored.
+ *
+ * </para><para>
+ * The neighbors are copied out of the cache by \ref
+ * igraph_lazy_adjcache_get(), so the same cache can be used from
+ * several threads at the same time, as long as the graph is not
+ * modified. This needs POSIX threads, or Windows; on other platforms
+ * the cache must only be used from a single thread.
+ *
+ * </para><para>
+ * Apart from the budget, the cache needs <code>sizeof(int)</code>
+ * bytes for every vertex of the graph.
+ * \param graph The input graph. It must not be modified or destroyed
+ *   while the cache is in use.
+ * \param cache Pointer to an uninitialized adjacency cache object.
+ * \param mode Constant, it gives whether incoming edges
+ *   (<code>IGRAPH_IN</code>), outgoing edges
+ *   (<code>IGRAPH_OUT</code>) or both types of edges
+ *   (<code>IGRAPH_ALL</code>) are considered. It is ignored for
+ *   undirected graphs.
+ * \param simplify Constant, it gives whether to remove loop and
+ *   multiple edges from the neighbor lists
+ *   (<code>IGRAPH_SIMPLIFY</code>) or not
+ *   (<code>IGRAPH_DONT_SIMPLIFY</code>).
+ * \param budget The maximum number of bytes used for the stored
+ *   neighbor lists. If zero, no lists are stored at all.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|), the number of vertices.
+ */
+
+int igraph_lazy_adjcache_init(const igraph_t *graph,
+                              igraph_lazy_adjcache_t *cache,
+                              igraph_neimode_t mode,
+                              igraph_lazy_adlist_simplify_t simplify,
+                              size_t budget) {
+    long int i, n = igraph_vcount(graph);
+    igraph_i_mutex_t *lock;
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create lazy adjacency cache", IGRAPH_EINVMODE);
+    }
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    cache->graph = graph;
+    cache->length = (igraph_integer_t) n;
+    cache->mode = mode;
+    cache->simplify = simplify;
+    cache->budget = budget;
+    cache->used = 0;
+    cache->entries = 0;
+    cache->size = cache->capacity = cache->hand = 0;
+
+    cache->slot_of = igraph_Calloc(n > 0 ? n : 1, int);
+    if (cache->slot_of == 0) {
+        IGRAPH_ERROR("Cannot create lazy adjacency cache", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, cache->slot_of);
+    for (i = 0; i < n; i++) {
+        cache->slot_of[i] = -1;
+    }
+
+    lock = igraph_Calloc(1, igraph_i_mutex_t);
+    if (lock == 0) {
+        IGRAPH_ERROR("Cannot create lazy adjacency cache", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, lock);
+    if (IGRAPH_I_MUTEX_INIT(lock) != 0) {
+        IGRAPH_ERROR("Cannot create lock for lazy adjacency cache",
+                     IGRAPH_FAILURE);
+    }
+    cache->lock = lock;
+
+    IGRAPH_FINALLY_CLEAN(2);
+    return 0;
+}
+
+/**
+ * \function igraph_lazy_adjcache_destroy
+ * Deallocate memory
+ *
+ * Free all memory allocated for a lazy adjacency cache. No other
+ * thread may use the cache at this point.
+ * \param cache The adjacency cache to deallocate.
+ *
+ * Time complexity: O(n), the number of stored neighbor lists.
+ */
+
+void igraph_lazy_adjcache_destroy(igraph_lazy_adjcache_t *cache) {
+    long int i;
+    for (i = 0; i < cache->size; i++) {
+        igraph_Free(cache->entries[i].neis);
+    }
+    igraph_Free(cache->entries);
+    igraph_Free(cache->slot_of);
+    IGRAPH_I_MUTEX_DESTROY((igraph_i_mutex_t *) cache->lock);
+    igraph_Free(cache->lock);
+}
+
+/* Evicts entries until 'cost' more bytes fit into the budget. Must be
+   called with the lock held, and only if cost <= budget. */
+
+static void igraph_i_lazy_adjcache_evict(igraph_lazy_adjcache_t *cache,
+        size_t cost) {
+    while (cache->size > 0 && cache->used + cost > cache->budget) {
+        igraph_i_adjcache_entry_t *e = &cache->entries[cache->hand];
+        if (e->ref) {
+            e->ref = 0;
+            cache->hand++;
+        } else {
+            cache->used -= IGRAPH_I_ADJCACHE_COST(e->size);
+            cache->slot_of[e->vid] = -1;
+            igraph_Free(e->neis);
+            /* Move the last entry into the hole */
+            cache->size--;
+            if (cache->hand != cache->size) {
+                *e = cache->entries[cache->size];
+                cache->slot_of[e->vid] = (int) cache->hand;
+            }
+        }
+        if (cache->hand >= cache->size) {
+            cache->hand = 0;
+        }
+    }
+}
+
+/* Stores a copy of the neighbors of 'no' in the cache, if they fit.
+   Failing to store them is not an error, they are simply queried
+   again next time. */
+
+static void igraph_i_lazy_adjcache_insert(igraph_lazy_adjcache_t *cache,
+        igraph_integer_t no,
+        const igraph_vector_int_t *neis) {
+    igraph_i_mutex_t *lock = cache->lock;
+    long int n = igraph_vector_int_size(neis);
+    size_t cost = IGRAPH_I_ADJCACHE_COST(n);
+    igraph_i_adjcache_entry_t *e;
+    int *copy;
+
+    if (cost > cache->budget) {
+        return;
+    }
+    copy = igraph_Calloc(n > 0 ? n : 1, int);
+    if (copy == 0) {
+        return;
+    }
+    memcpy(copy, VECTOR(*neis), (size_t) n * sizeof(int));
+
+    IGRAPH_I_MUTEX_LOCK(lock);
+    if (cache->slot_of[(long int) no] >= 0) {
+        /* Another thread was faster */
+        IGRAPH_I_MUTEX_UNLOCK(lock);
+        igraph_Free(copy);
+        return;
+    }
+    igraph_i_lazy_adjcache_evict(cache, cost);
+    if (cache->size == cache->capacity) {
+        long int newcap = cache->capacity > 0 ? 2 * cache->capacity : 16;
+        igraph_i_adjcache_entry_t *tmp =
+            igraph_Realloc(cache->entries, (size_t) newcap,
+                           igraph_i_adjcache_entry_t);
+        if (tmp == 0) {
+            IGRAPH_I_MUTEX_UNLOCK(lock);
+            igraph_Free(copy);
+            return;
+        }
+        cache->entries = tmp;
+        cache->capacity = newcap;
+    }
+    e = &cache->entries[cache->size];
+    e->vid = (int) no;
+    e->ref = 0;
+    e->size = n;
+    e->neis = copy;
+    cache->slot_of[(long int) no] = (int) cache->size;
+    cache->size++;
+    cache->used += cost;
+    IGRAPH_I_MUTEX_UNLOCK(lock);
+}
+
+/**
+ * \function igraph_lazy_adjcache_get
+ * Query neighbor vertices through a lazy adjacency cache
+ *
+ * Copies the neighbors of a vertex into \p neis. If the neighbors are
+ * stored in the cache, they are copied from there, otherwise they are
+ * queried from the graph and stored in the cache if they fit into
+ * its budget. The neighbors are listed in the same order as by \ref
+ * igraph_neighbors().
+ *
+ * </para><para>
+ * This function can be called from several threads at the same time,
+ * see \ref igraph_lazy_adjcache_init().
+ * \param cache The lazy adjacency cache.
+ * \param no The vertex id to query.
+ * \param neis Pointer to an initialized integer vector, the result is
+ *   stored here. It will be resized as needed.
+ * \return Error code: \c IGRAPH_EINVVID if \p no is not a valid
+ *   vertex id, \c IGRAPH_ENOMEM if there is not enough memory for
+ *   the result.
+ *
+ * Time complexity: O(d), the number of neighbors of the vertex, plus
+ * the cost of the evictions, which is O(1) amortized per stored
+ * neighbor list.
+ */
+
+int igraph_lazy_adjcache_get(igraph_lazy_adjcache_t *cache,
+                             igraph_integer_t no,
+                             igraph_vector_int_t *neis) {
+    igraph_i_mutex_t *lock = cache->lock;
+    igraph_csr_view_t view;
+    long int slot, n;
+    int ret = 0;
+
+    if (no < 0 || no >= cache->length) {
+        IGRAPH_ERROR("Cannot query lazy adjacency cache", IGRAPH_EINVVID);
+    }
+
+    IGRAPH_I_MUTEX_LOCK(lock);
+    slot = cache->slot_of[(long int) no];
+    if (slot >= 0) {
+        igraph_i_adjcache_entry_t *e = &cache->entries[slot];
+        e->ref = 1;
+        ret = igraph_vector_int_resize(neis, e->size);
+        if (ret == 0) {
+            memcpy(VECTOR(*neis), e->neis, (size_t) e->size * sizeof(int));
+        }
+    }
+    IGRAPH_I_MUTEX_UNLOCK(lock);
+    if (ret != 0) {
+        IGRAPH_ERROR("Cannot query lazy adjacency cache", ret);
+    }
+    if (slot >= 0) {
+        return 0;
+    }
+
+    /* Not in the cache, the graph is read without holding the lock */
+    IGRAPH_CHECK(igraph_csr_view(cache->graph, &view, no, cache->mode));
+    IGRAPH_CHECK(igraph_vector_int_resize(neis, IGRAPH_CSR_VIEW_SIZE(view)));
+    for (n = 0; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+        int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+        if (cache->simplify == IGRAPH_SIMPLIFY &&
+            (nei == no || (n > 0 && VECTOR(*neis)[n - 1] == nei))) {
+            continue;
+        }
+        VECTOR(*neis)[n++] = nei;
+    }
+    igraph_vector_int_resize(neis, n);  /* shrinks, cannot fail */
+
+    igraph_i_lazy_adjcache_insert(cache, no, neis);
+
+    return 0;
+}
+
+/**
+ * \function igraph_lazy_adjcache_used
+ * The memory used by the stored neighbor lists
+ *
+ * \param cache The lazy adjacency cache.
+ * \return The number of bytes used by the stored neighbor lists, it
+ *   is never larger than the budget of the cache.
+ *
+ * Time complexity: O(1).
+ */
+
+size_t igraph_lazy_adjcache_used(const igraph_lazy_adjcache_t *cache) {
+    igraph_i_mutex_t *lock = cache->lock;
+    size_t used;
+    IGRAPH_I_MUTEX_LOCK(lock);
+    used = cache->used;
+    IGRAPH_I_MUTEX_UNLOCK(lock);
+    return used;
+}
+
 /**
  * \function igraph_lazy_adjedgelist_init
  * Initializes a lazy incidence list of edges
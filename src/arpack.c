@@ -25,6 +25,7 @@
 #include "igraph_arpack.h"
 #include "igraph_arpack_internal.h"
 #include "igraph_memory.h"
+#include "igraph_trace_internal.h"
 
 #include <math.h>
 #include <stdio.h>
@@ -984,6 +985,7 @@ int igraph_arpack_rssolve(igraph_arpack_function_t *fun, void *extra,
         if (ido == -1 || ido == 1) {
             igraph_real_t *from = workd + options->ipntr[0] - 1;
             igraph_real_t *to = workd + options->ipntr[1] - 1;
+            IGRAPH_I_TRACE_ADD(arpack_matvecs, 1);
             if (fun(to, from, options->n, extra) != 0) {
                 IGRAPH_ERROR("ARPACK error while evaluating matrix-vector product",
                              IGRAPH_ARPACK_PROD);
@@ -1058,6 +1060,7 @@ int igraph_arpack_rssolve(igraph_arpack_function_t *fun, void *extra,
         igraph_Free(v);
         IGRAPH_FINALLY_CLEAN(7);
     }
+    IGRAPH_I_TRACE_REPORT("igraph_arpack_rssolve");
     return 0;
 }
 
@@ -1238,6 +1241,7 @@ int igraph_arpack_rnsolve(igraph_arpack_function_t *fun, void *extra,
         if (ido == -1 || ido == 1) {
             igraph_real_t *from = workd + options->ipntr[0] - 1;
             igraph_real_t *to = workd + options->ipntr[1] - 1;
+            IGRAPH_I_TRACE_ADD(arpack_matvecs, 1);
             if (fun(to, from, options->n, extra) != 0) {
                 IGRAPH_ERROR("ARPACK error while evaluating matrix-vector product",
                              IGRAPH_ARPACK_PROD);
@@ -1315,6 +1319,7 @@ int igraph_arpack_rnsolve(igraph_arpack_function_t *fun, void *extra,
         igraph_Free(v);
         IGRAPH_FINALLY_CLEAN(8);
     }
+    IGRAPH_I_TRACE_REPORT("igraph_arpack_rnsolve");
     return 0;
 }
 
@@ -100,7 +100,7 @@ int igraph_bipartite_projection_size(const igraph_t *graph,
     IGRAPH_CHECK(igraph_vector_long_init(&added, no_of_nodes));
     IGRAPH_FINALLY(igraph_vector_long_destroy, &added);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
 
     for (i = 0; i < no_of_nodes; i++) {
@@ -177,7 +177,7 @@ int igraph_i_bipartite_projection(const igraph_t *graph,
     IGRAPH_VECTOR_INIT_FINALLY(&vertex_index, no_of_nodes);
     IGRAPH_CHECK(igraph_vector_long_init(&added, no_of_nodes));
     IGRAPH_FINALLY(igraph_vector_long_destroy, &added);
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
     if (multiplicity) {
         IGRAPH_VECTOR_INIT_FINALLY(&mult, no_of_nodes);
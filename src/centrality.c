@@ -36,6 +36,7 @@
 #include "igraph_topology.h"
 #include "igraph_types_internal.h"
 #include "igraph_stack.h"
+#include "igraph_msbfs_internal.h"
 #include "igraph_dqueue.h"
 #include "config.h"
 
@@ -2351,14 +2352,14 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
 
     directed = directed && igraph_is_directed(graph);
     if (directed) {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_OUT));
+        IGRAPH_CHECK(igraph_inclist_init_flat(graph, &elist_out, IGRAPH_OUT));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_in, IGRAPH_IN));
+        IGRAPH_CHECK(igraph_inclist_init_flat(graph, &elist_in, IGRAPH_IN));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_in);
         elist_out_p = &elist_out;
         elist_in_p = &elist_in;
     } else {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_ALL));
+        IGRAPH_CHECK(igraph_inclist_init_flat(graph, &elist_out, IGRAPH_ALL));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
         elist_out_p = elist_in_p = &elist_out;
     }
@@ -2700,6 +2701,33 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
     return 0;
 }
 
+/* The sum of the distances, the number of reached vertices and the
+   largest distance of every source, in a multi-source BFS. Every
+   source belongs to one batch, so only one thread writes them. The
+   sources are searched in rounds, 'offset' is the index of the first
+   source of the round. */
+
+typedef struct {
+    igraph_vector_t *res, *nodes_reached, *maxdist;
+    long int offset;
+} igraph_i_closeness_data_t;
+
+static int igraph_i_closeness_visit(void *arg, long int batch, long int vertex,
+                                    igraph_i_msbfs_mask_t reached,
+                                    long int dist) {
+    igraph_i_closeness_data_t *data = arg;
+    long int first = data->offset + batch * IGRAPH_I_MSBFS_WIDTH;
+    IGRAPH_UNUSED(vertex);
+    while (reached) {
+        long int i = first + IGRAPH_I_MSBFS_LOWEST(reached);
+        VECTOR(*data->res)[i] += dist;
+        VECTOR(*data->nodes_reached)[i] += 1;
+        VECTOR(*data->maxdist)[i] = dist;
+        reached &= reached - 1;
+    }
+    return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_closeness_estimate
@@ -2773,14 +2801,11 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
                               igraph_bool_t normalized) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_vector_t already_counted;
-    igraph_vector_int_t *neis;
-    long int i, j;
-    long int nodes_reached;
-    long int actdist;
+    long int round = igraph_i_msbfs_round();
+    long int i;
     igraph_adjlist_t allneis;
-
-    igraph_dqueue_t q;
+    igraph_vector_t sources, round_sources, nodes_reached, maxdist;
+    igraph_i_closeness_data_t data;
 
     long int nodes_to_calc;
     igraph_vit_t vit;
@@ -2802,57 +2827,40 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
         IGRAPH_ERROR("calculating closeness", IGRAPH_EINVMODE);
     }
 
-    IGRAPH_VECTOR_INIT_FINALLY(&already_counted, no_of_nodes);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
+    IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+    IGRAPH_CHECK(igraph_vit_as_vector(&vit, &sources));
+    IGRAPH_VECTOR_INIT_FINALLY(&nodes_reached, nodes_to_calc);
+    IGRAPH_VECTOR_INIT_FINALLY(&maxdist, nodes_to_calc);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, mode));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &allneis, mode));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
     IGRAPH_CHECK(igraph_vector_resize(res, nodes_to_calc));
     igraph_vector_null(res);
 
-    for (IGRAPH_VIT_RESET(vit), i = 0;
-         !IGRAPH_VIT_END(vit);
-         IGRAPH_VIT_NEXT(vit), i++) {
-        igraph_dqueue_clear(&q);
-        IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(vit)));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        nodes_reached = 1;
-        VECTOR(already_counted)[(long int)IGRAPH_VIT_GET(vit)] = i + 1;
-
-        IGRAPH_PROGRESS("Closeness: ", 100.0 * i / no_of_nodes, NULL);
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int act = (long int) igraph_dqueue_pop(&q);
-            actdist = (long int) igraph_dqueue_pop(&q);
-
-            VECTOR(*res)[i] += actdist;
-
-            if (cutoff > 0 && actdist >= cutoff) {
-                continue;    /* NOT break!!! */
-            }
+    IGRAPH_PROGRESS("Closeness: ", 0.0, NULL);
 
-            /* check the neighbors */
-            neis = igraph_adjlist_get(&allneis, act);
-            for (j = 0; j < igraph_vector_int_size(neis); j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (VECTOR(already_counted)[neighbor] == i + 1) {
-                    continue;
-                }
-                VECTOR(already_counted)[neighbor] = i + 1;
-                nodes_reached++;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-            }
-        }
+    data.res = res;
+    data.nodes_reached = &nodes_reached;
+    data.maxdist = &maxdist;
+    for (data.offset = 0; data.offset < nodes_to_calc; data.offset += round) {
+        long int size = nodes_to_calc - data.offset < round ?
+                        nodes_to_calc - data.offset : round;
+        igraph_vector_view(&round_sources, VECTOR(sources) + data.offset, size);
+        IGRAPH_CHECK(igraph_i_msbfs(&allneis, &round_sources, cutoff,
+                                    igraph_i_closeness_visit, &data));
+        IGRAPH_PROGRESS("Closeness: ", 100.0 * (data.offset + size) / nodes_to_calc,
+                        NULL);
+    }
 
+    for (i = 0; i < nodes_to_calc; i++) {
         /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
-        VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached));
+        VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes *
+                            (no_of_nodes - VECTOR(nodes_reached)[i]));
         VECTOR(*res)[i] = (no_of_nodes - 1) / VECTOR(*res)[i];
 
-        if (((cutoff > 0 && actdist < cutoff) || cutoff <= 0) &&
-            no_of_nodes > nodes_reached && !warning_shown) {
+        if (((cutoff > 0 && VECTOR(maxdist)[i] < cutoff) || cutoff <= 0) &&
+            no_of_nodes > VECTOR(nodes_reached)[i] && !warning_shown) {
             IGRAPH_WARNING("closeness centrality is not well-defined for disconnected graphs");
             warning_shown = 1;
         }
@@ -2867,11 +2875,12 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
     IGRAPH_PROGRESS("Closeness: ", 100.0, NULL);
 
     /* Clean */
-    igraph_dqueue_destroy(&q);
-    igraph_vector_destroy(&already_counted);
-    igraph_vit_destroy(&vit);
     igraph_adjlist_destroy(&allneis);
-    IGRAPH_FINALLY_CLEAN(4);
+    igraph_vector_destroy(&maxdist);
+    igraph_vector_destroy(&nodes_reached);
+    igraph_vector_destroy(&sources);
+    igraph_vit_destroy(&vit);
+    IGRAPH_FINALLY_CLEAN(5);
 
     return 0;
 }
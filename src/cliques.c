@@ -820,7 +820,7 @@ int igraph_maximal_independent_vertex_sets(const igraph_t *graph,
     clqdata.matrix_size = no_of_nodes;
     clqdata.keep_only_largest = 0;
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &clqdata.adj_list, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &clqdata.adj_list, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &clqdata.adj_list);
 
     clqdata.IS = igraph_Calloc(no_of_nodes, igraph_integer_t);
@@ -897,7 +897,7 @@ int igraph_independence_number(const igraph_t *graph, igraph_integer_t *no) {
     clqdata.matrix_size = no_of_nodes;
     clqdata.keep_only_largest = 0;
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &clqdata.adj_list, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &clqdata.adj_list, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &clqdata.adj_list);
 
     clqdata.IS = igraph_Calloc(no_of_nodes, igraph_integer_t);
@@ -1133,7 +1133,7 @@ int igraph_i_maximal_cliques(const igraph_t *graph, igraph_i_maximal_clique_func
     }
 
     /* Construct an adjacency list representation */
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adj_list, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adj_list, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adj_list);
     IGRAPH_CHECK(igraph_adjlist_simplify(&adj_list));
     igraph_adjlist_sort(&adj_list);
@@ -1349,7 +1349,7 @@ int igraph_i_maximal_or_largest_cliques_or_indsets(const igraph_t *graph,
     if (complementer) {
         IGRAPH_CHECK(igraph_adjlist_init_complementer(graph, &clqdata.adj_list, IGRAPH_ALL, 0));
     } else {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &clqdata.adj_list, IGRAPH_ALL));
+        IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &clqdata.adj_list, IGRAPH_ALL));
     }
     IGRAPH_FINALLY(igraph_adjlist_destroy, &clqdata.adj_list);
 
@@ -27,9 +27,17 @@
 #include "igraph_adjlist.h"
 #include "igraph_interrupt_internal.h"
 #include "igraph_interface.h"
+#include "igraph_threads_internal.h"
 #include "config.h"
 #include <math.h>
 
+/* Memory budget of the neighbor lists cached by the pairwise similarity
+   functions, in bytes */
+#define IGRAPH_I_SIMILARITY_CACHE_BUDGET ((size_t) 64 * 1024 * 1024)
+
+/* Number of vertex pairs that a thread processes at once */
+#define IGRAPH_I_SIMILARITY_PAIRS_GRAIN 1024
+
 int igraph_cocitation_real(const igraph_t *graph, igraph_matrix_t *res,
                            igraph_vs_t vids, igraph_neimode_t mode,
                            igraph_vector_t *weights);
@@ -279,6 +287,41 @@ int igraph_i_neisets_intersect(const igraph_vector_t *v1,
     return 0;
 }
 
+static int igraph_i_neisets_intersect_int(const igraph_vector_int_t *v1,
+        const igraph_vector_int_t *v2, long int *len_union,
+        long int *len_intersection) {
+    /* ASSERT: v1 and v2 are sorted */
+    long int i, j, i0, jj0;
+    i0 = igraph_vector_int_size(v1); jj0 = igraph_vector_int_size(v2);
+    *len_union = i0 + jj0; *len_intersection = 0;
+    i = 0; j = 0;
+    while (i < i0 && j < jj0) {
+        if (VECTOR(*v1)[i] == VECTOR(*v2)[j]) {
+            (*len_intersection)++; (*len_union)--;
+            i++; j++;
+        } else if (VECTOR(*v1)[i] < VECTOR(*v2)[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return 0;
+}
+
+/* Neighbor set of a vertex for the Jaccard similarity, optionally
+   including the vertex itself */
+
+static int igraph_i_similarity_neiset(igraph_lazy_adjcache_t *cache,
+                                      long int vid, igraph_bool_t loops,
+                                      igraph_vector_int_t *neis) {
+    long int pos;
+    IGRAPH_CHECK(igraph_lazy_adjcache_get(cache, (igraph_integer_t) vid, neis));
+    if (loops && !igraph_vector_int_binsearch(neis, (int) vid, &pos)) {
+        IGRAPH_CHECK(igraph_vector_int_insert(neis, pos, (int) vid));
+    }
+    return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_similarity_jaccard
@@ -384,6 +427,54 @@ int igraph_similarity_jaccard(const igraph_t *graph, igraph_matrix_t *res,
     return 0;
 }
 
+typedef struct igraph_i_jaccard_pairs_data_t {
+    igraph_lazy_adjcache_t *cache;
+    const igraph_vector_t *pairs;
+    igraph_vector_t *res;
+    igraph_bool_t loops;
+} igraph_i_jaccard_pairs_data_t;
+
+/* Similarities of the pairs from <= j < to, this may run on several
+   threads at the same time, for different ranges */
+
+static int igraph_i_similarity_jaccard_pairs_range(void *arg, long int from,
+        long int to) {
+    igraph_i_jaccard_pairs_data_t *data = (igraph_i_jaccard_pairs_data_t *) arg;
+    const igraph_vector_t *pairs = data->pairs;
+    igraph_vector_t *res = data->res;
+    long int j, u, v;
+    long int len_union, len_intersection;
+    igraph_vector_int_t v1, v2;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&v1, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&v2, 0);
+
+    for (j = from; j < to; j++) {
+        u = (long int) VECTOR(*pairs)[2 * j];
+        v = (long int) VECTOR(*pairs)[2 * j + 1];
+
+        if (u == v) {
+            VECTOR(*res)[j] = 1.0;
+            continue;
+        }
+
+        IGRAPH_CHECK(igraph_i_similarity_neiset(data->cache, u, data->loops, &v1));
+        IGRAPH_CHECK(igraph_i_similarity_neiset(data->cache, v, data->loops, &v2));
+        igraph_i_neisets_intersect_int(&v1, &v2, &len_union, &len_intersection);
+        if (len_union > 0) {
+            VECTOR(*res)[j] = ((igraph_real_t)len_intersection) / len_union;
+        } else {
+            VECTOR(*res)[j] = 0.0;
+        }
+    }
+
+    igraph_vector_int_destroy(&v2);
+    igraph_vector_int_destroy(&v1);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_similarity_jaccard_pairs
@@ -393,7 +484,9 @@ int igraph_similarity_jaccard(const igraph_t *graph, igraph_matrix_t *res,
  * The Jaccard similarity coefficient of two vertices is the number of common
  * neighbors divided by the number of vertices that are neighbors of at
  * least one of the two vertices being considered. This function calculates
- * the pairwise Jaccard similarities for a list of vertex pairs.
+ * the pairwise Jaccard similarities for a list of vertex pairs. Long
+ * lists are processed by several threads, see \ref
+ * igraph_set_num_threads().
  *
  * \param graph The graph object to analyze
  * \param res Pointer to a vector, the result of the calculation will
@@ -438,11 +531,9 @@ int igraph_similarity_jaccard(const igraph_t *graph, igraph_matrix_t *res,
  */
 int igraph_similarity_jaccard_pairs(const igraph_t *graph, igraph_vector_t *res,
                                     const igraph_vector_t *pairs, igraph_neimode_t mode, igraph_bool_t loops) {
-    igraph_lazy_adjlist_t al;
-    long int i, j, k, u, v;
-    long int len_union, len_intersection;
-    igraph_vector_t *v1, *v2;
-    igraph_bool_t *seen;
+    igraph_lazy_adjcache_t cache;
+    igraph_i_jaccard_pairs_data_t data;
+    long int k;
 
     k = igraph_vector_size(pairs);
     if (k % 2 != 0) {
@@ -450,54 +541,22 @@ int igraph_similarity_jaccard_pairs(const igraph_t *graph, igraph_vector_t *res,
     }
     IGRAPH_CHECK(igraph_vector_resize(res, k / 2));
 
-    IGRAPH_CHECK(igraph_lazy_adjlist_init(graph, &al, mode, IGRAPH_SIMPLIFY));
-    IGRAPH_FINALLY(igraph_lazy_adjlist_destroy, &al);
-
-    if (loops) {
-        /* Add the loop edges */
-        i = igraph_vcount(graph);
-        seen = igraph_Calloc(i, igraph_bool_t);
-        if (seen == 0) {
-            IGRAPH_ERROR("cannot calculate Jaccard similarity", IGRAPH_ENOMEM);
-        }
-        IGRAPH_FINALLY(free, seen);
-
-        for (i = 0; i < k; i++) {
-            j = (long int) VECTOR(*pairs)[i];
-            if (seen[j]) {
-                continue;
-            }
-            seen[j] = 1;
-            v1 = igraph_lazy_adjlist_get(&al, (igraph_integer_t) j);
-            if (!igraph_vector_binsearch(v1, j, &u)) {
-                igraph_vector_insert(v1, u, j);
-            }
-        }
-
-        free(seen);
-        IGRAPH_FINALLY_CLEAN(1);
-    }
-
-    for (i = 0, j = 0; i < k; i += 2, j++) {
-        u = (long int) VECTOR(*pairs)[i];
-        v = (long int) VECTOR(*pairs)[i + 1];
-
-        if (u == v) {
-            VECTOR(*res)[j] = 1.0;
-            continue;
-        }
-
-        v1 = igraph_lazy_adjlist_get(&al, (igraph_integer_t) u);
-        v2 = igraph_lazy_adjlist_get(&al, (igraph_integer_t) v);
-        igraph_i_neisets_intersect(v1, v2, &len_union, &len_intersection);
-        if (len_union > 0) {
-            VECTOR(*res)[j] = ((igraph_real_t)len_intersection) / len_union;
-        } else {
-            VECTOR(*res)[j] = 0.0;
-        }
-    }
-
-    igraph_lazy_adjlist_destroy(&al);
+    /* The pairs may visit the vertices in any order, keep only a
+       bounded number of neighbor lists around. The cache is shared by
+       the threads. */
+    IGRAPH_CHECK(igraph_lazy_adjcache_init(graph, &cache, mode, IGRAPH_SIMPLIFY,
+                                           IGRAPH_I_SIMILARITY_CACHE_BUDGET));
+    IGRAPH_FINALLY(igraph_lazy_adjcache_destroy, &cache);
+
+    data.cache = &cache;
+    data.pairs = pairs;
+    data.res = res;
+    data.loops = loops;
+    IGRAPH_CHECK(igraph_i_parallel_for(k / 2, IGRAPH_I_SIMILARITY_PAIRS_GRAIN,
+                                       igraph_i_similarity_jaccard_pairs_range,
+                                       &data));
+
+    igraph_lazy_adjcache_destroy(&cache);
     IGRAPH_FINALLY_CLEAN(1);
 
     return 0;
@@ -24,7 +24,7 @@ int igraph_i_vertex_coloring_greedy_cn(const igraph_t *graph, igraph_vector_int_
         return IGRAPH_SUCCESS;
     }
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
 
     /* find maximum degree and a corresponding vertex */
@@ -41,6 +41,7 @@
 #include "igraph_conversion.h"
 #include "igraph_centrality.h"
 #include "igraph_structural.h"
+#include "igraph_trace_internal.h"
 #include "config.h"
 
 #include <string.h>
@@ -2249,7 +2250,7 @@ int igraph_community_fluid_communities(const igraph_t *graph,
     }
 
     /* Create an adjacency list representation for efficiency. */
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &al, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &al, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &al);
 
     /* Create storage space for counting distinct labels and dominant ones */
@@ -2503,10 +2504,10 @@ int igraph_community_label_propagation(const igraph_t *graph,
      * For the unweighted case, the adjacency list is enough. For the
      * weighted case, we need the incidence list */
     if (weights) {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &il, IGRAPH_IN));
+        IGRAPH_CHECK(igraph_inclist_init_flat(graph, &il, IGRAPH_IN));
         IGRAPH_FINALLY(igraph_inclist_destroy, &il);
     } else {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &al, IGRAPH_IN));
+        IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &al, IGRAPH_IN));
         IGRAPH_FINALLY(igraph_adjlist_destroy, &al);
     }
 
@@ -3102,6 +3103,7 @@ int igraph_i_community_multilevel_step(igraph_t *graph,
                 changed++;
             }
         }
+        IGRAPH_I_TRACE_ADD(community_moves, changed);
 
         q = igraph_i_multilevel_community_modularity(&communities);
 
@@ -3276,6 +3278,7 @@ int igraph_community_multilevel(const igraph_t *graph,
 
         /* Increase the level counter */
         level++;
+        IGRAPH_I_TRACE_ADD(community_levels, 1);
     }
 
     /* It might happen that there are no merges, so every vertex is in its
@@ -3312,6 +3315,8 @@ int igraph_community_multilevel(const igraph_t *graph,
     igraph_vector_destroy(&level_membership);
     IGRAPH_FINALLY_CLEAN(4);
 
+    IGRAPH_I_TRACE_REPORT("igraph_community_multilevel");
+
     return 0;
 }
 
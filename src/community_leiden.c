@@ -31,6 +31,7 @@
 #include "igraph_random.h"
 #include "igraph_stack.h"
 #include "igraph_constructors.h"
+#include "igraph_trace_internal.h"
 
 /* Move nodes in order to improve the quality of a partition.
  *
@@ -171,6 +172,7 @@ int igraph_i_community_leiden_fastmovenodes(const igraph_t *graph,
         /* Add stable neighbours that are not part of the new cluster to the queue */
         if (best_cluster != current_cluster) {
             VECTOR(*membership)[v] = best_cluster;
+            IGRAPH_I_TRACE_ADD(community_moves, 1);
 
             for (i = 0; i < degree; i++) {
                 long int e = VECTOR(*edges)[i];
@@ -751,7 +753,7 @@ int igraph_i_community_leiden(const igraph_t *graph,
     do {
 
         /* Get incidence list for fast iteration */
-        IGRAPH_CHECK(igraph_inclist_init(aggregated_graph, &edges_per_node, IGRAPH_ALL));
+        IGRAPH_CHECK(igraph_inclist_init_flat(aggregated_graph, &edges_per_node, IGRAPH_ALL));
         IGRAPH_FINALLY(igraph_inclist_destroy, &edges_per_node);
 
         /* Move around the nodes in order to increase the quality */
@@ -876,6 +878,7 @@ int igraph_i_community_leiden(const igraph_t *graph,
             igraph_vector_update(aggregated_membership, &tmp_membership);
 
             level += 1;
+            IGRAPH_I_TRACE_ADD(community_levels, 1);
         }
 
         /* We are done iterating, so we destroy the incidence list */
@@ -1075,5 +1078,9 @@ int igraph_community_leiden(const igraph_t *graph,
         IGRAPH_FINALLY_CLEAN(2);
     }
 
+    if (ret == 0) {
+        IGRAPH_I_TRACE_REPORT("igraph_community_leiden");
+    }
+
     return ret;
 }
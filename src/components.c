@@ -200,7 +200,7 @@ static int igraph_i_clusters_strong(const igraph_t *graph, igraph_vector_t *memb
         igraph_vector_clear(csize);
     }
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_OUT));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, IGRAPH_OUT));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
 
     num_seen = 0;
@@ -248,7 +248,7 @@ static int igraph_i_clusters_strong(const igraph_t *graph, igraph_vector_t *memb
     igraph_adjlist_destroy(&adjlist);
     IGRAPH_FINALLY_CLEAN(1);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_IN));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, IGRAPH_IN));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
 
     /* OK, we've the 'out' values for the nodes, let's use them in
@@ -660,7 +660,7 @@ static int igraph_i_decompose_strong(const igraph_t *graph,
 
     igraph_vector_null(&out);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_OUT));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, IGRAPH_OUT));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
 
     /* number of components seen */
@@ -726,7 +726,7 @@ static int igraph_i_decompose_strong(const igraph_t *graph,
     igraph_adjlist_destroy(&adjlist);
     IGRAPH_FINALLY_CLEAN(1);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_IN));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, IGRAPH_IN));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
 
     /* OK, we've the 'out' values for the nodes, let's use them in
@@ -950,7 +950,7 @@ int igraph_biconnected_components(const igraph_t *graph,
     IGRAPH_VECTOR_INIT_FINALLY(&edgestack, 0);
     IGRAPH_CHECK(igraph_vector_reserve(&edgestack, 100));
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &inclist, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
 
     IGRAPH_CHECK(igraph_vector_long_init(&vertex_added, no_of_nodes));
@@ -0,0 +1,592 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_adjlist.h"
+#include "igraph_memory.h"
+#include "igraph_interface.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+#include <math.h>
+
+/**
+ * \section about_compressed_adjlists
+ * <para>A compressed adjacency list stores the sorted neighbor list of
+ * every vertex as a sequence of gaps between consecutive neighbors,
+ * and every gap is written in a variable length code, using seven bits
+ * per byte. As neighboring vertices tend to have close ids, especially
+ * after \ref igraph_reorder_for_locality(), most gaps fit into a
+ * single byte, and the whole structure needs a byte or two per
+ * neighbor, instead of the four integers per edge of
+ * <type>igraph_t</type>. It is read-only: it is created from a graph,
+ * after which the graph can be destroyed.</para>
+ *
+ * <para>The neighbors of a vertex are decoded sequentially, which is
+ * fast enough to run traversals directly on the compressed lists, see
+ * \ref igraph_compressed_adjlist_bfs(), \ref
+ * igraph_compressed_adjlist_clusters() and \ref
+ * igraph_compressed_adjlist_pagerank().</para>
+ */
+
+/* The list of vertex 'v' starts with its degree, then comes the
+   difference of the first neighbor and 'v' in zig-zag encoding (the
+   sign goes to the lowest bit), then the non-negative differences of
+   the consecutive neighbors. All numbers are unsigned variable length
+   integers, seven bits per byte, least significant group first, the
+   highest bit of a byte is set if more bytes follow. */
+
+#define IGRAPH_I_VARINT_READ(p, x) do {                       \
+        unsigned int igraph_i_shift = 0;                      \
+        unsigned char igraph_i_byte;                          \
+        (x) = 0;                                              \
+        do {                                                  \
+            igraph_i_byte = *(p)++;                           \
+            (x) |= (unsigned int) (igraph_i_byte & 0x7f) << igraph_i_shift; \
+            igraph_i_shift += 7;                              \
+        } while (igraph_i_byte & 0x80);                       \
+    } while (0)
+
+static size_t igraph_i_varint_size(unsigned int x) {
+    size_t size = 1;
+    while (x >= 0x80) {
+        x >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static unsigned char *igraph_i_varint_write(unsigned char *p, unsigned int x) {
+    while (x >= 0x80) {
+        *p++ = (unsigned char) ((x & 0x7f) | 0x80);
+        x >>= 7;
+    }
+    *p++ = (unsigned char) x;
+    return p;
+}
+
+static unsigned int igraph_i_zigzag(long int diff) {
+    return diff >= 0 ? ((unsigned int) diff) << 1 :
+           (((unsigned int) (-(diff + 1))) << 1) | 1;
+}
+
+/* Decodes the neighbors of 'vid' into 'res', which must have room for
+   the degree of 'vid', and returns the degree. */
+
+static long int igraph_i_compressed_adjlist_decode(
+    const igraph_compressed_adjlist_t *al, long int vid, int *res) {
+
+    const unsigned char *p = al->data + al->offsets[vid];
+    unsigned int deg, gap, i;
+    long int prev;
+
+    IGRAPH_I_VARINT_READ(p, deg);
+    if (deg == 0) {
+        return 0;
+    }
+    IGRAPH_I_VARINT_READ(p, gap);
+    prev = (gap & 1) ? vid - (long int) (gap >> 1) - 1 : vid + (long int) (gap >> 1);
+    res[0] = (int) prev;
+    for (i = 1; i < deg; i++) {
+        IGRAPH_I_VARINT_READ(p, gap);
+        prev += gap;
+        res[i] = (int) prev;
+    }
+
+    return deg;
+}
+
+/**
+ * \function igraph_compressed_adjlist_init
+ * Create a compressed adjacency list from a graph
+ *
+ * The neighbors of each vertex are stored sorted, gap encoded and
+ * compressed, see the introduction of this section. Multiple edges
+ * are stored as repeated neighbors, loop edges appear twice if \p
+ * mode is \c IGRAPH_ALL or the graph is undirected, as in \ref
+ * igraph_neighbors(). The adjacency list is independent of the graph
+ * after creation.
+ * \param graph The input graph.
+ * \param al Pointer to an uninitialized
+ *   <type>igraph_compressed_adjlist_t</type> object.
+ * \param mode Constant specifying whether outgoing
+ *   (<code>IGRAPH_OUT</code>), incoming (<code>IGRAPH_IN</code>),
+ *   or both (<code>IGRAPH_ALL</code>) types of neighbors to include
+ *   in the adjacency list. It is ignored for undirected networks.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+
+int igraph_compressed_adjlist_init(const igraph_t *graph,
+                                   igraph_compressed_adjlist_t *al,
+                                   igraph_neimode_t mode) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int i;
+    igraph_csr_view_t view;
+    unsigned char *p;
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create compressed adjlist", IGRAPH_EINVMODE);
+    }
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+
+    al->length = (igraph_integer_t) no_of_nodes;
+    al->mode = mode;
+    al->maxdegree = 0;
+    al->data = 0;
+    al->offsets = igraph_Calloc(no_of_nodes + 1, size_t);
+    if (al->offsets == 0) {
+        IGRAPH_ERROR("Cannot create compressed adjlist", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_compressed_adjlist_destroy, al);
+
+    /* First pass: the size of the lists */
+    for (i = 0; i < no_of_nodes; i++) {
+        long int deg, prev = i;
+        size_t size;
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) i, mode));
+        deg = IGRAPH_CSR_VIEW_SIZE(view);
+        if (deg > al->maxdegree) {
+            al->maxdegree = (igraph_integer_t) deg;
+        }
+        size = igraph_i_varint_size((unsigned int) deg);
+        if (deg > 0) {
+            prev = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+            size += igraph_i_varint_size(igraph_i_zigzag(prev - i));
+            IGRAPH_CSR_VIEW_NEXT(view);
+        }
+        while (!IGRAPH_CSR_VIEW_END(view)) {
+            long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+            size += igraph_i_varint_size((unsigned int) (nei - prev));
+            prev = nei;
+            IGRAPH_CSR_VIEW_NEXT(view);
+        }
+        al->offsets[i + 1] = al->offsets[i] + size;
+    }
+
+    al->data = igraph_Calloc(al->offsets[no_of_nodes] > 0 ?
+                             al->offsets[no_of_nodes] : 1, unsigned char);
+    if (al->data == 0) {
+        IGRAPH_ERROR("Cannot create compressed adjlist", IGRAPH_ENOMEM);
+    }
+
+    /* Second pass: encode them */
+    p = al->data;
+    for (i = 0; i < no_of_nodes; i++) {
+        long int deg, prev;
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) i, mode));
+        deg = IGRAPH_CSR_VIEW_SIZE(view);
+        p = igraph_i_varint_write(p, (unsigned int) deg);
+        if (deg > 0) {
+            prev = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+            p = igraph_i_varint_write(p, igraph_i_zigzag(prev - i));
+            IGRAPH_CSR_VIEW_NEXT(view);
+            while (!IGRAPH_CSR_VIEW_END(view)) {
+                long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+                p = igraph_i_varint_write(p, (unsigned int) (nei - prev));
+                prev = nei;
+                IGRAPH_CSR_VIEW_NEXT(view);
+            }
+        }
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_adjlist_destroy
+ * Deallocate a compressed adjacency list
+ *
+ * Free all memory allocated for a compressed adjacency list.
+ * \param al The adjacency list to destroy.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_compressed_adjlist_destroy(igraph_compressed_adjlist_t *al) {
+    if (al->offsets != 0) {
+        igraph_Free(al->offsets);
+    }
+    if (al->data != 0) {
+        igraph_Free(al->data);
+    }
+}
+
+/**
+ * \function igraph_compressed_adjlist_size
+ * The number of vertices in a compressed adjacency list
+ *
+ * \param al The compressed adjacency list.
+ * \return The number of vertices.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_compressed_adjlist_size(const igraph_compressed_adjlist_t *al) {
+    return al->length;
+}
+
+/**
+ * \function igraph_compressed_adjlist_bytes
+ * The memory used by a compressed adjacency list
+ *
+ * \param al The compressed adjacency list.
+ * \return The number of bytes used by the offsets and the
+ *   compressed neighbor lists.
+ *
+ * Time complexity: O(1).
+ */
+
+size_t igraph_compressed_adjlist_bytes(const igraph_compressed_adjlist_t *al) {
+    return sizeof(size_t) * ((size_t) al->length + 1) +
+           al->offsets[al->length];
+}
+
+/**
+ * \function igraph_compressed_adjlist_degree
+ * The number of neighbors of a vertex
+ *
+ * \param al The compressed adjacency list.
+ * \param no The vertex id, it must be valid, it is not checked.
+ * \return The number of neighbors of \p no, the size of the vector
+ *   that \ref igraph_compressed_adjlist_get() returns.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_compressed_adjlist_degree(const igraph_compressed_adjlist_t *al,
+        igraph_integer_t no) {
+    const unsigned char *p = al->data + al->offsets[(long int) no];
+    unsigned int deg;
+    IGRAPH_I_VARINT_READ(p, deg);
+    return (igraph_integer_t) deg;
+}
+
+/**
+ * \function igraph_compressed_adjlist_get
+ * Decode the neighbors of a vertex
+ *
+ * \param al The compressed adjacency list.
+ * \param no The vertex id.
+ * \param neis An initialized vector, it is resized and the sorted
+ *   neighbors of \p no are stored in it.
+ * \return Error code:
+ *   \c IGRAPH_EINVVID if \p no is not a valid vertex id.
+ *
+ * Time complexity: O(d), the number of neighbors.
+ */
+
+int igraph_compressed_adjlist_get(const igraph_compressed_adjlist_t *al,
+                                  igraph_integer_t no,
+                                  igraph_vector_int_t *neis) {
+    if (no < 0 || no >= al->length) {
+        IGRAPH_ERROR("Cannot decode neighbors", IGRAPH_EINVVID);
+    }
+    IGRAPH_CHECK(igraph_vector_int_resize(neis,
+                                          igraph_compressed_adjlist_degree(al, no)));
+    igraph_i_compressed_adjlist_decode(al, no, VECTOR(*neis));
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_adjlist_bfs
+ * Breadth-first search on a compressed adjacency list
+ *
+ * Visits the vertices that are reachable from \p root, following the
+ * neighbor lists stored in \p al, so the mode of the adjacency list
+ * determines the direction of the search. The neighbors of a vertex
+ * are visited in increasing vertex id order, so the results are the
+ * same as those of \ref igraph_bfs() on the original graph with the
+ * same mode.
+ * \param al The compressed adjacency list.
+ * \param root The id of the root vertex.
+ * \param order If not a null pointer, then the vertex ids of the
+ *   graph are stored here, in the same order as they were visited.
+ *   The vector is resized to the number of vertices, the end of it
+ *   is filled with \c IGRAPH_NAN if not all vertices were reached.
+ * \param dist If not a null pointer, then the distance of every
+ *   vertex from the root is stored here, \c IGRAPH_NAN for the
+ *   vertices that were not reached.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * the total size of the neighbor lists.
+ */
+
+int igraph_compressed_adjlist_bfs(const igraph_compressed_adjlist_t *al,
+                                  igraph_integer_t root,
+                                  igraph_vector_t *order,
+                                  igraph_vector_t *dist) {
+    long int no_of_nodes = al->length;
+    igraph_vector_int_t queue, distance, neis;
+    long int head = 0, tail = 0, i;
+
+    if (root < 0 || root >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid root vertex in BFS", IGRAPH_EINVVID);
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &queue);
+    IGRAPH_CHECK(igraph_vector_int_init(&distance, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &distance);
+    IGRAPH_CHECK(igraph_vector_int_init(&neis, al->maxdegree));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &neis);
+    igraph_vector_int_fill(&distance, -1);
+
+    VECTOR(queue)[tail++] = root;
+    VECTOR(distance)[(long int) root] = 0;
+    while (head < tail) {
+        long int actvect = VECTOR(queue)[head++];
+        int actdist = VECTOR(distance)[actvect];
+        long int n = igraph_i_compressed_adjlist_decode(al, actvect, VECTOR(neis));
+        IGRAPH_ALLOW_INTERRUPTION();
+        for (i = 0; i < n; i++) {
+            int nei = VECTOR(neis)[i];
+            if (VECTOR(distance)[nei] < 0) {
+                VECTOR(distance)[nei] = actdist + 1;
+                VECTOR(queue)[tail++] = nei;
+            }
+        }
+    }
+
+    if (order) {
+        IGRAPH_CHECK(igraph_vector_resize(order, no_of_nodes));
+        for (i = 0; i < tail; i++) {
+            VECTOR(*order)[i] = VECTOR(queue)[i];
+        }
+        for (; i < no_of_nodes; i++) {
+            VECTOR(*order)[i] = IGRAPH_NAN;
+        }
+    }
+    if (dist) {
+        IGRAPH_CHECK(igraph_vector_resize(dist, no_of_nodes));
+        for (i = 0; i < no_of_nodes; i++) {
+            VECTOR(*dist)[i] = VECTOR(distance)[i] < 0 ? IGRAPH_NAN :
+                               VECTOR(distance)[i];
+        }
+    }
+
+    igraph_vector_int_destroy(&neis);
+    igraph_vector_int_destroy(&distance);
+    igraph_vector_int_destroy(&queue);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_adjlist_clusters
+ * Weakly connected components of a compressed adjacency list
+ *
+ * The adjacency list must contain both the in- and out-neighbors,
+ * i.e. it must be created with \c IGRAPH_ALL, or from an undirected
+ * graph. The components are numbered in the same way as in \ref
+ * igraph_clusters().
+ * \param al The compressed adjacency list.
+ * \param membership If not a null pointer, then the component id of
+ *   every vertex is stored here.
+ * \param csize If not a null pointer, then the sizes of the
+ *   components are stored here.
+ * \param no If not a null pointer, then the number of components is
+ *   stored here.
+ * \return Error code:
+ *   \c IGRAPH_EINVMODE if \p al does not contain both directions.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * the total size of the neighbor lists.
+ */
+
+int igraph_compressed_adjlist_clusters(const igraph_compressed_adjlist_t *al,
+                                       igraph_vector_t *membership,
+                                       igraph_vector_t *csize,
+                                       igraph_integer_t *no) {
+    long int no_of_nodes = al->length;
+    igraph_vector_int_t queue, neis;
+    char *already_added;
+    long int first_node, no_of_clusters = 0, i;
+
+    if (al->mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Weakly connected components need an undirected "
+                     "compressed adjlist", IGRAPH_EINVMODE);
+    }
+
+    already_added = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, char);
+    if (already_added == 0) {
+        IGRAPH_ERROR("Cannot calculate clusters", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, already_added);
+    IGRAPH_CHECK(igraph_vector_int_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &queue);
+    IGRAPH_CHECK(igraph_vector_int_init(&neis, al->maxdegree));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &neis);
+
+    if (membership) {
+        IGRAPH_CHECK(igraph_vector_resize(membership, no_of_nodes));
+    }
+    if (csize) {
+        igraph_vector_clear(csize);
+    }
+
+    for (first_node = 0; first_node < no_of_nodes; first_node++) {
+        long int head = 0, tail = 0;
+        if (already_added[first_node]) {
+            continue;
+        }
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        already_added[first_node] = 1;
+        VECTOR(queue)[tail++] = (int) first_node;
+        while (head < tail) {
+            long int actvect = VECTOR(queue)[head++];
+            long int n = igraph_i_compressed_adjlist_decode(al, actvect, VECTOR(neis));
+            if (membership) {
+                VECTOR(*membership)[actvect] = no_of_clusters;
+            }
+            for (i = 0; i < n; i++) {
+                int nei = VECTOR(neis)[i];
+                if (!already_added[nei]) {
+                    already_added[nei] = 1;
+                    VECTOR(queue)[tail++] = nei;
+                }
+            }
+        }
+        no_of_clusters++;
+        if (csize) {
+            IGRAPH_CHECK(igraph_vector_push_back(csize, tail));
+        }
+    }
+
+    if (no) {
+        *no = (igraph_integer_t) no_of_clusters;
+    }
+
+    igraph_vector_int_destroy(&neis);
+    igraph_vector_int_destroy(&queue);
+    igraph_Free(already_added);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/**
+ * \function igraph_compressed_adjlist_pagerank
+ * PageRank on a compressed adjacency list
+ *
+ * Calculates the PageRank scores with power iteration, pulling the
+ * scores along the stored neighbor lists, so the adjacency list of a
+ * directed graph must be created with \c IGRAPH_IN. With \c
+ * IGRAPH_ALL, or for undirected graphs, the undirected PageRank is
+ * calculated. Vertices without out-neighbors distribute their score
+ * uniformly, as in \ref igraph_pagerank(). The iteration stops when
+ * the total change of the scores in an iteration is below
+ * 1e-10, or after 1000 iterations, with a warning.
+ * \param al The compressed adjacency list.
+ * \param vector Pointer to an initialized vector, the scores are
+ *   stored here, they sum up to one.
+ * \param damping The damping factor ("d" in the original paper),
+ *   it must be in the interval [0, 1].
+ * \return Error code:
+ *   \c IGRAPH_EINVMODE if \p al contains out-neighbors only,
+ *   \c IGRAPH_EINVAL if \p damping is invalid.
+ *
+ * Time complexity: O(k(|V|+|E|)) for k iterations.
+ */
+
+int igraph_compressed_adjlist_pagerank(const igraph_compressed_adjlist_t *al,
+                                       igraph_vector_t *vector,
+                                       igraph_real_t damping) {
+    long int no_of_nodes = al->length;
+    igraph_vector_int_t outdeg, neis;
+    igraph_vector_t contrib;
+    long int i, j, iter;
+    igraph_real_t change = 1.0;
+
+    if (al->mode == IGRAPH_OUT) {
+        IGRAPH_ERROR("PageRank needs in-neighbors in the compressed adjlist",
+                     IGRAPH_EINVMODE);
+    }
+    if (damping < 0 || damping > 1) {
+        IGRAPH_ERROR("The PageRank damping factor must be in the range [0,1]",
+                     IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_vector_resize(vector, no_of_nodes));
+    if (no_of_nodes == 0) {
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_init(&outdeg, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &outdeg);
+    IGRAPH_CHECK(igraph_vector_int_init(&neis, al->maxdegree));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &neis);
+    IGRAPH_VECTOR_INIT_FINALLY(&contrib, no_of_nodes);
+
+    /* A vertex appears in the in-lists as many times as its out-degree */
+    for (i = 0; i < no_of_nodes; i++) {
+        long int n = igraph_i_compressed_adjlist_decode(al, i, VECTOR(neis));
+        for (j = 0; j < n; j++) {
+            VECTOR(outdeg)[(long int) VECTOR(neis)[j]] += 1;
+        }
+    }
+
+    igraph_vector_fill(vector, 1.0 / no_of_nodes);
+    for (iter = 0; iter < 1000 && change >= 1e-10; iter++) {
+        igraph_real_t dangling = 0.0, teleport;
+        IGRAPH_ALLOW_INTERRUPTION();
+        for (i = 0; i < no_of_nodes; i++) {
+            if (VECTOR(outdeg)[i] == 0) {
+                dangling += VECTOR(*vector)[i];
+                VECTOR(contrib)[i] = 0.0;
+            } else {
+                VECTOR(contrib)[i] = VECTOR(*vector)[i] / VECTOR(outdeg)[i];
+            }
+        }
+        teleport = (1 - damping + damping * dangling) / no_of_nodes;
+        change = 0.0;
+        for (i = 0; i < no_of_nodes; i++) {
+            long int n = igraph_i_compressed_adjlist_decode(al, i, VECTOR(neis));
+            igraph_real_t sum = 0.0, newval;
+            for (j = 0; j < n; j++) {
+                sum += VECTOR(contrib)[(long int) VECTOR(neis)[j]];
+            }
+            newval = teleport + damping * sum;
+            change += fabs(newval - VECTOR(*vector)[i]);
+            VECTOR(*vector)[i] = newval;
+        }
+    }
+    if (change >= 1e-10) {
+        IGRAPH_WARNING("PageRank power iteration did not converge");
+    }
+
+    igraph_vector_destroy(&contrib);
+    igraph_vector_int_destroy(&neis);
+    igraph_vector_int_destroy(&outdeg);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
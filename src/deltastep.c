@@ -0,0 +1,320 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_deltastep_internal.h"
+#include "igraph_threads_internal.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_trace_internal.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_error.h"
+#include "config.h"
+
+#include <string.h>
+
+/* Delta-stepping, after U. Meyer and P. Sanders: Delta-stepping: a
+   parallelizable shortest path algorithm, J. Algorithms 49 (2003).
+
+   The tentative distances are kept in buckets of width 'delta'. The
+   vertices of the lowest non-empty bucket are processed together:
+   first their light edges (weight at most delta) are relaxed, which
+   may put more vertices into the same bucket, until it stays empty;
+   then the heavy edges of all vertices removed from the bucket. Only
+   the pending distances are in buckets, they are less than delta plus
+   the largest weight above the current bucket, so a small cyclic
+   array of buckets is enough. A vertex may be in several buckets, the
+   entries that do not match its distance any more are skipped.
+
+   Every phase scans the edges of a set of vertices on the thread
+   pool. The scans only read the distances, and write the shorter
+   distances they find into a request array, at a fixed place for
+   every edge. The requests are applied by the calling thread, in
+   the order of the array, so the distances and the shortest path
+   tree do not depend on the number of threads. */
+
+/* Vertices per range of the parallel scans */
+#define IGRAPH_I_DELTASTEP_GRAIN 256
+
+typedef struct {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_neimode_t mode;
+    igraph_real_t delta;
+    igraph_bool_t light;
+    const igraph_real_t *dist;
+    const long int *vertices;  /* the vertices to scan */
+    const long int *offsets;   /* the first request of each vertex */
+    long int *req_vertex;      /* -1 if no shorter distance was found */
+    long int *req_edge;
+    igraph_real_t *req_dist;
+} igraph_i_deltastep_scan_t;
+
+typedef struct {
+    igraph_vector_long_t *buckets;
+    long int no_of_buckets;
+    igraph_vector_long_t vertices, offsets, removed;
+    igraph_vector_long_t req_vertex, req_edge;
+    igraph_vector_t req_dist;
+    long int pending;          /* the number of entries in the buckets */
+    char *mark;
+} igraph_i_deltastep_work_t;
+
+/* 'work' is zeroed before anything is allocated, so this can be
+   called after a partial initialization: members without storage
+   are skipped. */
+
+static void igraph_i_deltastep_work_destroy(igraph_i_deltastep_work_t *work) {
+    long int i;
+    if (work->buckets) {
+        for (i = 0; i < work->no_of_buckets; i++) {
+            if (work->buckets[i].stor_begin) {
+                igraph_vector_long_destroy(&work->buckets[i]);
+            }
+        }
+        igraph_Free(work->buckets);
+    }
+    if (work->vertices.stor_begin) {
+        igraph_vector_long_destroy(&work->vertices);
+    }
+    if (work->offsets.stor_begin) {
+        igraph_vector_long_destroy(&work->offsets);
+    }
+    if (work->removed.stor_begin) {
+        igraph_vector_long_destroy(&work->removed);
+    }
+    if (work->req_vertex.stor_begin) {
+        igraph_vector_long_destroy(&work->req_vertex);
+    }
+    if (work->req_edge.stor_begin) {
+        igraph_vector_long_destroy(&work->req_edge);
+    }
+    if (work->req_dist.stor_begin) {
+        igraph_vector_destroy(&work->req_dist);
+    }
+    if (work->mark) {
+        igraph_Free(work->mark);
+    }
+}
+
+static int igraph_i_deltastep_scan(void *arg, long int from, long int to) {
+    igraph_i_deltastep_scan_t *scan = arg;
+    igraph_csr_view_t view;
+    long int i;
+
+    for (i = from; i < to; i++) {
+        long int actvect = scan->vertices[i];
+        long int req = scan->offsets[i];
+        igraph_real_t actdist = scan->dist[actvect];
+        IGRAPH_CHECK(igraph_csr_view(scan->graph, &view,
+                                     (igraph_integer_t) actvect, scan->mode));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view), req++) {
+            long int edge = IGRAPH_CSR_VIEW_EDGE(view);
+            long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+            igraph_real_t weight = VECTOR(*scan->weights)[edge];
+            igraph_real_t altdist = actdist + weight;
+            scan->req_vertex[req] = -1;
+            if ((weight <= scan->delta) == scan->light &&
+                altdist < scan->dist[nei]) {
+                scan->req_vertex[req] = nei;
+                scan->req_edge[req] = edge;
+                scan->req_dist[req] = altdist;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Scans the edges of the vertices in work->vertices, and applies the
+   shorter distances found */
+
+static int igraph_i_deltastep_relax(igraph_i_deltastep_scan_t *scan,
+                                    igraph_i_deltastep_work_t *work,
+                                    igraph_real_t *dist, long int *parents) {
+    long int no_of_vertices = igraph_vector_long_size(&work->vertices);
+    long int i, no_of_req = 0;
+    igraph_csr_view_t view;
+
+    IGRAPH_CHECK(igraph_vector_long_resize(&work->offsets, no_of_vertices));
+    for (i = 0; i < no_of_vertices; i++) {
+        IGRAPH_CHECK(igraph_csr_view(scan->graph, &view,
+                                     (igraph_integer_t) VECTOR(work->vertices)[i],
+                                     scan->mode));
+        VECTOR(work->offsets)[i] = no_of_req;
+        no_of_req += IGRAPH_CSR_VIEW_SIZE(view);
+    }
+    IGRAPH_CHECK(igraph_vector_long_resize(&work->req_vertex, no_of_req));
+    IGRAPH_CHECK(igraph_vector_long_resize(&work->req_edge, no_of_req));
+    IGRAPH_CHECK(igraph_vector_resize(&work->req_dist, no_of_req));
+    IGRAPH_I_TRACE_ADD(visited_vertices, no_of_vertices);
+    IGRAPH_I_TRACE_ADD(relaxed_edges, no_of_req);
+
+    scan->dist = dist;
+    scan->vertices = VECTOR(work->vertices);
+    scan->offsets = VECTOR(work->offsets);
+    scan->req_vertex = VECTOR(work->req_vertex);
+    scan->req_edge = VECTOR(work->req_edge);
+    scan->req_dist = VECTOR(work->req_dist);
+    IGRAPH_CHECK(igraph_i_parallel_for(no_of_vertices, IGRAPH_I_DELTASTEP_GRAIN,
+                                       igraph_i_deltastep_scan, scan));
+
+    for (i = 0; i < no_of_req; i++) {
+        long int nei = VECTOR(work->req_vertex)[i];
+        igraph_real_t altdist = VECTOR(work->req_dist)[i];
+        if (nei >= 0 && altdist < dist[nei]) {
+            long int bucket = (long int) (altdist / scan->delta);
+            dist[nei] = altdist;
+            if (parents) {
+                parents[nei] = VECTOR(work->req_edge)[i] + 1;
+            }
+            IGRAPH_CHECK(igraph_vector_long_push_back(
+                             &work->buckets[bucket % work->no_of_buckets], nei));
+            work->pending++;
+        }
+    }
+
+    return 0;
+}
+
+igraph_bool_t igraph_i_deltastep_enabled(const igraph_t *graph,
+                                         const igraph_vector_t *weights) {
+    return igraph_vcount(graph) >= IGRAPH_I_DELTASTEP_MIN_NODES &&
+           (igraph_vector_size(weights) == 0 ||
+            IGRAPH_FINITE(igraph_vector_max(weights)));
+}
+
+int igraph_i_deltastep(const igraph_t *graph, const igraph_vector_t *weights,
+                       igraph_neimode_t mode, long int source,
+                       igraph_vector_t *dist, long int *parents) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_i_deltastep_work_t work;
+    igraph_i_deltastep_scan_t scan;
+    igraph_real_t maxweight, avgdegree;
+    long int i, bucket;
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
+        mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    /* The bucket width is the largest weight over the average degree,
+       as suggested by Meyer and Sanders. Then a vertex has about one
+       light edge, and there are as many buckets as the average
+       degree. */
+    maxweight = no_of_edges > 0 ? igraph_vector_max(weights) : 0.0;
+    avgdegree = (mode == IGRAPH_ALL ? 2.0 : 1.0) * no_of_edges / no_of_nodes;
+    if (avgdegree < 1) {
+        avgdegree = 1;
+    }
+    scan.delta = maxweight > 0 ? maxweight / avgdegree : 1.0;
+    scan.graph = graph;
+    scan.weights = weights;
+    scan.mode = mode;
+
+    memset(&work, 0, sizeof(work));
+    IGRAPH_FINALLY(igraph_i_deltastep_work_destroy, &work);
+    work.no_of_buckets = (long int) (maxweight / scan.delta) + 3;
+    work.buckets = igraph_Calloc(work.no_of_buckets, igraph_vector_long_t);
+    if (!work.buckets) {
+        IGRAPH_ERROR("Cannot calculate shortest paths", IGRAPH_ENOMEM);
+    }
+    work.mark = igraph_Calloc(no_of_nodes, char);
+    if (!work.mark) {
+        IGRAPH_ERROR("Cannot calculate shortest paths", IGRAPH_ENOMEM);
+    }
+    IGRAPH_CHECK(igraph_vector_long_init(&work.vertices, 0));
+    IGRAPH_CHECK(igraph_vector_long_init(&work.offsets, 0));
+    IGRAPH_CHECK(igraph_vector_long_init(&work.removed, 0));
+    IGRAPH_CHECK(igraph_vector_long_init(&work.req_vertex, 0));
+    IGRAPH_CHECK(igraph_vector_long_init(&work.req_edge, 0));
+    IGRAPH_CHECK(igraph_vector_init(&work.req_dist, 0));
+    for (i = 0; i < work.no_of_buckets; i++) {
+        IGRAPH_CHECK(igraph_vector_long_init(&work.buckets[i], 0));
+    }
+
+    IGRAPH_CHECK(igraph_vector_resize(dist, no_of_nodes));
+    igraph_vector_fill(dist, IGRAPH_INFINITY);
+    if (parents) {
+        memset(parents, 0, sizeof(long int) * (size_t) no_of_nodes);
+    }
+
+    VECTOR(*dist)[source] = 0.0;
+    IGRAPH_CHECK(igraph_vector_long_push_back(&work.buckets[0], source));
+    work.pending = 1;
+
+    /* The vertices of the current light phase are marked with bit 1,
+       the vertices removed from the current bucket with bit 2 */
+    for (bucket = 0; work.pending > 0; bucket++) {
+        igraph_vector_long_t *actbucket =
+            &work.buckets[bucket % work.no_of_buckets];
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        /* Light edges, until the bucket stays empty */
+        igraph_vector_long_clear(&work.removed);
+        while (!igraph_vector_long_empty(actbucket)) {
+            long int size = igraph_vector_long_size(actbucket);
+            igraph_vector_long_clear(&work.vertices);
+            for (i = 0; i < size; i++) {
+                long int v = VECTOR(*actbucket)[i];
+                if ((long int) (VECTOR(*dist)[v] / scan.delta) != bucket ||
+                    (work.mark[v] & 1)) {
+                    continue;       /* stale entry, or a duplicate */
+                }
+                IGRAPH_CHECK(igraph_vector_long_push_back(&work.vertices, v));
+                work.mark[v] |= 1;
+                if (!(work.mark[v] & 2)) {
+                    IGRAPH_CHECK(igraph_vector_long_push_back(&work.removed, v));
+                    work.mark[v] |= 2;
+                }
+            }
+            igraph_vector_long_clear(actbucket);
+            work.pending -= size;
+            scan.light = 1;
+            IGRAPH_CHECK(igraph_i_deltastep_relax(&scan, &work, VECTOR(*dist),
+                                                  parents));
+            for (i = 0; i < igraph_vector_long_size(&work.vertices); i++) {
+                work.mark[VECTOR(work.vertices)[i]] &= ~1;
+            }
+        }
+
+        /* Heavy edges of all vertices removed from the bucket, they
+           lead to later buckets */
+        for (i = 0; i < igraph_vector_long_size(&work.removed); i++) {
+            work.mark[VECTOR(work.removed)[i]] = 0;
+        }
+        IGRAPH_CHECK(igraph_vector_long_update(&work.vertices, &work.removed));
+        scan.light = 0;
+        IGRAPH_CHECK(igraph_i_deltastep_relax(&scan, &work, VECTOR(*dist),
+                                              parents));
+    }
+
+    igraph_i_deltastep_work_destroy(&work);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
@@ -23,6 +23,7 @@
 
 #include "igraph_types.h"
 #include "igraph_dqueue.h"
+#include "igraph_memory_internal.h"
 
 #define BASE_IGRAPH_REAL
 #include "igraph_pmt.h"
@@ -0,0 +1,364 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_foreign.h"
+#include "igraph_attributes.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_storage_internal.h"
+#include "config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_SYS_STAT_H)
+    #define IGRAPH_I_SNAPSHOT_MMAP 1
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+/* The snapshot file starts with this header, it is followed by the
+   'from', 'to', 'oi' and 'ii' vectors (no_of_edges integers each),
+   and the 'os' and 'is' vectors (no_of_nodes+1 integers each). The
+   integers are stored in native byte order, the header records the
+   byte order and the size of the integers, so that a file written on
+   an incompatible machine is rejected. The checksum covers the other
+   fields of the header. */
+
+#define IGRAPH_I_SNAPSHOT_MAGIC   "IGSNAP\r\n"
+#define IGRAPH_I_SNAPSHOT_VERSION 2
+
+typedef struct igraph_i_snapshot_header_t {
+    char magic[8];
+    int byteorder;
+    int intsize;
+    int version;
+    int directed;
+    int no_of_nodes;
+    int no_of_edges;
+    unsigned int checksum;
+} igraph_i_snapshot_header_t;
+
+/* FNV-1a of the header fields before the checksum */
+
+static unsigned int igraph_i_snapshot_checksum(
+        const igraph_i_snapshot_header_t *header) {
+    const unsigned char *p = (const unsigned char *) header;
+    size_t i, n = offsetof(igraph_i_snapshot_header_t, checksum);
+    unsigned int h = 2166136261u;
+    for (i = 0; i < n; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static size_t igraph_i_snapshot_size(long int no_of_nodes,
+                                     long int no_of_edges) {
+    return sizeof(igraph_i_snapshot_header_t) +
+           sizeof(int) * (4 * (size_t) no_of_edges + 2 * ((size_t) no_of_nodes + 1));
+}
+
+/**
+ * \ingroup loadsave
+ * \function igraph_write_graph_snapshot
+ * \brief Writes the graph to a binary snapshot file.
+ *
+ * </para><para>
+ * The snapshot contains the edge list of the graph together with the
+ * indices that \a igraph uses for querying it, so it can be loaded
+ * without parsing and without building the indices again, see \ref
+ * igraph_read_graph_mmap(). The format is binary and it depends on
+ * the byte order and integer size of the machine, it is meant for
+ * sharing a graph between processes, and not for long-term storage.
+ *
+ * </para><para>
+ * Attributes are not saved in the snapshot.
+ * \param graph The graph to write.
+ * \param outstream The stream to write the snapshot to, it should be
+ *        opened in binary mode.
+ * \return Error code:
+ *         \c IGRAPH_EFILE if the writing failed.
+ *
+ * Time complexity: O(|V|+|E|), the number of vertices plus the number
+ * of edges.
+ *
+ * \sa \ref igraph_read_graph_mmap() to read the snapshot.
+ *
+ * \example examples/simple/igraph_read_graph_mmap.c
+ */
+
+int igraph_write_graph_snapshot(const igraph_t *graph, FILE *outstream) {
+    igraph_i_snapshot_header_t header;
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IGRAPH_I_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.byteorder = 0x01020304;
+    header.intsize = sizeof(int);
+    header.version = IGRAPH_I_SNAPSHOT_VERSION;
+    header.directed = igraph_is_directed(graph) ? 1 : 0;
+    header.no_of_nodes = (int) no_of_nodes;
+    header.no_of_edges = (int) no_of_edges;
+    header.checksum = igraph_i_snapshot_checksum(&header);
+
+    if (fwrite(&header, sizeof(header), 1, outstream) != 1 ||
+        fwrite(VECTOR(graph->from), sizeof(int), no_of_edges, outstream) !=
+        (size_t) no_of_edges ||
+        fwrite(VECTOR(graph->to), sizeof(int), no_of_edges, outstream) !=
+        (size_t) no_of_edges ||
+        fwrite(VECTOR(graph->oi), sizeof(int), no_of_edges, outstream) !=
+        (size_t) no_of_edges ||
+        fwrite(VECTOR(graph->ii), sizeof(int), no_of_edges, outstream) !=
+        (size_t) no_of_edges ||
+        fwrite(VECTOR(graph->os), sizeof(int), no_of_nodes + 1, outstream) !=
+        (size_t) no_of_nodes + 1 ||
+        fwrite(VECTOR(graph->is), sizeof(int), no_of_nodes + 1, outstream) !=
+        (size_t) no_of_nodes + 1) {
+        IGRAPH_ERROR("Cannot write graph snapshot", IGRAPH_EFILE);
+    }
+
+    return 0;
+}
+
+/* Checks the contents of a snapshot in a single pass, if the caller
+   asked for it, so that a damaged or forged file cannot make the graph
+   functions index out of the mapping: the vertex ids must be valid, 'os' and 'is' must start
+   at zero, never decrease and end at the number of edges, and the
+   edge ids in 'oi' and 'ii' must be valid and list the edges of the
+   vertices in the ranges given by 'os' and 'is'. */
+
+static igraph_bool_t igraph_i_snapshot_valid(const int *data,
+                                             long int no_of_nodes,
+                                             long int no_of_edges) {
+    const int *from = data, *to = from + no_of_edges;
+    const int *oi = to + no_of_edges, *ii = oi + no_of_edges;
+    const int *os = ii + no_of_edges, *is = os + no_of_nodes + 1;
+    long int i, j;
+
+    for (i = 0; i < no_of_edges; i++) {
+        if (from[i] < 0 || from[i] >= no_of_nodes ||
+            to[i] < 0 || to[i] >= no_of_nodes) {
+            return 0;
+        }
+    }
+    if (os[0] != 0 || is[0] != 0 ||
+        os[no_of_nodes] != no_of_edges || is[no_of_nodes] != no_of_edges) {
+        return 0;
+    }
+    for (i = 0; i < no_of_nodes; i++) {
+        if (os[i + 1] < os[i] || os[i + 1] > no_of_edges ||
+            is[i + 1] < is[i] || is[i + 1] > no_of_edges) {
+            return 0;
+        }
+        for (j = os[i]; j < os[i + 1]; j++) {
+            if (oi[j] < 0 || oi[j] >= no_of_edges || from[oi[j]] != i) {
+                return 0;
+            }
+        }
+        for (j = is[i]; j < is[i + 1]; j++) {
+            if (ii[j] < 0 || ii[j] >= no_of_edges || to[ii[j]] != i) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+#ifdef IGRAPH_I_SNAPSHOT_MMAP
+
+static void igraph_i_snapshot_unmap(void *data, size_t size) {
+    munmap(data, size);
+}
+
+#else
+
+static void igraph_i_snapshot_free(void *data, size_t size) {
+    IGRAPH_UNUSED(size);
+    igraph_Free(data);
+}
+
+#endif
+
+/**
+ * \ingroup loadsave
+ * \function igraph_read_graph_mmap
+ * \brief Maps a binary snapshot file into memory as a graph.
+ *
+ * </para><para>
+ * Reads a snapshot that was written by \ref
+ * igraph_write_graph_snapshot(). On systems that support it, the
+ * file is memory mapped read-only, and the edge list and the indices
+ * of the graph point directly into the mapping. Loading is then
+ * independent of the size of the graph, the data is read from the
+ * disk on demand, and all processes that map the same file share the
+ * same physical memory. On other systems the file is read into
+ * memory, which still avoids parsing and indexing.
+ *
+ * </para><para>
+ * The graph can be used like any other graph. The first function
+ * that modifies it, e.g. \ref igraph_add_edges(), copies the edge list
+ * and the indices into private memory first, the file itself is never
+ * modified. The mapping is kept until the graph is destroyed, so the
+ * stream can be closed right after this function returns.
+ *
+ * </para><para>
+ * The header of the snapshot, its checksum and the size of the file
+ * are always checked. The edge list and the indices are only checked
+ * if \p verify is true, because this reads the whole file. Without
+ * it, a damaged snapshot whose header is intact is accepted, and
+ * later queries on the graph may crash, so only files that were
+ * written by \ref igraph_write_graph_snapshot() and could not be
+ * modified since should be read without verification.
+ * \param graph Pointer to an uninitialized graph object. The graph
+ *        has no attributes.
+ * \param instream The stream to read the snapshot from, it must be
+ *        associated with a regular file, opened in binary mode.
+ * \param verify Whether to check the edge list and the indices:
+ *        the vertex ids of the edges, and that the indices are
+ *        consistent with the edge list.
+ * \return Error code:
+ *         \c IGRAPH_PARSEERROR if the file is not a valid snapshot, or
+ *         it was written on a machine with a different byte order or
+ *         integer size, \c IGRAPH_EFILE if the file cannot be mapped
+ *         or read.
+ *
+ * Time complexity: O(1) if the file can be memory mapped and \p
+ * verify is false, O(|V|+|E|) otherwise.
+ *
+ * \example examples/simple/igraph_read_graph_mmap.c
+ */
+
+int igraph_read_graph_mmap(igraph_t *graph, FILE *instream,
+                           igraph_bool_t verify) {
+    igraph_i_storage_t *storage;
+    igraph_i_snapshot_header_t *header;
+    int *data;
+    long int no_of_nodes, no_of_edges;
+
+    storage = igraph_Calloc(1, igraph_i_storage_t);
+    if (storage == 0) {
+        IGRAPH_ERROR("Cannot read graph snapshot", IGRAPH_ENOMEM);
+    }
+    storage->refcount = 1;
+    IGRAPH_FINALLY(igraph_free, storage);
+
+#ifdef IGRAPH_I_SNAPSHOT_MMAP
+    {
+        struct stat st;
+        int fd = fileno(instream);
+        if (fstat(fd, &st) != 0) {
+            IGRAPH_ERROR("Cannot read graph snapshot", IGRAPH_EFILE);
+        }
+        if ((size_t) st.st_size < sizeof(igraph_i_snapshot_header_t)) {
+            IGRAPH_ERROR("Cannot read graph snapshot, file too short",
+                         IGRAPH_PARSEERROR);
+        }
+        storage->size = (size_t) st.st_size;
+        storage->data = mmap(0, storage->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (storage->data == MAP_FAILED) {
+            IGRAPH_ERROR("Cannot map graph snapshot", IGRAPH_EFILE);
+        }
+        storage->release = igraph_i_snapshot_unmap;
+    }
+#else
+    {
+        long int size;
+        if (fseek(instream, 0, SEEK_END) != 0 || (size = ftell(instream)) < 0 ||
+            fseek(instream, 0, SEEK_SET) != 0) {
+            IGRAPH_ERROR("Cannot read graph snapshot", IGRAPH_EFILE);
+        }
+        if ((size_t) size < sizeof(igraph_i_snapshot_header_t)) {
+            IGRAPH_ERROR("Cannot read graph snapshot, file too short",
+                         IGRAPH_PARSEERROR);
+        }
+        storage->size = (size_t) size;
+        storage->data = igraph_Calloc(storage->size, char);
+        if (storage->data == 0) {
+            IGRAPH_ERROR("Cannot read graph snapshot", IGRAPH_ENOMEM);
+        }
+        if (fread(storage->data, 1, storage->size, instream) != storage->size) {
+            igraph_Free(storage->data);
+            IGRAPH_ERROR("Cannot read graph snapshot", IGRAPH_EFILE);
+        }
+        storage->release = igraph_i_snapshot_free;
+    }
+#endif
+
+    /* From now on the storage owns the data */
+    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FINALLY(igraph_i_storage_release, storage);
+
+    header = (igraph_i_snapshot_header_t *) storage->data;
+    if (memcmp(header->magic, IGRAPH_I_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != IGRAPH_I_SNAPSHOT_VERSION) {
+        IGRAPH_ERROR("Cannot read graph snapshot, not a snapshot file",
+                     IGRAPH_PARSEERROR);
+    }
+    if (header->checksum != igraph_i_snapshot_checksum(header)) {
+        IGRAPH_ERROR("Cannot read graph snapshot, invalid header checksum",
+                     IGRAPH_PARSEERROR);
+    }
+    if (header->byteorder != 0x01020304 || header->intsize != sizeof(int)) {
+        IGRAPH_ERROR("Cannot read graph snapshot, it was written on an "
+                     "incompatible machine", IGRAPH_PARSEERROR);
+    }
+    no_of_nodes = header->no_of_nodes;
+    no_of_edges = header->no_of_edges;
+    if (no_of_nodes < 0 || no_of_edges < 0 ||
+        igraph_i_snapshot_size(no_of_nodes, no_of_edges) != storage->size) {
+        IGRAPH_ERROR("Cannot read graph snapshot, invalid size",
+                     IGRAPH_PARSEERROR);
+    }
+
+    data = (int *) (header + 1);
+    if (verify && !igraph_i_snapshot_valid(data, no_of_nodes, no_of_edges)) {
+        IGRAPH_ERROR("Cannot read graph snapshot, invalid contents",
+                     IGRAPH_PARSEERROR);
+    }
+
+    graph->n = (igraph_integer_t) no_of_nodes;
+    graph->directed = header->directed ? 1 : 0;
+    igraph_vector_int_view(&graph->from, data, no_of_edges);
+    data += no_of_edges;
+    igraph_vector_int_view(&graph->to, data, no_of_edges);
+    data += no_of_edges;
+    igraph_vector_int_view(&graph->oi, data, no_of_edges);
+    data += no_of_edges;
+    igraph_vector_int_view(&graph->ii, data, no_of_edges);
+    data += no_of_edges;
+    igraph_vector_int_view(&graph->os, data, no_of_nodes + 1);
+    data += no_of_nodes + 1;
+    igraph_vector_int_view(&graph->is, data, no_of_nodes + 1);
+    graph->storage = storage;
+    graph->eid_index = 0;
+    graph->pending = 0;
+
+    graph->attr = 0;
+    IGRAPH_CHECK(igraph_i_attribute_init(graph, 0));
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
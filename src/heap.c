@@ -24,6 +24,7 @@
 #include "igraph_types.h"
 #include "igraph_types_internal.h"
 #include "igraph_memory.h"
+#include "igraph_memory_internal.h"
 #include "igraph_random.h"
 #include "igraph_error.h"
 #include "config.h"
@@ -33,6 +34,16 @@
 #include <string.h>         /* memcpy & co. */
 #include <stdlib.h>
 
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#else
+    #ifdef HAVE_SYS_INT_TYPES_H
+        #include <sys/int_types.h>
+    #else
+        #include "pstdint.h"
+    #endif
+#endif
+
 #define PARENT(x)     (((x)+1)/2-1)
 #define LEFTCHILD(x)  (((x)+1)*2-1)
 #define RIGHTCHILD(x) (((x)+1)*2)
@@ -49,14 +60,14 @@ int igraph_indheap_init           (igraph_indheap_t* h, long int alloc_size) {
     if (alloc_size <= 0 ) {
         alloc_size = 1;
     }
-    h->stor_begin = igraph_Calloc(alloc_size, igraph_real_t);
+    h->stor_begin = igraph_i_Calloc(alloc_size, igraph_real_t);
     if (h->stor_begin == 0) {
         h->index_begin = 0;
         IGRAPH_ERROR("indheap init failed", IGRAPH_ENOMEM);
     }
-    h->index_begin = igraph_Calloc(alloc_size, long int);
+    h->index_begin = igraph_i_Calloc(alloc_size, long int);
     if (h->index_begin == 0) {
-        igraph_Free(h->stor_begin);
+        igraph_i_Free(h->stor_begin);
         h->stor_begin = 0;
         IGRAPH_ERROR("indheap init failed", IGRAPH_ENOMEM);
     }
@@ -84,14 +95,14 @@ int igraph_indheap_clear(igraph_indheap_t *h) {
 int igraph_indheap_init_array     (igraph_indheap_t *h, igraph_real_t* data, long int len) {
     long int i;
 
-    h->stor_begin = igraph_Calloc(len, igraph_real_t);
+    h->stor_begin = igraph_i_Calloc(len, igraph_real_t);
     if (h->stor_begin == 0) {
         h->index_begin = 0;
         IGRAPH_ERROR("indheap init from array failed", IGRAPH_ENOMEM);
     }
-    h->index_begin = igraph_Calloc(len, long int);
+    h->index_begin = igraph_i_Calloc(len, long int);
     if (h->index_begin == 0) {
-        igraph_Free(h->stor_begin);
+        igraph_i_Free(h->stor_begin);
         h->stor_begin = 0;
         IGRAPH_ERROR("indheap init from array failed", IGRAPH_ENOMEM);
     }
@@ -118,11 +129,11 @@ void igraph_indheap_destroy        (igraph_indheap_t* h) {
     assert(h != 0);
     if (h->destroy) {
         if (h->stor_begin != 0) {
-            igraph_Free(h->stor_begin);
+            igraph_i_Free(h->stor_begin);
             h->stor_begin = 0;
         }
         if (h->index_begin != 0) {
-            igraph_Free(h->index_begin);
+            igraph_i_Free(h->index_begin);
             h->index_begin = 0;
         }
     }
@@ -285,20 +296,20 @@ int igraph_indheap_reserve        (igraph_indheap_t* h, long int size) {
         return 0;
     }
 
-    tmp1 = igraph_Calloc(size, igraph_real_t);
+    tmp1 = igraph_i_Calloc(size, igraph_real_t);
     if (tmp1 == 0) {
         IGRAPH_ERROR("indheap reserve failed", IGRAPH_ENOMEM);
     }
-    IGRAPH_FINALLY(free, tmp1);   /* TODO: hack */
-    tmp2 = igraph_Calloc(size, long int);
+    IGRAPH_FINALLY(igraph_i_free, tmp1);
+    tmp2 = igraph_i_Calloc(size, long int);
     if (tmp2 == 0) {
         IGRAPH_ERROR("indheap reserve failed", IGRAPH_ENOMEM);
     }
-    IGRAPH_FINALLY(free, tmp2);
+    IGRAPH_FINALLY(igraph_i_free, tmp2);
     memcpy(tmp1, h->stor_begin, (size_t) actual_size * sizeof(igraph_real_t));
     memcpy(tmp2, h->index_begin, (size_t) actual_size * sizeof(long int));
-    igraph_Free(h->stor_begin);
-    igraph_Free(h->index_begin);
+    igraph_i_Free(h->stor_begin);
+    igraph_i_Free(h->index_begin);
 
     h->stor_begin = tmp1;
     h->index_begin = tmp2;
@@ -417,7 +428,7 @@ int igraph_d_indheap_init           (igraph_d_indheap_t* h, long int alloc_size)
     if (alloc_size <= 0 ) {
         alloc_size = 1;
     }
-    h->stor_begin = igraph_Calloc(alloc_size, igraph_real_t);
+    h->stor_begin = igraph_i_Calloc(alloc_size, igraph_real_t);
     if (h->stor_begin == 0) {
         h->index_begin = 0;
         h->index2_begin = 0;
@@ -426,17 +437,17 @@ int igraph_d_indheap_init           (igraph_d_indheap_t* h, long int alloc_size)
     h->stor_end = h->stor_begin + alloc_size;
     h->end = h->stor_begin;
     h->destroy = 1;
-    h->index_begin = igraph_Calloc(alloc_size, long int);
+    h->index_begin = igraph_i_Calloc(alloc_size, long int);
     if (h->index_begin == 0) {
-        igraph_Free(h->stor_begin);
+        igraph_i_Free(h->stor_begin);
         h->stor_begin = 0;
         h->index2_begin = 0;
         IGRAPH_ERROR("d_indheap init failed", IGRAPH_ENOMEM);
     }
-    h->index2_begin = igraph_Calloc(alloc_size, long int);
+    h->index2_begin = igraph_i_Calloc(alloc_size, long int);
     if (h->index2_begin == 0) {
-        igraph_Free(h->stor_begin);
-        igraph_Free(h->index_begin);
+        igraph_i_Free(h->stor_begin);
+        igraph_i_Free(h->index_begin);
         h->stor_begin = 0;
         h->index_begin = 0;
         IGRAPH_ERROR("d_indheap init failed", IGRAPH_ENOMEM);
@@ -454,15 +465,15 @@ void igraph_d_indheap_destroy        (igraph_d_indheap_t* h) {
     assert(h != 0);
     if (h->destroy) {
         if (h->stor_begin != 0) {
-            igraph_Free(h->stor_begin);
+            igraph_i_Free(h->stor_begin);
             h->stor_begin = 0;
         }
         if (h->index_begin != 0) {
-            igraph_Free(h->index_begin);
+            igraph_i_Free(h->index_begin);
             h->index_begin = 0;
         }
         if (h->index2_begin != 0) {
-            igraph_Free(h->index2_begin);
+            igraph_i_Free(h->index2_begin);
             h->index2_begin = 0;
         }
     }
@@ -571,28 +582,28 @@ int igraph_d_indheap_reserve        (igraph_d_indheap_t* h, long int size) {
         return 0;
     }
 
-    tmp1 = igraph_Calloc(size, igraph_real_t);
+    tmp1 = igraph_i_Calloc(size, igraph_real_t);
     if (tmp1 == 0) {
         IGRAPH_ERROR("d_indheap reserve failed", IGRAPH_ENOMEM);
     }
-    IGRAPH_FINALLY(free, tmp1);   /* TODO: hack */
-    tmp2 = igraph_Calloc(size, long int);
+    IGRAPH_FINALLY(igraph_i_free, tmp1);
+    tmp2 = igraph_i_Calloc(size, long int);
     if (tmp2 == 0) {
         IGRAPH_ERROR("d_indheap reserve failed", IGRAPH_ENOMEM);
     }
-    IGRAPH_FINALLY(free, tmp2);   /* TODO: hack */
-    tmp3 = igraph_Calloc(size, long int);
+    IGRAPH_FINALLY(igraph_i_free, tmp2);
+    tmp3 = igraph_i_Calloc(size, long int);
     if (tmp3 == 0) {
         IGRAPH_ERROR("d_indheap reserve failed", IGRAPH_ENOMEM);
     }
-    IGRAPH_FINALLY(free, tmp3);   /* TODO: hack */
+    IGRAPH_FINALLY(igraph_i_free, tmp3);
 
     memcpy(tmp1, h->stor_begin, (size_t) actual_size * sizeof(igraph_real_t));
     memcpy(tmp2, h->index_begin, (size_t) actual_size * sizeof(long int));
     memcpy(tmp3, h->index2_begin, (size_t) actual_size * sizeof(long int));
-    igraph_Free(h->stor_begin);
-    igraph_Free(h->index_begin);
-    igraph_Free(h->index2_begin);
+    igraph_i_Free(h->stor_begin);
+    igraph_i_Free(h->index_begin);
+    igraph_i_Free(h->index2_begin);
 
     h->stor_begin = tmp1;
     h->stor_end = h->stor_begin + size;
@@ -1081,3 +1092,172 @@ int igraph_2wheap_check(igraph_2wheap_t *h) {
 
     return 0;
 }
+
+/* -------------------------------------------------- */
+/* Indexed radix heap                                 */
+/* -------------------------------------------------- */
+
+/* After R. K. Ahuja, K. Mehlhorn, J. B. Orlin and R. E. Tarjan:
+   Faster algorithms for the shortest path problem, J. ACM 37 (1990),
+   in the simple form with one bucket per bit. Every bucket is a
+   doubly linked list of indices. When bucket zero is empty, the
+   minimum of the first non-empty bucket becomes the new 'last' key,
+   and the elements of that bucket are moved to lower buckets. An
+   element can only move down, at most 64 times, so a deletion takes
+   O(log C) amortized time if the keys are at most C, and the other
+   operations take O(1) time. */
+
+static long int igraph_i_radixheap_bucket(const igraph_radixheap_t *h,
+        igraph_real_t elem) {
+    uint64_t diff = ((uint64_t) elem) ^ ((uint64_t) h->last);
+    long int bucket = 0;
+#if defined(__GNUC__)
+    if (diff) {
+        bucket = 64 - __builtin_clzll(diff);
+    }
+#else
+    while (diff) {
+        diff >>= 1;
+        bucket++;
+    }
+#endif
+    return bucket;
+}
+
+static void igraph_i_radixheap_link(igraph_radixheap_t *h, long int idx) {
+    long int bucket = igraph_i_radixheap_bucket(h, VECTOR(h->keys)[idx]);
+    long int first = h->head[bucket];
+    VECTOR(h->bucket)[idx] = bucket;
+    VECTOR(h->prev)[idx] = -1;
+    VECTOR(h->next)[idx] = first;
+    if (first >= 0) {
+        VECTOR(h->prev)[first] = idx;
+    }
+    h->head[bucket] = idx;
+}
+
+static void igraph_i_radixheap_unlink(igraph_radixheap_t *h, long int idx) {
+    long int prev = VECTOR(h->prev)[idx], next = VECTOR(h->next)[idx];
+    if (prev >= 0) {
+        VECTOR(h->next)[prev] = next;
+    } else {
+        h->head[VECTOR(h->bucket)[idx]] = next;
+    }
+    if (next >= 0) {
+        VECTOR(h->prev)[next] = prev;
+    }
+}
+
+int igraph_radixheap_init(igraph_radixheap_t *h, long int size) {
+    IGRAPH_VECTOR_INIT_FINALLY(&h->keys, size);
+    IGRAPH_CHECK(igraph_vector_long_init(&h->next, size));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &h->next);
+    IGRAPH_CHECK(igraph_vector_long_init(&h->prev, size));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &h->prev);
+    IGRAPH_CHECK(igraph_vector_long_init(&h->bucket, size));
+    IGRAPH_FINALLY_CLEAN(3);
+    igraph_radixheap_clear(h);
+    return 0;
+}
+
+void igraph_radixheap_destroy(igraph_radixheap_t *h) {
+    igraph_vector_destroy(&h->keys);
+    igraph_vector_long_destroy(&h->next);
+    igraph_vector_long_destroy(&h->prev);
+    igraph_vector_long_destroy(&h->bucket);
+}
+
+int igraph_radixheap_clear(igraph_radixheap_t *h) {
+    long int i;
+    h->size = 0;
+    h->last = 0;
+    igraph_vector_long_fill(&h->bucket, -1);
+    for (i = 0; i < IGRAPH_I_RADIXHEAP_BUCKETS; i++) {
+        h->head[i] = -1;
+    }
+    return 0;
+}
+
+igraph_bool_t igraph_radixheap_empty(const igraph_radixheap_t *h) {
+    return h->size == 0;
+}
+
+long int igraph_radixheap_size(const igraph_radixheap_t *h) {
+    return h->size;
+}
+
+int igraph_radixheap_push_with_index(igraph_radixheap_t *h,
+                                     long int idx, igraph_real_t elem) {
+    VECTOR(h->keys)[idx] = elem;
+    igraph_i_radixheap_link(h, idx);
+    h->size++;
+    return 0;
+}
+
+igraph_bool_t igraph_radixheap_has_elem(const igraph_radixheap_t *h, long int idx) {
+    return VECTOR(h->bucket)[idx] != -1;
+}
+
+igraph_bool_t igraph_radixheap_has_active(const igraph_radixheap_t *h, long int idx) {
+    return VECTOR(h->bucket)[idx] >= 0;
+}
+
+igraph_real_t igraph_radixheap_get(const igraph_radixheap_t *h, long int idx) {
+    return VECTOR(h->keys)[idx];
+}
+
+igraph_real_t igraph_radixheap_deactivate_min_index(igraph_radixheap_t *h,
+        long int *idx) {
+    long int min;
+
+    if (h->head[0] < 0) {
+        /* Redistribute the first non-empty bucket */
+        long int bucket = 1, i, next;
+        igraph_real_t last;
+        while (h->head[bucket] < 0) {
+            bucket++;
+        }
+        i = h->head[bucket];
+        last = VECTOR(h->keys)[i];
+        for (; i >= 0; i = VECTOR(h->next)[i]) {
+            if (VECTOR(h->keys)[i] < last) {
+                last = VECTOR(h->keys)[i];
+            }
+        }
+        h->last = last;
+        i = h->head[bucket];
+        h->head[bucket] = -1;
+        for (; i >= 0; i = next) {
+            next = VECTOR(h->next)[i];
+            igraph_i_radixheap_link(h, i);
+        }
+    }
+
+    min = h->head[0];
+    igraph_i_radixheap_unlink(h, min);
+    VECTOR(h->bucket)[min] = -2;
+    h->size--;
+    if (idx) {
+        *idx = min;
+    }
+    return VECTOR(h->keys)[min];
+}
+
+igraph_real_t igraph_radixheap_delete_min_index(igraph_radixheap_t *h,
+        long int *idx) {
+    long int min;
+    igraph_real_t tmp = igraph_radixheap_deactivate_min_index(h, &min);
+    VECTOR(h->bucket)[min] = -1;
+    if (idx) {
+        *idx = min;
+    }
+    return tmp;
+}
+
+int igraph_radixheap_modify(igraph_radixheap_t *h, long int idx,
+                            igraph_real_t elem) {
+    igraph_i_radixheap_unlink(h, idx);
+    VECTOR(h->keys)[idx] = elem;
+    igraph_i_radixheap_link(h, idx);
+    return 0;
+}
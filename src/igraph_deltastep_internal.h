@@ -0,0 +1,54 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_DELTASTEP_INTERNAL_H
+#define IGRAPH_DELTASTEP_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_datatype.h"
+#include "igraph_constants.h"
+#include "igraph_vector.h"
+
+/* Parallel single-source shortest paths with delta-stepping, see
+   deltastep.c. It is used instead of Dijkstra's algorithm for all
+   distances from a vertex, if the graph has at least this many
+   vertices and the weights are finite. The choice must not depend on
+   the number of threads, so that the predecessors are the same with
+   any number of threads. */
+
+#define IGRAPH_I_DELTASTEP_MIN_NODES 50000
+
+igraph_bool_t igraph_i_deltastep_enabled(const igraph_t *graph,
+                                         const igraph_vector_t *weights);
+
+/* The distances from 'source' are stored in 'dist', IGRAPH_INFINITY
+   for unreachable vertices. If 'parents' is not null, it must have
+   room for all vertices, the id plus one of the edge through which
+   each vertex was reached is stored there, zero for the source and
+   the unreachable vertices. The weights must be non-negative and
+   finite. */
+
+int igraph_i_deltastep(const igraph_t *graph, const igraph_vector_t *weights,
+                       igraph_neimode_t mode, long int source,
+                       igraph_vector_t *dist, long int *parents);
+
+#endif
@@ -23,6 +23,7 @@
 
 #include "igraph_types.h"
 #include "igraph_heap.h"
+#include "igraph_memory_internal.h"
 
 #define BASE_IGRAPH_REAL
 #define HEAP_TYPE_MAX
@@ -0,0 +1,71 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_MEMORY_INTERNAL_H
+#define IGRAPH_MEMORY_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_memory.h"
+
+#include <stddef.h>
+
+__BEGIN_DECLS
+
+/* Allocation through the current allocator, see igraph_allocator_push().
+   They are used for the storage of vectors, matrices, queues, stacks,
+   heaps and sets, i.e. for the memory that is only ever freed by the
+   destructors of these types. Other memory must use igraph_Calloc(),
+   because it may be freed with free() directly. New memory is zeroed
+   like with igraph_Calloc(). Memory that was allocated before the
+   current allocator was pushed is reallocated and freed by the
+   allocator that owns it, or by the system allocator. */
+
+void *igraph_i_calloc(size_t count, size_t size);
+void *igraph_i_realloc(void *ptr, size_t size);
+void igraph_i_free(void *ptr);
+
+#define igraph_i_Calloc(n,t)    (t*) igraph_i_calloc((size_t)(n), sizeof(t))
+#define igraph_i_Realloc(p,n,t) (t*) igraph_i_realloc((void*)(p), (size_t)((n)*sizeof(t)))
+#define igraph_i_Free(p)        (igraph_i_free((void *)(p)), (p) = NULL)
+
+/* The allocator and memory statistics of a thread. The thread pool
+   installs the context of the calling thread in the workers for the
+   duration of a job, so that the workers allocate from the same arena
+   and are counted by the same statistics, see threads.c. While a
+   context is shared, the allocation functions above serialize the
+   access to it with a lock. */
+
+typedef struct igraph_i_memory_context_t {
+    igraph_allocator_t *allocator;
+    igraph_memstat_t *memstat;
+    int shared;
+} igraph_i_memory_context_t;
+
+void igraph_i_memory_share(igraph_i_memory_context_t *context);
+void igraph_i_memory_unshare(void);
+void igraph_i_memory_install(const igraph_i_memory_context_t *context,
+                             igraph_i_memory_context_t *saved);
+void igraph_i_memory_restore(const igraph_i_memory_context_t *saved);
+
+__END_DECLS
+
+#endif
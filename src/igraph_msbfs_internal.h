@@ -0,0 +1,82 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_MSBFS_INTERNAL_H
+#define IGRAPH_MSBFS_INTERNAL_H
+
+#include "config.h"
+#include "igraph_types.h"
+#include "igraph_adjlist.h"
+
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#else
+    #ifdef HAVE_SYS_INT_TYPES_H
+        #include <sys/int_types.h>
+    #else
+        #include "pstdint.h"
+    #endif
+#endif
+
+/* Multi-source breadth-first search, see msbfs.c. The sources are
+   processed in batches of IGRAPH_I_MSBFS_WIDTH, source 'k' of the
+   batch is bit 'k' of the masks, and it is source number
+   batch * IGRAPH_I_MSBFS_WIDTH + k of all sources. */
+
+typedef uint64_t igraph_i_msbfs_mask_t;
+
+#define IGRAPH_I_MSBFS_WIDTH 64
+
+/* Called once for every vertex and distance at which some sources of
+   the batch reach the vertex first; 'reached' has the bits of these
+   sources. The sources themselves are reported at distance zero. The
+   batches may run in parallel, but the calls of one batch are made
+   from one thread, in the order of the distances. */
+
+typedef int igraph_i_msbfs_visit_t(void *arg, long int batch, long int vertex,
+                                   igraph_i_msbfs_mask_t reached,
+                                   long int dist);
+
+int igraph_i_msbfs(const igraph_adjlist_t *adjlist,
+                   const igraph_vector_t *sources, igraph_real_t cutoff,
+                   igraph_i_msbfs_visit_t *visit, void *arg);
+
+/* The number of sources to give to one igraph_i_msbfs() call, for
+   callers that report progress between the calls, or that keep data
+   for every batch: a few batches for every thread. It is a multiple
+   of IGRAPH_I_MSBFS_WIDTH. */
+
+long int igraph_i_msbfs_round(void);
+
+/* The number of bits of a mask, and the index of its lowest bit */
+
+#if defined(__GNUC__)
+#define IGRAPH_I_MSBFS_COUNT(mask) __builtin_popcountll(mask)
+#define IGRAPH_I_MSBFS_LOWEST(mask) __builtin_ctzll(mask)
+#else
+int igraph_i_msbfs_count(igraph_i_msbfs_mask_t mask);
+int igraph_i_msbfs_lowest(igraph_i_msbfs_mask_t mask);
+#define IGRAPH_I_MSBFS_COUNT(mask) igraph_i_msbfs_count(mask)
+#define IGRAPH_I_MSBFS_LOWEST(mask) igraph_i_msbfs_lowest(mask)
+#endif
+
+#endif
@@ -23,6 +23,7 @@
 
 #include "igraph_types.h"
 #include "igraph_memory.h"
+#include "igraph_memory_internal.h"
 #include "igraph_error.h"
 #include "igraph_types_internal.h"
 #include "config.h"
@@ -51,7 +52,7 @@ int igraph_set_init(igraph_set_t *set, int long size) {
     if (size < 0) {
         size = 0;
     }
-    set->stor_begin = igraph_Calloc(alloc_size, igraph_integer_t);
+    set->stor_begin = igraph_i_Calloc(alloc_size, igraph_integer_t);
     set->stor_end = set->stor_begin + alloc_size;
     set->end = set->stor_begin;
 
@@ -70,7 +71,7 @@ int igraph_set_init(igraph_set_t *set, int long size) {
 void igraph_set_destroy(igraph_set_t* set) {
     assert(set != 0);
     if (set->stor_begin != 0) {
-        igraph_Free(set->stor_begin);
+        igraph_i_Free(set->stor_begin);
         set->stor_begin = NULL;
     }
 }
@@ -114,7 +115,7 @@ int igraph_set_reserve(igraph_set_t* set, long int size) {
         return 0;
     }
 
-    tmp = igraph_Realloc(set->stor_begin, (size_t) size, igraph_integer_t);
+    tmp = igraph_i_Realloc(set->stor_begin, (size_t) size, igraph_integer_t);
     if (tmp == 0) {
         IGRAPH_ERROR("cannot reserve space for set", IGRAPH_ENOMEM);
     }
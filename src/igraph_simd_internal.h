@@ -0,0 +1,68 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_SIMD_INTERNAL_H
+#define IGRAPH_SIMD_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_types.h"
+
+__BEGIN_DECLS
+
+/* Vectorized kernels for the real and integer vector templates. The
+   best implementation (AVX2, SSE2 or plain C) is selected at run time.
+   The reductions add the elements in eight interleaved partial sums,
+   in the same order in all implementations, so the result does not
+   depend on the processor. The element-wise operations work in place:
+   x[i] = x[i] op y[i], or x[i] = x[i] op c. max and min need at least
+   one element, and ignore NaN elements unless the first element is
+   NaN, exactly like the scalar loops of the templates. */
+
+igraph_real_t igraph_i_simd_sum_real(const igraph_real_t *x, long int n);
+igraph_real_t igraph_i_simd_sumsq_real(const igraph_real_t *x, long int n);
+void igraph_i_simd_add_real(igraph_real_t *x, const igraph_real_t *y, long int n);
+void igraph_i_simd_sub_real(igraph_real_t *x, const igraph_real_t *y, long int n);
+void igraph_i_simd_mul_real(igraph_real_t *x, const igraph_real_t *y, long int n);
+void igraph_i_simd_div_real(igraph_real_t *x, const igraph_real_t *y, long int n);
+void igraph_i_simd_scale_real(igraph_real_t *x, igraph_real_t c, long int n);
+void igraph_i_simd_add_constant_real(igraph_real_t *x, igraph_real_t c, long int n);
+igraph_real_t igraph_i_simd_max_real(const igraph_real_t *x, long int n);
+igraph_real_t igraph_i_simd_min_real(const igraph_real_t *x, long int n);
+
+int igraph_i_simd_sum_int(const int *x, long int n);
+void igraph_i_simd_add_int(int *x, const int *y, long int n);
+void igraph_i_simd_sub_int(int *x, const int *y, long int n);
+void igraph_i_simd_mul_int(int *x, const int *y, long int n);
+void igraph_i_simd_scale_int(int *x, int c, long int n);
+void igraph_i_simd_add_constant_int(int *x, int c, long int n);
+int igraph_i_simd_max_int(const int *x, long int n);
+int igraph_i_simd_min_int(const int *x, long int n);
+
+/* Limits the implementation used: 0 is plain C, 1 is SSE2, 2 is AVX2.
+   Levels that the processor does not support are never used. Returns
+   the level that is actually used. For testing. */
+
+int igraph_i_simd_set_level(int level);
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,55 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_STORAGE_INTERNAL_H
+#define IGRAPH_STORAGE_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_datatype.h"
+
+#include <stddef.h>
+
+__BEGIN_DECLS
+
+/* Memory that backs the edge list and the indices of a graph, if they
+   do not own their memory, see the 'storage' member of igraph_t. The
+   vectors of the graph point into 'data'. The storage can be shared by
+   several graphs, 'refcount' is the number of graphs using it, it is
+   only changed while holding a lock, see type_indexededgelist.c.
+   'release' is called with 'data' and 'size' when the last of these
+   graphs is destroyed, or modified, in which case the vectors are
+   copied to their own memory first. */
+
+typedef struct igraph_i_storage_s {
+    void (*release)(void *data, size_t size);
+    void *data;
+    size_t size;
+    long int refcount;
+} igraph_i_storage_t;
+
+void igraph_i_storage_release(igraph_i_storage_t *storage);
+int igraph_i_graph_own(igraph_t *graph);
+int igraph_i_graph_index(const igraph_t *graph);
+
+__END_DECLS
+
+#endif
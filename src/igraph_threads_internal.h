@@ -0,0 +1,127 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_THREADS_INTERNAL_H
+#define IGRAPH_THREADS_INTERNAL_H
+
+#include "config.h"
+#include "igraph_types.h"
+
+/* A minimal mutex for data structures that may be used from several
+   threads. It uses POSIX threads if they were found by configure, and
+   critical sections on Windows. Without either of them the operations
+   do nothing, and the data structures are only safe to use from a
+   single thread. IGRAPH_I_MUTEX_INIT evaluates to zero on success. */
+
+#if defined(HAVE_PTHREAD)
+
+#include <pthread.h>
+
+typedef pthread_mutex_t igraph_i_mutex_t;
+
+#define IGRAPH_I_MUTEX_INIT(m)    pthread_mutex_init((m), 0)
+#define IGRAPH_I_MUTEX_DESTROY(m) pthread_mutex_destroy(m)
+#define IGRAPH_I_MUTEX_LOCK(m)    pthread_mutex_lock(m)
+#define IGRAPH_I_MUTEX_UNLOCK(m)  pthread_mutex_unlock(m)
+
+#elif defined(_WIN32)
+
+#include <windows.h>
+
+typedef CRITICAL_SECTION igraph_i_mutex_t;
+
+#define IGRAPH_I_MUTEX_INIT(m)    (InitializeCriticalSection(m), 0)
+#define IGRAPH_I_MUTEX_DESTROY(m) DeleteCriticalSection(m)
+#define IGRAPH_I_MUTEX_LOCK(m)    EnterCriticalSection(m)
+#define IGRAPH_I_MUTEX_UNLOCK(m)  LeaveCriticalSection(m)
+
+#else
+
+typedef int igraph_i_mutex_t;
+
+#define IGRAPH_I_MUTEX_INIT(m)    (*(m) = 0)
+#define IGRAPH_I_MUTEX_DESTROY(m) ((void) (m))
+#define IGRAPH_I_MUTEX_LOCK(m)    ((void) (m))
+#define IGRAPH_I_MUTEX_UNLOCK(m)  ((void) (m))
+
+#endif
+
+/* A mutex with static storage that needs no initialization, for
+   global data. IGRAPH_I_STATIC_MUTEX defines it. */
+
+#if defined(HAVE_PTHREAD)
+
+#define IGRAPH_I_STATIC_MUTEX(name) \
+    static pthread_mutex_t name = PTHREAD_MUTEX_INITIALIZER
+#define IGRAPH_I_STATIC_MUTEX_LOCK(m)   pthread_mutex_lock(m)
+#define IGRAPH_I_STATIC_MUTEX_UNLOCK(m) pthread_mutex_unlock(m)
+
+#elif defined(_WIN32)
+
+#define IGRAPH_I_STATIC_MUTEX(name) static SRWLOCK name = SRWLOCK_INIT
+#define IGRAPH_I_STATIC_MUTEX_LOCK(m)   AcquireSRWLockExclusive(m)
+#define IGRAPH_I_STATIC_MUTEX_UNLOCK(m) ReleaseSRWLockExclusive(m)
+
+#else
+
+#define IGRAPH_I_STATIC_MUTEX(name) static int name = 0
+#define IGRAPH_I_STATIC_MUTEX_LOCK(m)   ((void) (m))
+#define IGRAPH_I_STATIC_MUTEX_UNLOCK(m) ((void) (m))
+
+#endif
+
+/* Loading and storing an int that is also read without holding the
+   lock that protects its writes. The store publishes everything that
+   was written before it to the threads that load the new value. */
+
+#if defined(__GNUC__)
+
+#define IGRAPH_I_ATOMIC_LOAD(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define IGRAPH_I_ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#else
+
+#define IGRAPH_I_ATOMIC_LOAD(p)     (*(volatile const int *) (p))
+#define IGRAPH_I_ATOMIC_STORE(p, v) (*(volatile int *) (p) = (v))
+
+#endif
+
+/* Running functions on the thread pool, see threads.c. The parts of
+   igraph_i_parallel_run() are numbered from zero to nthreads-1, the
+   ranges of igraph_i_parallel_for() contain the indices from <= i < to.
+   The reduction functions store the partial result of their range. */
+
+typedef void igraph_i_thread_func_t(void *arg, int thread, int nthreads);
+typedef int igraph_i_parallel_for_func_t(void *arg, long int from,
+        long int to);
+typedef int igraph_i_parallel_reduce_func_t(void *arg, long int from,
+        long int to, igraph_real_t *result);
+
+void igraph_i_parallel_run(igraph_i_thread_func_t *func, void *arg,
+                           int nthreads);
+int igraph_i_parallel_for(long int n, long int grain,
+                          igraph_i_parallel_for_func_t *func, void *arg);
+int igraph_i_parallel_reduce(long int n, long int grain,
+                             igraph_i_parallel_reduce_func_t *func,
+                             void *arg, igraph_real_t *result);
+
+#endif
@@ -0,0 +1,51 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+
+#ifndef IGRAPH_TRACE_INTERNAL_H
+#define IGRAPH_TRACE_INTERNAL_H
+
+#include "igraph_trace.h"
+#include "config.h"
+
+/* Updating and reporting the tracing counters, see trace.c. Without
+   --enable-tracing the macros expand to nothing, and their arguments
+   are not evaluated. */
+
+#ifdef IGRAPH_TRACING
+
+extern IGRAPH_THREAD_LOCAL igraph_trace_counters_t igraph_i_trace_counters;
+
+void igraph_i_trace_report(const char *function);
+
+#define IGRAPH_I_TRACE_ADD(counter, n) \
+    (igraph_i_trace_counters.counter += (long int) (n))
+#define IGRAPH_I_TRACE_REPORT(function) igraph_i_trace_report(function)
+
+#else
+
+#define IGRAPH_I_TRACE_ADD(counter, n) ((void) 0)
+#define IGRAPH_I_TRACE_REPORT(function) ((void) 0)
+
+#endif
+
+#endif
@@ -158,6 +158,43 @@ igraph_real_t igraph_2wheap_delete_max_index(igraph_2wheap_t *h, long int *idx);
 int igraph_2wheap_modify(igraph_2wheap_t *h, long int idx, igraph_real_t elem);
 int igraph_2wheap_check(igraph_2wheap_t *h);
 
+/* -------------------------------------------------- */
+/* Indexed radix heap                                 */
+/* -------------------------------------------------- */
+
+/* A monotone minimum heap for non-negative integer keys below 2^53,
+   e.g. the distances of Dijkstra's algorithm with integer weights.
+   The deleted minimums must be non-decreasing, and new keys must not
+   be smaller than the last deleted minimum. Element i of bucket b
+   differs from the last minimum first in bit b-1, bucket zero
+   contains the elements equal to it. The interface is like that of
+   the two-way heap, but for a minimum heap. */
+
+#define IGRAPH_I_RADIXHEAP_BUCKETS 65
+
+typedef struct igraph_radixheap_t {
+    long int size;
+    igraph_real_t last;
+    igraph_vector_t keys;
+    igraph_vector_long_t next, prev;
+    igraph_vector_long_t bucket;   /* -1: never added, -2: deactivated */
+    long int head[IGRAPH_I_RADIXHEAP_BUCKETS];
+} igraph_radixheap_t;
+
+int igraph_radixheap_init(igraph_radixheap_t *h, long int size);
+void igraph_radixheap_destroy(igraph_radixheap_t *h);
+int igraph_radixheap_clear(igraph_radixheap_t *h);
+int igraph_radixheap_push_with_index(igraph_radixheap_t *h,
+                                     long int idx, igraph_real_t elem);
+igraph_bool_t igraph_radixheap_empty(const igraph_radixheap_t *h);
+long int igraph_radixheap_size(const igraph_radixheap_t *h);
+igraph_bool_t igraph_radixheap_has_elem(const igraph_radixheap_t *h, long int idx);
+igraph_bool_t igraph_radixheap_has_active(const igraph_radixheap_t *h, long int idx);
+igraph_real_t igraph_radixheap_get(const igraph_radixheap_t *h, long int idx);
+igraph_real_t igraph_radixheap_delete_min_index(igraph_radixheap_t *h, long int *idx);
+igraph_real_t igraph_radixheap_deactivate_min_index(igraph_radixheap_t *h, long int *idx);
+int igraph_radixheap_modify(igraph_radixheap_t *h, long int idx, igraph_real_t elem);
+
 /**
  * Trie data type
  * \ingroup internal
@@ -0,0 +1,371 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=4 sw=4 sts=4 et: */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_structural.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_qsort.h"
+#include "igraph_topology.h"
+#include "igraph_types_internal.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+#include <math.h>
+
+/* The size of the sliding window in the Gorder algorithm, the value
+   recommended by Wei et al. */
+#define IGRAPH_I_GORDER_WINDOW 5
+
+/* Sorts the vertices by degree with counting sort, ties are broken by
+   the vertex ids, in increasing order. */
+
+static int igraph_i_reorder_by_degree(const igraph_vector_t *degree,
+                                      igraph_vector_long_t *order,
+                                      igraph_bool_t descending) {
+    long int no_of_nodes = igraph_vector_size(degree);
+    long int maxdeg = no_of_nodes > 0 ? (long int) igraph_vector_max(degree) : 0;
+    igraph_vector_long_t start;
+    long int i;
+
+    IGRAPH_CHECK(igraph_vector_long_init(&start, maxdeg + 2));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &start);
+
+    for (i = 0; i < no_of_nodes; i++) {
+        long int d = (long int) VECTOR(*degree)[i];
+        VECTOR(start)[descending ? maxdeg - d + 1 : d + 1] += 1;
+    }
+    for (i = 1; i <= maxdeg + 1; i++) {
+        VECTOR(start)[i] += VECTOR(start)[i - 1];
+    }
+    for (i = 0; i < no_of_nodes; i++) {
+        long int d = (long int) VECTOR(*degree)[i];
+        long int key = descending ? maxdeg - d : d;
+        VECTOR(*order)[ VECTOR(start)[key]++ ] = i;
+    }
+
+    igraph_vector_long_destroy(&start);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+static int igraph_i_reorder_rcm_cmp(void *extra, const void *a,
+                                    const void *b) {
+    const igraph_vector_t *degree = (const igraph_vector_t *) extra;
+    long int v1 = *(const long int *) a, v2 = *(const long int *) b;
+    igraph_real_t d1 = VECTOR(*degree)[v1], d2 = VECTOR(*degree)[v2];
+    if (d1 != d2) {
+        return d1 < d2 ? -1 : 1;
+    }
+    return v1 < v2 ? -1 : (v1 > v2 ? 1 : 0);
+}
+
+/* Reverse Cuthill-McKee: breadth-first search from a minimum degree
+   vertex of each component, visiting the new neighbors of a vertex in
+   increasing degree order. The order is reversed at the end. */
+
+static int igraph_i_reorder_rcm(const igraph_t *graph,
+                                const igraph_vector_t *degree,
+                                igraph_vector_long_t *order) {
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vector_long_t bydegree;
+    igraph_vector_char_t added;
+    igraph_csr_view_t view;
+    long int i, head = 0, pos = 0;
+
+    IGRAPH_CHECK(igraph_vector_long_init(&bydegree, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &bydegree);
+    IGRAPH_CHECK(igraph_vector_char_init(&added, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_char_destroy, &added);
+
+    IGRAPH_CHECK(igraph_i_reorder_by_degree(degree, &bydegree, /*descending=*/ 0));
+
+    /* 'order' is also the queue of the search */
+    for (i = 0; i < no_of_nodes; i++) {
+        long int root = VECTOR(bydegree)[i];
+        if (VECTOR(added)[root]) {
+            continue;
+        }
+        VECTOR(added)[root] = 1;
+        VECTOR(*order)[pos++] = root;
+
+        while (head < pos) {
+            long int actnode = VECTOR(*order)[head++];
+            long int first = pos;
+
+            IGRAPH_ALLOW_INTERRUPTION();
+
+            IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actnode,
+                                         IGRAPH_ALL));
+            for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+                if (!VECTOR(added)[nei]) {
+                    VECTOR(added)[nei] = 1;
+                    VECTOR(*order)[pos++] = nei;
+                }
+            }
+            if (pos - first > 1) {
+                igraph_qsort_r(VECTOR(*order) + first, (size_t) (pos - first),
+                               sizeof(long int), (void *) degree,
+                               igraph_i_reorder_rcm_cmp);
+            }
+        }
+    }
+
+    for (i = 0; i < no_of_nodes / 2; i++) {
+        long int tmp = VECTOR(*order)[i];
+        VECTOR(*order)[i] = VECTOR(*order)[no_of_nodes - 1 - i];
+        VECTOR(*order)[no_of_nodes - 1 - i] = tmp;
+    }
+
+    igraph_vector_char_destroy(&added);
+    igraph_vector_long_destroy(&bydegree);
+    IGRAPH_FINALLY_CLEAN(2);
+    return 0;
+}
+
+/* Adds 'delta' to the Gorder score of the vertices that are still in
+   the heap and are related to 'vertex': its out- and in-neighbors and
+   its siblings, i.e. the vertices that have a common in-neighbor with
+   it. In-neighbors with more than 'hub' out-neighbors are not used for
+   finding siblings, these would make the update too slow while adding
+   little information. */
+
+static int igraph_i_reorder_gorder_update(const igraph_t *graph,
+        igraph_2wheap_t *heap,
+        long int vertex, igraph_real_t delta,
+        long int hub) {
+    igraph_csr_view_t view, view2;
+
+#define ADD(v) do {                                                     \
+        long int v_ = (v);                                              \
+        if (igraph_2wheap_has_elem(heap, v_)) {                         \
+            IGRAPH_CHECK(igraph_2wheap_modify(heap, v_,                 \
+                                              igraph_2wheap_get(heap, v_) + delta)); \
+        }                                                               \
+    } while (0)
+
+    /* In undirected graphs the in-neighbors are all neighbors, so
+       these are not counted twice */
+    if (igraph_is_directed(graph)) {
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) vertex,
+                                     IGRAPH_OUT));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            ADD(IGRAPH_CSR_VIEW_NEIGHBOR(view));
+        }
+    }
+
+    IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) vertex,
+                                 IGRAPH_IN));
+    for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+        long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+        ADD(nei);
+        IGRAPH_CHECK(igraph_csr_view(graph, &view2, (igraph_integer_t) nei,
+                                     IGRAPH_OUT));
+        if (IGRAPH_CSR_VIEW_SIZE(view2) > hub) {
+            continue;
+        }
+        for (; !IGRAPH_CSR_VIEW_END(view2); IGRAPH_CSR_VIEW_NEXT(view2)) {
+            long int sibling = IGRAPH_CSR_VIEW_NEIGHBOR(view2);
+            if (sibling != vertex) {
+                ADD(sibling);
+            }
+        }
+    }
+
+#undef ADD
+
+    return 0;
+}
+
+/* Gorder: greedily place the vertex that has the highest score with
+   the last few placed vertices. The score of two vertices is the
+   number of edges between them plus the number of their common
+   in-neighbors. The fractional part of the initial key is the
+   relative degree, it breaks ties in favor of the high degree vertices
+   but never overrides a score. */
+
+static int igraph_i_reorder_gorder(const igraph_t *graph,
+                                   const igraph_vector_t *degree,
+                                   igraph_vector_long_t *order) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int hub = (long int) sqrt((double) no_of_nodes);
+    igraph_real_t maxdeg;
+    igraph_2wheap_t heap;
+    long int i;
+
+    if (no_of_nodes == 0) {
+        return 0;
+    }
+
+    maxdeg = igraph_vector_max(degree);
+    IGRAPH_CHECK(igraph_2wheap_init(&heap, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &heap);
+    for (i = 0; i < no_of_nodes; i++) {
+        IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap, i,
+                     VECTOR(*degree)[i] / (maxdeg + 1)));
+    }
+
+    for (i = 0; i < no_of_nodes; i++) {
+        long int vertex;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        igraph_2wheap_delete_max_index(&heap, &vertex);
+        VECTOR(*order)[i] = vertex;
+        IGRAPH_CHECK(igraph_i_reorder_gorder_update(graph, &heap, vertex, 1.0,
+                     hub));
+        if (i >= IGRAPH_I_GORDER_WINDOW) {
+            IGRAPH_CHECK(igraph_i_reorder_gorder_update(graph, &heap,
+                         VECTOR(*order)[i - IGRAPH_I_GORDER_WINDOW], -1.0, hub));
+        }
+    }
+
+    igraph_2wheap_destroy(&heap);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/**
+ * \function igraph_reorder_for_locality
+ * \brief Relabels the vertices to improve memory locality.
+ *
+ * </para><para>
+ * The running time of many graph algorithms, e.g. breadth-first
+ * search, PageRank and betweenness, is dominated by memory access on
+ * large sparse graphs, as they jump between the data of a vertex and
+ * its neighbors. If adjacent vertices have close vertex ids, their data
+ * are close in memory, and the caches of the processor are used much
+ * more efficiently. This function computes such a vertex ordering, it
+ * can be applied with \ref igraph_permute_vertices(), or by giving the
+ * \p res argument.
+ *
+ * </para><para>
+ * The following methods are implemented:
+ * <variablelist>
+ * <varlistentry><term><constant>IGRAPH_REORDER_RCM</constant></term>
+ * <listitem><para>The reverse Cuthill-McKee ordering: a breadth-first
+ * search from a minimum degree vertex of each component, visiting the
+ * neighbors of each vertex in increasing degree order; the order of the
+ * search is reversed at the end. This keeps the bandwidth of the
+ * adjacency matrix low, and it works well for meshes and road
+ * networks.</para></listitem></varlistentry>
+ * <varlistentry><term><constant>IGRAPH_REORDER_DEGREE</constant></term>
+ * <listitem><para>The vertices are sorted by decreasing degree, ties
+ * are broken by the original vertex ids. This is the cheapest
+ * method, it packs the hubs of scale-free graphs, which are visited
+ * most often, together.</para></listitem></varlistentry>
+ * <varlistentry><term><constant>IGRAPH_REORDER_GORDER</constant></term>
+ * <listitem><para>The Gorder method of H. Wei, J. X. Yu, C. Lu and
+ * X. Lin: Speedup graph processing by graph ordering, SIGMOD 2016.
+ * It places the vertices greedily, always choosing the vertex that
+ * has the most edges and common in-neighbors with the last five
+ * placed vertices. It is the slowest of the three, but usually gives
+ * the best locality on social and web graphs.</para></listitem></varlistentry>
+ * </variablelist>
+ *
+ * </para><para>
+ * Edge directions are ignored by \c IGRAPH_REORDER_RCM and \c
+ * IGRAPH_REORDER_DEGREE, the latter uses the total degree.
+ * \param graph The input graph.
+ * \param res Pointer to an uninitialized graph object, or a null
+ *        pointer. If not null, then the relabeled graph is created
+ *        here, with the graph, vertex and edge attributes of the
+ *        input graph. The edge ids do not change.
+ * \param permutation Pointer to an initialized vector, or a null
+ *        pointer. If not null, then the new id of each vertex is
+ *        stored here, in the format expected by \ref
+ *        igraph_permute_vertices(): the element at index \c i is the
+ *        new id of vertex \c i.
+ * \param algo The ordering method, see above.
+ * \return Error code:
+ *         \c IGRAPH_EINVAL if \p algo is invalid.
+ *
+ * Time complexity: O(|V|+|E| log d) for \c IGRAPH_REORDER_RCM, where
+ * d is the maximum degree, O(|V|+|E|) for \c IGRAPH_REORDER_DEGREE
+ * and O(sum(d_in(v) d_out(v)) log |V|) for \c IGRAPH_REORDER_GORDER.
+ *
+ * \sa \ref igraph_permute_vertices().
+ *
+ * \example examples/simple/igraph_reorder_for_locality.c
+ */
+
+int igraph_reorder_for_locality(const igraph_t *graph, igraph_t *res,
+                                igraph_vector_t *permutation,
+                                igraph_reorder_algorithm_t algo) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vector_t degree, myperm, *perm = permutation;
+    igraph_vector_long_t order;
+    long int i;
+
+    if (algo != IGRAPH_REORDER_RCM && algo != IGRAPH_REORDER_DEGREE &&
+        algo != IGRAPH_REORDER_GORDER) {
+        IGRAPH_ERROR("Invalid vertex ordering method", IGRAPH_EINVAL);
+    }
+
+    if (!perm) {
+        perm = &myperm;
+        IGRAPH_VECTOR_INIT_FINALLY(perm, no_of_nodes);
+    } else {
+        IGRAPH_CHECK(igraph_vector_resize(perm, no_of_nodes));
+    }
+
+    IGRAPH_VECTOR_INIT_FINALLY(&degree, no_of_nodes);
+    IGRAPH_CHECK(igraph_vector_long_init(&order, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_long_destroy, &order);
+
+    IGRAPH_CHECK(igraph_degree(graph, &degree, igraph_vss_all(), IGRAPH_ALL,
+                               IGRAPH_LOOPS));
+
+    switch (algo) {
+    case IGRAPH_REORDER_RCM:
+        IGRAPH_CHECK(igraph_i_reorder_rcm(graph, &degree, &order));
+        break;
+    case IGRAPH_REORDER_DEGREE:
+        IGRAPH_CHECK(igraph_i_reorder_by_degree(&degree, &order,
+                                                /*descending=*/ 1));
+        break;
+    case IGRAPH_REORDER_GORDER:
+        IGRAPH_CHECK(igraph_i_reorder_gorder(graph, &degree, &order));
+        break;
+    }
+
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(*perm)[ VECTOR(order)[i] ] = i;
+    }
+
+    if (res) {
+        IGRAPH_CHECK(igraph_permute_vertices(graph, res, perm));
+    }
+
+    igraph_vector_long_destroy(&order);
+    igraph_vector_destroy(&degree);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    if (!permutation) {
+        igraph_vector_destroy(&myperm);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    return 0;
+}
@@ -581,7 +581,7 @@ int igraph_i_maximum_bipartite_matching_weighted(const igraph_t* graph,
     IGRAPH_CHECK(igraph_adjlist_init_empty(&tight_phantom_edges,
                                            (igraph_integer_t) no_of_nodes));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &tight_phantom_edges);
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &inclist, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
     IGRAPH_VECTOR_INIT_FINALLY(&smaller_set, 0);
     IGRAPH_VECTOR_INIT_FINALLY(&larger_set, 0);
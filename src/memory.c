@@ -22,8 +22,13 @@
 */
 
 #include "igraph_memory.h"
+#include "igraph_memory_internal.h"
+#include "igraph_error.h"
+#include "igraph_threads_internal.h"
 #include "config.h"
 
+#include <string.h>
+
 /**
  * \function igraph_free
  * Deallocate memory that was allocated by igraph functions
@@ -97,3 +102,820 @@ int igraph_free(void *p) {
 void *igraph_malloc(size_t n) {
     return malloc(n);
 }
+
+/**
+ * \section about_allocators
+ * <para>The storage of vectors, matrices, double ended queues, stacks,
+ * heaps and sets, and thus most temporary memory used by the igraph
+ * functions, is allocated through the current allocator. By default
+ * this is the system allocator, i.e. <function>malloc()</function>
+ * and <function>free()</function>. A different allocator can be
+ * installed with \ref igraph_allocator_push() and removed with \ref
+ * igraph_allocator_pop(). Allocators are kept on a stack, which is
+ * per thread if igraph was compiled with thread-local storage. The
+ * worker threads of the parallel functions, see \ref
+ * about_num_threads, use the allocators of the thread that called the
+ * function; the allocator functions are never called by two threads
+ * at the same time.</para>
+ *
+ * <para>An allocator is described by an <type>igraph_allocator_t</type>
+ * structure, with the following members:
+ * <variablelist>
+ * <varlistentry><term><structfield>alloc</structfield></term>
+ * <listitem><para>Allocates the given number of bytes, like
+ * <function>malloc()</function>, it returns a null pointer if
+ * it fails. The memory does not need to be zeroed.</para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>realloc</structfield></term>
+ * <listitem><para>Resizes a piece of memory owned by the allocator,
+ * like <function>realloc()</function>.</para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>free</structfield></term>
+ * <listitem><para>Frees a piece of memory owned by the allocator.
+ * </para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>owns</structfield></term>
+ * <listitem><para>Returns non-zero if the given pointer was allocated
+ * by the allocator. Memory that is not owned by any allocator on the
+ * stack is resized and freed by the system allocator, so objects
+ * created before an allocator was pushed keep working.</para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>data</structfield></term>
+ * <listitem><para>Passed to all functions above as their first
+ * argument.</para></listitem>
+ * </varlistentry>
+ * </variablelist>
+ * The <structfield>prev</structfield> member is used by igraph to
+ * link the allocators of the stack.</para>
+ *
+ * <para>The arena allocator is an allocator that is useful when
+ * running many small computations: it hands out memory by simply
+ * advancing a pointer in large chunks, freeing memory does nothing
+ * (except for the last allocated piece, which can also be grown in
+ * place), and all memory is released at once when the arena is not
+ * needed any more. Use \ref igraph_arena_begin() and \ref
+ * igraph_arena_end() around the computation:
+ * <programlisting>
+ * igraph_arena_t arena;
+ * igraph_t g;
+ * igraph_real_t t;
+ * igraph_arena_init(&amp;arena, 0);
+ * for (i = 0; i &lt; n; i++) {
+ *     igraph_arena_begin(&amp;arena);
+ *     igraph_erdos_renyi_game(&amp;g, IGRAPH_ERDOS_RENYI_GNM, 30, 60, 0, 0);
+ *     igraph_transitivity_undirected(&amp;g, &amp;t, IGRAPH_TRANSITIVITY_ZERO);
+ *     igraph_destroy(&amp;g);
+ *     igraph_arena_end(&amp;arena);
+ *     VECTOR(res)[i] = t;
+ * }
+ * igraph_arena_destroy(&amp;arena);
+ * </programlisting>
+ * The objects created inside the arena should still be destroyed
+ * before \ref igraph_arena_end(), as some of their memory may come
+ * from the system allocator, and none of them may be used after it,
+ * not even by their destructors. This includes
+ * objects that were created before \ref igraph_arena_begin(), but got
+ * new storage inside the arena, e.g. a graph that was modified after
+ * it was copied with \ref igraph_copy(). Only plain values should
+ * leave the arena.</para>
+ */
+
+static IGRAPH_THREAD_LOCAL igraph_allocator_t *igraph_i_allocator = 0;
+
+/**
+ * \function igraph_allocator_push
+ * Install an allocator
+ *
+ * The allocator is used for all subsequent allocations made by the
+ * vector, matrix, queue, stack, heap and set types, until it is
+ * removed by \ref igraph_allocator_pop(). Memory that the allocator
+ * owns is freed through it, even if it is not the current allocator
+ * any more, as long as it is still on the stack.
+ *
+ * \param allocator The allocator, it must stay valid until it is
+ *   removed from the stack.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_allocator_push(igraph_allocator_t *allocator) {
+    allocator->prev = igraph_i_allocator;
+    igraph_i_allocator = allocator;
+}
+
+/**
+ * \function igraph_allocator_pop
+ * Remove the current allocator
+ *
+ * Removes the allocator installed by the last \ref
+ * igraph_allocator_push() call. The memory owned by the allocator
+ * must not be used by igraph functions after this.
+ *
+ * \return The removed allocator, or a null pointer, if the system
+ *   allocator was the current allocator, in which case nothing
+ *   happens.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_allocator_t *igraph_allocator_pop(void) {
+    igraph_allocator_t *allocator = igraph_i_allocator;
+    if (allocator) {
+        igraph_i_allocator = allocator->prev;
+        allocator->prev = 0;
+    }
+    return allocator;
+}
+
+static igraph_allocator_t *igraph_i_allocator_owner(const void *ptr) {
+    igraph_allocator_t *a;
+    for (a = igraph_i_allocator; a; a = a->prev) {
+        if (a->owns(a->data, ptr)) {
+            return a;
+        }
+    }
+    return 0;
+}
+
+static void *igraph_i_calloc_raw(size_t count, size_t size) {
+    igraph_allocator_t *a = igraph_i_allocator;
+    void *ptr;
+    if (!a) {
+        return calloc(count, size);
+    }
+    if (size != 0 && count > (size_t) -1 / size) {
+        return 0;
+    }
+    ptr = a->alloc(a->data, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+static void *igraph_i_realloc_raw(void *ptr, size_t size) {
+    igraph_allocator_t *a = igraph_i_allocator;
+    if (!a) {
+        return realloc(ptr, size);
+    }
+    if (!ptr) {
+        return a->alloc(a->data, size);
+    }
+    a = igraph_i_allocator_owner(ptr);
+    return a ? a->realloc(a->data, ptr, size) : realloc(ptr, size);
+}
+
+static void igraph_i_free_raw(void *ptr) {
+    igraph_allocator_t *a = igraph_i_allocator;
+    if (!a) {
+        free(ptr);
+        return;
+    }
+    if (!ptr) {
+        return;
+    }
+    a = igraph_i_allocator_owner(ptr);
+    if (a) {
+        a->free(a->data, ptr);
+    } else {
+        free(ptr);
+    }
+}
+
+/* Memory usage statistics. The active statistics form a stack, like
+   the allocators. Every statistics object keeps the size of the pieces
+   allocated while it was the innermost one in a hash table, keyed by
+   the pointer, with linear probing. When it ends, the pieces that are
+   still alive move to the enclosing statistics object. */
+
+static IGRAPH_THREAD_LOCAL igraph_memstat_t *igraph_i_memstat = 0;
+
+#define IGRAPH_I_MEMSTAT_MIN_CAPACITY 64
+
+static size_t igraph_i_memstat_hash(const void *ptr, size_t capacity) {
+    size_t h = (size_t) ptr >> 4;
+    h ^= h >> 15;
+    h *= 2654435761u;
+    h ^= h >> 13;
+    return h & (capacity - 1);
+}
+
+static void igraph_i_memstat_insert(igraph_memstat_t *stat, void *ptr,
+                                    size_t size) {
+    size_t i = igraph_i_memstat_hash(ptr, stat->capacity);
+    while (stat->ptrs[i]) {
+        i = (i + 1) & (stat->capacity - 1);
+    }
+    stat->ptrs[i] = ptr;
+    stat->sizes[i] = size;
+    stat->used++;
+}
+
+/* Makes room for 'extra' more pieces, keeping the table at most half
+   full. Returns zero if there is no memory for this. */
+
+static int igraph_i_memstat_reserve(igraph_memstat_t *stat, size_t extra) {
+    size_t capacity = stat->capacity ? stat->capacity : IGRAPH_I_MEMSTAT_MIN_CAPACITY;
+    void **oldptrs = stat->ptrs;
+    size_t *oldsizes = stat->sizes;
+    size_t i, oldcapacity = stat->capacity;
+
+    if (2 * (stat->used + extra) <= stat->capacity) {
+        return 1;
+    }
+    while (2 * (stat->used + extra) > capacity) {
+        capacity *= 2;
+    }
+    stat->ptrs = calloc(capacity, sizeof(void *));
+    stat->sizes = malloc(capacity * sizeof(size_t));
+    if (!stat->ptrs || !stat->sizes) {
+        free(stat->ptrs);
+        free(stat->sizes);
+        stat->ptrs = oldptrs;
+        stat->sizes = oldsizes;
+        return 0;
+    }
+    stat->capacity = capacity;
+    stat->used = 0;
+    for (i = 0; i < oldcapacity; i++) {
+        if (oldptrs[i]) {
+            igraph_i_memstat_insert(stat, oldptrs[i], oldsizes[i]);
+        }
+    }
+    free(oldptrs);
+    free(oldsizes);
+    return 1;
+}
+
+/* Finds the statistics object that counted 'ptr', and its position
+   in the hash table. */
+
+static igraph_memstat_t *igraph_i_memstat_find(const void *ptr, size_t *pos) {
+    igraph_memstat_t *stat;
+    for (stat = igraph_i_memstat; stat; stat = stat->prev) {
+        size_t i;
+        if (!stat->capacity) {
+            continue;
+        }
+        i = igraph_i_memstat_hash(ptr, stat->capacity);
+        while (stat->ptrs[i]) {
+            if (stat->ptrs[i] == ptr) {
+                *pos = i;
+                return stat;
+            }
+            i = (i + 1) & (stat->capacity - 1);
+        }
+    }
+    return 0;
+}
+
+/* Removes the piece at 'pos' from the hash table of 'owner', and
+   subtracts its size from the live memory of 'owner' and the objects
+   enclosing it. */
+
+static void igraph_i_memstat_remove(igraph_memstat_t *owner, size_t pos) {
+    size_t mask = owner->capacity - 1, size = owner->sizes[pos];
+    size_t i = pos, j = pos;
+    igraph_memstat_t *stat;
+
+    /* Move back the following entries of the cluster that could not
+       be found otherwise */
+    owner->ptrs[i] = 0;
+    for (;;) {
+        size_t home;
+        j = (j + 1) & mask;
+        if (!owner->ptrs[j]) {
+            break;
+        }
+        home = igraph_i_memstat_hash(owner->ptrs[j], owner->capacity);
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            owner->ptrs[i] = owner->ptrs[j];
+            owner->sizes[i] = owner->sizes[j];
+            owner->ptrs[j] = 0;
+            i = j;
+        }
+    }
+    owner->used--;
+
+    for (stat = owner; stat; stat = stat->prev) {
+        stat->live -= size;
+    }
+}
+
+/* Checks whether 'size' new bytes fit into the limits, when a piece
+   of 'oldsize' bytes counted by 'owner' is released at the same time.
+   Returns zero if they do not. */
+
+static int igraph_i_memstat_check(size_t size, const igraph_memstat_t *owner,
+                                  size_t oldsize) {
+    igraph_memstat_t *stat;
+    int released = 0;
+    for (stat = igraph_i_memstat; stat; stat = stat->prev) {
+        released = released || stat == owner;
+        if (stat->limit > 0 && (!released || size > oldsize) &&
+            stat->live + size - (released ? oldsize : 0) > stat->limit) {
+            stat->limit_reached = 1;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Counts a new piece in all statistics objects, the innermost one
+   must have room for it in its hash table. */
+
+static void igraph_i_memstat_add(void *ptr, size_t size) {
+    igraph_memstat_t *stat;
+    igraph_i_memstat_insert(igraph_i_memstat, ptr, size);
+    for (stat = igraph_i_memstat; stat; stat = stat->prev) {
+        stat->live += size;
+        stat->allocations++;
+        if (stat->live > stat->peak) {
+            stat->peak = stat->live;
+        }
+    }
+}
+
+/* Non-zero while the allocator and statistics of the thread are
+   shared with the workers of the thread pool. The lock is only taken
+   then, and only if there is an allocator or statistics to protect,
+   the system allocator is thread-safe itself. */
+
+static IGRAPH_THREAD_LOCAL int igraph_i_memory_shared = 0;
+IGRAPH_I_STATIC_MUTEX(igraph_i_memory_lock);
+
+#define IGRAPH_I_MEMORY_LOCKED() \
+    (igraph_i_memory_shared && (igraph_i_allocator || igraph_i_memstat))
+
+static void *igraph_i_calloc_unlocked(size_t count, size_t size) {
+    void *ptr;
+    if (!igraph_i_memstat) {
+        return igraph_i_calloc_raw(count, size);
+    }
+    if (size != 0 && count > (size_t) -1 / size) {
+        return 0;
+    }
+    if (!igraph_i_memstat_reserve(igraph_i_memstat, 1) ||
+        !igraph_i_memstat_check(count * size, 0, 0)) {
+        return 0;
+    }
+    ptr = igraph_i_calloc_raw(count, size);
+    if (ptr) {
+        igraph_i_memstat_add(ptr, count * size);
+    }
+    return ptr;
+}
+
+static void *igraph_i_realloc_unlocked(void *ptr, size_t size) {
+    igraph_memstat_t *owner = 0;
+    size_t pos = 0;
+    void *newptr;
+    if (!igraph_i_memstat) {
+        return igraph_i_realloc_raw(ptr, size);
+    }
+    if (!igraph_i_memstat_reserve(igraph_i_memstat, 1)) {
+        return 0;
+    }
+    if (ptr) {
+        owner = igraph_i_memstat_find(ptr, &pos);
+    }
+    if (!igraph_i_memstat_check(size, owner, owner ? owner->sizes[pos] : 0)) {
+        return 0;
+    }
+    newptr = igraph_i_realloc_raw(ptr, size);
+    if (newptr) {
+        if (owner) {
+            igraph_i_memstat_remove(owner, pos);
+        }
+        igraph_i_memstat_add(newptr, size);
+    }
+    return newptr;
+}
+
+static void igraph_i_free_unlocked(void *ptr) {
+    if (igraph_i_memstat && ptr) {
+        size_t pos;
+        igraph_memstat_t *owner = igraph_i_memstat_find(ptr, &pos);
+        if (owner) {
+            igraph_i_memstat_remove(owner, pos);
+        }
+    }
+    igraph_i_free_raw(ptr);
+}
+
+void *igraph_i_calloc(size_t count, size_t size) {
+    void *ptr;
+    if (!IGRAPH_I_MEMORY_LOCKED()) {
+        return igraph_i_calloc_unlocked(count, size);
+    }
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_memory_lock);
+    ptr = igraph_i_calloc_unlocked(count, size);
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_memory_lock);
+    return ptr;
+}
+
+void *igraph_i_realloc(void *ptr, size_t size) {
+    void *newptr;
+    if (!IGRAPH_I_MEMORY_LOCKED()) {
+        return igraph_i_realloc_unlocked(ptr, size);
+    }
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_memory_lock);
+    newptr = igraph_i_realloc_unlocked(ptr, size);
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_memory_lock);
+    return newptr;
+}
+
+void igraph_i_free(void *ptr) {
+    if (!IGRAPH_I_MEMORY_LOCKED()) {
+        igraph_i_free_unlocked(ptr);
+        return;
+    }
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_memory_lock);
+    igraph_i_free_unlocked(ptr);
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_memory_lock);
+}
+
+/* Called by the thread that submits a job to the pool, before the
+   workers start: stores its context in 'context' and locks its own
+   allocations until igraph_i_memory_unshare(). */
+
+void igraph_i_memory_share(igraph_i_memory_context_t *context) {
+    igraph_i_memory_shared++;
+    context->allocator = igraph_i_allocator;
+    context->memstat = igraph_i_memstat;
+    context->shared = igraph_i_memory_shared;
+}
+
+void igraph_i_memory_unshare(void) {
+    igraph_i_memory_shared--;
+}
+
+/* Called by a worker for the duration of a job */
+
+void igraph_i_memory_install(const igraph_i_memory_context_t *context,
+                             igraph_i_memory_context_t *saved) {
+    saved->allocator = igraph_i_allocator;
+    saved->memstat = igraph_i_memstat;
+    saved->shared = igraph_i_memory_shared;
+    igraph_i_allocator = context->allocator;
+    igraph_i_memstat = context->memstat;
+    igraph_i_memory_shared = context->shared;
+}
+
+void igraph_i_memory_restore(const igraph_i_memory_context_t *saved) {
+    igraph_i_allocator = saved->allocator;
+    igraph_i_memstat = saved->memstat;
+    igraph_i_memory_shared = saved->shared;
+}
+
+/* The arena is a list of chunks, the newest (and largest) first.
+   Every piece of memory is preceded by its size, and both the pieces
+   and their sizes are aligned to IGRAPH_I_ARENA_ALIGN bytes. */
+
+typedef struct igraph_i_arena_chunk_s {
+    struct igraph_i_arena_chunk_s *next;
+    size_t size, used;
+} igraph_i_arena_chunk_t;
+
+#define IGRAPH_I_ARENA_ALIGN 16
+#define IGRAPH_I_ARENA_ROUND(n) \
+    (((n) + IGRAPH_I_ARENA_ALIGN - 1) & ~((size_t) IGRAPH_I_ARENA_ALIGN - 1))
+#define IGRAPH_I_ARENA_HEADER IGRAPH_I_ARENA_ROUND(sizeof(size_t))
+#define IGRAPH_I_ARENA_NEED(n) (IGRAPH_I_ARENA_HEADER + IGRAPH_I_ARENA_ROUND(n))
+#define IGRAPH_I_ARENA_DATA(c) \
+    ((char *) (c) + IGRAPH_I_ARENA_ROUND(sizeof(igraph_i_arena_chunk_t)))
+#define IGRAPH_I_ARENA_SIZEOF(p) \
+    (*(size_t *) ((char *) (p) - IGRAPH_I_ARENA_HEADER))
+
+static void *igraph_i_arena_alloc(void *data, size_t size) {
+    igraph_arena_t *arena = data;
+    igraph_i_arena_chunk_t *chunk = arena->chunks;
+    size_t need;
+    char *ptr;
+
+    if (size > ((size_t) -1) / 4) {
+        return 0;
+    }
+    need = IGRAPH_I_ARENA_NEED(size);
+
+    if (!chunk || chunk->size - chunk->used < need) {
+        size_t csize = chunk ? 2 * chunk->size : arena->chunk_size;
+        while (csize < need) {
+            csize *= 2;
+        }
+        chunk = malloc(IGRAPH_I_ARENA_ROUND(sizeof(igraph_i_arena_chunk_t)) + csize);
+        if (!chunk) {
+            return 0;
+        }
+        chunk->size = csize;
+        chunk->used = 0;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    ptr = IGRAPH_I_ARENA_DATA(chunk) + chunk->used + IGRAPH_I_ARENA_HEADER;
+    IGRAPH_I_ARENA_SIZEOF(ptr) = size;
+    chunk->used += need;
+    arena->last = ptr;
+    return ptr;
+}
+
+static void *igraph_i_arena_realloc(void *data, void *ptr, size_t size) {
+    igraph_arena_t *arena = data;
+    igraph_i_arena_chunk_t *chunk = arena->chunks;
+    size_t oldsize = IGRAPH_I_ARENA_SIZEOF(ptr);
+    void *newptr;
+
+    if (ptr == arena->last && size <= ((size_t) -1) / 4) {
+        /* The last piece is at the end of the first chunk */
+        size_t base = chunk->used - IGRAPH_I_ARENA_NEED(oldsize);
+        if (chunk->size - base >= IGRAPH_I_ARENA_NEED(size)) {
+            chunk->used = base + IGRAPH_I_ARENA_NEED(size);
+            IGRAPH_I_ARENA_SIZEOF(ptr) = size;
+            return ptr;
+        }
+    } else if (size <= oldsize) {
+        return ptr;
+    }
+
+    newptr = igraph_i_arena_alloc(data, size);
+    if (newptr) {
+        memcpy(newptr, ptr, oldsize < size ? oldsize : size);
+    }
+    return newptr;
+}
+
+static void igraph_i_arena_free(void *data, void *ptr) {
+    igraph_arena_t *arena = data;
+    if (ptr == arena->last) {
+        arena->chunks->used -= IGRAPH_I_ARENA_NEED(IGRAPH_I_ARENA_SIZEOF(ptr));
+        arena->last = 0;
+    }
+}
+
+static int igraph_i_arena_owns(void *data, const void *ptr) {
+    igraph_arena_t *arena = data;
+    igraph_i_arena_chunk_t *chunk;
+    for (chunk = arena->chunks; chunk; chunk = chunk->next) {
+        const char *begin = IGRAPH_I_ARENA_DATA(chunk);
+        if ((const char *) ptr >= begin && (const char *) ptr < begin + chunk->size) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_arena_init
+ * Initialize an arena allocator
+ *
+ * No memory is allocated until the arena is first used.
+ *
+ * \param arena Pointer to an uninitialized arena object.
+ * \param chunk_size The size of the first chunk of memory requested
+ *   from the system, in bytes. Later chunks are twice as large as the
+ *   previous ones. If zero, 64 kilobytes are used.
+ * \return Error code, currently always \c IGRAPH_SUCCESS.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_arena_init(igraph_arena_t *arena, size_t chunk_size) {
+    arena->allocator.alloc = igraph_i_arena_alloc;
+    arena->allocator.realloc = igraph_i_arena_realloc;
+    arena->allocator.free = igraph_i_arena_free;
+    arena->allocator.owns = igraph_i_arena_owns;
+    arena->allocator.data = arena;
+    arena->allocator.prev = 0;
+    arena->chunks = 0;
+    arena->chunk_size = chunk_size > 0 ? chunk_size : 65536;
+    arena->last = 0;
+    return 0;
+}
+
+/**
+ * \function igraph_arena_destroy
+ * Destroy an arena allocator
+ *
+ * Frees all memory of the arena. The arena must not be the current
+ * allocator, see \ref igraph_arena_end().
+ *
+ * \param arena The arena to destroy.
+ *
+ * Time complexity: O(c), the number of chunks of the arena.
+ */
+
+void igraph_arena_destroy(igraph_arena_t *arena) {
+    while (arena->chunks) {
+        igraph_i_arena_chunk_t *next = arena->chunks->next;
+        free(arena->chunks);
+        arena->chunks = next;
+    }
+    arena->last = 0;
+}
+
+/**
+ * \function igraph_arena_begin
+ * Start allocating from an arena
+ *
+ * Makes the arena the current allocator, see \ref
+ * igraph_allocator_push().
+ *
+ * \param arena The arena.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_arena_begin(igraph_arena_t *arena) {
+    igraph_allocator_push(&arena->allocator);
+}
+
+/**
+ * \function igraph_arena_end
+ * Stop allocating from an arena and release its memory
+ *
+ * Removes the arena from the allocator stack, and releases all the
+ * memory allocated from it in one step. The largest chunk of memory
+ * is kept for the next \ref igraph_arena_begin(), so an arena that is
+ * used repeatedly for similar computations does not need to allocate
+ * memory from the system at all after the first round. None of the
+ * objects allocated from the arena may be used after this call.
+ *
+ * \param arena The arena, it must be the current allocator.
+ * \return Error code, \c IGRAPH_EINVAL if the arena is not the
+ *   current allocator.
+ *
+ * Time complexity: O(c), the number of chunks of the arena.
+ */
+
+int igraph_arena_end(igraph_arena_t *arena) {
+    if (igraph_i_allocator != &arena->allocator) {
+        IGRAPH_ERROR("Arena is not the current allocator", IGRAPH_EINVAL);
+    }
+    igraph_allocator_pop();
+
+    if (arena->chunks) {
+        igraph_i_arena_chunk_t *rest = arena->chunks->next;
+        while (rest) {
+            igraph_i_arena_chunk_t *next = rest->next;
+            free(rest);
+            rest = next;
+        }
+        arena->chunks->next = 0;
+        arena->chunks->used = 0;
+    }
+    arena->last = 0;
+    return 0;
+}
+
+/**
+ * \function igraph_arena_size
+ * The memory reserved by an arena
+ *
+ * \param arena The arena.
+ * \return The total size of the chunks of the arena, in bytes.
+ *
+ * Time complexity: O(c), the number of chunks of the arena.
+ */
+
+size_t igraph_arena_size(const igraph_arena_t *arena) {
+    igraph_i_arena_chunk_t *chunk;
+    size_t size = 0;
+    for (chunk = arena->chunks; chunk; chunk = chunk->next) {
+        size += chunk->size;
+    }
+    return size;
+}
+
+/**
+ * \section about_memstat
+ * <para>igraph can count the memory used by the vectors, matrices,
+ * queues, stacks, heaps and sets, which hold the bulk of the memory
+ * used by most igraph functions, including their temporary data.
+ * Start counting with \ref igraph_memstat_begin() and stop with \ref
+ * igraph_memstat_end(). In between, the <type>igraph_memstat_t</type>
+ * object has the following members:
+ * <variablelist>
+ * <varlistentry><term><structfield>live</structfield></term>
+ * <listitem><para>The number of bytes allocated since \ref
+ * igraph_memstat_begin() and not freed yet.</para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>peak</structfield></term>
+ * <listitem><para>The largest value of <structfield>live</structfield>
+ * so far.</para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>allocations</structfield></term>
+ * <listitem><para>The number of allocations, resizes included.
+ * </para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>limit</structfield></term>
+ * <listitem><para>The limit given to \ref igraph_memstat_begin(),
+ * zero means no limit. An allocation that would make
+ * <structfield>live</structfield> larger than the limit fails, and
+ * the igraph function that requested it returns with an
+ * \c IGRAPH_ENOMEM error.</para></listitem>
+ * </varlistentry>
+ * <varlistentry><term><structfield>limit_reached</structfield></term>
+ * <listitem><para>Non-zero if an allocation failed because of the
+ * limit. This tells the limit apart from a real out of memory
+ * condition.</para></listitem>
+ * </varlistentry>
+ * </variablelist>
+ * The values stay available after \ref igraph_memstat_end():
+ * <programlisting>
+ * igraph_memstat_t stat;
+ * int ret;
+ * igraph_memstat_begin(&amp;stat, 1024 * 1024 * 1024);
+ * ret = igraph_shortest_paths(&amp;graph, &amp;res, igraph_vss_all(), igraph_vss_all(), IGRAPH_OUT);
+ * igraph_memstat_end(&amp;stat);
+ * if (ret == IGRAPH_ENOMEM &amp;&amp; stat.limit_reached) {
+ *     printf("More than 1GB would be needed.\n");
+ * } else {
+ *     printf("Peak memory usage: %lu bytes.\n", (unsigned long) stat.peak);
+ * }
+ * </programlisting>
+ * </para>
+ *
+ * <para>Statistics can be nested, the memory counted by the inner
+ * one is also counted by the outer ones, and all limits apply.
+ * Memory allocated before \ref igraph_memstat_begin() is not counted,
+ * not even when it is freed, but if it is resized, then its new size
+ * is counted. Memory allocated directly with <function>malloc()</function>,
+ * or by third party libraries used by igraph, is not counted either.
+ * Like the allocators, the statistics are per thread if igraph was
+ * compiled with thread-local storage. The worker threads of the
+ * parallel functions, see \ref about_num_threads, count their memory
+ * in the statistics of the thread that called the function, and its
+ * limits apply to them as well.</para>
+ *
+ * <para>Counting needs a hash table lookup for every allocation, so
+ * it makes allocations slower, but it has no cost when it is not
+ * active.</para>
+ */
+
+/**
+ * \function igraph_memstat_begin
+ * Start counting memory usage
+ *
+ * \param stat The statistics object, it does not need to be
+ *   initialized. It must stay valid until \ref igraph_memstat_end()
+ *   is called.
+ * \param limit The largest number of bytes that may be allocated and
+ *   not freed while counting, zero means no limit.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_memstat_begin(igraph_memstat_t *stat, size_t limit) {
+    stat->live = stat->peak = stat->allocations = 0;
+    stat->limit = limit;
+    stat->limit_reached = 0;
+    stat->ptrs = 0;
+    stat->sizes = 0;
+    stat->capacity = stat->used = 0;
+    stat->prev = igraph_i_memstat;
+    igraph_i_memstat = stat;
+}
+
+/**
+ * \function igraph_memstat_end
+ * Stop counting memory usage
+ *
+ * Statistics must be ended in reverse order of their start. The
+ * memory counted by \p stat that is still alive will be counted by
+ * the enclosing statistics, if there is one, when it is freed.
+ *
+ * \param stat The statistics object, it must be the last one started.
+ * \return Error code, \c IGRAPH_EINVAL if \p stat is not the last
+ *   statistics object started.
+ *
+ * Time complexity: O(a), the number of allocations that are still
+ * alive.
+ */
+
+int igraph_memstat_end(igraph_memstat_t *stat) {
+    igraph_memstat_t *prev = stat->prev;
+    size_t i;
+
+    if (igraph_i_memstat != stat) {
+        IGRAPH_ERROR("Memory statistics ended in wrong order", IGRAPH_EINVAL);
+    }
+    igraph_i_memstat = prev;
+
+    /* If the enclosing table cannot grow, these pieces will not be
+       subtracted from its live memory when they are freed */
+    if (prev && stat->used > 0 && igraph_i_memstat_reserve(prev, stat->used)) {
+        for (i = 0; i < stat->capacity; i++) {
+            if (stat->ptrs[i]) {
+                igraph_i_memstat_insert(prev, stat->ptrs[i], stat->sizes[i]);
+            }
+        }
+    }
+    free(stat->ptrs);
+    free(stat->sizes);
+    stat->ptrs = 0;
+    stat->sizes = 0;
+    stat->capacity = stat->used = 0;
+    stat->prev = 0;
+    return 0;
+}
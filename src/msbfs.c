@@ -0,0 +1,243 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_msbfs_internal.h"
+#include "igraph_threads_internal.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_memory.h"
+#include "igraph_error.h"
+#include "igraph_threading.h"
+#include "config.h"
+
+#include <string.h>
+
+/* Multi-source BFS, after Then et al.: The More the Merrier: Efficient
+   Multi-Source Graph Traversal, VLDB 2014.
+
+   A batch of up to 64 breadth-first searches runs at the same time.
+   Every vertex has three bit masks: the sources that have already
+   reached it ('seen'), the sources for which it is in the current
+   frontier ('visit') and the sources that reach it in the next level
+   ('next'). The neighbors of a frontier vertex are scanned only once
+   per level for all of its sources, instead of once per source, and
+   the vertices that are at the same distance from several sources
+   are visited once. The frontier is kept as a list of vertices, so a
+   level costs the degrees of its vertices, not the number of
+   vertices. The batches are independent, and run on the thread pool. */
+
+#ifndef __GNUC__
+int igraph_i_msbfs_count(igraph_i_msbfs_mask_t mask) {
+    int count = 0;
+    while (mask) {
+        mask &= mask - 1;
+        count++;
+    }
+    return count;
+}
+
+int igraph_i_msbfs_lowest(igraph_i_msbfs_mask_t mask) {
+    int idx = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        idx++;
+    }
+    return idx;
+}
+#endif
+
+/* The largest number of batches in a parallel range */
+#define IGRAPH_I_MSBFS_MAX_GRAIN 16
+
+typedef struct {
+    const igraph_adjlist_t *adjlist;
+    const igraph_vector_t *sources;
+    igraph_real_t cutoff;
+    igraph_i_msbfs_visit_t *visit;
+    void *arg;
+} igraph_i_msbfs_data_t;
+
+typedef struct {
+    igraph_i_msbfs_mask_t *seen, *visit, *next;
+    long int *frontier, *next_frontier;
+} igraph_i_msbfs_work_t;
+
+static void igraph_i_msbfs_work_destroy(igraph_i_msbfs_work_t *work) {
+    igraph_Free(work->seen);
+    igraph_Free(work->visit);
+    igraph_Free(work->next);
+    igraph_Free(work->frontier);
+    igraph_Free(work->next_frontier);
+}
+
+static int igraph_i_msbfs_batch(const igraph_i_msbfs_data_t *data,
+                                igraph_i_msbfs_work_t *work, long int batch) {
+    const igraph_adjlist_t *adjlist = data->adjlist;
+    long int first = batch * IGRAPH_I_MSBFS_WIDTH;
+    long int last = first + IGRAPH_I_MSBFS_WIDTH;
+    long int no_of_frontier = 0, no_of_next;
+    long int i, j, k, dist = 0;
+    igraph_i_msbfs_mask_t *seen = work->seen, *visit = work->visit,
+                           *next = work->next, *tmp_mask;
+    long int *frontier = work->frontier, *next_frontier = work->next_frontier,
+              *tmp_list;
+
+    if (last > igraph_vector_size(data->sources)) {
+        last = igraph_vector_size(data->sources);
+    }
+
+    /* A vertex may be given several times as a source */
+    for (k = first; k < last; k++) {
+        long int source = (long int) VECTOR(*data->sources)[k];
+        igraph_i_msbfs_mask_t bit = ((igraph_i_msbfs_mask_t) 1) << (k - first);
+        if (!visit[source]) {
+            frontier[no_of_frontier++] = source;
+        }
+        visit[source] |= bit;
+        seen[source] |= bit;
+    }
+    for (i = 0; i < no_of_frontier; i++) {
+        IGRAPH_CHECK(data->visit(data->arg, batch, frontier[i],
+                                 visit[frontier[i]], 0));
+    }
+
+    while (no_of_frontier > 0 && (data->cutoff <= 0 || dist < data->cutoff)) {
+        no_of_next = 0;
+        for (i = 0; i < no_of_frontier; i++) {
+            long int actnode = frontier[i];
+            igraph_i_msbfs_mask_t actmask = visit[actnode];
+            igraph_vector_int_t *neis = igraph_adjlist_get(adjlist, actnode);
+            long int n = igraph_vector_int_size(neis);
+            for (j = 0; j < n; j++) {
+                long int nei = VECTOR(*neis)[j];
+                igraph_i_msbfs_mask_t newmask = actmask & ~seen[nei];
+                if (newmask) {
+                    if (!next[nei]) {
+                        next_frontier[no_of_next++] = nei;
+                    }
+                    next[nei] |= newmask;
+                }
+            }
+            visit[actnode] = 0;
+        }
+
+        dist++;
+        for (i = 0; i < no_of_next; i++) {
+            long int nei = next_frontier[i];
+            seen[nei] |= next[nei];
+            IGRAPH_CHECK(data->visit(data->arg, batch, nei, next[nei], dist));
+        }
+
+        /* The next level becomes the frontier, and the cleared masks
+           of the old frontier are used for the following level */
+        tmp_mask = visit; visit = next; next = tmp_mask;
+        tmp_list = frontier; frontier = next_frontier; next_frontier = tmp_list;
+        no_of_frontier = no_of_next;
+    }
+
+    /* Reset the workspace for the next batch */
+    for (i = 0; i < no_of_frontier; i++) {
+        visit[frontier[i]] = 0;
+    }
+    memset(seen, 0, sizeof(igraph_i_msbfs_mask_t) * (size_t) adjlist->length);
+    work->visit = visit;
+    work->next = next;
+    work->frontier = frontier;
+    work->next_frontier = next_frontier;
+
+    return 0;
+}
+
+static int igraph_i_msbfs_range(void *arg, long int from, long int to) {
+    igraph_i_msbfs_data_t *data = arg;
+    long int no_of_nodes = data->adjlist->length;
+    igraph_i_msbfs_work_t work;
+    long int batch;
+
+    work.seen = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1,
+                              igraph_i_msbfs_mask_t);
+    work.visit = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1,
+                               igraph_i_msbfs_mask_t);
+    work.next = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1,
+                              igraph_i_msbfs_mask_t);
+    work.frontier = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, long int);
+    work.next_frontier = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1,
+                                       long int);
+    IGRAPH_FINALLY(igraph_i_msbfs_work_destroy, &work);
+    if (!work.seen || !work.visit || !work.next || !work.frontier ||
+        !work.next_frontier) {
+        IGRAPH_ERROR("Multi-source BFS failed", IGRAPH_ENOMEM);
+    }
+
+    for (batch = from; batch < to; batch++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_i_msbfs_batch(data, &work, batch));
+    }
+
+    igraph_i_msbfs_work_destroy(&work);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* Batches for every thread in a round of igraph_i_msbfs_round() */
+#define IGRAPH_I_MSBFS_ROUND_BATCHES 4
+
+long int igraph_i_msbfs_round(void) {
+    return IGRAPH_I_MSBFS_WIDTH * IGRAPH_I_MSBFS_ROUND_BATCHES *
+           igraph_get_num_threads();
+}
+
+/* Runs a breadth-first search from every vertex of 'sources', the
+   search does not continue from vertices whose distance is 'cutoff'
+   or more, unless it is zero or negative. 'visit' is called for the
+   reached vertices. The batches run in parallel in thread-safe builds,
+   if igraph_set_num_threads() allows it. */
+
+int igraph_i_msbfs(const igraph_adjlist_t *adjlist,
+                   const igraph_vector_t *sources, igraph_real_t cutoff,
+                   igraph_i_msbfs_visit_t *visit, void *arg) {
+    igraph_i_msbfs_data_t data;
+    long int no_of_sources = igraph_vector_size(sources);
+    long int no_of_batches = (no_of_sources + IGRAPH_I_MSBFS_WIDTH - 1) /
+                             IGRAPH_I_MSBFS_WIDTH;
+    long int grain;
+
+    data.adjlist = adjlist;
+    data.sources = sources;
+    data.cutoff = cutoff;
+    data.visit = visit;
+    data.arg = arg;
+
+    /* Every range allocates its own workspace, so the ranges have a
+       few batches, but there are still several ranges per thread to
+       balance the load */
+    grain = no_of_batches / (4 * igraph_get_num_threads());
+    if (grain < 1) {
+        grain = 1;
+    } else if (grain > IGRAPH_I_MSBFS_MAX_GRAIN) {
+        grain = IGRAPH_I_MSBFS_MAX_GRAIN;
+    }
+    IGRAPH_CHECK(igraph_i_parallel_for(no_of_batches, grain,
+                                       igraph_i_msbfs_range, &data));
+
+    return 0;
+}
@@ -969,9 +969,9 @@ int igraph_difference(igraph_t *res,
 
     IGRAPH_VECTOR_INIT_FINALLY(&edge_ids, 0);
     IGRAPH_VECTOR_INIT_FINALLY(&edges, 0);
-    IGRAPH_CHECK(igraph_inclist_init(orig, &inc_orig, IGRAPH_OUT));
+    IGRAPH_CHECK(igraph_inclist_init_flat(orig, &inc_orig, IGRAPH_OUT));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inc_orig);
-    IGRAPH_CHECK(igraph_inclist_init(sub, &inc_sub, IGRAPH_OUT));
+    IGRAPH_CHECK(igraph_inclist_init_flat(sub, &inc_sub, IGRAPH_OUT));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inc_sub);
 
     smaller_nodes = no_of_nodes_orig > no_of_nodes_sub ?
@@ -21,12 +21,17 @@
 
 */
 
+#include "igraph_paths.h"
 #include "igraph_interface.h"
 #include "igraph_interrupt_internal.h"
 #include "igraph_vector_ptr.h"
 #include "igraph_iterators.h"
 #include "igraph_adjlist.h"
 #include "igraph_stack.h"
+#include "igraph_dqueue.h"
+#include "igraph_memory.h"
+#include "igraph_types_internal.h"
+#include "igraph_trace_internal.h"
 
 /**
  * \function igraph_get_all_simple_paths
@@ -173,3 +178,584 @@ int igraph_get_all_simple_paths(const igraph_t *graph,
 
     return 0;
 }
+
+
+/* -------------------------------------------------- */
+/* Point-to-point shortest paths                      */
+/* -------------------------------------------------- */
+
+/* The parent arrays of the searches below: zero if the vertex was not
+   reached yet, one for the root of the search, otherwise the id of
+   the edge from which the vertex was reached, plus two. */
+
+/* Creates the path from the two search trees, 'fparent' is rooted at
+   the source, 'bparent' at the target, and 'meet' is in both of
+   them. For a single search tree, 'bparent' is zero and 'meet' is the
+   target. */
+
+static int igraph_i_p2p_path(const igraph_t *graph,
+                             igraph_vector_t *vertices,
+                             igraph_vector_t *edges,
+                             const long int *fparent,
+                             const long int *bparent,
+                             long int meet) {
+    long int act, flen = 0, blen = 0, pos;
+
+    for (act = meet; fparent[act] != 1; flen++) {
+        act = IGRAPH_OTHER(graph, fparent[act] - 2, act);
+    }
+    for (act = meet; bparent && bparent[act] != 1; blen++) {
+        act = IGRAPH_OTHER(graph, bparent[act] - 2, act);
+    }
+
+    if (vertices) {
+        IGRAPH_CHECK(igraph_vector_resize(vertices, flen + blen + 1));
+        VECTOR(*vertices)[flen] = meet;
+    }
+    if (edges) {
+        IGRAPH_CHECK(igraph_vector_resize(edges, flen + blen));
+    }
+
+    /* From the meeting point back to the source */
+    for (act = meet, pos = flen; pos > 0; pos--) {
+        long int edge = fparent[act] - 2;
+        act = IGRAPH_OTHER(graph, edge, act);
+        if (vertices) {
+            VECTOR(*vertices)[pos - 1] = act;
+        }
+        if (edges) {
+            VECTOR(*edges)[pos - 1] = edge;
+        }
+    }
+
+    /* And on to the target */
+    for (act = meet, pos = flen; pos < flen + blen; pos++) {
+        long int edge = bparent[act] - 2;
+        act = IGRAPH_OTHER(graph, edge, act);
+        if (vertices) {
+            VECTOR(*vertices)[pos + 1] = act;
+        }
+        if (edges) {
+            VECTOR(*edges)[pos] = edge;
+        }
+    }
+
+    return 0;
+}
+
+static int igraph_i_p2p_unreachable(igraph_vector_t *vertices,
+                                    igraph_vector_t *edges) {
+    IGRAPH_WARNING("Couldn't reach some vertices");
+    if (vertices) {
+        igraph_vector_clear(vertices);
+    }
+    if (edges) {
+        igraph_vector_clear(edges);
+    }
+    return 0;
+}
+
+/* The mode of the search from the target */
+
+static igraph_neimode_t igraph_i_p2p_reverse(const igraph_t *graph,
+        igraph_neimode_t mode) {
+    if (!igraph_is_directed(graph) || mode == IGRAPH_ALL) {
+        return IGRAPH_ALL;
+    }
+    return mode == IGRAPH_OUT ? IGRAPH_IN : IGRAPH_OUT;
+}
+
+static int igraph_i_p2p_check(const igraph_t *graph,
+                              igraph_integer_t from, igraph_integer_t to,
+                              const igraph_vector_t *weights,
+                              igraph_neimode_t mode) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+
+    if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes) {
+        IGRAPH_ERROR("Cannot get shortest path", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+            IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_get_shortest_path
+ * Shortest path from one vertex to another one.
+ *
+ * Calculates and returns a single unweighted shortest path from a
+ * given vertex to another one. If there are more than one shortest
+ * paths between the two vertices, then an arbitrary one is returned.
+ *
+ * </para><para>
+ * Two breadth-first searches are run at the same time, one from
+ * \p from and one backwards from \p to, always extending the one
+ * with the smaller frontier, until they meet. This usually visits
+ * far fewer vertices than a search from \p from only, see \ref
+ * igraph_get_shortest_paths() for the version with more target
+ * vertices.
+ *
+ * \param graph The input graph, it can be directed or
+ *        undirected. Directed paths are considered in directed
+ *        graphs.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices.
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \param mode A constant specifying how edge directions are
+ *        considered in directed graphs. Valid modes are:
+ *        \c IGRAPH_OUT, follows edge directions;
+ *        \c IGRAPH_IN, follows the opposite directions; and
+ *        \c IGRAPH_ALL, ignores edge directions. This argument is
+ *        ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges in the graph, in the worst case.
+ *
+ * \sa \ref igraph_get_shortest_paths() for the version with more target
+ * vertices.
+ */
+
+int igraph_get_shortest_path(const igraph_t *graph,
+                             igraph_vector_t *vertices,
+                             igraph_vector_t *edges,
+                             igraph_integer_t from,
+                             igraph_integer_t to,
+                             igraph_neimode_t mode) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_neimode_t rmode = igraph_i_p2p_reverse(graph, mode);
+    long int *fparent, *bparent;
+    igraph_dqueue_long_t fq, bq;
+    igraph_csr_view_t view;
+    long int meet = -1;
+
+    IGRAPH_CHECK(igraph_i_p2p_check(graph, from, to, 0, mode));
+
+    fparent = igraph_Calloc(no_of_nodes, long int);
+    if (fparent == 0) {
+        IGRAPH_ERROR("Cannot get shortest path", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, fparent);
+    bparent = igraph_Calloc(no_of_nodes, long int);
+    if (bparent == 0) {
+        IGRAPH_ERROR("Cannot get shortest path", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, bparent);
+    IGRAPH_CHECK(igraph_dqueue_long_init(&fq, 100));
+    IGRAPH_FINALLY(igraph_dqueue_long_destroy, &fq);
+    IGRAPH_CHECK(igraph_dqueue_long_init(&bq, 100));
+    IGRAPH_FINALLY(igraph_dqueue_long_destroy, &bq);
+
+    fparent[(long int) from] = 1;
+    bparent[(long int) to] = 1;
+    IGRAPH_CHECK(igraph_dqueue_long_push(&fq, from));
+    IGRAPH_CHECK(igraph_dqueue_long_push(&bq, to));
+    if (from == to) {
+        meet = from;
+    }
+
+    /* A whole level of the smaller frontier is processed at a
+       time. Before it, the vertices reached from the source are
+       closer than k+1 to it, the ones reached from the target closer
+       than j+1 to the target, and no vertex is reached from both
+       sides, so the path is longer than k+j. The first vertex that is
+       reached from both sides gives a path of length k+j+1. */
+    while (meet < 0 && !igraph_dqueue_long_empty(&fq) &&
+           !igraph_dqueue_long_empty(&bq)) {
+        igraph_bool_t forward = igraph_dqueue_long_size(&fq) <=
+                                igraph_dqueue_long_size(&bq);
+        igraph_dqueue_long_t *q = forward ? &fq : &bq;
+        long int *parent = forward ? fparent : bparent;
+        long int *other = forward ? bparent : fparent;
+        long int n = igraph_dqueue_long_size(q);
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        while (n-- > 0 && meet < 0) {
+            long int act = igraph_dqueue_long_pop(q);
+            IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) act,
+                                         forward ? mode : rmode));
+            view.merge = 0;
+            IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+            IGRAPH_I_TRACE_ADD(relaxed_edges, IGRAPH_CSR_VIEW_SIZE(view));
+            for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                long int edge = IGRAPH_CSR_VIEW_EDGE(view);
+                long int nei = IGRAPH_OTHER(graph, edge, act);
+                if (parent[nei] != 0) {
+                    continue;
+                }
+                parent[nei] = edge + 2;
+                if (other[nei] != 0) {
+                    meet = nei;
+                    break;
+                }
+                IGRAPH_CHECK(igraph_dqueue_long_push(q, nei));
+            }
+        }
+    }
+
+    if (meet >= 0) {
+        IGRAPH_CHECK(igraph_i_p2p_path(graph, vertices, edges, fparent,
+                                       bparent, meet));
+    } else {
+        IGRAPH_CHECK(igraph_i_p2p_unreachable(vertices, edges));
+    }
+
+    igraph_dqueue_long_destroy(&bq);
+    igraph_dqueue_long_destroy(&fq);
+    igraph_Free(bparent);
+    igraph_Free(fparent);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    IGRAPH_I_TRACE_REPORT("igraph_get_shortest_path");
+
+    return 0;
+}
+
+/**
+ * \function igraph_get_shortest_path_dijkstra
+ * Weighted shortest path from one vertex to another one.
+ *
+ * Calculates a single (positively) weighted shortest path from
+ * a single vertex to another one, using a bidirectional version of
+ * Dijkstra's algorithm.
+ *
+ * </para><para>
+ * Dijkstra's algorithm is run from \p from and backwards from \p to
+ * at the same time, always extending the search with fewer vertices
+ * in its queue. They stop when the sum of the distances of the next
+ * vertices to process is not smaller than the shortest path found
+ * through a vertex reached by both of them. This usually visits far
+ * fewer vertices than a search from \p from only. If there are
+ * several shortest paths, any of them may be returned.
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices.
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \param weights Vector of edge weights, in the order of edge
+ *        ids. They must be non-negative, otherwise the algorithm does
+ *        not work. If a null pointer, then the unweighted \ref
+ *        igraph_get_shortest_path() is called.
+ * \param mode A constant specifying how edge directions are
+ *        considered in directed graphs. \c IGRAPH_OUT follows edge
+ *        directions, \c IGRAPH_IN follows the opposite directions,
+ *        and \c IGRAPH_ALL ignores edge directions. This argument is
+ *        ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(|E|log|E|+|V|), |V| is the number of vertices,
+ * |E| is the number of edges in the graph, in the worst case.
+ *
+ * \sa \ref igraph_get_shortest_paths_dijkstra() for the version with
+ * more target vertices, \ref igraph_get_shortest_path_astar() if a
+ * lower bound of the distances is known.
+ */
+
+int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
+                                      igraph_vector_t *vertices,
+                                      igraph_vector_t *edges,
+                                      igraph_integer_t from,
+                                      igraph_integer_t to,
+                                      const igraph_vector_t *weights,
+                                      igraph_neimode_t mode) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_neimode_t rmode = igraph_i_p2p_reverse(graph, mode);
+    long int *fparent, *bparent;
+    igraph_vector_t fdist, bdist;
+    igraph_2wheap_t fQ, bQ;
+    igraph_csr_view_t view;
+    igraph_real_t best = IGRAPH_INFINITY;
+    long int meet = -1;
+
+    if (!weights) {
+        return igraph_get_shortest_path(graph, vertices, edges, from, to, mode);
+    }
+
+    IGRAPH_CHECK(igraph_i_p2p_check(graph, from, to, weights, mode));
+
+    fparent = igraph_Calloc(no_of_nodes, long int);
+    if (fparent == 0) {
+        IGRAPH_ERROR("Cannot get shortest path", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, fparent);
+    bparent = igraph_Calloc(no_of_nodes, long int);
+    if (bparent == 0) {
+        IGRAPH_ERROR("Cannot get shortest path", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, bparent);
+    IGRAPH_VECTOR_INIT_FINALLY(&fdist, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&bdist, no_of_nodes);
+    IGRAPH_CHECK(igraph_2wheap_init(&fQ, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &fQ);
+    IGRAPH_CHECK(igraph_2wheap_init(&bQ, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &bQ);
+
+    /* The heaps are maximum heaps, they contain the opposite of the
+       distances. The distances are also kept in 'fdist' and 'bdist',
+       as they are needed after a vertex left the heap. */
+    fparent[(long int) from] = 1;
+    bparent[(long int) to] = 1;
+    IGRAPH_CHECK(igraph_2wheap_push_with_index(&fQ, from, 0.0));
+    IGRAPH_CHECK(igraph_2wheap_push_with_index(&bQ, to, 0.0));
+    if (from == to) {
+        meet = from;
+        best = 0.0;
+    }
+
+    while (!igraph_2wheap_empty(&fQ) && !igraph_2wheap_empty(&bQ)) {
+        igraph_bool_t forward;
+        igraph_2wheap_t *Q;
+        long int *parent, *other;
+        igraph_real_t *dist, *otherdist;
+        long int minnei;
+        igraph_real_t mindist;
+
+        /* No path through an unprocessed vertex can be shorter */
+        if (-igraph_2wheap_max(&fQ) - igraph_2wheap_max(&bQ) >= best) {
+            break;
+        }
+
+        forward = igraph_2wheap_size(&fQ) <= igraph_2wheap_size(&bQ);
+        Q = forward ? &fQ : &bQ;
+        parent = forward ? fparent : bparent;
+        other = forward ? bparent : fparent;
+        dist = VECTOR(forward ? fdist : bdist);
+        otherdist = VECTOR(forward ? bdist : fdist);
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        minnei = igraph_2wheap_max_index(Q);
+        mindist = -igraph_2wheap_deactivate_max(Q);
+
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) minnei,
+                                     forward ? mode : rmode));
+        view.merge = 0;
+        IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+        IGRAPH_I_TRACE_ADD(relaxed_edges, IGRAPH_CSR_VIEW_SIZE(view));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            long int edge = IGRAPH_CSR_VIEW_EDGE(view);
+            long int tto = IGRAPH_OTHER(graph, edge, minnei);
+            igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
+            if (parent[tto] == 0) {
+                /* This is the first non-infinite distance */
+                IGRAPH_CHECK(igraph_2wheap_push_with_index(Q, tto, -altdist));
+            } else if (igraph_2wheap_has_active(Q, tto) && altdist < dist[tto]) {
+                /* This is a shorter path */
+                IGRAPH_CHECK(igraph_2wheap_modify(Q, tto, -altdist));
+            } else {
+                continue;
+            }
+            parent[tto] = edge + 2;
+            dist[tto] = altdist;
+            if (other[tto] != 0 && altdist + otherdist[tto] < best) {
+                best = altdist + otherdist[tto];
+                meet = tto;
+            }
+        }
+    }
+
+    if (meet >= 0) {
+        IGRAPH_CHECK(igraph_i_p2p_path(graph, vertices, edges, fparent,
+                                       bparent, meet));
+    } else {
+        IGRAPH_CHECK(igraph_i_p2p_unreachable(vertices, edges));
+    }
+
+    igraph_2wheap_destroy(&bQ);
+    igraph_2wheap_destroy(&fQ);
+    igraph_vector_destroy(&bdist);
+    igraph_vector_destroy(&fdist);
+    igraph_Free(bparent);
+    igraph_Free(fparent);
+    IGRAPH_FINALLY_CLEAN(6);
+
+    IGRAPH_I_TRACE_REPORT("igraph_get_shortest_path_dijkstra");
+
+    return 0;
+}
+
+/**
+ * \function igraph_get_shortest_path_astar
+ * Shortest path from one vertex to another one, with the A* algorithm.
+ *
+ * Calculates a single (positively) weighted shortest path from
+ * a single vertex to another one, using the A* algorithm of Hart,
+ * Nilsson and Raphael. It is Dijkstra's algorithm, but the vertices
+ * are processed in the order of their distance from \p from plus a
+ * lower bound of their distance to \p to, given by the \p heuristic
+ * function. The better the bounds, the fewer vertices are visited
+ * before \p to is reached, e.g. the straight line distance between
+ * the coordinates of the vertices is a good bound for road networks,
+ * if the weights are lengths.
+ *
+ * </para><para>
+ * The result is a shortest path only if the heuristic never
+ * overestimates the distance to \p to. If it is also consistent,
+ * i.e. the estimate for a vertex is at most the weight of an edge
+ * to a neighbor plus the estimate for the neighbor, then every
+ * vertex is processed at most once.
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices.
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \param weights Vector of edge weights, in the order of edge
+ *        ids. They must be non-negative. If a null pointer, then
+ *        every edge has weight one.
+ * \param mode A constant specifying how edge directions are
+ *        considered in directed graphs. \c IGRAPH_OUT follows edge
+ *        directions, \c IGRAPH_IN follows the opposite directions,
+ *        and \c IGRAPH_ALL ignores edge directions. This argument is
+ *        ignored for undirected graphs.
+ * \param heuristic The function that estimates the distance of a
+ *        vertex to \p to, see \ref igraph_astar_heuristic_func_t.
+ *        It is called at most once for every vertex. If a null
+ *        pointer, then all estimates are zero and this is Dijkstra's
+ *        algorithm, stopping when \p to is reached.
+ * \param extra Extra argument to pass to \p heuristic.
+ * \return Error code. \c IGRAPH_EINVAL if the heuristic returns a
+ *        negative or NaN estimate.
+ *
+ * Time complexity: O(|E|log|E|+|V|), |V| is the number of vertices,
+ * |E| is the number of edges in the graph, in the worst case, with a
+ * consistent heuristic, plus the time of the calls to \p heuristic.
+ *
+ * \sa \ref igraph_get_shortest_path_dijkstra() if there is no known
+ * bound.
+ */
+
+int igraph_get_shortest_path_astar(const igraph_t *graph,
+                                   igraph_vector_t *vertices,
+                                   igraph_vector_t *edges,
+                                   igraph_integer_t from,
+                                   igraph_integer_t to,
+                                   const igraph_vector_t *weights,
+                                   igraph_neimode_t mode,
+                                   igraph_astar_heuristic_func_t *heuristic,
+                                   void *extra) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int *parent;
+    igraph_vector_t dist, estimate;
+    igraph_2wheap_t Q;
+    igraph_csr_view_t view;
+    igraph_bool_t found = 0;
+
+    IGRAPH_CHECK(igraph_i_p2p_check(graph, from, to, weights, mode));
+
+    parent = igraph_Calloc(no_of_nodes, long int);
+    if (parent == 0) {
+        IGRAPH_ERROR("Cannot get shortest path", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, parent);
+    IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&estimate, no_of_nodes);
+    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+
+    /* The heap contains the opposite of the distance plus the
+       estimate. A processed vertex may be put back into the heap if
+       a shorter path is found to it later, this only happens if the
+       heuristic is not consistent. */
+    parent[(long int) from] = 1;
+    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, from, 0.0));
+
+    while (!igraph_2wheap_empty(&Q)) {
+        long int minnei = igraph_2wheap_max_index(&Q);
+        igraph_real_t mindist;
+
+        igraph_2wheap_deactivate_max(&Q);
+        if (minnei == to) {
+            found = 1;
+            break;
+        }
+        mindist = VECTOR(dist)[minnei];
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) minnei,
+                                     mode));
+        view.merge = 0;
+        IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+        IGRAPH_I_TRACE_ADD(relaxed_edges, IGRAPH_CSR_VIEW_SIZE(view));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            long int edge = IGRAPH_CSR_VIEW_EDGE(view);
+            long int tto = IGRAPH_OTHER(graph, edge, minnei);
+            igraph_real_t altdist = mindist +
+                                    (weights ? VECTOR(*weights)[edge] : 1.0);
+            if (parent[tto] == 0) {
+                /* This is the first non-infinite distance */
+                igraph_real_t h = 0.0;
+                if (heuristic) {
+                    IGRAPH_CHECK(heuristic(&h, (igraph_integer_t) tto, to, extra));
+                    if (!(h >= 0)) {
+                        IGRAPH_ERROR("Heuristic must return a non-negative "
+                                     "estimate", IGRAPH_EINVAL);
+                    }
+                }
+                VECTOR(estimate)[tto] = h;
+                IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -(altdist + h)));
+            } else if (altdist >= VECTOR(dist)[tto] || tto == from) {
+                continue;
+            } else if (igraph_2wheap_has_active(&Q, tto)) {
+                /* This is a shorter path */
+                IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto,
+                                                  -(altdist + VECTOR(estimate)[tto])));
+            } else {
+                /* A shorter path to a processed vertex */
+                IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto,
+                             -(altdist + VECTOR(estimate)[tto])));
+            }
+            parent[tto] = edge + 2;
+            VECTOR(dist)[tto] = altdist;
+        }
+    }
+
+    if (found) {
+        IGRAPH_CHECK(igraph_i_p2p_path(graph, vertices, edges, parent, 0, to));
+    } else {
+        IGRAPH_CHECK(igraph_i_p2p_unreachable(vertices, edges));
+    }
+
+    igraph_2wheap_destroy(&Q);
+    igraph_vector_destroy(&estimate);
+    igraph_vector_destroy(&dist);
+    igraph_Free(parent);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    IGRAPH_I_TRACE_REPORT("igraph_get_shortest_path_astar");
+
+    return 0;
+}
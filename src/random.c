@@ -28,6 +28,15 @@
 #include <math.h>
 #include <limits.h>
 #include <string.h>
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#else
+    #ifdef HAVE_SYS_INT_TYPES_H
+        #include <sys/int_types.h>
+    #else
+        #include "pstdint.h"
+    #endif
+#endif
 #include "igraph_math.h"
 #include "igraph_types.h"
 #include "igraph_vector.h"
@@ -110,6 +119,23 @@
  * </para>
  * </section>
  *
+ * <section><title>Threads and parallel computations</title>
+ * <para>
+ * If igraph was compiled with thread-local storage, then every thread
+ * has its own default generator, so the randomized igraph functions
+ * can run in several threads at the same time. The default generator
+ * of each thread must be seeded separately for reproducible results.
+ * </para>
+ *
+ * <para>
+ * To get the same random numbers in a parallel computation, no matter
+ * how many threads are used and how the work is distributed among
+ * them, use a counter-based generator, \ref igraph_rngtype_philox,
+ * and give every unit of work its own stream with \ref
+ * igraph_rng_split().
+ * </para>
+ * </section>
+ *
  * <section><title>Example</title>
  * <para>
  * \example examples/simple/random_seed.c
@@ -480,9 +506,187 @@ const igraph_rng_type_t igraph_rngtype_mt19937 = {
 
 /* ------------------------------------ */
 
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+
+/* The first two words of the counter are the number of the block
+   within the stream, the last two are the number of the stream. Every
+   block gives four 32 bit numbers. */
+
+typedef struct {
+    uint32_t key[2];
+    uint64_t stream;
+    uint64_t pos;      /* the number of the next output word */
+    uint64_t block;    /* the block in 'output', if 'valid' */
+    uint32_t output[4];
+    int valid;
+} igraph_i_rng_philox_state_t;
+
+static void igraph_i_rng_philox_block(const uint32_t *key,
+                                      const uint32_t *counter,
+                                      uint32_t *out) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    int round;
+
+    for (round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+        uint32_t hi0 = (uint32_t) (p0 >> 32), lo0 = (uint32_t) p0;
+        uint32_t hi1 = (uint32_t) (p1 >> 32), lo1 = (uint32_t) p1;
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+unsigned long int igraph_rng_philox_get(void *vstate) {
+    igraph_i_rng_philox_state_t *state = vstate;
+    uint64_t block = state->pos >> 2;
+
+    if (!state->valid || state->block != block) {
+        uint32_t counter[4];
+        counter[0] = (uint32_t) block;
+        counter[1] = (uint32_t) (block >> 32);
+        counter[2] = (uint32_t) state->stream;
+        counter[3] = (uint32_t) (state->stream >> 32);
+        igraph_i_rng_philox_block(state->key, counter, state->output);
+        state->block = block;
+        state->valid = 1;
+    }
+
+    return state->output[(state->pos++) & 3];
+}
+
+igraph_real_t igraph_rng_philox_get_real(void *vstate) {
+    return igraph_rng_philox_get(vstate) / 4294967296.0;
+}
+
+int igraph_rng_philox_seed(void *vstate, unsigned long int seed) {
+    igraph_i_rng_philox_state_t *state = vstate;
+    state->key[0] = (uint32_t) seed;
+    state->key[1] = (uint32_t) (((uint64_t) seed) >> 32);
+    state->stream = 0;
+    state->pos = 0;
+    state->valid = 0;
+    return 0;
+}
+
+int igraph_rng_philox_jump(void *vstate, unsigned long int n) {
+    igraph_i_rng_philox_state_t *state = vstate;
+    state->pos += n;
+    return 0;
+}
+
+/* The stream of the child is a bijective mix of the stream number,
+   combined with the stream of the parent, and mixed again, so that
+   different streams of the same parent never coincide, and splitting
+   a stream again does not lead back to an earlier one. */
+
+static uint64_t igraph_i_rng_philox_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+int igraph_rng_philox_split(const void *vstate, void *vchild,
+                            unsigned long int stream) {
+    const igraph_i_rng_philox_state_t *state = vstate;
+    igraph_i_rng_philox_state_t *child = vchild;
+    child->key[0] = state->key[0];
+    child->key[1] = state->key[1];
+    child->stream = igraph_i_rng_philox_mix(state->stream ^
+                                            igraph_i_rng_philox_mix((uint64_t) stream + 1));
+    child->pos = 0;
+    child->valid = 0;
+    return 0;
+}
+
+int igraph_rng_philox_init(void **state) {
+    igraph_i_rng_philox_state_t *st;
+
+    st = igraph_Calloc(1, igraph_i_rng_philox_state_t);
+    if (!st) {
+        IGRAPH_ERROR("Cannot initialize RNG", IGRAPH_ENOMEM);
+    }
+    (*state) = st;
+
+    igraph_rng_philox_seed(st, 0);
+
+    return 0;
+}
+
+void igraph_rng_philox_destroy(void *vstate) {
+    igraph_i_rng_philox_state_t *state =
+        (igraph_i_rng_philox_state_t*) vstate;
+    igraph_Free(state);
+}
+
+/**
+ * \var igraph_rngtype_philox
+ * \brief The Philox4x32-10 counter-based random number generator
+ *
+ * Philox is a counter-based generator: the n-th random number is
+ * computed directly from n and the seed, by a bijective function of
+ * ten rounds of multiplications and exclusive ors. This makes it
+ * possible to skip ahead in the sequence in constant time, see \ref
+ * igraph_rng_jump(), and to create a practically unlimited number of
+ * independent streams from a single seed, see \ref
+ * igraph_rng_split(). Parallel computations can use a separate stream
+ * for each unit of work, e.g. for each vertex, and their results do
+ * not depend on the number of threads or on the order in which the
+ * work is done.
+ *
+ * The generator has a period of 2^66 within each of the 2^64 streams,
+ * its state is a few words, and it passes the BigCrush tests of the
+ * TestU01 suite. The seed is used as the 64 bit key of the generator,
+ * so 32 bit long integers only give 2^32 different keys.
+ *
+ * For more information see,
+ * John K. Salmon, Mark A. Moraes, Ron O. Dror and David E. Shaw,
+ * “Parallel random numbers: as easy as 1, 2, 3”. Proceedings of the
+ * International Conference for High Performance Computing,
+ * Networking, Storage and Analysis (SC11), 2011.
+ */
+
+const igraph_rng_type_t igraph_rngtype_philox = {
+    /* name= */      "PHILOX",
+    /* min=  */      0,
+    /* max=  */      0xffffffffUL,
+    /* init= */      igraph_rng_philox_init,
+    /* destroy= */   igraph_rng_philox_destroy,
+    /* seed= */      igraph_rng_philox_seed,
+    /* get= */       igraph_rng_philox_get,
+    /* get_real= */  igraph_rng_philox_get_real,
+    /* get_norm= */  0,
+    /* get_geom= */  0,
+    /* get_binom= */ 0,
+    /* get_exp= */   0,
+    /* get_gamma= */ 0,
+    /* jump= */      igraph_rng_philox_jump,
+    /* split= */     igraph_rng_philox_split
+};
+
+#undef PHILOX_M0
+#undef PHILOX_M1
+#undef PHILOX_W0
+#undef PHILOX_W1
+
+/* ------------------------------------ */
+
 #ifndef USING_R
 
-igraph_i_rng_mt19937_state_t igraph_i_rng_default_state;
+static IGRAPH_THREAD_LOCAL igraph_i_rng_mt19937_state_t igraph_i_rng_default_state;
 
 #define addr(a) (&a)
 
@@ -498,11 +702,16 @@ igraph_i_rng_mt19937_state_t igraph_i_rng_default_state;
  *
  * You can change the default generator using the \ref
  * igraph_rng_set_default() function.
+ *
+ * If igraph was compiled with thread-local storage, then every thread
+ * has its own default generator, with its own state. The address of
+ * a thread-local state is not a constant, so the state is filled in
+ * by \ref igraph_rng_default() when it is first called in a thread.
  */
 
 IGRAPH_THREAD_LOCAL igraph_rng_t igraph_i_rng_default = {
     addr(igraph_rngtype_mt19937),
-    addr(igraph_i_rng_default_state),
+    /* state= */ 0,
     /* def= */ 1
 };
 
@@ -627,6 +836,11 @@ IGRAPH_THREAD_LOCAL igraph_rng_t igraph_i_rng_default = {
  */
 
 igraph_rng_t *igraph_rng_default() {
+#ifndef USING_R
+    if (!igraph_i_rng_default.state) {
+        igraph_i_rng_default.state = &igraph_i_rng_default_state;
+    }
+#endif
     return &igraph_i_rng_default;
 }
 
@@ -740,6 +954,101 @@ const char *igraph_rng_name(igraph_rng_t *rng) {
     return type->name;
 }
 
+/**
+ * \function igraph_rng_jump
+ * Skip random numbers
+ *
+ * Advances the generator as if \p n random integers were generated
+ * with it. This is done in constant time for the generators that
+ * support it, e.g. \ref igraph_rngtype_philox, and by generating the
+ * numbers for the others.
+ *
+ * </para><para>
+ * Note that some functions, e.g. \ref igraph_rng_get_normal(), may
+ * use more than one integer from the generator for one random number.
+ *
+ * \param rng The RNG.
+ * \param n The number of integers to skip.
+ * \return Error code.
+ *
+ * Time complexity: O(1) for generators that support it, O(n)
+ * otherwise.
+ */
+
+int igraph_rng_jump(igraph_rng_t *rng, unsigned long int n) {
+    const igraph_rng_type_t *type = rng->type;
+    unsigned long int i;
+    if (type->jump) {
+        IGRAPH_CHECK(type->jump(rng->state, n));
+    } else {
+        for (i = 0; i < n; i++) {
+            type->get(rng->state);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_rng_split
+ * Create an independent stream of random numbers
+ *
+ * Initializes a new generator of the same type as \p rng, which
+ * generates a stream of random numbers that is independent of the
+ * stream of \p rng, and of the streams created with other \p stream
+ * numbers. The new stream only depends on the seed and the stream of
+ * \p rng, and on \p stream, but not on the state of \p rng, so
+ * splitting does not change \p rng, and gives the same result every
+ * time. Streams can be split further.
+ *
+ * </para><para>
+ * This makes it possible to do randomized computations in parallel,
+ * with results that do not depend on the number of threads: use a
+ * separate stream for each unit of work, numbered by the unit, not by
+ * the thread:
+ * <programlisting>
+ * igraph_rng_t rng, stream;
+ * igraph_rng_init(&amp;rng, &amp;igraph_rngtype_philox);
+ * igraph_rng_seed(&amp;rng, 42);
+ * // in parallel, for every vertex v:
+ *     igraph_rng_split(&amp;rng, &amp;stream, v);
+ *     ... igraph_rng_get_unif01(&amp;stream) ...
+ *     igraph_rng_destroy(&amp;stream);
+ * </programlisting>
+ *
+ * </para><para>
+ * Only generators without a global state can be split, currently
+ * this is \ref igraph_rngtype_philox.
+ *
+ * \param rng The RNG to split.
+ * \param child Pointer to an uninitialized RNG, the new stream is
+ *    created here. Destroy it with \ref igraph_rng_destroy() when it
+ *    is not needed any more.
+ * \param stream The number of the stream.
+ * \return Error code: \c IGRAPH_UNIMPLEMENTED if the type of
+ *    \p rng does not support splitting, \c IGRAPH_ENOMEM if there is
+ *    not enough memory for the new generator.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_rng_split(igraph_rng_t *rng, igraph_rng_t *child,
+                     unsigned long int stream) {
+    const igraph_rng_type_t *type = rng->type;
+    int ret;
+    if (!type->split) {
+        IGRAPH_ERROR("Random number generator cannot be split",
+                     IGRAPH_UNIMPLEMENTED);
+    }
+    IGRAPH_CHECK(igraph_rng_init(child, type));
+    ret = type->split(rng->state, child->state, stream);
+    if (ret) {
+        igraph_rng_destroy(child);
+        IGRAPH_ERROR("Cannot split random number generator", ret);
+    }
+    child->def = 0;
+    return 0;
+}
+
 /**
  * \function igraph_rng_get_integer
  * Generate an integer random number from an interval
@@ -54,8 +54,7 @@
  *   to contain the actual interrupted walk.
  * \return Error code.
  *
- * Time complexity: O(l + d), where \c l is the length of the
- * walk, and \c d is the total degree of the visited nodes.
+ * Time complexity: O(l), where \c l is the length of the walk.
  */
 
 
@@ -69,7 +68,6 @@ int igraph_random_walk(const igraph_t *graph, igraph_vector_t *walk,
        - weights
     */
 
-    igraph_lazy_adjlist_t adj;
     igraph_integer_t vc = igraph_vcount(graph);
     igraph_integer_t i;
 
@@ -80,20 +78,20 @@ int igraph_random_walk(const igraph_t *graph, igraph_vector_t *walk,
         IGRAPH_ERROR("Invalid number of steps", IGRAPH_EINVAL);
     }
 
-    IGRAPH_CHECK(igraph_lazy_adjlist_init(graph, &adj, mode,
-                                          IGRAPH_DONT_SIMPLIFY));
-    IGRAPH_FINALLY(igraph_lazy_adjlist_destroy, &adj);
-
     IGRAPH_CHECK(igraph_vector_resize(walk, steps));
 
     RNG_BEGIN();
 
     VECTOR(*walk)[0] = start;
     for (i = 1; i < steps; i++) {
-        igraph_vector_t *neis;
-        igraph_integer_t nn;
-        neis = igraph_lazy_adjlist_get(&adj, start);
-        nn = igraph_vector_size(neis);
+        igraph_csr_view_t view;
+        long int nout, nn, r;
+
+        /* The view reads the neighbors straight from the graph, there
+           is no need to cache them */
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, start, mode));
+        nout = view.out_end - view.out;
+        nn = IGRAPH_CSR_VIEW_SIZE(view);
 
         if (IGRAPH_UNLIKELY(nn == 0)) {
             igraph_vector_resize(walk, i);
@@ -103,14 +101,14 @@ int igraph_random_walk(const igraph_t *graph, igraph_vector_t *walk,
                 IGRAPH_ERROR("Random walk got stuck", IGRAPH_ERWSTUCK);
             }
         }
-        start = VECTOR(*walk)[i] = VECTOR(*neis)[ RNG_INTEGER(0, nn - 1) ];
+        r = RNG_INTEGER(0, nn - 1);
+        start = (igraph_integer_t) (r < nout ? view.to[view.out[r]] :
+                                    view.from[view.in[r - nout]]);
+        VECTOR(*walk)[i] = start;
     }
 
     RNG_END();
 
-    igraph_lazy_adjlist_destroy(&adj);
-    IGRAPH_FINALLY_CLEAN(1);
-
     return 0;
 }
 
@@ -197,7 +195,7 @@ int igraph_random_edge_walk(const igraph_t *graph,
 
     IGRAPH_CHECK(igraph_vector_resize(edgewalk, steps));
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &il, mode));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &il, mode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &il);
 
     IGRAPH_VECTOR_INIT_FINALLY(&weight_temp, 0);
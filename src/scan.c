@@ -130,7 +130,7 @@ int igraph_i_local_scan_1_directed(const igraph_t *graph,
 
     igraph_vector_int_t neis;
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &incs, mode));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &incs, mode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &incs);
 
     igraph_vector_int_init(&neis, no_of_nodes);
@@ -190,7 +190,7 @@ int igraph_i_local_scan_1_directed_all(const igraph_t *graph,
 
     igraph_vector_int_t neis;
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &incs, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &incs, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_inclist_destroy, &incs);
 
     igraph_vector_int_init(&neis, no_of_nodes);
@@ -284,7 +284,7 @@ int igraph_i_local_scan_1_sumweights(const igraph_t *graph,
         VECTOR(rank)[ VECTOR(order)[i] ] = no_of_nodes - i - 1;
     }
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &allinc, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &allinc, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_inclist_destroy, &allinc);
     IGRAPH_CHECK(igraph_i_trans4_il_simplify(graph, &allinc, &rank));
 
@@ -510,10 +510,10 @@ int igraph_local_scan_1_ecount_them(const igraph_t *us, const igraph_t *them,
                      IGRAPH_EINVAL);
     }
 
-    igraph_adjlist_init(us, &adj_us, mode);
+    igraph_adjlist_init_flat(us, &adj_us, mode);
     IGRAPH_FINALLY(igraph_adjlist_destroy, &adj_us);
     igraph_adjlist_simplify(&adj_us);
-    igraph_inclist_init(them, &incs_them, mode);
+    igraph_inclist_init_flat(them, &incs_them, mode);
     IGRAPH_FINALLY(igraph_inclist_destroy, &incs_them);
 
     igraph_vector_int_init(&neis, no_of_nodes);
@@ -628,7 +628,7 @@ int igraph_local_scan_k_ecount(const igraph_t *graph, int k,
     IGRAPH_FINALLY(igraph_dqueue_int_destroy, &Q);
     IGRAPH_CHECK(igraph_vector_int_init(&marked, no_of_nodes));
     IGRAPH_FINALLY(igraph_vector_int_destroy, &marked);
-    IGRAPH_CHECK(igraph_inclist_init(graph, &incs, mode));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &incs, mode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &incs);
 
     IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
@@ -733,9 +733,9 @@ int igraph_local_scan_k_ecount_them(const igraph_t *us, const igraph_t *them,
     IGRAPH_FINALLY(igraph_dqueue_int_destroy, &Q);
     IGRAPH_CHECK(igraph_vector_int_init(&marked, no_of_nodes));
     IGRAPH_FINALLY(igraph_vector_int_destroy, &marked);
-    IGRAPH_CHECK(igraph_inclist_init(us, &incs_us, mode));
+    IGRAPH_CHECK(igraph_inclist_init_flat(us, &incs_us, mode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &incs_us);
-    IGRAPH_CHECK(igraph_inclist_init(them, &incs_them, mode));
+    IGRAPH_CHECK(igraph_inclist_init_flat(them, &incs_them, mode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &incs_them);
     IGRAPH_CHECK(igraph_stack_int_init(&ST, 100));
     IGRAPH_FINALLY(igraph_stack_int_destroy, &ST);
@@ -835,7 +835,7 @@ int igraph_local_scan_neighborhood_ecount(const igraph_t *graph,
 
     IGRAPH_CHECK(igraph_vector_int_init(&marked, no_of_nodes));
     IGRAPH_FINALLY(igraph_vector_int_destroy, &marked);
-    IGRAPH_CHECK(igraph_inclist_init(graph, &incs, IGRAPH_OUT));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &incs, IGRAPH_OUT));
     IGRAPH_FINALLY(igraph_inclist_destroy, &incs);
 
     IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
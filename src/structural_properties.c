@@ -41,7 +41,11 @@
 #include "igraph_attributes.h"
 #include "igraph_neighborhood.h"
 #include "igraph_topology.h"
+#include "igraph_visitor.h"
 #include "igraph_qsort.h"
+#include "igraph_trace_internal.h"
+#include "igraph_msbfs_internal.h"
+#include "igraph_deltastep_internal.h"
 #include "config.h"
 #include "structural_properties_internal.h"
 
@@ -118,7 +122,7 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
     IGRAPH_FINALLY(igraph_free, already_added);
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, dirmode));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &allneis, dirmode));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
     for (i = 0; i < no_of_nodes; i++) {
@@ -226,18 +230,38 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
  * \example examples/simple/igraph_average_path_length.c
  */
 
+/* The partial sums of the path lengths and the number of paths are
+   collected for every batch of sources, and added in the order of the
+   batches, so the result does not depend on the number of threads */
+
+typedef struct {
+    igraph_real_t *sums, *counts;
+} igraph_i_average_path_length_data_t;
+
+static int igraph_i_average_path_length_visit(void *arg, long int batch,
+        long int vertex, igraph_i_msbfs_mask_t reached, long int dist) {
+    igraph_i_average_path_length_data_t *data = arg;
+    IGRAPH_UNUSED(vertex);
+    if (dist > 0) {
+        int count = IGRAPH_I_MSBFS_COUNT(reached);
+        data->sums[batch] += (igraph_real_t) count * dist;
+        data->counts[batch] += count;
+    }
+    return 0;
+}
+
 int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
                                igraph_bool_t directed, igraph_bool_t unconn) {
     long int no_of_nodes = igraph_vcount(graph);
-    long int i, j, n;
-    long int *already_added;
-    long int nodes_reached = 0;
+    long int no_of_batches = (no_of_nodes + IGRAPH_I_MSBFS_WIDTH - 1) /
+                             IGRAPH_I_MSBFS_WIDTH;
+    long int i;
     igraph_real_t normfact = 0.0;
 
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
+    igraph_vector_t sources, sums, counts;
     igraph_neimode_t dirmode;
     igraph_adjlist_t allneis;
+    igraph_i_average_path_length_data_t data;
 
     *res = 0;
     if (directed) {
@@ -245,51 +269,34 @@ int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
     } else {
         dirmode = IGRAPH_ALL;
     }
-    already_added = igraph_Calloc(no_of_nodes, long int);
-    if (already_added == 0) {
-        IGRAPH_ERROR("average path length failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(free, already_added); /* TODO: hack */
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-
-    igraph_adjlist_init(graph, &allneis, dirmode);
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
+    IGRAPH_VECTOR_INIT_FINALLY(&sources, no_of_nodes);
     for (i = 0; i < no_of_nodes; i++) {
-        nodes_reached = 0;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        already_added[i] = i + 1;
-
-        IGRAPH_ALLOW_INTERRUPTION();
+        VECTOR(sources)[i] = i;
+    }
+    IGRAPH_VECTOR_INIT_FINALLY(&sums, no_of_batches);
+    IGRAPH_VECTOR_INIT_FINALLY(&counts, no_of_batches);
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &allneis, dirmode));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
-            neis = igraph_adjlist_get(&allneis, actnode);
-            n = igraph_vector_int_size(neis);
-            for (j = 0; j < n; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (already_added[neighbor] == i + 1) {
-                    continue;
-                }
-                already_added[neighbor] = i + 1;
-                nodes_reached++;
-                *res += actdist + 1;
-                normfact += 1;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-            }
-        } /* while !igraph_dqueue_empty */
+    data.sums = VECTOR(sums);
+    data.counts = VECTOR(counts);
+    IGRAPH_CHECK(igraph_i_msbfs(&allneis, &sources, /*cutoff=*/ 0,
+                                igraph_i_average_path_length_visit, &data));
 
-        /* not connected, return largest possible */
-        if (!unconn) {
-            *res += (no_of_nodes * (no_of_nodes - 1 - nodes_reached));
-            normfact += no_of_nodes - 1 - nodes_reached;
-        }
-    } /* for i<no_of_nodes */
+    for (i = 0; i < no_of_batches; i++) {
+        *res += VECTOR(sums)[i];
+        normfact += VECTOR(counts)[i];
+    }
 
+    /* not connected, return largest possible */
+    if (!unconn) {
+        igraph_real_t unreachable =
+            (igraph_real_t) no_of_nodes * (no_of_nodes - 1) - normfact;
+        *res += no_of_nodes * unreachable;
+        normfact += unreachable;
+    }
 
     if (normfact > 0) {
         *res /= normfact;
@@ -298,10 +305,11 @@ int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
     }
 
     /* clean */
-    igraph_Free(already_added);
-    igraph_dqueue_destroy(&q);
     igraph_adjlist_destroy(&allneis);
-    IGRAPH_FINALLY_CLEAN(3);
+    igraph_vector_destroy(&counts);
+    igraph_vector_destroy(&sums);
+    igraph_vector_destroy(&sources);
+    IGRAPH_FINALLY_CLEAN(4);
 
     return 0;
 }
@@ -333,20 +341,45 @@ int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
  * \sa \ref igraph_average_path_length() and \ref igraph_shortest_paths()
  */
 
+/* The sources are searched in rounds, every batch of a round counts
+   the distances in its own column of 'hists', and records the largest
+   one. The columns are allocated by the calling thread, they are long
+   enough for any distance, so the searches only write into them. The
+   calling thread adds them to the result after every round. */
+
+typedef struct {
+    igraph_matrix_t hists;
+    igraph_vector_long_t maxdist;
+} igraph_i_path_length_hist_data_t;
+
+static void igraph_i_path_length_hist_data_destroy(
+        igraph_i_path_length_hist_data_t *data) {
+    igraph_matrix_destroy(&data->hists);
+    igraph_vector_long_destroy(&data->maxdist);
+}
+
+static int igraph_i_path_length_hist_visit(void *arg, long int batch,
+        long int vertex, igraph_i_msbfs_mask_t reached, long int dist) {
+    igraph_i_path_length_hist_data_t *data = arg;
+    IGRAPH_UNUSED(vertex);
+    if (dist > 0) {
+        MATRIX(data->hists, dist - 1, batch) += IGRAPH_I_MSBFS_COUNT(reached);
+        VECTOR(data->maxdist)[batch] = dist;
+    }
+    return 0;
+}
+
 int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
                             igraph_real_t *unconnected, igraph_bool_t directed) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    long int i, j, n;
-    igraph_vector_long_t already_added;
-    long int nodes_reached;
-
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
+    long int round = igraph_i_msbfs_round();
+    long int start, i, j;
+    igraph_vector_t sources, round_sources;
+    igraph_i_path_length_hist_data_t data;
     igraph_neimode_t dirmode;
     igraph_adjlist_t allneis;
-    igraph_real_t unconn = 0;
-    long int ressize;
+    igraph_real_t unconn, reached = 0;
 
     if (directed) {
         dirmode = IGRAPH_OUT;
@@ -354,68 +387,64 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
         dirmode = IGRAPH_ALL;
     }
 
-    IGRAPH_CHECK(igraph_vector_long_init(&already_added, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_long_destroy, &already_added);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, dirmode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
-
-    IGRAPH_CHECK(igraph_vector_resize(res, 0));
-    ressize = 0;
-
+    IGRAPH_VECTOR_INIT_FINALLY(&sources, no_of_nodes);
     for (i = 0; i < no_of_nodes; i++) {
-        nodes_reached = 1;      /* itself */
-        IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        VECTOR(already_added)[i] = i + 1;
+        VECTOR(sources)[i] = i;
+    }
+    IGRAPH_CHECK(igraph_matrix_init(&data.hists,
+                                    no_of_nodes > 1 ? no_of_nodes - 1 : 0,
+                                    round / IGRAPH_I_MSBFS_WIDTH));
+    IGRAPH_FINALLY(igraph_matrix_destroy, &data.hists);
+    IGRAPH_CHECK(igraph_vector_long_init(&data.maxdist,
+                                         round / IGRAPH_I_MSBFS_WIDTH));
+    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FINALLY(igraph_i_path_length_hist_data_destroy, &data);
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &allneis, dirmode));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
-        IGRAPH_PROGRESS("Path-hist: ", 100.0 * i / no_of_nodes, NULL);
+    igraph_vector_clear(res);
 
-        IGRAPH_ALLOW_INTERRUPTION();
+    IGRAPH_PROGRESS("Path-hist: ", 0.0, NULL);
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
+    for (start = 0; start < no_of_nodes; start += round) {
+        long int size = no_of_nodes - start < round ? no_of_nodes - start : round;
+        long int no_of_batches = (size + IGRAPH_I_MSBFS_WIDTH - 1) /
+                                 IGRAPH_I_MSBFS_WIDTH;
 
-            neis = igraph_adjlist_get(&allneis, actnode);
-            n = igraph_vector_int_size(neis);
-            for (j = 0; j < n; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (VECTOR(already_added)[neighbor] == i + 1) {
-                    continue;
-                }
-                VECTOR(already_added)[neighbor] = i + 1;
-                nodes_reached++;
-                if (actdist + 1 > ressize) {
-                    IGRAPH_CHECK(igraph_vector_resize(res, actdist + 1));
-                    for (; ressize < actdist + 1; ressize++) {
-                        VECTOR(*res)[ressize] = 0;
-                    }
-                }
-                VECTOR(*res)[actdist] += 1;
+        igraph_vector_view(&round_sources, VECTOR(sources) + start, size);
+        IGRAPH_CHECK(igraph_i_msbfs(&allneis, &round_sources, /*cutoff=*/ 0,
+                                    igraph_i_path_length_hist_visit, &data));
 
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
+        for (i = 0; i < no_of_batches; i++) {
+            long int maxdist = VECTOR(data.maxdist)[i];
+            while (igraph_vector_size(res) < maxdist) {
+                IGRAPH_CHECK(igraph_vector_push_back(res, 0));
             }
-        } /* while !igraph_dqueue_empty */
-
-        unconn += (no_of_nodes - nodes_reached);
+            for (j = 0; j < maxdist; j++) {
+                VECTOR(*res)[j] += MATRIX(data.hists, j, i);
+                reached += MATRIX(data.hists, j, i);
+                MATRIX(data.hists, j, i) = 0;
+            }
+            VECTOR(data.maxdist)[i] = 0;
+        }
 
-    } /* for i<no_of_nodes */
+        IGRAPH_PROGRESS("Path-hist: ", 100.0 * (start + size) / no_of_nodes,
+                        NULL);
+    }
 
-    IGRAPH_PROGRESS("Path-hist: ", 100.0, NULL);
+    unconn = (igraph_real_t) no_of_nodes * (no_of_nodes - 1) - reached;
 
     /* count every pair only once for an undirected graph */
     if (!directed || !igraph_is_directed(graph)) {
-        for (i = 0; i < ressize; i++) {
+        for (i = 0; i < igraph_vector_size(res); i++) {
             VECTOR(*res)[i] /= 2;
         }
         unconn /= 2;
     }
 
-    igraph_vector_long_destroy(&already_added);
-    igraph_dqueue_destroy(&q);
     igraph_adjlist_destroy(&allneis);
+    igraph_i_path_length_hist_data_destroy(&data);
+    igraph_vector_destroy(&sources);
     IGRAPH_FINALLY_CLEAN(3);
 
     if (unconnected) {
@@ -476,6 +505,31 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
  * \ref igraph_shortest_paths_dijkstra() for the weighted version.
  */
 
+/* Several sources share the traversals of the graph, the rows of the
+   sources are written by the thread of their batch */
+
+typedef struct {
+    igraph_matrix_t *res;
+    const igraph_vector_t *indexv;
+} igraph_i_shortest_paths_data_t;
+
+static int igraph_i_shortest_paths_visit(void *arg, long int batch,
+        long int vertex, igraph_i_msbfs_mask_t reached, long int dist) {
+    igraph_i_shortest_paths_data_t *data = arg;
+    long int row = batch * IGRAPH_I_MSBFS_WIDTH, col = vertex;
+    if (data->indexv) {
+        if (!VECTOR(*data->indexv)[vertex]) {
+            return 0;
+        }
+        col = (long int) VECTOR(*data->indexv)[vertex] - 1;
+    }
+    while (reached) {
+        MATRIX(*data->res, row + IGRAPH_I_MSBFS_LOWEST(reached), col) = dist;
+        reached &= reached - 1;
+    }
+    return 0;
+}
+
 int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
                           const igraph_vs_t from, const igraph_vs_t to,
                           igraph_neimode_t mode) {
@@ -502,16 +556,6 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
     IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
     no_of_from = IGRAPH_VIT_SIZE(fromvit);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-
-    already_counted = igraph_Calloc(no_of_nodes, long int);
-    if (already_counted == 0) {
-        IGRAPH_ERROR("shortest paths failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(free, already_counted);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-
     if ( (all_to = igraph_vs_is_all(&to)) ) {
         no_of_to = no_of_nodes;
     } else {
@@ -532,44 +576,87 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
     IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
     igraph_matrix_fill(res, my_infinity);
 
-    for (IGRAPH_VIT_RESET(fromvit), i = 0;
-         !IGRAPH_VIT_END(fromvit);
-         IGRAPH_VIT_NEXT(fromvit), i++) {
-        long int reached = 0;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(fromvit)));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        already_counted[ (long int) IGRAPH_VIT_GET(fromvit) ] = i + 1;
+    if (no_of_from > 1) {
+        /* A multi-source BFS from all sources */
+        igraph_vector_t sources;
+        igraph_i_shortest_paths_data_t data;
+        IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, mode));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+        IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+        IGRAPH_CHECK(igraph_vit_as_vector(&fromvit, &sources));
+        data.res = res;
+        data.indexv = all_to ? 0 : &indexv;
+        IGRAPH_CHECK(igraph_i_msbfs(&adjlist, &sources, /*cutoff=*/ 0,
+                                    igraph_i_shortest_paths_visit, &data));
+        igraph_vector_destroy(&sources);
+        igraph_adjlist_destroy(&adjlist);
+        IGRAPH_FINALLY_CLEAN(2);
+    } else if (no_of_from == 1 && all_to) {
+        /* All distances from one vertex, the direction-optimizing
+           search needs no adjacency list */
+        igraph_vector_t dist;
+        IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
+        IGRAPH_CHECK(igraph_bfs_distances(graph, &dist, /*father=*/ 0,
+                                          IGRAPH_VIT_GET(fromvit), mode,
+                                          IGRAPH_BFS_DIRECTION_OPTIMIZING));
+        IGRAPH_CHECK(igraph_matrix_set_row(res, &dist, 0));
+        igraph_vector_destroy(&dist);
+        IGRAPH_FINALLY_CLEAN(1);
+    } else if (no_of_from == 1) {
+        /* A single BFS, it stops when all 'to' vertices are reached */
+        IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &adjlist, mode));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+        already_counted = igraph_Calloc(no_of_nodes, long int);
+        if (already_counted == 0) {
+            IGRAPH_ERROR("shortest paths failed", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(free, already_counted);
+        IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
+
+        for (IGRAPH_VIT_RESET(fromvit), i = 0;
+             !IGRAPH_VIT_END(fromvit);
+             IGRAPH_VIT_NEXT(fromvit), i++) {
+            long int reached = 0;
+            IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(fromvit)));
+            IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
+            already_counted[ (long int) IGRAPH_VIT_GET(fromvit) ] = i + 1;
 
-        IGRAPH_ALLOW_INTERRUPTION();
+            IGRAPH_ALLOW_INTERRUPTION();
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int act = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
+            while (!igraph_dqueue_empty(&q)) {
+                long int act = (long int) igraph_dqueue_pop(&q);
+                long int actdist = (long int) igraph_dqueue_pop(&q);
 
-            if (all_to) {
-                MATRIX(*res, i, act) = actdist;
-            } else {
-                if (VECTOR(indexv)[act]) {
-                    MATRIX(*res, i, (long int)(VECTOR(indexv)[act] - 1)) = actdist;
-                    reached++;
-                    if (reached == no_of_to) {
-                        igraph_dqueue_clear(&q);
-                        break;
+                if (all_to) {
+                    MATRIX(*res, i, act) = actdist;
+                } else {
+                    if (VECTOR(indexv)[act]) {
+                        MATRIX(*res, i, (long int)(VECTOR(indexv)[act] - 1)) = actdist;
+                        reached++;
+                        if (reached == no_of_to) {
+                            igraph_dqueue_clear(&q);
+                            break;
+                        }
                     }
                 }
-            }
 
-            neis = igraph_adjlist_get(&adjlist, act);
-            for (j = 0; j < igraph_vector_int_size(neis); j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (already_counted[neighbor] == i + 1) {
-                    continue;
+                neis = igraph_adjlist_get(&adjlist, act);
+                for (j = 0; j < igraph_vector_int_size(neis); j++) {
+                    long int neighbor = (long int) VECTOR(*neis)[j];
+                    if (already_counted[neighbor] == i + 1) {
+                        continue;
+                    }
+                    already_counted[neighbor] = i + 1;
+                    IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
+                    IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
                 }
-                already_counted[neighbor] = i + 1;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
             }
         }
+
+        igraph_dqueue_destroy(&q);
+        igraph_Free(already_counted);
+        igraph_adjlist_destroy(&adjlist);
+        IGRAPH_FINALLY_CLEAN(3);
     }
 
     /* Clean */
@@ -579,11 +666,8 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
         IGRAPH_FINALLY_CLEAN(2);
     }
 
-    igraph_Free(already_counted);
-    igraph_dqueue_destroy(&q);
     igraph_vit_destroy(&fromvit);
-    igraph_adjlist_destroy(&adjlist);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_FINALLY_CLEAN(1);
 
     return 0;
 }
@@ -684,7 +768,7 @@ int igraph_get_shortest_paths(const igraph_t *graph,
     igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
 
     long int i, j;
-    igraph_vector_t tmp = IGRAPH_VECTOR_NULL;
+    igraph_csr_view_t view;
 
     igraph_vit_t vit;
 
@@ -714,7 +798,6 @@ int igraph_get_shortest_paths(const igraph_t *graph,
         IGRAPH_ERROR("cannot get shortest paths", IGRAPH_ENOMEM);
     }
     IGRAPH_FINALLY(igraph_free, father);
-    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
     /* Mark the vertices we need to reach */
@@ -750,9 +833,10 @@ int igraph_get_shortest_paths(const igraph_t *graph,
     while (!igraph_dqueue_empty(&q) && reached < to_reach) {
         long int act = (long int) igraph_dqueue_pop(&q) - 1;
 
-        IGRAPH_CHECK(igraph_incident(graph, &tmp, (igraph_integer_t) act, mode));
-        for (j = 0; j < igraph_vector_size(&tmp); j++) {
-            long int edge = (long int) VECTOR(tmp)[j];
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) act, mode));
+        view.merge = 0;     /* same order as igraph_incident() */
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            long int edge = IGRAPH_CSR_VIEW_EDGE(view);
             long int neighbor = IGRAPH_OTHER(graph, edge, act);
             if (father[neighbor] > 0) {
                 continue;
@@ -854,87 +938,8 @@ int igraph_get_shortest_paths(const igraph_t *graph,
     /* Clean */
     igraph_Free(father);
     igraph_dqueue_destroy(&q);
-    igraph_vector_destroy(&tmp);
     igraph_vit_destroy(&vit);
-    IGRAPH_FINALLY_CLEAN(4);
-
-    return 0;
-}
-
-/**
- * \function igraph_get_shortest_path
- * Shortest path from one vertex to another one.
- *
- * Calculates and returns a single unweighted shortest path from a
- * given vertex to another one. If there are more than one shortest
- * paths between the two vertices, then an arbitrary one is returned.
- *
- * </para><para>This function is a wrapper to \ref
- * igraph_get_shortest_paths(), for the special case when only one
- * target vertex is considered.
- * \param graph The input graph, it can be directed or
- *        undirected. Directed paths are considered in directed
- *        graphs.
- * \param vertices Pointer to an initialized vector or a null
- *        pointer. If not a null pointer, then the vertex ids along
- *        the path are stored here, including the source and target
- *        vertices.
- * \param edges Pointer to an uninitialized vector or a null
- *        pointer. If not a null pointer, then the edge ids along the
- *        path are stored here.
- * \param from The id of the source vertex.
- * \param to The id of the target vertex.
- * \param mode A constant specifying how edge directions are
- *        considered in directed graphs. Valid modes are:
- *        \c IGRAPH_OUT, follows edge directions;
- *        \c IGRAPH_IN, follows the opposite directions; and
- *        \c IGRAPH_ALL, ignores edge directions. This argument is
- *        ignored for undirected graphs.
- * \return Error code.
- *
- * Time complexity: O(|V|+|E|), linear in the number of vertices and
- * edges in the graph.
- *
- * \sa \ref igraph_get_shortest_paths() for the version with more target
- * vertices.
- */
-
-int igraph_get_shortest_path(const igraph_t *graph,
-                             igraph_vector_t *vertices,
-                             igraph_vector_t *edges,
-                             igraph_integer_t from,
-                             igraph_integer_t to,
-                             igraph_neimode_t mode) {
-
-    igraph_vector_ptr_t vertices2, *vp = &vertices2;
-    igraph_vector_ptr_t edges2, *ep = &edges2;
-
-    if (vertices) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&vertices2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &vertices2);
-        VECTOR(vertices2)[0] = vertices;
-    } else {
-        vp = 0;
-    }
-    if (edges) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&edges2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &edges2);
-        VECTOR(edges2)[0] = edges;
-    } else {
-        ep = 0;
-    }
-
-    IGRAPH_CHECK(igraph_get_shortest_paths(graph, vp, ep, from,
-                                           igraph_vss_1(to), mode, 0, 0));
-
-    if (edges) {
-        igraph_vector_ptr_destroy(&edges2);
-        IGRAPH_FINALLY_CLEAN(1);
-    }
-    if (vertices) {
-        igraph_vector_ptr_destroy(&vertices2);
-        IGRAPH_FINALLY_CLEAN(1);
-    }
+    IGRAPH_FINALLY_CLEAN(3);
 
     return 0;
 }
@@ -1012,7 +1017,7 @@ int igraph_get_all_shortest_paths(const igraph_t *graph,
     igraph_vector_ptr_t paths;
     igraph_dqueue_t q;
     igraph_vector_t *vptr;
-    igraph_vector_t neis;
+    igraph_csr_view_t view;
     igraph_vector_t ptrlist;
     igraph_vector_t ptrhead;
     long int n, j, i;
@@ -1034,9 +1039,6 @@ int igraph_get_all_shortest_paths(const igraph_t *graph,
     /* paths will store the shortest paths during the search */
     IGRAPH_CHECK(igraph_vector_ptr_init(&paths, 0));
     IGRAPH_FINALLY(igraph_i_gasp_paths_destroy, &paths);
-    /* neis is a temporary vector holding the neighbors of the
-     * node being examined */
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     /* ptrlist stores indices into the paths vector, in the order
      * of how they were found. ptrhead is a second-level index that
      * will be used to find paths that terminate in a given vertex */
@@ -1116,11 +1118,10 @@ int igraph_get_all_shortest_paths(const igraph_t *graph,
             }
         }
 
-        IGRAPH_CHECK(igraph_neighbors(graph, &neis, (igraph_integer_t) actnode,
-                                      mode));
-        n = igraph_vector_size(&neis);
-        for (j = 0; j < n; j++) {
-            long int neighbor = (long int) VECTOR(neis)[j];
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actnode,
+                                     mode));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            long int neighbor = IGRAPH_CSR_VIEW_NEIGHBOR(view);
             long int fatherptr;
 
             if (geodist[neighbor] > 0 &&
@@ -1216,10 +1217,9 @@ int igraph_get_all_shortest_paths(const igraph_t *graph,
     igraph_Free(geodist);
     igraph_vector_destroy(&ptrlist);
     igraph_vector_destroy(&ptrhead);
-    igraph_vector_destroy(&neis);
     igraph_vector_ptr_destroy(&paths);
     igraph_vit_destroy(&vit);
-    IGRAPH_FINALLY_CLEAN(6);
+    IGRAPH_FINALLY_CLEAN(5);
 
     return 0;
 }
@@ -1274,8 +1274,7 @@ int igraph_subcomponent(const igraph_t *graph, igraph_vector_t *res, igraph_real
     long int no_of_nodes = igraph_vcount(graph);
     igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
     char *already_added;
-    long int i;
-    igraph_vector_t tmp = IGRAPH_VECTOR_NULL;
+    igraph_csr_view_t view;
 
     if (!IGRAPH_FINITE(vertex) || vertex < 0 || vertex >= no_of_nodes) {
         IGRAPH_ERROR("subcomponent failed", IGRAPH_EINVVID);
@@ -1293,7 +1292,6 @@ int igraph_subcomponent(const igraph_t *graph, igraph_vector_t *res, igraph_real
 
     igraph_vector_clear(res);
 
-    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
     IGRAPH_CHECK(igraph_dqueue_push(&q, vertex));
@@ -1305,10 +1303,10 @@ int igraph_subcomponent(const igraph_t *graph, igraph_vector_t *res, igraph_real
 
         IGRAPH_ALLOW_INTERRUPTION();
 
-        IGRAPH_CHECK(igraph_neighbors(graph, &tmp, (igraph_integer_t) actnode,
-                                      mode));
-        for (i = 0; i < igraph_vector_size(&tmp); i++) {
-            long int neighbor = (long int) VECTOR(tmp)[i];
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actnode,
+                                     mode));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            long int neighbor = IGRAPH_CSR_VIEW_NEIGHBOR(view);
 
             if (already_added[neighbor]) {
                 continue;
@@ -1320,9 +1318,8 @@ int igraph_subcomponent(const igraph_t *graph, igraph_vector_t *res, igraph_real
     }
 
     igraph_dqueue_destroy(&q);
-    igraph_vector_destroy(&tmp);
     igraph_Free(already_added);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -1459,7 +1456,7 @@ int igraph_pagerank_old(const igraph_t *graph, igraph_vector_t *res,
     } else {
         dirmode = IGRAPH_ALL;
     }
-    igraph_adjlist_init(graph, &allneis, dirmode);
+    igraph_adjlist_init_flat(graph, &allneis, dirmode);
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 
     /* Calculate outdegrees for every node */
@@ -2988,9 +2985,9 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
     long int no_of_nodes = igraph_vcount(graph);
     igraph_dqueue_t q;
     igraph_vit_t vit;
-    long int i, j;
+    long int i;
     long int *added;
-    igraph_vector_t neis;
+    igraph_csr_view_t view;
 
     if (order < 0) {
         IGRAPH_ERROR("Negative order in neighborhood size", IGRAPH_EINVAL);
@@ -3009,7 +3006,6 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
 
     for (i = 0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
@@ -3025,14 +3021,13 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
         while (!igraph_dqueue_empty(&q)) {
             long int actnode = (long int) igraph_dqueue_pop(&q);
             long int actdist = (long int) igraph_dqueue_pop(&q);
-            long int n;
-            igraph_neighbors(graph, &neis, (igraph_integer_t) actnode, mode);
-            n = igraph_vector_size(&neis);
+            IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actnode,
+                                         mode));
 
             if (actdist < order - 1) {
                 /* we add them to the q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
+                for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                    long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                     if (added[nei] != i + 1) {
                         added[nei] = i + 1;
                         IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
@@ -3044,8 +3039,8 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
                 }
             } else {
                 /* we just count them, but don't add them */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
+                for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                    long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                     if (added[nei] != i + 1) {
                         added[nei] = i + 1;
                         if (actdist + 1 >= mindist) {
@@ -3060,11 +3055,10 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
         VECTOR(*res)[i] = size;
     } /* for VIT, i */
 
-    igraph_vector_destroy(&neis);
     igraph_vit_destroy(&vit);
     igraph_dqueue_destroy(&q);
     igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_FINALLY_CLEAN(3);
 
     return 0;
 }
@@ -3116,9 +3110,9 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
     long int no_of_nodes = igraph_vcount(graph);
     igraph_dqueue_t q;
     igraph_vit_t vit;
-    long int i, j;
+    long int i;
     long int *added;
-    igraph_vector_t neis;
+    igraph_csr_view_t view;
     igraph_vector_t tmp;
     igraph_vector_t *newv;
 
@@ -3139,7 +3133,6 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
     IGRAPH_CHECK(igraph_vector_ptr_resize(res, IGRAPH_VIT_SIZE(vit)));
 
@@ -3158,14 +3151,13 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
         while (!igraph_dqueue_empty(&q)) {
             long int actnode = (long int) igraph_dqueue_pop(&q);
             long int actdist = (long int) igraph_dqueue_pop(&q);
-            long int n;
-            igraph_neighbors(graph, &neis, (igraph_integer_t) actnode, mode);
-            n = igraph_vector_size(&neis);
+            IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actnode,
+                                         mode));
 
             if (actdist < order - 1) {
                 /* we add them to the q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
+                for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                    long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                     if (added[nei] != i + 1) {
                         added[nei] = i + 1;
                         IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
@@ -3177,8 +3169,8 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
                 }
             } else {
                 /* we just count them but don't add them to q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
+                for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                    long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                     if (added[nei] != i + 1) {
                         added[nei] = i + 1;
                         if (actdist + 1 >= mindist) {
@@ -3201,11 +3193,10 @@ int igraph_neighborhood(const igraph_t *graph, igraph_vector_ptr_t *res,
     }
 
     igraph_vector_destroy(&tmp);
-    igraph_vector_destroy(&neis);
     igraph_vit_destroy(&vit);
     igraph_dqueue_destroy(&q);
     igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(5);
+    IGRAPH_FINALLY_CLEAN(4);
 
     return 0;
 }
@@ -3261,9 +3252,9 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
     long int no_of_nodes = igraph_vcount(graph);
     igraph_dqueue_t q;
     igraph_vit_t vit;
-    long int i, j;
+    long int i;
     long int *added;
-    igraph_vector_t neis;
+    igraph_csr_view_t view;
     igraph_vector_t tmp;
     igraph_t *newg;
 
@@ -3284,7 +3275,6 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
     IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
     IGRAPH_CHECK(igraph_vector_ptr_resize(res, IGRAPH_VIT_SIZE(vit)));
 
@@ -3303,14 +3293,13 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
         while (!igraph_dqueue_empty(&q)) {
             long int actnode = (long int) igraph_dqueue_pop(&q);
             long int actdist = (long int) igraph_dqueue_pop(&q);
-            long int n;
-            igraph_neighbors(graph, &neis, (igraph_integer_t) actnode, mode);
-            n = igraph_vector_size(&neis);
+            IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actnode,
+                                         mode));
 
             if (actdist < order - 1) {
                 /* we add them to the q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
+                for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                    long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                     if (added[nei] != i + 1) {
                         added[nei] = i + 1;
                         IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
@@ -3322,8 +3311,8 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
                 }
             } else {
                 /* we just count them but don't add them to q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
+                for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                    long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                     if (added[nei] != i + 1) {
                         added[nei] = i + 1;
                         if (actdist + 1 >= mindist) {
@@ -3352,11 +3341,10 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
     }
 
     igraph_vector_destroy(&tmp);
-    igraph_vector_destroy(&neis);
     igraph_vit_destroy(&vit);
     igraph_dqueue_destroy(&q);
     igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(5);
+    IGRAPH_FINALLY_CLEAN(4);
 
     return 0;
 }
@@ -3396,10 +3384,11 @@ int igraph_neighborhood_graphs(const igraph_t *graph, igraph_vector_ptr_t *res,
 int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
                                igraph_neimode_t mode) {
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_vector_t degrees, neis;
+    igraph_vector_t degrees;
+    igraph_csr_view_t view;
     igraph_dqueue_t sources;
     igraph_neimode_t deg_mode;
-    long int node, i, j;
+    long int node, i;
 
     if (mode == IGRAPH_ALL || !igraph_is_directed(graph)) {
         IGRAPH_ERROR("topological sorting does not make sense for undirected graphs", IGRAPH_EINVAL);
@@ -3412,7 +3401,6 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
     }
 
     IGRAPH_VECTOR_INIT_FINALLY(&degrees, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_dqueue_init(&sources, 0));
     IGRAPH_FINALLY(igraph_dqueue_destroy, &sources);
     IGRAPH_CHECK(igraph_degree(graph, &degrees, igraph_vss_all(), deg_mode, 0));
@@ -3434,12 +3422,12 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
         /* Exclude the node from further source searches */
         VECTOR(degrees)[node] = -1;
         /* Get the neighbors and decrease their degrees by one */
-        IGRAPH_CHECK(igraph_neighbors(graph, &neis, (igraph_integer_t) node, mode));
-        j = igraph_vector_size(&neis);
-        for (i = 0; i < j; i++) {
-            VECTOR(degrees)[(long)VECTOR(neis)[i]]--;
-            if (VECTOR(degrees)[(long)VECTOR(neis)[i]] == 0) {
-                IGRAPH_CHECK(igraph_dqueue_push(&sources, VECTOR(neis)[i]));
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) node, mode));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+            VECTOR(degrees)[nei]--;
+            if (VECTOR(degrees)[nei] == 0) {
+                IGRAPH_CHECK(igraph_dqueue_push(&sources, nei));
             }
         }
     }
@@ -3449,9 +3437,8 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
     }
 
     igraph_vector_destroy(&degrees);
-    igraph_vector_destroy(&neis);
     igraph_dqueue_destroy(&sources);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -3476,9 +3463,10 @@ int igraph_topological_sorting(const igraph_t* graph, igraph_vector_t *res,
  */
 int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_vector_t degrees, neis;
+    igraph_vector_t degrees;
+    igraph_csr_view_t view;
     igraph_dqueue_t sources;
-    long int node, i, j, nei, vertices_left;
+    long int node, i, nei, vertices_left;
 
     if (!igraph_is_directed(graph)) {
         *res = 0;
@@ -3486,7 +3474,6 @@ int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
     }
 
     IGRAPH_VECTOR_INIT_FINALLY(&degrees, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_dqueue_init(&sources, 0));
     IGRAPH_FINALLY(igraph_dqueue_destroy, &sources);
     IGRAPH_CHECK(igraph_degree(graph, &degrees, igraph_vss_all(), IGRAPH_OUT, 1));
@@ -3507,11 +3494,10 @@ int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
         VECTOR(degrees)[node] = -1;
         vertices_left--;
         /* Get the neighbors and decrease their degrees by one */
-        IGRAPH_CHECK(igraph_neighbors(graph, &neis, (igraph_integer_t) node,
-                                      IGRAPH_IN));
-        j = igraph_vector_size(&neis);
-        for (i = 0; i < j; i++) {
-            nei = (long)VECTOR(neis)[i];
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) node,
+                                     IGRAPH_IN));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
             if (nei == node) {
                 continue;
             }
@@ -3528,9 +3514,8 @@ int igraph_is_dag(const igraph_t* graph, igraph_bool_t *res) {
     }
 
     igraph_vector_destroy(&degrees);
-    igraph_vector_destroy(&neis);
     igraph_dqueue_destroy(&sources);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return IGRAPH_SUCCESS;
 }
@@ -4247,7 +4232,7 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
     for (k = 0; k < (directed ? 2 : 1); k++) {
         igraph_neimode_t neimode = (k == 0) ? IGRAPH_OUT : IGRAPH_IN;
         igraph_real_t *vec;
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, neimode));
+        IGRAPH_CHECK(igraph_inclist_init_flat(graph, &inclist, neimode));
         IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
         vec = (k == 0) ? VECTOR(*ins_p) : VECTOR(*outs_p);
         for (i = 0; i < no_of_nodes; i++) {
@@ -4334,6 +4319,111 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
     return 0;
 }
 
+/* The priority queue of Dijkstra's algorithm. It is a radix heap if
+   all weights are integers and the distances are exact in floating
+   point, and a two-way binary heap otherwise. Both return the
+   smallest distance first. */
+
+typedef struct {
+    igraph_bool_t radix;
+    igraph_2wheap_t heap;
+    igraph_radixheap_t radixheap;
+} igraph_i_dijkstra_queue_t;
+
+static igraph_bool_t igraph_i_dijkstra_integer_weights(
+        const igraph_vector_t *weights, long int no_of_nodes) {
+    long int i, n = igraph_vector_size(weights);
+    igraph_real_t maxweight = 0;
+    for (i = 0; i < n; i++) {
+        igraph_real_t w = VECTOR(*weights)[i];
+        if (w != floor(w) || !IGRAPH_FINITE(w)) {
+            return 0;
+        }
+        if (w > maxweight) {
+            maxweight = w;
+        }
+    }
+    /* The longest path has no_of_nodes-1 edges, plus one for the
+       shifted distances in the callers */
+    return maxweight * no_of_nodes < 9007199254740992.0; /* 2^53 */
+}
+
+static int igraph_i_dijkstra_queue_init(igraph_i_dijkstra_queue_t *q,
+                                        long int size,
+                                        const igraph_vector_t *weights) {
+    q->radix = igraph_i_dijkstra_integer_weights(weights, size);
+    if (q->radix) {
+        IGRAPH_CHECK(igraph_radixheap_init(&q->radixheap, size));
+    } else {
+        IGRAPH_CHECK(igraph_2wheap_init(&q->heap, size));
+    }
+    return 0;
+}
+
+static void igraph_i_dijkstra_queue_destroy(igraph_i_dijkstra_queue_t *q) {
+    if (q->radix) {
+        igraph_radixheap_destroy(&q->radixheap);
+    } else {
+        igraph_2wheap_destroy(&q->heap);
+    }
+}
+
+static void igraph_i_dijkstra_queue_clear(igraph_i_dijkstra_queue_t *q) {
+    if (q->radix) {
+        igraph_radixheap_clear(&q->radixheap);
+    } else {
+        igraph_2wheap_clear(&q->heap);
+    }
+}
+
+static igraph_bool_t igraph_i_dijkstra_queue_empty(
+        const igraph_i_dijkstra_queue_t *q) {
+    return q->radix ? igraph_radixheap_empty(&q->radixheap) :
+           igraph_2wheap_empty(&q->heap);
+}
+
+static igraph_bool_t igraph_i_dijkstra_queue_has_elem(
+        const igraph_i_dijkstra_queue_t *q, long int idx) {
+    return q->radix ? igraph_radixheap_has_elem(&q->radixheap, idx) :
+           igraph_2wheap_has_elem(&q->heap, idx);
+}
+
+static igraph_bool_t igraph_i_dijkstra_queue_has_active(
+        const igraph_i_dijkstra_queue_t *q, long int idx) {
+    return q->radix ? igraph_radixheap_has_active(&q->radixheap, idx) :
+           igraph_2wheap_has_active(&q->heap, idx);
+}
+
+static igraph_real_t igraph_i_dijkstra_queue_get(
+        const igraph_i_dijkstra_queue_t *q, long int idx) {
+    return q->radix ? igraph_radixheap_get(&q->radixheap, idx) :
+           -igraph_2wheap_get(&q->heap, idx);
+}
+
+static int igraph_i_dijkstra_queue_push(igraph_i_dijkstra_queue_t *q,
+                                        long int idx, igraph_real_t dist) {
+    return q->radix ?
+           igraph_radixheap_push_with_index(&q->radixheap, idx, dist) :
+           igraph_2wheap_push_with_index(&q->heap, idx, -dist);
+}
+
+static int igraph_i_dijkstra_queue_modify(igraph_i_dijkstra_queue_t *q,
+        long int idx, igraph_real_t dist) {
+    return q->radix ? igraph_radixheap_modify(&q->radixheap, idx, dist) :
+           igraph_2wheap_modify(&q->heap, idx, -dist);
+}
+
+/* Removes the closest vertex, but remembers that it was in the queue */
+
+static igraph_real_t igraph_i_dijkstra_queue_deactivate_min(
+        igraph_i_dijkstra_queue_t *q, long int *idx) {
+    if (q->radix) {
+        return igraph_radixheap_deactivate_min_index(&q->radixheap, idx);
+    }
+    *idx = igraph_2wheap_max_index(&q->heap);
+    return -igraph_2wheap_deactivate_max(&q->heap);
+}
+
 /**
  * \function igraph_shortest_paths_dijkstra
  * Weighted shortest paths from some sources.
@@ -4343,6 +4433,13 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
  * independently for the given sources.) It uses a binary heap for
  * efficient implementation.
  *
+ * </para><para>
+ * If the distances to all vertices are requested, the graph has at
+ * least 50000 vertices, the delta-stepping algorithm of U. Meyer
+ * and P. Sanders is used instead, which scans the edges of many
+ * vertices in parallel, with the number of threads set by \ref
+ * igraph_set_num_threads(). The result is the same.
+ *
  * \param graph The input graph, can be directed.
  * \param res The result, a matrix. A pointer to an initialized matrix
  *    should be passed here. The matrix will be resized as needed.
@@ -4383,15 +4480,16 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
                                    igraph_neimode_t mode) {
 
     /* Implementation details. This is the basic Dijkstra algorithm,
-       with a binary heap. The heap is indexed, i.e. it stores not only
-       the distances, but also which vertex they belong to.
+       with a binary heap, or a radix heap for integer weights. The
+       heap is indexed, i.e. it stores not only the distances, but also
+       which vertex they belong to.
 
-       From now on we use a 2-way heap, so the distances can be queried
-       directly from the heap.
+       The heap is an igraph_i_dijkstra_queue_t, a radix heap if the
+       weights are integers, see igraph_i_dijkstra_integer_weights(),
+       and a 2-way heap otherwise. Both can be queried for the
+       distance of a vertex that is still in the queue.
 
        Dirty tricks:
-       - the opposite of the distance is stored in the heap, as it is a
-         maximum heap and we need a minimum heap.
        - we don't use IGRAPH_INFINITY in the res matrix during the
          computation, as IGRAPH_FINITE() might involve a function call
          and we want to spare that. -1 will denote infinity instead.
@@ -4399,14 +4497,14 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
 
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
-    igraph_2wheap_t Q;
+    igraph_i_dijkstra_queue_t Q;
     igraph_vit_t fromvit, tovit;
     long int no_of_from, no_of_to;
     igraph_lazy_inclist_t inclist;
     long int i, j;
     igraph_real_t my_infinity = IGRAPH_INFINITY;
-    igraph_bool_t all_to;
-    igraph_vector_t indexv;
+    igraph_bool_t all_to, deltastep;
+    igraph_vector_t indexv, dist;
 
     if (!weights) {
         return igraph_shortest_paths(graph, res, from, to, mode);
@@ -4423,8 +4521,8 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
     IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
     no_of_from = IGRAPH_VIT_SIZE(fromvit);
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+    IGRAPH_CHECK(igraph_i_dijkstra_queue_init(&Q, no_of_nodes, weights));
+    IGRAPH_FINALLY(igraph_i_dijkstra_queue_destroy, &Q);
     IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
     IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
 
@@ -4448,18 +4546,30 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
     IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
     igraph_matrix_fill(res, my_infinity);
 
+    /* Parallel delta-stepping instead, on large graphs */
+    deltastep = all_to && igraph_i_deltastep_enabled(graph, weights);
+    IGRAPH_VECTOR_INIT_FINALLY(&dist, 0);
+
     for (IGRAPH_VIT_RESET(fromvit), i = 0;
          !IGRAPH_VIT_END(fromvit);
          IGRAPH_VIT_NEXT(fromvit), i++) {
 
         long int reached = 0;
         long int source = IGRAPH_VIT_GET(fromvit);
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
 
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_deactivate_max(&Q);
+        if (deltastep) {
+            IGRAPH_CHECK(igraph_i_deltastep(graph, weights, mode, source,
+                                            &dist, 0));
+            IGRAPH_CHECK(igraph_matrix_set_row(res, &dist, i));
+            continue;
+        }
+
+        igraph_i_dijkstra_queue_clear(&Q);
+        IGRAPH_CHECK(igraph_i_dijkstra_queue_push(&Q, source, 1.0));
+
+        while (!igraph_i_dijkstra_queue_empty(&Q)) {
+            long int minnei;
+            igraph_real_t mindist = igraph_i_dijkstra_queue_deactivate_min(&Q, &minnei);
             igraph_vector_t *neis;
             long int nlen;
 
@@ -4470,7 +4580,7 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
                     MATRIX(*res, i, (long int)(VECTOR(indexv)[minnei] - 1)) = mindist - 1.0;
                     reached++;
                     if (reached == no_of_to) {
-                        igraph_2wheap_clear(&Q);
+                        igraph_i_dijkstra_queue_clear(&Q);
                         break;
                     }
                 }
@@ -4479,26 +4589,31 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
             /* Now check all neighbors of 'minnei' for a shorter path */
             neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
             nlen = igraph_vector_size(neis);
+            IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+            IGRAPH_I_TRACE_ADD(relaxed_edges, nlen);
             for (j = 0; j < nlen; j++) {
                 long int edge = (long int) VECTOR(*neis)[j];
                 long int tto = IGRAPH_OTHER(graph, edge, minnei);
                 igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_bool_t active = igraph_2wheap_has_active(&Q, tto);
-                igraph_bool_t has = igraph_2wheap_has_elem(&Q, tto);
-                igraph_real_t curdist = active ? -igraph_2wheap_get(&Q, tto) : 0.0;
+                igraph_bool_t active = igraph_i_dijkstra_queue_has_active(&Q, tto);
+                igraph_bool_t has = igraph_i_dijkstra_queue_has_elem(&Q, tto);
+                igraph_real_t curdist = active ? igraph_i_dijkstra_queue_get(&Q, tto) : 0.0;
                 if (!has) {
                     /* This is the first non-infinite distance */
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dijkstra_queue_push(&Q, tto, altdist));
                 } else if (altdist < curdist) {
                     /* This is a shorter path */
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dijkstra_queue_modify(&Q, tto, altdist));
                 }
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_i_dijkstra_queue_empty(&Q) */
 
     } /* !IGRAPH_VIT_END(fromvit) */
 
+    igraph_vector_destroy(&dist);
+    IGRAPH_FINALLY_CLEAN(1);
+
     if (!all_to) {
         igraph_vit_destroy(&tovit);
         igraph_vector_destroy(&indexv);
@@ -4506,10 +4621,12 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
     }
 
     igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_dijkstra_queue_destroy(&Q);
     igraph_vit_destroy(&fromvit);
     IGRAPH_FINALLY_CLEAN(3);
 
+    IGRAPH_I_TRACE_REPORT("igraph_shortest_paths_dijkstra");
+
     return 0;
 }
 
@@ -4586,6 +4703,14 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
  *           invalid mode argument.
  *        \endclist
  *
+ * </para><para>
+ * If \p to contains all vertices, the parallel delta-stepping
+ * algorithm is used on large graphs, like in \ref
+ * igraph_shortest_paths_dijkstra(). If there are several shortest
+ * paths to a vertex, it may choose a different one than Dijkstra's
+ * algorithm, but the choice does not depend on the number of
+ * threads.
+ *
  * Time complexity: O(|E|log|E|+|V|), where |V| is the number of
  * vertices and |E| is the number of edges
  *
@@ -4684,43 +4809,56 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
         }
     }
 
-    VECTOR(dists)[(long int)from] = 0.0;  /* zero distance */
-    parents[(long int)from] = 0;
-    igraph_2wheap_push_with_index(&Q, from, 0);
+    if (igraph_vs_is_all(&to) && igraph_i_deltastep_enabled(graph, weights)) {
+        /* Parallel delta-stepping on large graphs */
+        IGRAPH_CHECK(igraph_i_deltastep(graph, weights, mode, from, &dists,
+                                        parents));
+        for (i = 0; i < no_of_nodes; i++) {
+            if (is_target[i] && (i == from || parents[i] > 0)) {
+                to_reach--;
+            }
+        }
+    } else {
+        VECTOR(dists)[(long int)from] = 0.0;  /* zero distance */
+        parents[(long int)from] = 0;
+        igraph_2wheap_push_with_index(&Q, from, 0);
 
-    while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
-        long int nlen, minnei = igraph_2wheap_max_index(&Q);
-        igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
-        igraph_vector_t *neis;
+        while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
+            long int nlen, minnei = igraph_2wheap_max_index(&Q);
+            igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
+            igraph_vector_t *neis;
 
-        IGRAPH_ALLOW_INTERRUPTION();
+            IGRAPH_ALLOW_INTERRUPTION();
 
-        if (is_target[minnei]) {
-            is_target[minnei] = 0;
-            to_reach--;
-        }
+            if (is_target[minnei]) {
+                is_target[minnei] = 0;
+                to_reach--;
+            }
 
-        /* Now check all neighbors of 'minnei' for a shorter path */
-        neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
-        nlen = igraph_vector_size(neis);
-        for (i = 0; i < nlen; i++) {
-            long int edge = (long int) VECTOR(*neis)[i];
-            long int tto = IGRAPH_OTHER(graph, edge, minnei);
-            igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-            igraph_real_t curdist = VECTOR(dists)[tto];
-            if (curdist < 0) {
-                /* This is the first finite distance */
-                VECTOR(dists)[tto] = altdist;
-                parents[tto] = edge + 1;
-                IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
-            } else if (altdist < curdist) {
-                /* This is a shorter path */
-                VECTOR(dists)[tto] = altdist;
-                parents[tto] = edge + 1;
-                IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+            /* Now check all neighbors of 'minnei' for a shorter path */
+            neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
+            nlen = igraph_vector_size(neis);
+            IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+            IGRAPH_I_TRACE_ADD(relaxed_edges, nlen);
+            for (i = 0; i < nlen; i++) {
+                long int edge = (long int) VECTOR(*neis)[i];
+                long int tto = IGRAPH_OTHER(graph, edge, minnei);
+                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
+                igraph_real_t curdist = VECTOR(dists)[tto];
+                if (curdist < 0) {
+                    /* This is the first finite distance */
+                    VECTOR(dists)[tto] = altdist;
+                    parents[tto] = edge + 1;
+                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                } else if (altdist < curdist) {
+                    /* This is a shorter path */
+                    VECTOR(dists)[tto] = altdist;
+                    parents[tto] = edge + 1;
+                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                }
             }
-        }
-    } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_2wheap_empty(&Q) */
+    }
 
     if (to_reach > 0) {
         IGRAPH_WARNING("Couldn't reach some vertices");
@@ -4813,84 +4951,7 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
     igraph_vit_destroy(&vit);
     IGRAPH_FINALLY_CLEAN(6);
 
-    return 0;
-}
-
-/**
- * \function igraph_get_shortest_path_dijkstra
- * Weighted shortest path from one vertex to another one.
- *
- * Calculates a single (positively) weighted shortest path from
- * a single vertex to another one, using Dijkstra's algorithm.
- *
- * </para><para>This function is a special case (and a wrapper) to
- * \ref igraph_get_shortest_paths_dijkstra().
- *
- * \param graph The input graph, it can be directed or undirected.
- * \param vertices Pointer to an initialized vector or a null
- *        pointer. If not a null pointer, then the vertex ids along
- *        the path are stored here, including the source and target
- *        vertices.
- * \param edges Pointer to an uninitialized vector or a null
- *        pointer. If not a null pointer, then the edge ids along the
- *        path are stored here.
- * \param from The id of the source vertex.
- * \param to The id of the target vertex.
- * \param weights Vector of edge weights, in the order of edge
- *        ids. They must be non-negative, otherwise the algorithm does
- *        not work.
- * \param mode A constant specifying how edge directions are
- *        considered in directed graphs. \c IGRAPH_OUT follows edge
- *        directions, \c IGRAPH_IN follows the opposite directions,
- *        and \c IGRAPH_ALL ignores edge directions. This argument is
- *        ignored for undirected graphs.
- * \return Error code.
- *
- * Time complexity: O(|E|log|E|+|V|), |V| is the number of vertices,
- * |E| is the number of edges in the graph.
- *
- * \sa \ref igraph_get_shortest_paths_dijkstra() for the version with
- * more target vertices.
- */
-
-int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
-                                      igraph_vector_t *vertices,
-                                      igraph_vector_t *edges,
-                                      igraph_integer_t from,
-                                      igraph_integer_t to,
-                                      const igraph_vector_t *weights,
-                                      igraph_neimode_t mode) {
-
-    igraph_vector_ptr_t vertices2, *vp = &vertices2;
-    igraph_vector_ptr_t edges2, *ep = &edges2;
-
-    if (vertices) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&vertices2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &vertices2);
-        VECTOR(vertices2)[0] = vertices;
-    } else {
-        vp = 0;
-    }
-    if (edges) {
-        IGRAPH_CHECK(igraph_vector_ptr_init(&edges2, 1));
-        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &edges2);
-        VECTOR(edges2)[0] = edges;
-    } else {
-        ep = 0;
-    }
-
-    IGRAPH_CHECK(igraph_get_shortest_paths_dijkstra(graph, vp, ep,
-                 from, igraph_vss_1(to),
-                 weights, mode, 0, 0));
-
-    if (edges) {
-        igraph_vector_ptr_destroy(&edges2);
-        IGRAPH_FINALLY_CLEAN(1);
-    }
-    if (vertices) {
-        igraph_vector_ptr_destroy(&vertices2);
-        IGRAPH_FINALLY_CLEAN(1);
-    }
+    IGRAPH_I_TRACE_REPORT("igraph_get_shortest_paths_dijkstra");
 
     return 0;
 }
@@ -5076,6 +5137,8 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
         /* Now check all neighbors of 'minnei' for a shorter path */
         neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
         nlen = igraph_vector_size(neis);
+        IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+        IGRAPH_I_TRACE_ADD(relaxed_edges, nlen);
         for (i = 0; i < nlen; i++) {
             long int edge = (long int) VECTOR(*neis)[i];
             long int tto = IGRAPH_OTHER(graph, edge, minnei);
@@ -5334,6 +5397,8 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
     igraph_vector_ptr_destroy_all(&parents);
     IGRAPH_FINALLY_CLEAN(4);
 
+    IGRAPH_I_TRACE_REPORT("igraph_get_all_shortest_paths_dijkstra");
+
     return 0;
 }
 
@@ -6267,15 +6332,16 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
                              igraph_bool_t unconn) {
 
     /* Implementation details. This is the basic Dijkstra algorithm,
-       with a binary heap. The heap is indexed, i.e. it stores not only
-       the distances, but also which vertex they belong to.
+       with a binary heap, or a radix heap for integer weights. The
+       heap is indexed, i.e. it stores not only the distances, but also
+       which vertex they belong to.
 
-       From now on we use a 2-way heap, so the distances can be queried
-       directly from the heap.
+       The heap is an igraph_i_dijkstra_queue_t, a radix heap if the
+       weights are integers, see igraph_i_dijkstra_integer_weights(),
+       and a 2-way heap otherwise. Both can be queried for the
+       distance of a vertex that is still in the queue.
 
        Dirty tricks:
-       - the opposite of the distance is stored in the heap, as it is a
-         maximum heap and we need a minimum heap.
        - we don't use IGRAPH_INFINITY during the computation, as IGRAPH_FINITE()
          might involve a function call and we want to spare that. -1 will denote
          infinity instead.
@@ -6284,7 +6350,7 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
 
-    igraph_2wheap_t Q;
+    igraph_i_dijkstra_queue_t Q;
     igraph_inclist_t inclist;
     long int source, j;
     igraph_neimode_t dirmode = directed ? IGRAPH_OUT : IGRAPH_ALL;
@@ -6310,9 +6376,9 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
         IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
     }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, dirmode));
+    IGRAPH_CHECK(igraph_i_dijkstra_queue_init(&Q, no_of_nodes, weights));
+    IGRAPH_FINALLY(igraph_i_dijkstra_queue_destroy, &Q);
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &inclist, dirmode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
 
     for (source = 0; source < no_of_nodes; source++) {
@@ -6320,14 +6386,14 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
         IGRAPH_PROGRESS("Weighted diameter: ", source * 100.0 / no_of_nodes, NULL);
         IGRAPH_ALLOW_INTERRUPTION();
 
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
+        igraph_i_dijkstra_queue_clear(&Q);
+        IGRAPH_CHECK(igraph_i_dijkstra_queue_push(&Q, source, 1.0));
 
         nodes_reached = 0.0;
 
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_deactivate_max(&Q);
+        while (!igraph_i_dijkstra_queue_empty(&Q)) {
+            long int minnei;
+            igraph_real_t mindist = igraph_i_dijkstra_queue_deactivate_min(&Q, &minnei);
             igraph_vector_int_t *neis;
             long int nlen;
 
@@ -6343,20 +6409,20 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
                 long int edge = (long int) VECTOR(*neis)[j];
                 long int tto = IGRAPH_OTHER(graph, edge, minnei);
                 igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_bool_t active = igraph_2wheap_has_active(&Q, tto);
-                igraph_bool_t has = igraph_2wheap_has_elem(&Q, tto);
-                igraph_real_t curdist = active ? -igraph_2wheap_get(&Q, tto) : 0.0;
+                igraph_bool_t active = igraph_i_dijkstra_queue_has_active(&Q, tto);
+                igraph_bool_t has = igraph_i_dijkstra_queue_has_elem(&Q, tto);
+                igraph_real_t curdist = active ? igraph_i_dijkstra_queue_get(&Q, tto) : 0.0;
 
                 if (!has) {
                     /* First finite distance */
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dijkstra_queue_push(&Q, tto, altdist));
                 } else if (altdist < curdist) {
                     /* A shorter path */
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_dijkstra_queue_modify(&Q, tto, altdist));
                 }
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_i_dijkstra_queue_empty(&Q) */
 
         /* not connected, return infinity */
         if (nodes_reached != no_of_nodes && !unconn) {
@@ -6371,7 +6437,7 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     res -= 1;
 
     igraph_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_dijkstra_queue_destroy(&Q);
     IGRAPH_FINALLY_CLEAN(2);
 
     IGRAPH_PROGRESS("Weighted diameter: ", 100.0, NULL);
@@ -0,0 +1,547 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_threads_internal.h"
+#include "igraph_threading.h"
+#include "igraph_error.h"
+#include "igraph_memory.h"
+#include "igraph_memory_internal.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+#include <string.h>
+
+#if defined(HAVE_PTHREAD)
+#include <errno.h>
+#include <sys/time.h>
+#endif
+#if defined(HAVE_PTHREAD) && defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+/**
+ * \section about_num_threads
+ *
+ * <para>
+ * Some functions use all processors of the machine for their
+ * computations, currently \ref igraph_vector_int_order(), the
+ * creation of large graphs, which uses it, \ref
+ * igraph_similarity_jaccard_pairs(), and the unweighted \ref
+ * igraph_shortest_paths(), \ref igraph_average_path_length(), \ref
+ * igraph_path_length_hist() and \ref igraph_closeness(), which run
+ * their breadth-first searches in batches of 64 sources, and \ref
+ * igraph_shortest_paths_dijkstra() and \ref
+ * igraph_get_shortest_paths_dijkstra() on large graphs. The work is
+ * done by a pool of worker threads that is started at the first
+ * parallel computation and reused later. The result of these
+ * functions does not depend on the number of threads.
+ * </para>
+ *
+ * <para>
+ * The number of threads can be queried with \ref
+ * igraph_get_num_threads() and changed with \ref
+ * igraph_set_num_threads(). By default it is the number of processors.
+ * If a parallel function is called while the pool is busy, for
+ * example from several threads of the application at the same time,
+ * it runs on the calling thread only.
+ * </para>
+ *
+ * <para>
+ * Parallel functions that can fail or be interrupted only run in
+ * parallel in thread-safe builds, see \ref IGRAPH_THREAD_SAFE. An
+ * error in a worker thread is reported by the calling thread, through
+ * its own error handler, after all workers stopped working on the
+ * computation and released their temporary data. Similarly, the
+ * calling thread checks the interruption handler while it waits for
+ * the workers, and stops them if the computation was interrupted.
+ * </para>
+ */
+
+#define IGRAPH_I_MAX_THREADS 256
+
+static int igraph_i_num_threads = 0;
+
+#if defined(HAVE_PTHREAD)
+
+/* The number of processors, at least one */
+
+static int igraph_i_processor_count(void) {
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+    long int n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 1 ? (int) n : 1;
+#else
+    return 1;
+#endif
+}
+
+#endif
+
+/**
+ * \function igraph_set_num_threads
+ * \brief Sets the number of threads of the parallel functions.
+ *
+ * The new number is used from the next parallel computation on; the
+ * worker threads are restarted then if needed.
+ * \param num_threads The number of threads, zero means the number of
+ *    processors, which is the default. It is capped at 256.
+ * \return Error code: \c IGRAPH_EINVAL if \p num_threads is negative.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_set_num_threads(int num_threads) {
+    if (num_threads < 0) {
+        IGRAPH_ERROR("Number of threads must not be negative", IGRAPH_EINVAL);
+    }
+    igraph_i_num_threads = num_threads > IGRAPH_I_MAX_THREADS ?
+                           IGRAPH_I_MAX_THREADS : num_threads;
+    return 0;
+}
+
+/**
+ * \function igraph_get_num_threads
+ * \brief The number of threads of the parallel functions.
+ *
+ * \return The number of threads set by \ref igraph_set_num_threads(),
+ *    or the number of processors by default. It is always one if
+ *    igraph was built without thread support.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_get_num_threads(void) {
+#if defined(HAVE_PTHREAD)
+    int n = igraph_i_num_threads;
+    if (n == 0) {
+        n = igraph_i_processor_count();
+    }
+    return n > IGRAPH_I_MAX_THREADS ? IGRAPH_I_MAX_THREADS : n;
+#else
+    return 1;
+#endif
+}
+
+/* A computation that is run by the pool. Its items are claimed one by
+   one by the workers, an item is a part for igraph_i_parallel_run()
+   and a chunk of indices for igraph_i_parallel_for(). */
+
+typedef struct igraph_i_job_t {
+    igraph_i_thread_func_t *run_func;
+    igraph_i_parallel_for_func_t *for_func;
+    void *arg;
+    long int n, grain;
+    long int items, next;
+    int nparts;
+    int active;            /* number of workers working on the job */
+    int cancel;            /* stop claiming new items */
+    int error;
+    char message[256];
+    igraph_i_memory_context_t memory;   /* of the calling thread */
+} igraph_i_job_t;
+
+/* Runs a single item of a job, without holding the pool lock */
+
+static int igraph_i_job_run_item(igraph_i_job_t *job, long int item) {
+    if (job->run_func) {
+        job->run_func(job->arg, (int) item, job->nparts);
+        return 0;
+    } else {
+        long int from = item * job->grain;
+        long int to = from + job->grain < job->n ? from + job->grain : job->n;
+        return job->for_func(job->arg, from, to);
+    }
+}
+
+#if defined(HAVE_PTHREAD)
+
+/* The pool: a single job at a time, the workers wait on 'wake' for
+   a new generation, the caller waits on 'finished' for the workers. */
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake, finished;
+    int busy, shutdown, nworkers;
+    unsigned long int generation;
+    igraph_i_job_t *job;
+    pthread_t workers[IGRAPH_I_MAX_THREADS];
+} igraph_i_pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, 0, 0, 0, 0, 0
+};
+
+#ifdef HAVE_TLS
+
+/* The workers report errors through these handlers. The error
+   handler frees the finally stack of the worker and keeps the
+   message, the interruption handler stops the worker when the job
+   was cancelled. */
+
+static IGRAPH_THREAD_LOCAL igraph_i_job_t *igraph_i_worker_job = 0;
+static IGRAPH_THREAD_LOCAL char igraph_i_worker_message[256];
+
+static void igraph_i_worker_error_handler(const char *reason,
+        const char *file, int line, int igraph_errno) {
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    IGRAPH_UNUSED(igraph_errno);
+    /* The first call has the message, IGRAPH_CHECK adds empty ones */
+    if (igraph_i_worker_message[0] == '\0') {
+        strncpy(igraph_i_worker_message, reason,
+                sizeof(igraph_i_worker_message) - 1);
+    }
+    IGRAPH_FINALLY_FREE();
+}
+
+static int igraph_i_worker_interruption_handler(void *data) {
+    int cancel = 0;
+    IGRAPH_UNUSED(data);
+    if (igraph_i_worker_job) {
+        pthread_mutex_lock(&igraph_i_pool.lock);
+        cancel = igraph_i_worker_job->cancel;
+        pthread_mutex_unlock(&igraph_i_pool.lock);
+    }
+    return cancel ? IGRAPH_INTERRUPTED : IGRAPH_SUCCESS;
+}
+
+#endif
+
+/* Claims and runs the items of a job until there are no more, or the
+   job is cancelled. The first error is kept in the job and cancels
+   it; the interruptions that follow a cancellation are not errors. */
+
+static void igraph_i_worker_run(igraph_i_job_t *job) {
+    long int item;
+    int ret;
+
+    for (;;) {
+        pthread_mutex_lock(&igraph_i_pool.lock);
+        if (job->cancel || job->next >= job->items) {
+            pthread_mutex_unlock(&igraph_i_pool.lock);
+            return;
+        }
+        item = job->next++;
+        pthread_mutex_unlock(&igraph_i_pool.lock);
+
+#ifdef HAVE_TLS
+        igraph_i_worker_message[0] = '\0';
+#endif
+        ret = igraph_i_job_run_item(job, item);
+        if (ret != 0) {
+            pthread_mutex_lock(&igraph_i_pool.lock);
+            if (!job->error && ret != IGRAPH_INTERRUPTED) {
+                job->error = ret;
+#ifdef HAVE_TLS
+                strcpy(job->message, igraph_i_worker_message);
+#endif
+            }
+            job->cancel = 1;
+            pthread_mutex_unlock(&igraph_i_pool.lock);
+#ifdef HAVE_TLS
+            /* In case it returned without calling IGRAPH_ERROR */
+            IGRAPH_FINALLY_FREE();
+#endif
+        }
+    }
+}
+
+static void *igraph_i_worker_main(void *arg) {
+    unsigned long int seen = 0;
+    igraph_i_job_t *job;
+#ifdef HAVE_TLS
+    igraph_i_memory_context_t memory;
+#endif
+
+    IGRAPH_UNUSED(arg);
+#ifdef HAVE_TLS
+    igraph_set_error_handler(igraph_i_worker_error_handler);
+    igraph_set_interruption_handler(igraph_i_worker_interruption_handler);
+#endif
+
+    /* The job of the current generation, if there is one, was
+       submitted after the worker was started, so it is new */
+    pthread_mutex_lock(&igraph_i_pool.lock);
+    for (;;) {
+        while (!igraph_i_pool.shutdown &&
+               (!igraph_i_pool.job || igraph_i_pool.generation == seen)) {
+            pthread_cond_wait(&igraph_i_pool.wake, &igraph_i_pool.lock);
+        }
+        if (igraph_i_pool.shutdown) {
+            break;
+        }
+        seen = igraph_i_pool.generation;
+        job = igraph_i_pool.job;
+        job->active++;
+        pthread_mutex_unlock(&igraph_i_pool.lock);
+
+#ifdef HAVE_TLS
+        /* Without thread-local storage the allocators and statistics
+           are global, and shared already */
+        igraph_i_worker_job = job;
+        igraph_i_memory_install(&job->memory, &memory);
+#endif
+        igraph_i_worker_run(job);
+#ifdef HAVE_TLS
+        igraph_i_memory_restore(&memory);
+        igraph_i_worker_job = 0;
+#endif
+
+        pthread_mutex_lock(&igraph_i_pool.lock);
+        job->active--;
+        pthread_cond_broadcast(&igraph_i_pool.finished);
+    }
+    pthread_mutex_unlock(&igraph_i_pool.lock);
+
+    return 0;
+}
+
+/* Reserves the pool for a job and makes sure that it has the right
+   number of workers. Returns the number of workers, zero if the pool
+   is busy or no worker could be started. */
+
+static int igraph_i_pool_acquire(int nthreads) {
+    int i, nworkers;
+
+    pthread_mutex_lock(&igraph_i_pool.lock);
+    if (igraph_i_pool.busy) {
+        pthread_mutex_unlock(&igraph_i_pool.lock);
+        return 0;
+    }
+    igraph_i_pool.busy = 1;
+
+    if (igraph_i_pool.nworkers != nthreads) {
+        igraph_i_pool.shutdown = 1;
+        pthread_cond_broadcast(&igraph_i_pool.wake);
+        pthread_mutex_unlock(&igraph_i_pool.lock);
+        for (i = 0; i < igraph_i_pool.nworkers; i++) {
+            pthread_join(igraph_i_pool.workers[i], 0);
+        }
+        pthread_mutex_lock(&igraph_i_pool.lock);
+        igraph_i_pool.shutdown = 0;
+        for (i = 0; i < nthreads; i++) {
+            if (pthread_create(&igraph_i_pool.workers[i], 0,
+                               igraph_i_worker_main, 0) != 0) {
+                break;
+            }
+        }
+        igraph_i_pool.nworkers = i;
+    }
+
+    nworkers = igraph_i_pool.nworkers;
+    if (nworkers == 0) {
+        igraph_i_pool.busy = 0;
+    }
+    pthread_mutex_unlock(&igraph_i_pool.lock);
+
+    return nworkers;
+}
+
+/* Waits with a timeout, so that the caller can check its
+   interruption handler regularly */
+
+static void igraph_i_pool_timedwait(void) {
+    struct timeval now;
+    struct timespec until;
+    gettimeofday(&now, 0);
+    until.tv_sec = now.tv_sec;
+    until.tv_nsec = (now.tv_usec + 10000) * 1000L;
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&igraph_i_pool.finished, &igraph_i_pool.lock,
+                           &until);
+}
+
+/* Hands a job to the workers and waits until it is done. Returns
+   IGRAPH_INTERRUPTED if the caller was interrupted meanwhile. */
+
+static int igraph_i_pool_execute(igraph_i_job_t *job, igraph_bool_t poll) {
+    int interrupted = 0;
+
+    igraph_i_memory_share(&job->memory);
+    pthread_mutex_lock(&igraph_i_pool.lock);
+    igraph_i_pool.job = job;
+    igraph_i_pool.generation++;
+    pthread_cond_broadcast(&igraph_i_pool.wake);
+
+    while (job->active > 0 || (!job->cancel && job->next < job->items)) {
+        if (!poll) {
+            pthread_cond_wait(&igraph_i_pool.finished, &igraph_i_pool.lock);
+            continue;
+        }
+        igraph_i_pool_timedwait();
+        if (!interrupted && igraph_i_interruption_handler) {
+            pthread_mutex_unlock(&igraph_i_pool.lock);
+            interrupted = igraph_allow_interruption(NULL) != IGRAPH_SUCCESS;
+            pthread_mutex_lock(&igraph_i_pool.lock);
+            if (interrupted) {
+                job->cancel = 1;
+            }
+        }
+    }
+
+    /* Workers that did not pick up the job yet will not see it */
+    igraph_i_pool.job = 0;
+    igraph_i_pool.busy = 0;
+    pthread_mutex_unlock(&igraph_i_pool.lock);
+    igraph_i_memory_unshare();
+
+    return interrupted ? IGRAPH_INTERRUPTED : IGRAPH_SUCCESS;
+}
+
+#endif
+
+/* Calls func(arg, i, nthreads) for i = 0, ..., nthreads-1, on the
+   workers of the pool, and returns when all calls have returned. If
+   the pool is busy, or there is no thread support, the parts run on
+   the calling thread, so the function cannot fail; func must not
+   depend on the parts running at the same time, and it must not call
+   the error handling functions of igraph. */
+
+void igraph_i_parallel_run(igraph_i_thread_func_t *func, void *arg,
+                           int nthreads) {
+    int i;
+
+    if (nthreads > IGRAPH_I_MAX_THREADS) {
+        nthreads = IGRAPH_I_MAX_THREADS;
+    }
+
+#if defined(HAVE_PTHREAD)
+    if (nthreads > 1 && igraph_i_pool_acquire(igraph_get_num_threads()) > 0) {
+        igraph_i_job_t job;
+        memset(&job, 0, sizeof(job));
+        job.run_func = func;
+        job.arg = arg;
+        job.items = nthreads;
+        job.nparts = nthreads;
+        igraph_i_pool_execute(&job, /* poll= */ 0);
+        return;
+    }
+#endif
+
+    for (i = 0; i < nthreads; i++) {
+        func(arg, i, nthreads);
+    }
+}
+
+/* Calls func(arg, from, to) for consecutive ranges of at most
+   'grain' indices that cover 0, ..., n-1. The ranges run in parallel
+   on the workers of the pool in thread-safe builds, and on the
+   calling thread otherwise, so func must allocate its temporary data
+   itself.
+
+   func may fail with IGRAPH_ERROR and it may be interrupted with
+   IGRAPH_ALLOW_INTERRUPTION, as usual. On a worker, the finally stack
+   of the worker is freed, the remaining ranges are skipped and the
+   first error is reported here, through the error handler of the
+   calling thread. The workers allocate through the allocator and the
+   memory statistics of the calling thread. */
+
+int igraph_i_parallel_for(long int n, long int grain,
+                          igraph_i_parallel_for_func_t *func, void *arg) {
+    long int items, i;
+
+    if (grain < 1) {
+        grain = 1;
+    }
+    items = (n + grain - 1) / grain;
+
+#if defined(HAVE_PTHREAD) && defined(HAVE_TLS)
+    if (items > 1 && igraph_get_num_threads() > 1 &&
+        igraph_i_pool_acquire(igraph_get_num_threads()) > 0) {
+        igraph_i_job_t job;
+        int ret;
+        memset(&job, 0, sizeof(job));
+        job.for_func = func;
+        job.arg = arg;
+        job.n = n;
+        job.grain = grain;
+        job.items = items;
+        ret = igraph_i_pool_execute(&job, /* poll= */ 1);
+        if (job.error) {
+            IGRAPH_ERROR(job.message[0] ? job.message :
+                         "Parallel computation failed", job.error);
+        }
+        return ret;
+    }
+#endif
+
+    for (i = 0; i < items; i++) {
+        long int from = i * grain, to = from + grain < n ? from + grain : n;
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(func(arg, from, to));
+    }
+
+    return 0;
+}
+
+typedef struct igraph_i_reduce_data_t {
+    igraph_i_parallel_reduce_func_t *func;
+    void *arg;
+    long int grain;
+    igraph_real_t *partial;
+} igraph_i_reduce_data_t;
+
+static int igraph_i_parallel_reduce_chunk(void *arg, long int from,
+        long int to) {
+    igraph_i_reduce_data_t *data = (igraph_i_reduce_data_t *) arg;
+    return data->func(data->arg, from, to, &data->partial[from / data->grain]);
+}
+
+/* Like igraph_i_parallel_for(), but every range computes a partial
+   sum, and the sum of these is stored in 'result'. The partial sums
+   are added in the order of the ranges, so the result does not depend
+   on the number of threads. */
+
+int igraph_i_parallel_reduce(long int n, long int grain,
+                             igraph_i_parallel_reduce_func_t *func,
+                             void *arg, igraph_real_t *result) {
+    igraph_i_reduce_data_t data;
+    long int items, i;
+    igraph_real_t sum = 0.0;
+
+    if (grain < 1) {
+        grain = 1;
+    }
+    items = (n + grain - 1) / grain;
+
+    data.func = func;
+    data.arg = arg;
+    data.grain = grain;
+    data.partial = igraph_Calloc(items > 0 ? items : 1, igraph_real_t);
+    if (data.partial == 0) {
+        IGRAPH_ERROR("Cannot run parallel reduction", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, data.partial);
+
+    IGRAPH_CHECK(igraph_i_parallel_for(n, grain, igraph_i_parallel_reduce_chunk,
+                                       &data));
+    for (i = 0; i < items; i++) {
+        sum += data.partial[i];
+    }
+    *result = sum;
+
+    igraph_Free(data.partial);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+
+#include "igraph_trace.h"
+#include "igraph_trace_internal.h"
+#include "config.h"
+
+#include <string.h>
+
+/**
+ * \section about_trace
+ *
+ * <para>
+ * When a computation is slow, it is often useful to know how much
+ * work it does: how many vertices a traversal visits, how many
+ * edges Dijkstra's algorithm relaxes, or how many matrix-vector
+ * products ARPACK needs. igraph keeps such work counters, of type
+ * \ref igraph_trace_counters_t, if it was configured with the
+ * <code>--enable-tracing</code> option. Otherwise the counters are
+ * not compiled into the library, they cost nothing, and they are
+ * always zero.
+ * </para>
+ *
+ * <para>
+ * Every thread has its own counters. They can be queried with \ref
+ * igraph_trace_counters(), and set to zero with \ref
+ * igraph_trace_counters_reset(). Alternatively, a trace handler can be
+ * installed with \ref igraph_set_trace_handler(). It is called when
+ * one of the following functions returns successfully, with the name
+ * of the function and the work it did, then the counters are set to
+ * zero: \ref igraph_bfs(), \ref igraph_dfs(),
+ * \ref igraph_shortest_paths_dijkstra(), \ref
+ * igraph_get_shortest_paths_dijkstra(), \ref
+ * igraph_get_all_shortest_paths_dijkstra(), \ref
+ * igraph_get_shortest_path(), \ref igraph_get_shortest_path_dijkstra(),
+ * \ref igraph_get_shortest_path_astar(), \ref
+ * igraph_arpack_rssolve(), \ref igraph_arpack_rnsolve(), \ref
+ * igraph_community_multilevel() and \ref igraph_community_leiden().
+ * If one of these functions calls another one, the handler is called
+ * for both, and the counters of the outer one only contain the work
+ * that is not reported by the inner one.
+ * </para>
+ */
+
+#ifdef IGRAPH_TRACING
+IGRAPH_THREAD_LOCAL igraph_trace_counters_t igraph_i_trace_counters;
+#endif
+
+static IGRAPH_THREAD_LOCAL igraph_trace_handler_t *igraph_i_trace_handler = 0;
+
+/**
+ * \function igraph_set_trace_handler
+ * \brief Installs a trace handler.
+ *
+ * The trace handler is called when an igraph function that updates
+ * the tracing counters returns. Trace handlers are only called if
+ * igraph was configured with <code>--enable-tracing</code>.
+ * \param new_handler The new trace handler, or a null pointer to
+ *    remove the current one.
+ * \return The old trace handler.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_trace_handler_t *igraph_set_trace_handler(igraph_trace_handler_t *new_handler) {
+    igraph_trace_handler_t *previous_handler = igraph_i_trace_handler;
+    igraph_i_trace_handler = new_handler;
+    return previous_handler;
+}
+
+/**
+ * \function igraph_trace_counters
+ * \brief Queries the tracing counters of the calling thread.
+ *
+ * \param counters Pointer to an \ref igraph_trace_counters_t
+ *    structure, the counters are copied here. They are all zero if
+ *    igraph was configured without tracing.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_trace_counters(igraph_trace_counters_t *counters) {
+#ifdef IGRAPH_TRACING
+    *counters = igraph_i_trace_counters;
+#else
+    memset(counters, 0, sizeof(igraph_trace_counters_t));
+#endif
+}
+
+/**
+ * \function igraph_trace_counters_reset
+ * \brief Sets the tracing counters of the calling thread to zero.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_trace_counters_reset(void) {
+#ifdef IGRAPH_TRACING
+    memset(&igraph_i_trace_counters, 0, sizeof(igraph_trace_counters_t));
+#endif
+}
+
+#ifdef IGRAPH_TRACING
+
+/* Passes the counters to the trace handler, if there is one, and
+   starts counting again from zero */
+
+void igraph_i_trace_report(const char *function) {
+    if (igraph_i_trace_handler) {
+        igraph_i_trace_handler(function, &igraph_i_trace_counters);
+        igraph_trace_counters_reset();
+    }
+}
+
+#endif
@@ -106,7 +106,7 @@ int igraph_transitivity_avglocal_undirected(const igraph_t *graph,
         VECTOR(rank)[ (long int) VECTOR(order)[i] ] = no_of_nodes - i - 1;
     }
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &allneis, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
     IGRAPH_CHECK(igraph_adjlist_simplify(&allneis));
 
@@ -653,7 +653,7 @@ int igraph_transitivity_undirected(const igraph_t *graph,
         VECTOR(rank)[ (long int) VECTOR(order)[i] ] = no_of_nodes - i - 1;
     }
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &allneis, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
     IGRAPH_CHECK(igraph_adjlist_simplify(&allneis));
 
@@ -854,7 +854,7 @@ int igraph_transitivity_barrat4(const igraph_t *graph,
         VECTOR(rank)[ (long int)VECTOR(order)[i] ] = no_of_nodes - i - 1;
     }
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &incident, IGRAPH_ALL));
+    IGRAPH_CHECK(igraph_inclist_init_flat(graph, &incident, IGRAPH_ALL));
     IGRAPH_FINALLY(igraph_inclist_destroy, &incident);
 
     IGRAPH_CHECK(igraph_vector_long_init(&neis, no_of_nodes));
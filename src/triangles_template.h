@@ -48,7 +48,7 @@ for (i = 0; i < no_of_nodes; i++) {
     VECTOR(rank)[ VECTOR(order)[i] ] = no_of_nodes - i - 1;
 }
 
-IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, IGRAPH_ALL));
+IGRAPH_CHECK(igraph_adjlist_init_flat(graph, &allneis, IGRAPH_ALL));
 IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
 IGRAPH_CHECK(igraph_i_trans4_al_simplify(&allneis, &rank));
 
@@ -25,13 +25,119 @@
 #include "igraph_interface.h"
 #include "igraph_attributes.h"
 #include "igraph_memory.h"
+#include "igraph_storage_internal.h"
+#include "igraph_threads_internal.h"
 #include <string.h>     /* memset & co. */
 #include "config.h"
 
 /* Internal functions */
 
-int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vector_t *index,
-                          igraph_integer_t nodes);
+int igraph_i_create_start(igraph_vector_int_t *res, igraph_vector_int_t *el,
+                          igraph_vector_int_t *index, igraph_integer_t nodes);
+
+/* Reserves space for an edge list or an edge index. The capacity is
+   at least doubled each time, just like in igraph_vector_push_back(),
+   so that the storage is not copied for every small batch of new
+   edges. */
+
+static int igraph_i_edgelist_reserve(igraph_vector_int_t *v, long int size) {
+    long int capacity = igraph_vector_int_capacity(v);
+    if (size > capacity) {
+        long int newcap = igraph_vector_int_size(v) * 2;
+        IGRAPH_CHECK(igraph_vector_int_reserve(v, size > newcap ? size : newcap));
+    }
+    return 0;
+}
+
+/* Merges the new edges, edge ids from 'no_of_edges' on, into the
+   sorted index 'idx'. 'neworder' is the order of the new edges only,
+   relative to 'no_of_edges', sorted by (el1, el2). The merge runs
+   backwards in place, so only the tail of the index that follows the
+   first new edge is moved, without the sorting and the allocations of
+   a full rebuild. igraph_vector_int_order() puts edges with the same
+   endpoints in decreasing id order, so new edges precede old ones
+   with the same endpoints, and the result is exactly the index that
+   would be built for the whole edge list. 'idx' must have enough
+   reserved space. */
+
+static void igraph_i_merge_index(igraph_vector_int_t *idx,
+                                 const igraph_vector_int_t *neworder,
+                                 const igraph_vector_int_t *el1,
+                                 const igraph_vector_int_t *el2,
+                                 long int no_of_edges) {
+
+    long int edges_to_add = igraph_vector_int_size(neworder);
+    long int i = no_of_edges - 1, j = edges_to_add - 1;
+    long int w = no_of_edges + edges_to_add - 1;
+
+    igraph_vector_int_resize(idx, no_of_edges + edges_to_add); /* reserved */
+
+    while (j >= 0) {
+        long int enew = no_of_edges + VECTOR(*neworder)[j];
+        if (i >= 0) {
+            long int eold = VECTOR(*idx)[i];
+            if (VECTOR(*el1)[eold] > VECTOR(*el1)[enew] ||
+                (VECTOR(*el1)[eold] == VECTOR(*el1)[enew] &&
+                 VECTOR(*el2)[eold] >= VECTOR(*el2)[enew])) {
+                VECTOR(*idx)[w--] = (int) eold;
+                i--;
+                continue;
+            }
+        }
+        VECTOR(*idx)[w--] = (int) enew;
+        j--;
+    }
+}
+
+/* Updates a start vector after the edges from 'no_of_edges' on were
+   added to the edge list 'el'. 'neworder' is the order of the new
+   edges by 'el', as for igraph_i_merge_index(). Every start position
+   is shifted by the number of new edges that come before it. */
+
+static void igraph_i_update_start(igraph_vector_int_t *res,
+                                  const igraph_vector_int_t *neworder,
+                                  const igraph_vector_int_t *el,
+                                  long int no_of_edges) {
+
+    long int no_of_nodes = igraph_vector_int_size(res) - 1;
+    long int edges_to_add = igraph_vector_int_size(neworder);
+    long int i, j = 0;
+
+    for (i = 0; i <= no_of_nodes; i++) {
+        while (j < edges_to_add &&
+               VECTOR(*el)[no_of_edges + VECTOR(*neworder)[j]] < i) {
+            j++;
+        }
+        VECTOR(*res)[i] += (int) j;
+    }
+}
+
+/* Removes the deleted edges from an index and updates the corresponding
+   start vector, in place. 'newids' gives the new id of each edge plus
+   one, or zero for a deleted edge. New ids must be increasing in the
+   old ids, then the order of the remaining edges is kept. */
+
+static void igraph_i_compact_index(igraph_vector_int_t *idx,
+                                   igraph_vector_int_t *start,
+                                   const int *newids) {
+
+    long int no_of_nodes = igraph_vector_int_size(start) - 1;
+    long int begin = 0, v, k, w = 0;
+
+    for (v = 0; v < no_of_nodes; v++) {
+        long int end = VECTOR(*start)[v + 1];
+        VECTOR(*start)[v] = (int) w;
+        for (k = begin; k < end; k++) {
+            int e = newids[ VECTOR(*idx)[k] ];
+            if (e != 0) {
+                VECTOR(*idx)[w++] = e - 1;
+            }
+        }
+        begin = end;
+    }
+    VECTOR(*start)[no_of_nodes] = (int) w;
+    igraph_vector_int_resize(idx, w); /* gets smaller */
+}
 
 /**
  * \section about_basic_interface
@@ -123,12 +229,15 @@ int igraph_empty_attrs(igraph_t *graph, igraph_integer_t n, igraph_bool_t direct
 
     graph->n = 0;
     graph->directed = directed;
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->from, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->to, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->oi, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->ii, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->os, 1);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->is, 1);
+    graph->storage = 0;
+    graph->eid_index = 0;
+    graph->pending = 0;
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->from, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->to, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->oi, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->ii, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->os, 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->is, 1);
 
     VECTOR(graph->os)[0] = 0;
     VECTOR(graph->is)[0] = 0;
@@ -164,12 +273,178 @@ void igraph_destroy(igraph_t *graph) {
 
     IGRAPH_I_ATTRIBUTE_DESTROY(graph);
 
-    igraph_vector_destroy(&graph->from);
-    igraph_vector_destroy(&graph->to);
-    igraph_vector_destroy(&graph->oi);
-    igraph_vector_destroy(&graph->ii);
-    igraph_vector_destroy(&graph->os);
-    igraph_vector_destroy(&graph->is);
+    igraph_drop_eid_index(graph);
+
+    if (graph->storage) {
+        igraph_i_storage_release(graph->storage);
+        return;
+    }
+
+    igraph_vector_int_destroy(&graph->from);
+    igraph_vector_int_destroy(&graph->to);
+    igraph_vector_int_destroy(&graph->oi);
+    igraph_vector_int_destroy(&graph->ii);
+    igraph_vector_int_destroy(&graph->os);
+    igraph_vector_int_destroy(&graph->is);
+}
+
+/* Several threads may copy the same graph, or destroy graphs that
+   share a storage, at the same time. This lock protects the reference
+   counts, and the 'storage' member of a graph while it is shared for
+   the first time. */
+
+IGRAPH_I_STATIC_MUTEX(igraph_i_storage_lock);
+
+/* Releases the external memory of a graph, see igraph_i_storage_t,
+   the memory is freed when the last graph using it releases it. */
+
+void igraph_i_storage_release(igraph_i_storage_t *storage) {
+    long int refcount;
+
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_storage_lock);
+    refcount = --storage->refcount;
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_storage_lock);
+
+    if (refcount > 0) {
+        return;
+    }
+    storage->release(storage->data, storage->size);
+    igraph_Free(storage);
+}
+
+/* The storage of the graphs created by igraph_copy(): 'data' holds
+   the six vectors of the original graph, in the order of igraph_t. */
+
+#define IGRAPH_I_SHARED_VECTORS 6
+
+static void igraph_i_storage_destroy_vectors(void *data, size_t size) {
+    igraph_vector_int_t *vectors = (igraph_vector_int_t *) data;
+    size_t i;
+    for (i = 0; i < size / sizeof(igraph_vector_int_t); i++) {
+        igraph_vector_int_destroy(&vectors[i]);
+    }
+    igraph_Free(vectors);
+}
+
+/* Makes the edge list and the indices of the graph shareable, by
+   moving them into a reference counted storage, if they are not in
+   one already, and adds a user to the storage. The contents of the
+   vectors are not touched, only the 'storage' member of the graph is
+   set, under the lock, so a const graph can be shared by several
+   threads at the same time. The new storage is allocated without the
+   lock, and thrown away if another thread was faster. */
+
+static int igraph_i_graph_share(const igraph_t *graph,
+                                igraph_i_storage_t **result) {
+    igraph_i_storage_t *storage, *existing;
+    igraph_vector_int_t *vectors;
+
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_storage_lock);
+    existing = graph->storage;
+    if (existing) {
+        existing->refcount += 1;
+    }
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_storage_lock);
+    if (existing) {
+        *result = existing;
+        return 0;
+    }
+
+    storage = igraph_Calloc(1, igraph_i_storage_t);
+    if (storage == 0) {
+        IGRAPH_ERROR("Cannot share graph", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, storage);
+    vectors = igraph_Calloc(IGRAPH_I_SHARED_VECTORS, igraph_vector_int_t);
+    if (vectors == 0) {
+        IGRAPH_ERROR("Cannot share graph", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY_CLEAN(1);
+
+    vectors[0] = graph->from;
+    vectors[1] = graph->to;
+    vectors[2] = graph->oi;
+    vectors[3] = graph->ii;
+    vectors[4] = graph->os;
+    vectors[5] = graph->is;
+    storage->data = vectors;
+    storage->size = IGRAPH_I_SHARED_VECTORS * sizeof(igraph_vector_int_t);
+    storage->release = igraph_i_storage_destroy_vectors;
+    storage->refcount = 2;      /* the graph and the new user */
+
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_storage_lock);
+    existing = graph->storage;
+    if (existing) {
+        existing->refcount += 1;
+    } else {
+        ((igraph_t *) graph)->storage = storage;
+    }
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_storage_lock);
+
+    if (existing) {
+        /* Not igraph_i_storage_destroy_vectors(), the vectors are
+           still used by the graph */
+        igraph_Free(vectors);
+        igraph_Free(storage);
+        *result = existing;
+    } else {
+        *result = storage;
+    }
+    return 0;
+}
+
+/* Makes sure that the edge list and the indices of the graph own their
+   memory, so that the graph can be modified, and drops the edge id
+   index, which would become invalid. This must be called by every
+   function that modifies them. */
+
+int igraph_i_graph_own(igraph_t *graph) {
+    igraph_vector_int_t from, to, oi, ii, os, is;
+    igraph_bool_t last;
+
+    igraph_drop_eid_index(graph);
+
+    if (!graph->storage) {
+        return 0;
+    }
+
+    /* The last user of a shared storage takes the vectors back. No
+       other graph can start to share it meanwhile, as that would need
+       a copy of this graph, which is being modified. */
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_storage_lock);
+    last = graph->storage->refcount == 1;
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_storage_lock);
+    if (last && graph->storage->release == igraph_i_storage_destroy_vectors) {
+        igraph_Free(graph->storage->data);
+        igraph_Free(graph->storage);
+        graph->storage = 0;
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_copy(&from, &graph->from));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &from);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to, &graph->to));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to);
+    IGRAPH_CHECK(igraph_vector_int_copy(&oi, &graph->oi));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &oi);
+    IGRAPH_CHECK(igraph_vector_int_copy(&ii, &graph->ii));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ii);
+    IGRAPH_CHECK(igraph_vector_int_copy(&os, &graph->os));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &os);
+    IGRAPH_CHECK(igraph_vector_int_copy(&is, &graph->is));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &is);
+
+    igraph_i_storage_release(graph->storage);
+    graph->storage = 0;
+    graph->from = from;
+    graph->to = to;
+    graph->oi = oi;
+    graph->ii = ii;
+    graph->os = os;
+    graph->is = is;
+
+    IGRAPH_FINALLY_CLEAN(6);
+    return 0;
 }
 
 /**
@@ -178,9 +453,19 @@ void igraph_destroy(igraph_t *graph) {
  * \brief Creates an exact (deep) copy of a graph.
  *
  * </para><para>
- * This function deeply copies a graph object to create an exact
- * replica of it. The new replica should be destroyed by calling
- * \ref igraph_destroy() on it when not needed any more.
+ * This function creates an exact replica of a graph object. The new
+ * replica should be destroyed by calling \ref igraph_destroy() on it
+ * when not needed any more. The edge id index of the graph, see \ref
+ * igraph_build_eid_index(), is not copied.
+ *
+ * </para><para>
+ * The edge list and the indices of the graph are not copied, they are
+ * shared by the two graphs, until one of them is modified, e.g. by
+ * \ref igraph_add_edges(). Only the modified graph copies them then,
+ * so creating a copy that is only queried is cheap. As the graphs are
+ * independent from the user's point of view, sharing is invisible,
+ * and the same graph can be copied from several threads at the same
+ * time. The attributes are copied.
  *
  * </para><para>
  * You can also create a shallow copy of a graph by simply using the
@@ -191,32 +476,39 @@ void igraph_destroy(igraph_t *graph) {
  * \param from Pointer to the graph object to copy.
  * \return Error code.
  *
- * Time complexity:  O(|V|+|E|) for a
- * graph with |V| vertices and
- * |E| edges.
+ * Time complexity: O(1) for the structure of the graph, plus the time
+ * needed to copy the attributes. The first modification of \p from or
+ * \p to takes O(|V|+|E|) additional time.
  *
  * \example examples/simple/igraph_copy.c
  */
 
 int igraph_copy(igraph_t *to, const igraph_t *from) {
+    igraph_i_storage_t *storage;
+
+    /* The copy shares the indices, so they must be complete */
+    IGRAPH_CHECK(igraph_i_graph_index(from));
+
+    /* Sharing the vectors does not change the graph, only who owns
+       its memory, so it is fine to do it to a const graph */
+    IGRAPH_CHECK(igraph_i_graph_share(from, &storage));
+    IGRAPH_FINALLY(igraph_i_storage_release, storage);
+
     to->n = from->n;
     to->directed = from->directed;
-    IGRAPH_CHECK(igraph_vector_copy(&to->from, &from->from));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->from);
-    IGRAPH_CHECK(igraph_vector_copy(&to->to, &from->to));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->to);
-    IGRAPH_CHECK(igraph_vector_copy(&to->oi, &from->oi));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->oi);
-    IGRAPH_CHECK(igraph_vector_copy(&to->ii, &from->ii));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->ii);
-    IGRAPH_CHECK(igraph_vector_copy(&to->os, &from->os));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->os);
-    IGRAPH_CHECK(igraph_vector_copy(&to->is, &from->is));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->is);
+    to->eid_index = 0;
+    to->pending = 0;
+    to->from = from->from;
+    to->to = from->to;
+    to->oi = from->oi;
+    to->ii = from->ii;
+    to->os = from->os;
+    to->is = from->is;
+    to->storage = storage;
 
     IGRAPH_I_ATTRIBUTE_COPY(to, from, 1, 1, 1); /* does IGRAPH_CHECK */
 
-    IGRAPH_FINALLY_CLEAN(6);
+    IGRAPH_FINALLY_CLEAN(1);
     return 0;
 }
 
@@ -245,21 +537,31 @@ int igraph_copy(igraph_t *to, const igraph_t *from) {
  * This function invalidates all iterators.
  *
  * </para><para>
- * Time complexity: O(|V|+|E|) where
- * |V| is the number of vertices and
- * |E| is the number of
- * edges in the \em new, extended graph.
+ * The new edges are only appended to the edge list, the indices of
+ * the graph are updated when they are needed next time, e.g. by \ref
+ * igraph_neighbors() or \ref igraph_degree(). So a stream of edges
+ * can be added in many small batches, and the indices are updated
+ * only once, when the graph is queried. If there are at least as many
+ * indexed edges as pending ones, then the pending edges are sorted on
+ * their own and merged into the existing indices, otherwise the
+ * indices are rebuilt. Both take O(|V|+|E|) time, so alternating
+ * between adding single edges and querying the graph still takes
+ * quadratic time.
+ *
+ * </para><para>
+ * Time complexity: O(k) amortized, where k is the number of new
+ * edges, plus the time needed to add the edge attributes. The next
+ * query of the graph takes an additional O(|V|+|E|) time, for all
+ * edges added since the previous query together.
  *
  * \example examples/simple/igraph_add_edges.c
  */
 int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
                      void *attr) {
-    long int no_of_edges = igraph_vector_size(&graph->from);
+    long int no_of_edges = igraph_vector_int_size(&graph->from);
     long int edges_to_add = igraph_vector_size(edges) / 2;
     long int i = 0;
-    igraph_error_handler_t *oldhandler;
-    int ret1, ret2;
-    igraph_vector_t newoi, newii;
+    int ret;
     igraph_bool_t directed = igraph_is_directed(graph);
 
     if (igraph_vector_size(edges) % 2 != 0) {
@@ -269,69 +571,156 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
         IGRAPH_ERROR("cannot add edges", IGRAPH_EINVVID);
     }
 
-    /* from & to */
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->from, no_of_edges + edges_to_add));
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->to, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_i_graph_own(graph));
+
+    /* from & to, the indices are updated by igraph_i_graph_index() */
+    IGRAPH_CHECK(igraph_i_edgelist_reserve(&graph->from, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_i_edgelist_reserve(&graph->to, no_of_edges + edges_to_add));
 
     while (i < edges_to_add * 2) {
-        if (directed || VECTOR(*edges)[i] > VECTOR(*edges)[i + 1]) {
-            igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
-            igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
+        int v1 = (int) VECTOR(*edges)[i++];
+        int v2 = (int) VECTOR(*edges)[i++];
+        if (directed || v1 > v2) {
+            igraph_vector_int_push_back(&graph->from, v1); /* reserved */
+            igraph_vector_int_push_back(&graph->to,   v2); /* reserved */
         } else {
-            igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
-            igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
+            igraph_vector_int_push_back(&graph->to,   v1); /* reserved */
+            igraph_vector_int_push_back(&graph->from, v2); /* reserved */
         }
     }
 
-    /* disable the error handler temporarily */
-    oldhandler = igraph_set_error_handler(igraph_error_handler_ignore);
+    /* Attributes */
+    if (graph->attr) {
+        ret = igraph_i_attribute_add_edges(graph, edges, attr);
+        if (ret != 0) {
+            igraph_vector_int_resize(&graph->from, no_of_edges); /* gets smaller */
+            igraph_vector_int_resize(&graph->to, no_of_edges);   /* gets smaller */
+            IGRAPH_ERROR("cannot add edges", ret);
+        }
+    }
+
+    /* The graph is not shared and not used by other threads while it
+       is modified, a plain store is enough. */
+    graph->pending += (igraph_integer_t) edges_to_add;
+
+    return 0;
+}
+
+/* Several threads may query the same graph while it has pending
+   edges, this lock makes sure that only one of them indexes them. */
+
+IGRAPH_I_STATIC_MUTEX(igraph_i_index_lock);
+
+/* Adds the pending edges of the graph to the indices. Small batches
+   are merged into the existing indices, large ones (compared to the
+   number of indexed edges) are indexed from scratch, because that is
+   faster for them. On error the graph is left unchanged, with the
+   same pending edges, and the error code is returned without calling
+   the error handler. */
 
-    /* oi & ii */
-    ret1 = igraph_vector_init(&newoi, no_of_edges);
-    ret2 = igraph_vector_init(&newii, no_of_edges);
+static int igraph_i_graph_index_pending(igraph_t *graph) {
+    long int no_of_edges = igraph_vector_int_size(&graph->from) - graph->pending;
+    long int edges_to_add = graph->pending;
+    int ret1, ret2;
+    igraph_vector_int_t newoi, newii;
+    igraph_bool_t merge = no_of_edges > 0 && edges_to_add <= no_of_edges;
+
+    if (merge) {
+        ret1 = igraph_i_edgelist_reserve(&graph->oi, no_of_edges + edges_to_add);
+        if (ret1 != 0) {
+            return ret1;
+        }
+        ret1 = igraph_i_edgelist_reserve(&graph->ii, no_of_edges + edges_to_add);
+        if (ret1 != 0) {
+            return ret1;
+        }
+    }
+
+    /* oi & ii, for merging only the order of the new edges is needed */
+    ret1 = igraph_vector_int_init(&newoi, merge ? edges_to_add : no_of_edges + edges_to_add);
+    ret2 = igraph_vector_int_init(&newii, merge ? edges_to_add : no_of_edges + edges_to_add);
     if (ret1 != 0 || ret2 != 0) {
-        igraph_vector_resize(&graph->from, no_of_edges); /* gets smaller */
-        igraph_vector_resize(&graph->to, no_of_edges);   /* gets smaller */
-        igraph_set_error_handler(oldhandler);
-        IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
+        if (ret1 == 0) {
+            igraph_vector_int_destroy(&newoi);
+        }
+        if (ret2 == 0) {
+            igraph_vector_int_destroy(&newii);
+        }
+        return IGRAPH_ERROR_SELECT_2(ret1, ret2);
+    }
+    if (merge) {
+        igraph_vector_int_t newfrom, newto;
+        igraph_vector_int_view(&newfrom, VECTOR(graph->from) + no_of_edges,
+                               edges_to_add);
+        igraph_vector_int_view(&newto, VECTOR(graph->to) + no_of_edges,
+                               edges_to_add);
+        ret1 = igraph_vector_int_order(&newfrom, &newto, &newoi, graph->n);
+        ret2 = igraph_vector_int_order(&newto, &newfrom, &newii, graph->n);
+    } else {
+        ret1 = igraph_vector_int_order(&graph->from, &graph->to, &newoi, graph->n);
+        ret2 = igraph_vector_int_order(&graph->to, &graph->from, &newii, graph->n);
     }
-    ret1 = igraph_vector_order(&graph->from, &graph->to, &newoi, graph->n);
-    ret2 = igraph_vector_order(&graph->to, &graph->from, &newii, graph->n);
     if (ret1 != 0 || ret2 != 0) {
-        igraph_vector_resize(&graph->from, no_of_edges);
-        igraph_vector_resize(&graph->to, no_of_edges);
-        igraph_vector_destroy(&newoi);
-        igraph_vector_destroy(&newii);
-        igraph_set_error_handler(oldhandler);
-        IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
+        igraph_vector_int_destroy(&newoi);
+        igraph_vector_int_destroy(&newii);
+        return IGRAPH_ERROR_SELECT_2(ret1, ret2);
     }
 
-    /* Attributes */
-    if (graph->attr) {
-        igraph_set_error_handler(oldhandler);
-        ret1 = igraph_i_attribute_add_edges(graph, edges, attr);
-        igraph_set_error_handler(igraph_error_handler_ignore);
-        if (ret1 != 0) {
-            igraph_vector_resize(&graph->from, no_of_edges);
-            igraph_vector_resize(&graph->to, no_of_edges);
-            igraph_vector_destroy(&newoi);
-            igraph_vector_destroy(&newii);
-            igraph_set_error_handler(oldhandler);
-            IGRAPH_ERROR("cannot add edges", ret1);
-        }
+    if (merge) {
+        /* oi & ii were reserved, os & is do not change length, error safe */
+        igraph_i_merge_index(&graph->oi, &newoi, &graph->from, &graph->to,
+                             no_of_edges);
+        igraph_i_merge_index(&graph->ii, &newii, &graph->to, &graph->from,
+                             no_of_edges);
+        igraph_i_update_start(&graph->os, &newoi, &graph->from, no_of_edges);
+        igraph_i_update_start(&graph->is, &newii, &graph->to, no_of_edges);
+        igraph_vector_int_destroy(&newoi);
+        igraph_vector_int_destroy(&newii);
+    } else {
+        /* os & is, its length does not change, error safe */
+        igraph_i_create_start(&graph->os, &graph->from, &newoi, graph->n);
+        igraph_i_create_start(&graph->is, &graph->to, &newii, graph->n);
+
+        /* everything went fine  */
+        igraph_vector_int_destroy(&graph->oi);
+        igraph_vector_int_destroy(&graph->ii);
+        graph->oi = newoi;
+        graph->ii = newii;
     }
 
-    /* os & is, its length does not change, error safe */
-    igraph_i_create_start(&graph->os, &graph->from, &newoi, graph->n);
-    igraph_i_create_start(&graph->is, &graph->to, &newii, graph->n);
+    return 0;
+}
+
+/* Makes sure that the indices of the graph contain all of its edges,
+   see the 'pending' member of igraph_t. This must be called by every
+   function that uses 'oi', 'ii', 'os' or 'is'. It only reads one int
+   if there are no pending edges. Indexing does not change the graph
+   from the user's point of view, so it is fine to do it to a const
+   graph, even from several threads at the same time: only one of
+   them indexes, under the lock, and the others wait for it. */
 
-    /* everything went fine  */
-    igraph_vector_destroy(&graph->oi);
-    igraph_vector_destroy(&graph->ii);
-    graph->oi = newoi;
-    graph->ii = newii;
-    igraph_set_error_handler(oldhandler);
+int igraph_i_graph_index(const igraph_t *graph) {
+    igraph_error_handler_t *oldhandler;
+    int ret = 0;
+
+    if (IGRAPH_I_ATOMIC_LOAD(&graph->pending) == 0) {
+        return 0;
+    }
+
+    IGRAPH_I_STATIC_MUTEX_LOCK(&igraph_i_index_lock);
+    if (graph->pending != 0) {
+        oldhandler = igraph_set_error_handler(igraph_error_handler_ignore);
+        ret = igraph_i_graph_index_pending((igraph_t *) graph);
+        igraph_set_error_handler(oldhandler);
+        if (ret == 0) {
+            IGRAPH_I_ATOMIC_STORE(&((igraph_t *) graph)->pending, 0);
+        }
+    }
+    IGRAPH_I_STATIC_MUTEX_UNLOCK(&igraph_i_index_lock);
 
+    if (ret != 0) {
+        IGRAPH_ERROR("Cannot index the new edges of the graph", ret);
+    }
     return 0;
 }
 
@@ -359,21 +748,24 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
  * \example examples/simple/igraph_add_vertices.c
  */
 int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
-    long int ec = igraph_ecount(graph);
+    /* the new vertices have no edges, not even pending ones */
+    long int ec = igraph_ecount(graph) - graph->pending;
     long int i;
 
     if (nv < 0) {
         IGRAPH_ERROR("cannot add negative number of vertices", IGRAPH_EINVAL);
     }
 
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->os, graph->n + nv + 1));
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->is, graph->n + nv + 1));
+    IGRAPH_CHECK(igraph_i_graph_own(graph));
 
-    igraph_vector_resize(&graph->os, graph->n + nv + 1); /* reserved */
-    igraph_vector_resize(&graph->is, graph->n + nv + 1); /* reserved */
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->os, graph->n + nv + 1));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->is, graph->n + nv + 1));
+
+    igraph_vector_int_resize(&graph->os, graph->n + nv + 1); /* reserved */
+    igraph_vector_int_resize(&graph->is, graph->n + nv + 1); /* reserved */
     for (i = graph->n + 1; i < graph->n + nv + 1; i++) {
-        VECTOR(graph->os)[i] = ec;
-        VECTOR(graph->is)[i] = ec;
+        VECTOR(graph->os)[i] = (int) ec;
+        VECTOR(graph->is)[i] = (int) ec;
     }
 
     graph->n += nv;
@@ -403,6 +795,14 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
  * \param edges The edges to remove.
  * \return Error code.
  *
+ * </para><para>
+ * The edge list and the indices are compacted in place, but the
+ * function allocates a temporary array with one integer for each edge
+ * of the graph, to record which edges are removed and the new ids of
+ * the others. If the graph has attributes, a vector of the new edge
+ * ids is allocated for them, too.
+ *
+ * </para><para>
  * Time complexity: O(|V|+|E|) where
  * |V|
  * and |E| are the number of vertices
@@ -412,16 +812,16 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
  */
 int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     long int no_of_edges = igraph_ecount(graph);
-    long int no_of_nodes = igraph_vcount(graph);
     long int edges_to_remove = 0;
     long int remaining_edges;
     igraph_eit_t eit;
 
-    igraph_vector_t newfrom, newto, newoi;
-
     int *mark;
     long int i, j;
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+    IGRAPH_CHECK(igraph_i_graph_own(graph));
+
     mark = igraph_Calloc(no_of_edges, int);
     if (mark == 0) {
         IGRAPH_ERROR("Cannot delete edges", IGRAPH_ENOMEM);
@@ -444,23 +844,6 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     igraph_eit_destroy(&eit);
     IGRAPH_FINALLY_CLEAN(1);
 
-    IGRAPH_VECTOR_INIT_FINALLY(&newfrom, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newto, remaining_edges);
-
-    /* Actually remove the edges, move from pos i to pos j in newfrom/newto */
-    for (i = 0, j = 0; j < remaining_edges; i++) {
-        if (mark[i] == 0) {
-            VECTOR(newfrom)[j] = VECTOR(graph->from)[i];
-            VECTOR(newto)[j] = VECTOR(graph->to)[i];
-            j++;
-        }
-    }
-
-    /* Create index, this might require additional memory */
-    IGRAPH_VECTOR_INIT_FINALLY(&newoi, remaining_edges);
-    IGRAPH_CHECK(igraph_vector_order(&newfrom, &newto, &newoi, no_of_nodes));
-    IGRAPH_CHECK(igraph_vector_order(&newto, &newfrom, &graph->ii, no_of_nodes));
-
     /* Edge attributes, we need an index that gives the ids of the
        original edges for every new edge.
     */
@@ -477,25 +860,30 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
         IGRAPH_FINALLY_CLEAN(1);
     }
 
-    /* Ok, we've all memory needed, free the old structure  */
-    igraph_vector_destroy(&graph->from);
-    igraph_vector_destroy(&graph->to);
-    igraph_vector_destroy(&graph->oi);
-    graph->from = newfrom;
-    graph->to = newto;
-    graph->oi = newoi;
-    IGRAPH_FINALLY_CLEAN(3);
+    /* No more memory is needed from here on, the edge list and the
+       indices are compacted in place. 'mark' is reused to store the
+       new id of every remaining edge, plus one, and zero for the
+       removed edges. */
+    for (i = 0, j = 0; i < no_of_edges; i++) {
+        mark[i] = mark[i] ? 0 : (int) ++j;
+    }
+    for (i = 0; i < no_of_edges; i++) {
+        if (mark[i] != 0) {
+            VECTOR(graph->from)[mark[i] - 1] = VECTOR(graph->from)[i];
+            VECTOR(graph->to  )[mark[i] - 1] = VECTOR(graph->to  )[i];
+        }
+    }
+    igraph_vector_int_resize(&graph->from, remaining_edges); /* gets smaller */
+    igraph_vector_int_resize(&graph->to, remaining_edges);   /* gets smaller */
+
+    /* Removing edges does not change the relative order of the
+       remaining ones in the indices, so they need no sorting. */
+    igraph_i_compact_index(&graph->oi, &graph->os, mark);
+    igraph_i_compact_index(&graph->ii, &graph->is, mark);
 
     igraph_Free(mark);
     IGRAPH_FINALLY_CLEAN(1);
 
-    /* Create start vectors, no memory is needed for this */
-    igraph_i_create_start(&graph->os, &graph->from, &graph->oi,
-                          (igraph_integer_t) no_of_nodes);
-    igraph_i_create_start(&graph->is, &graph->to,   &graph->ii,
-                          (igraph_integer_t) no_of_nodes);
-
-    /* Nothing to deallocate... */
     return 0;
 }
 
@@ -543,6 +931,8 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     long int i, j;
     long int remaining_vertices, remaining_edges;
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     if (idx) {
         my_vertex_recoding = idx;
         IGRAPH_CHECK(igraph_vector_resize(idx, no_of_nodes));
@@ -575,8 +965,8 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     }
     /* create edge recoding vector */
     for (remaining_edges = 0, i = 0; i < no_of_edges; i++) {
-        long int from = (long int) VECTOR(graph->from)[i];
-        long int to = (long int) VECTOR(graph->to)[i];
+        long int from = VECTOR(graph->from)[i];
+        long int to = VECTOR(graph->to)[i];
         if (VECTOR(*my_vertex_recoding)[from] != 0 &&
             VECTOR(*my_vertex_recoding)[to  ] != 0) {
             VECTOR(edge_recoding)[i] = remaining_edges + 1;
@@ -587,30 +977,42 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     /* start creating the graph */
     newgraph.n = (igraph_integer_t) remaining_vertices;
     newgraph.directed = graph->directed;
+    newgraph.storage = 0;
+    newgraph.eid_index = 0;
+    newgraph.pending = 0;
 
     /* allocate vectors */
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.from, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.to, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.oi, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.ii, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.os, remaining_vertices + 1);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.is, remaining_vertices + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.from, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.to, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.oi, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.ii, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.os, remaining_vertices + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.is, remaining_vertices + 1);
 
     /* Add the edges */
     for (i = 0, j = 0; j < remaining_edges; i++) {
         if (VECTOR(edge_recoding)[i] > 0) {
-            long int from = (long int) VECTOR(graph->from)[i];
-            long int to = (long int) VECTOR(graph->to  )[i];
-            VECTOR(newgraph.from)[j] = VECTOR(*my_vertex_recoding)[from] - 1;
-            VECTOR(newgraph.to  )[j] = VECTOR(*my_vertex_recoding)[to] - 1;
+            long int from = VECTOR(graph->from)[i];
+            long int to = VECTOR(graph->to  )[i];
+            VECTOR(newgraph.from)[j] = (int) VECTOR(*my_vertex_recoding)[from] - 1;
+            VECTOR(newgraph.to  )[j] = (int) VECTOR(*my_vertex_recoding)[to] - 1;
             j++;
         }
     }
-    /* update oi & ii */
-    IGRAPH_CHECK(igraph_vector_order(&newgraph.from, &newgraph.to, &newgraph.oi,
-                                     remaining_vertices));
-    IGRAPH_CHECK(igraph_vector_order(&newgraph.to, &newgraph.from, &newgraph.ii,
-                                     remaining_vertices));
+    /* update oi & ii, the vertex recoding keeps the order of the
+       remaining vertices, so the old indices only need to be filtered */
+    for (i = 0, j = 0; j < remaining_edges; i++) {
+        long int e = (long int) VECTOR(edge_recoding)[ VECTOR(graph->oi)[i] ];
+        if (e > 0) {
+            VECTOR(newgraph.oi)[j++] = (int) e - 1;
+        }
+    }
+    for (i = 0, j = 0; j < remaining_edges; i++) {
+        long int e = (long int) VECTOR(edge_recoding)[ VECTOR(graph->ii)[i] ];
+        if (e > 0) {
+            VECTOR(newgraph.ii)[j++] = (int) e - 1;
+        }
+    }
 
     IGRAPH_CHECK(igraph_i_create_start(&newgraph.os, &newgraph.from,
                                        &newgraph.oi, (igraph_integer_t)
@@ -700,7 +1102,7 @@ igraph_integer_t igraph_vcount(const igraph_t *graph) {
  * Time complexity: O(1)
  */
 igraph_integer_t igraph_ecount(const igraph_t *graph) {
-    return (igraph_integer_t) igraph_vector_size(&graph->from);
+    return (igraph_integer_t) igraph_vector_int_size(&graph->from);
 }
 
 /**
@@ -751,6 +1153,8 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
         IGRAPH_ERROR("cannot get neighbors", IGRAPH_EINVMODE);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     if (! graph->directed) {
         mode = IGRAPH_ALL;
     }
@@ -769,31 +1173,27 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
     if (!igraph_is_directed(graph) || mode != IGRAPH_ALL) {
 
         if (mode & IGRAPH_OUT) {
-            j = (long int) VECTOR(graph->os)[node + 1];
-            for (i = (long int) VECTOR(graph->os)[node]; i < j; i++) {
-                VECTOR(*neis)[idx++] =
-                    VECTOR(graph->to)[ (long int)VECTOR(graph->oi)[i] ];
+            j = VECTOR(graph->os)[node + 1];
+            for (i = VECTOR(graph->os)[node]; i < j; i++) {
+                VECTOR(*neis)[idx++] = VECTOR(graph->to)[ VECTOR(graph->oi)[i] ];
             }
         }
         if (mode & IGRAPH_IN) {
-            j = (long int) VECTOR(graph->is)[node + 1];
-            for (i = (long int) VECTOR(graph->is)[node]; i < j; i++) {
-                VECTOR(*neis)[idx++] =
-                    VECTOR(graph->from)[ (long int)VECTOR(graph->ii)[i] ];
+            j = VECTOR(graph->is)[node + 1];
+            for (i = VECTOR(graph->is)[node]; i < j; i++) {
+                VECTOR(*neis)[idx++] = VECTOR(graph->from)[ VECTOR(graph->ii)[i] ];
             }
         }
     } else {
         /* both in- and out- neighbors in a directed graph,
            we need to merge the two 'vectors' */
-        long int jj1 = (long int) VECTOR(graph->os)[node + 1];
-        long int j2 = (long int) VECTOR(graph->is)[node + 1];
-        long int i1 = (long int) VECTOR(graph->os)[node];
-        long int i2 = (long int) VECTOR(graph->is)[node];
+        long int jj1 = VECTOR(graph->os)[node + 1];
+        long int j2 = VECTOR(graph->is)[node + 1];
+        long int i1 = VECTOR(graph->os)[node];
+        long int i2 = VECTOR(graph->is)[node];
         while (i1 < jj1 && i2 < j2) {
-            long int n1 = (long int) VECTOR(graph->to)[
-                   (long int)VECTOR(graph->oi)[i1] ];
-            long int n2 = (long int) VECTOR(graph->from)[
-                   (long int)VECTOR(graph->ii)[i2] ];
+            long int n1 = VECTOR(graph->to)[ VECTOR(graph->oi)[i1] ];
+            long int n2 = VECTOR(graph->from)[ VECTOR(graph->ii)[i2] ];
             if (n1 < n2) {
                 VECTOR(*neis)[idx++] = n1;
                 i1++;
@@ -808,14 +1208,12 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
             }
         }
         while (i1 < jj1) {
-            long int n1 = (long int) VECTOR(graph->to)[
-                   (long int)VECTOR(graph->oi)[i1] ];
+            long int n1 = VECTOR(graph->to)[ VECTOR(graph->oi)[i1] ];
             VECTOR(*neis)[idx++] = n1;
             i1++;
         }
         while (i2 < j2) {
-            long int n2 = (long int) VECTOR(graph->from)[
-                   (long int)VECTOR(graph->ii)[i2] ];
+            long int n2 = VECTOR(graph->from)[ VECTOR(graph->ii)[i2] ];
             VECTOR(*neis)[idx++] = n2;
             i2++;
         }
@@ -829,41 +1227,41 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
  *
  */
 
-int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vector_t *iindex,
-                          igraph_integer_t nodes) {
+int igraph_i_create_start(igraph_vector_int_t *res, igraph_vector_int_t *el,
+                          igraph_vector_int_t *iindex, igraph_integer_t nodes) {
 
-# define EDGE(i) (VECTOR(*el)[ (long int) VECTOR(*iindex)[(i)] ])
+# define EDGE(i) (VECTOR(*el)[ VECTOR(*iindex)[(i)] ])
 
     long int no_of_nodes;
     long int no_of_edges;
     long int i, j, idx;
 
     no_of_nodes = nodes;
-    no_of_edges = igraph_vector_size(el);
+    no_of_edges = igraph_vector_int_size(el);
 
     /* result */
 
-    IGRAPH_CHECK(igraph_vector_resize(res, nodes + 1));
+    IGRAPH_CHECK(igraph_vector_int_resize(res, nodes + 1));
 
     /* create the index */
 
-    if (igraph_vector_size(el) == 0) {
+    if (no_of_edges == 0) {
         /* empty graph */
-        igraph_vector_null(res);
+        igraph_vector_int_null(res);
     } else {
         idx = -1;
         for (i = 0; i <= EDGE(0); i++) {
             idx++; VECTOR(*res)[idx] = 0;
         }
         for (i = 1; i < no_of_edges; i++) {
-            long int n = (long int) (EDGE(i) - EDGE((long int)VECTOR(*res)[idx]));
+            long int n = EDGE(i) - EDGE(VECTOR(*res)[idx]);
             for (j = 0; j < n; j++) {
-                idx++; VECTOR(*res)[idx] = i;
+                idx++; VECTOR(*res)[idx] = (int) i;
             }
         }
-        j = (long int) EDGE((long int)VECTOR(*res)[idx]);
+        j = EDGE(VECTOR(*res)[idx]);
         for (i = 0; i < no_of_nodes - j; i++) {
-            idx++; VECTOR(*res)[idx] = no_of_edges;
+            idx++; VECTOR(*res)[idx] = (int) no_of_edges;
         }
     }
 
@@ -944,6 +1342,8 @@ int igraph_degree(const igraph_t *graph, igraph_vector_t *res,
         IGRAPH_ERROR("degree calculation failed", IGRAPH_EINVMODE);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     nodes_to_calc = IGRAPH_VIT_SIZE(vit);
     if (!igraph_is_directed(graph)) {
         mode = IGRAPH_ALL;
@@ -976,9 +1376,9 @@ int igraph_degree(const igraph_t *graph, igraph_vector_t *res,
                  IGRAPH_VIT_NEXT(vit), i++) {
                 long int vid = IGRAPH_VIT_GET(vit);
                 VECTOR(*res)[i] += (VECTOR(graph->os)[vid + 1] - VECTOR(graph->os)[vid]);
-                for (j = (long int) VECTOR(graph->os)[vid];
+                for (j = VECTOR(graph->os)[vid];
                      j < VECTOR(graph->os)[vid + 1]; j++) {
-                    if (VECTOR(graph->to)[ (long int)VECTOR(graph->oi)[j] ] == vid) {
+                    if (VECTOR(graph->to)[ VECTOR(graph->oi)[j] ] == vid) {
                         VECTOR(*res)[i] -= 1;
                     }
                 }
@@ -990,9 +1390,9 @@ int igraph_degree(const igraph_t *graph, igraph_vector_t *res,
                  IGRAPH_VIT_NEXT(vit), i++) {
                 long int vid = IGRAPH_VIT_GET(vit);
                 VECTOR(*res)[i] += (VECTOR(graph->is)[vid + 1] - VECTOR(graph->is)[vid]);
-                for (j = (long int) VECTOR(graph->is)[vid];
+                for (j = VECTOR(graph->is)[vid];
                      j < VECTOR(graph->is)[vid + 1]; j++) {
-                    if (VECTOR(graph->from)[ (long int)VECTOR(graph->ii)[j] ] == vid) {
+                    if (VECTOR(graph->from)[ VECTOR(graph->ii)[j] ] == vid) {
                         VECTOR(*res)[i] -= 1;
                     }
                 }
@@ -1068,6 +1468,133 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
     return 0;
 }
 
+/* The edge id index is an open addressing hash table with linear
+   probing. Each slot holds the two end points of an edge and its id,
+   next to each other, the id is -1 in empty slots. The table is at
+   most half full. Undirected edges are stored with the larger vertex
+   id first, as in the edge list. */
+
+typedef struct igraph_i_eid_index_s {
+    unsigned long int mask;         /* number of slots minus one */
+    int *slots;
+} igraph_i_eid_index_t;
+
+#define IGRAPH_I_EID_HASH(from, to) \
+    ((((unsigned long int) (from)) * 2654435761UL) ^ \
+     (((unsigned long int) (to)) * 2246822519UL + 3266489917UL))
+
+static igraph_integer_t igraph_i_eid_index_find(const igraph_i_eid_index_t *index,
+        long int from, long int to) {
+    unsigned long int pos = IGRAPH_I_EID_HASH(from, to) & index->mask;
+    const int *slot = index->slots + 3 * pos;
+    while (slot[2] >= 0) {
+        if (slot[0] == from && slot[1] == to) {
+            return slot[2];
+        }
+        pos = (pos + 1) & index->mask;
+        slot = index->slots + 3 * pos;
+    }
+    return -1;
+}
+
+/**
+ * \function igraph_build_eid_index
+ * \brief Builds a hash index for looking up edge ids.
+ *
+ * </para><para>
+ * By default \ref igraph_get_eid() and \ref igraph_get_eids() find an
+ * edge with a binary search in the sorted incidence list of one of its
+ * end points, this takes O(log(d)) time and it jumps around in the
+ * memory for high degree vertices. After calling this function they
+ * use a hash table instead, and a lookup takes expected constant time.
+ * This is worth it if a large number of edges are looked up, e.g. when
+ * scoring many vertex pairs.
+ *
+ * </para><para>
+ * The index needs about 24 bytes for each edge (less if there are
+ * multiple edges). It is attached to the graph and it is dropped
+ * automatically if the graph is modified, or when the graph is
+ * destroyed. It is not copied by \ref igraph_copy(). Calling this
+ * function for a graph that already has an index does nothing.
+ *
+ * </para><para>
+ * The lookup functions give the same results with and without the
+ * index, also for multiple edges.
+ * \param graph The graph object.
+ * \return Error code.
+ *
+ * Time complexity: O(|E|), the number of edges, expected.
+ *
+ * \sa \ref igraph_drop_eid_index().
+ */
+
+int igraph_build_eid_index(igraph_t *graph) {
+    long int no_of_edges = igraph_ecount(graph);
+    unsigned long int size = 16;
+    igraph_i_eid_index_t *index;
+    long int e;
+
+    if (graph->eid_index) {
+        return 0;
+    }
+
+    while (size < 2 * (unsigned long int) no_of_edges) {
+        size *= 2;
+    }
+
+    index = igraph_Calloc(1, igraph_i_eid_index_t);
+    if (index == 0) {
+        IGRAPH_ERROR("Cannot build edge id index", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, index);
+    index->mask = size - 1;
+    index->slots = igraph_Calloc(3 * size, int);
+    if (index->slots == 0) {
+        IGRAPH_ERROR("Cannot build edge id index", IGRAPH_ENOMEM);
+    }
+    memset(index->slots, 0xff, 3 * size * sizeof(int));
+
+    /* The binary search finds the multiple edge with the largest id,
+       so later edges overwrite the earlier ones */
+    for (e = 0; e < no_of_edges; e++) {
+        int from = VECTOR(graph->from)[e], to = VECTOR(graph->to)[e];
+        unsigned long int pos = IGRAPH_I_EID_HASH(from, to) & index->mask;
+        int *slot = index->slots + 3 * pos;
+        while (slot[2] >= 0 && (slot[0] != from || slot[1] != to)) {
+            pos = (pos + 1) & index->mask;
+            slot = index->slots + 3 * pos;
+        }
+        slot[0] = from;
+        slot[1] = to;
+        slot[2] = (int) e;
+    }
+
+    graph->eid_index = index;
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/**
+ * \function igraph_drop_eid_index
+ * \brief Frees the edge id index of a graph.
+ *
+ * </para><para>
+ * Frees the memory of the index created by \ref
+ * igraph_build_eid_index(), edge ids are looked up with binary search
+ * again. It does nothing if the graph has no index.
+ * \param graph The graph object.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_drop_eid_index(igraph_t *graph) {
+    if (graph->eid_index) {
+        igraph_Free(graph->eid_index->slots);
+        igraph_Free(graph->eid_index);
+        graph->eid_index = 0;
+    }
+}
+
 /* This is an unsafe macro. Only supply variable names, i.e. no
    expressions as parameters, otherwise nasty things can happen */
 
@@ -1075,7 +1602,7 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
     do {                                                      \
         while ((start) < (end)) {                                 \
             long int mid=(start)+((end)-(start))/2;                 \
-            long int e=(long int) VECTOR((iindex))[mid];            \
+            long int e=VECTOR((iindex))[mid];            \
             if (VECTOR((edgelist))[e] < (value)) {                  \
                 (start)=mid+1;                                        \
             } else {                                                \
@@ -1083,7 +1610,7 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
             }                                                       \
         }                                                         \
         if ((start)<(N)) {                                        \
-            long int e=(long int) VECTOR((iindex))[(start)];        \
+            long int e=VECTOR((iindex))[(start)];        \
             if (VECTOR((edgelist))[e] == (value)) {                 \
                 *(pos)=(igraph_integer_t) e;              \
             }                                                       \
@@ -1091,16 +1618,20 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
 
 #define FIND_DIRECTED_EDGE(graph,xfrom,xto,eid)                     \
     do {                                                              \
-        long int start=(long int) VECTOR(graph->os)[xfrom];         \
-        long int end=(long int) VECTOR(graph->os)[xfrom+1];         \
-        long int N=end;                                                 \
-        long int start2=(long int) VECTOR(graph->is)[xto];          \
-        long int end2=(long int) VECTOR(graph->is)[xto+1];          \
-        long int N2=end2;                                               \
-        if (end-start<end2-start2) {                                    \
-            BINSEARCH(start,end,xto,graph->oi,graph->to,N,eid);           \
+        if (graph->eid_index) {                                         \
+            *(eid)=igraph_i_eid_index_find(graph->eid_index,xfrom,xto);   \
         } else {                                                        \
-            BINSEARCH(start2,end2,xfrom,graph->ii,graph->from,N2,eid);    \
+            long int start=VECTOR(graph->os)[xfrom];                      \
+            long int end=VECTOR(graph->os)[xfrom+1];                      \
+            long int N=end;                                               \
+            long int start2=VECTOR(graph->is)[xto];                       \
+            long int end2=VECTOR(graph->is)[xto+1];                       \
+            long int N2=end2;                                             \
+            if (end-start<end2-start2) {                                  \
+                BINSEARCH(start,end,xto,graph->oi,graph->to,N,eid);         \
+            } else {                                                      \
+                BINSEARCH(start2,end2,xfrom,graph->ii,graph->from,N2,eid);  \
+            }                                                             \
         }                                                               \
     } while (0)
 
@@ -1132,6 +1663,8 @@ int igraph_edges(const igraph_t *graph, igraph_es_t eids,
  * of \c pfrom and in-degree of \c pto if \p directed is true. If \p directed
  * is false, then it is O(log(d)+log(d2)), where d is the same as before and
  * d2 is the minimum of the out-degree of \c pto and the in-degree of \c pfrom.
+ * O(1) expected, if the graph has an edge id index, see \ref
+ * igraph_build_eid_index().
  *
  * \example examples/simple/igraph_get_eid.c
  *
@@ -1149,6 +1682,8 @@ int igraph_get_eid(const igraph_t *graph, igraph_integer_t *eid,
         IGRAPH_ERROR("cannot get edge id", IGRAPH_EINVVID);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     *eid = -1;
     if (igraph_is_directed(graph)) {
 
@@ -1198,6 +1733,8 @@ int igraph_get_eids_pairs(const igraph_t *graph, igraph_vector_t *eids,
         IGRAPH_ERROR("Cannot get edge ids, invalid vertex id", IGRAPH_EINVVID);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     IGRAPH_CHECK(igraph_vector_resize(eids, n / 2));
 
     if (igraph_is_directed(graph)) {
@@ -1246,6 +1783,8 @@ int igraph_get_eids_path(const igraph_t *graph, igraph_vector_t *eids,
         IGRAPH_ERROR("Cannot get edge ids, invalid vertex id", IGRAPH_EINVVID);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     IGRAPH_CHECK(igraph_vector_resize(eids, n == 0 ? 0 : n - 1));
 
     if (igraph_is_directed(graph)) {
@@ -1330,7 +1869,8 @@ int igraph_get_eids_path(const igraph_t *graph, igraph_vector_t *eids,
  * \return Error code.
  *
  * Time complexity: O(n log(d)), where n is the number of queried
- * edges and d is the average degree of the vertices.
+ * edges and d is the average degree of the vertices. O(n) expected,
+ * if the graph has an edge id index, see \ref igraph_build_eid_index().
  *
  * \sa \ref igraph_get_eid() for a single edge, \ref
  * igraph_get_eids_multi() for a version that handles multiple edges
@@ -1372,7 +1912,7 @@ int igraph_get_eids(const igraph_t *graph, igraph_vector_t *eids,
     do {                                                      \
         while ((start) < (end)) {                                 \
             long int mid=(start)+((end)-(start))/2;                 \
-            long int e=(long int) VECTOR((iindex))[mid];        \
+            long int e=VECTOR((iindex))[mid];        \
             if (VECTOR((edgelist))[e] < (value)) {                  \
                 (start)=mid+1;                                        \
             } else {                                                \
@@ -1380,10 +1920,10 @@ int igraph_get_eids(const igraph_t *graph, igraph_vector_t *eids,
             }                                                       \
         }                                                         \
         if ((start)<(N)) {                                        \
-            long int e=(long int) VECTOR((iindex))[(start)];        \
+            long int e=VECTOR((iindex))[(start)];        \
             while ((start)<(N) && seen[e] && VECTOR(edgelist)[e] == (value)) {  \
                 (start)++;                        \
-                e=(long int) VECTOR(iindex)[(start)];         \
+                e=VECTOR(iindex)[(start)];         \
             }                                           \
             if ((start)<(N) && !(seen[e]) && VECTOR(edgelist)[e] == (value)) {  \
                 *(pos)=(igraph_integer_t) e;                  \
@@ -1392,11 +1932,11 @@ int igraph_get_eids(const igraph_t *graph, igraph_vector_t *eids,
 
 #define FIND_DIRECTED_EDGE(graph,xfrom,xto,eid,seen)            \
     do {                                                              \
-        long int start=(long int) VECTOR(graph->os)[xfrom];         \
-        long int end=(long int) VECTOR(graph->os)[xfrom+1];         \
+        long int start=VECTOR(graph->os)[xfrom];         \
+        long int end=VECTOR(graph->os)[xfrom+1];         \
         long int N=end;                                                 \
-        long int start2=(long int) VECTOR(graph->is)[xto];          \
-        long int end2=(long int) VECTOR(graph->is)[xto+1];          \
+        long int start2=VECTOR(graph->is)[xto];          \
+        long int end2=VECTOR(graph->is)[xto+1];          \
         long int N2=end2;                                               \
         if (end-start<end2-start2) {                                    \
             BINSEARCH(start,end,xto,graph->oi,graph->to,N,eid,seen);      \
@@ -1440,6 +1980,8 @@ int igraph_get_eids_multipairs(const igraph_t *graph, igraph_vector_t *eids,
         IGRAPH_ERROR("Cannot get edge ids, invalid vertex id", IGRAPH_EINVVID);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     seen = igraph_Calloc(no_of_edges, igraph_bool_t);
     if (seen == 0) {
         IGRAPH_ERROR("Cannot get edge ids", IGRAPH_ENOMEM);
@@ -1501,6 +2043,8 @@ int igraph_get_eids_multipath(const igraph_t *graph, igraph_vector_t *eids,
         IGRAPH_ERROR("Cannot get edge ids, invalid vertex id", IGRAPH_EINVVID);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     seen = igraph_Calloc(no_of_edges, igraph_bool_t);
     if (!seen) {
         IGRAPH_ERROR("Cannot get edge ids", IGRAPH_ENOMEM);
@@ -1674,6 +2218,8 @@ int igraph_incident(const igraph_t *graph, igraph_vector_t *eids,
         IGRAPH_ERROR("cannot get neighbors", IGRAPH_EINVMODE);
     }
 
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+
     if (! graph->directed) {
         mode = IGRAPH_ALL;
     }
@@ -1690,17 +2236,109 @@ int igraph_incident(const igraph_t *graph, igraph_vector_t *eids,
     IGRAPH_CHECK(igraph_vector_resize(eids, length));
 
     if (mode & IGRAPH_OUT) {
-        j = (long int) VECTOR(graph->os)[node + 1];
-        for (i = (long int) VECTOR(graph->os)[node]; i < j; i++) {
+        j = VECTOR(graph->os)[node + 1];
+        for (i = VECTOR(graph->os)[node]; i < j; i++) {
             VECTOR(*eids)[idx++] = VECTOR(graph->oi)[i];
         }
     }
     if (mode & IGRAPH_IN) {
-        j = (long int) VECTOR(graph->is)[node + 1];
-        for (i = (long int) VECTOR(graph->is)[node]; i < j; i++) {
+        j = VECTOR(graph->is)[node + 1];
+        for (i = VECTOR(graph->is)[node]; i < j; i++) {
             VECTOR(*eids)[idx++] = VECTOR(graph->ii)[i];
         }
     }
 
     return 0;
 }
+
+/**
+ * \function igraph_csr_view
+ * \brief A read-only view of the neighbors of a vertex.
+ *
+ * Unlike \ref igraph_neighbors() and \ref igraph_incident(), this
+ * function does not copy anything, the view points directly into the
+ * indices of the graph. It is meant for tight loops that visit the
+ * neighbors of many vertices, e.g. in breadth-first search:
+ * <programlisting>
+ * igraph_csr_view_t view;
+ * IGRAPH_CHECK(igraph_csr_view(graph, &amp;view, vid, IGRAPH_OUT));
+ * for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+ *     long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+ *     long int edge = IGRAPH_CSR_VIEW_EDGE(view);
+ *     ...
+ * }
+ * </programlisting>
+ *
+ * </para><para>
+ * The neighbors are visited in the same order as they are listed by
+ * \ref igraph_neighbors(), i.e. for directed graphs with \c IGRAPH_ALL
+ * the out- and in-neighbors are merged on the fly. For \c IGRAPH_OUT
+ * and \c IGRAPH_IN, and for undirected graphs, the edges are also in
+ * the same order as in \ref igraph_incident(). Set the
+ * <code>merge</code> member of the view to false to get the
+ * \ref igraph_incident() order for directed graphs with \c IGRAPH_ALL
+ * as well: all out-edges first, then all in-edges.
+ *
+ * </para><para>
+ * The <code>out</code>, <code>out_end</code> and <code>in</code>,
+ * <code>in_end</code> members of the view are the (possibly empty)
+ * ranges of edge ids in the out- and in-list of the vertex. They can
+ * be used directly instead of the stepping macros, if the order of the
+ * neighbors is not important.
+ *
+ * </para><para>
+ * The view does not need to be destroyed. It is invalidated by any
+ * operation that modifies the graph.
+ * \param graph The graph object.
+ * \param view Pointer to an uninitialized view object.
+ * \param vid The vertex id.
+ * \param mode Specifies what kind of neighbors to include for
+ *        directed graphs. \c IGRAPH_OUT means only out-neighbors,
+ *        \c IGRAPH_IN only in-neighbors, \c IGRAPH_ALL both. This
+ *        parameter is ignored for undirected graphs.
+ * \return Error code. \c IGRAPH_EINVVID: invalid \p vid argument,
+ *   \c IGRAPH_EINVMODE: invalid \p mode argument.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_csr_view(const igraph_t *graph, igraph_csr_view_t *view,
+                    igraph_integer_t vid, igraph_neimode_t mode) {
+
+    long int node = vid;
+    const int *oi, *ii;
+
+    if (node < 0 || node > igraph_vcount(graph) - 1) {
+        IGRAPH_ERROR("cannot get neighbors", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
+        mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("cannot get neighbors", IGRAPH_EINVMODE);
+    }
+
+    IGRAPH_CHECK(igraph_i_graph_index(graph));
+    oi = VECTOR(graph->oi);
+    ii = VECTOR(graph->ii);
+
+    if (! graph->directed) {
+        mode = IGRAPH_ALL;
+    }
+
+    view->to = VECTOR(graph->to);
+    view->from = VECTOR(graph->from);
+    view->merge = graph->directed && mode == IGRAPH_ALL;
+    if (mode & IGRAPH_OUT) {
+        view->out = oi + VECTOR(graph->os)[node];
+        view->out_end = oi + VECTOR(graph->os)[node + 1];
+    } else {
+        view->out = view->out_end = oi;
+    }
+    if (mode & IGRAPH_IN) {
+        view->in = ii + VECTOR(graph->is)[node];
+        view->in_end = ii + VECTOR(graph->is)[node + 1];
+    } else {
+        view->in = view->in_end = ii;
+    }
+
+    return 0;
+}
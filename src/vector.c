@@ -23,6 +23,9 @@
 
 #include "igraph_types.h"
 #include "igraph_types_internal.h"
+#include "igraph_memory_internal.h"
+#include "igraph_threads_internal.h"
+#include "igraph_threading.h"
 #include "igraph_complex.h"
 #include "bigint.h"
 #include "config.h"
@@ -202,6 +205,250 @@ int igraph_vector_order(const igraph_vector_t* v,
     return 0;
 }
 
+/* Parallel version of igraph_vector_int_order(), for long vectors. It
+   is two stable counting sorts, by the secondary key and then by the
+   primary key, each done in four phases:
+   1. every thread counts the keys in its part of the input,
+   2. every thread sums the counts of its part of the keys over all
+      threads, giving the start of each key for each thread, relative
+      to its part of the keys,
+   3. every thread adds the total number of smaller keys of the
+      earlier parts,
+   4. every thread moves its part of the input to its place.
+   The first sort reads the indices in reverse order, this gives the
+   same order as the linked lists of the serial version: by the primary
+   key, then by the secondary key, then by decreasing index. */
+
+#define IGRAPH_I_ORDER_PARALLEL_MIN   (1 << 20)
+#define IGRAPH_I_ORDER_PER_THREAD_MIN (1 << 16)
+#define IGRAPH_I_MAX_ORDER_THREADS    64
+
+typedef struct igraph_i_order_data_t {
+    const int *src;     /* null: the indices, in reverse order */
+    const int *key;
+    int *dst;
+    int *count;         /* nthreads+1 rows, the last one is the sum */
+    long int *part_sum;
+    long int n, buckets;
+    int phase;
+} igraph_i_order_data_t;
+
+static void igraph_i_vector_int_order_thread(void *arg, int thread,
+        int nthreads) {
+    igraph_i_order_data_t *data = (igraph_i_order_data_t *) arg;
+    long int n = data->n, buckets = data->buckets;
+    long int from = n * thread / nthreads, to = n * (thread + 1) / nthreads;
+    long int bfrom = buckets * thread / nthreads;
+    long int bto = buckets * (thread + 1) / nthreads;
+    int *count = data->count + buckets * thread;
+    int *total = data->count + buckets * nthreads;
+    long int i, b, sum;
+    int t;
+
+    switch (data->phase) {
+    case 1:
+        memset(count, 0, sizeof(int) * (size_t) buckets);
+        if (data->src) {
+            for (i = from; i < to; i++) {
+                count[ data->key[ data->src[i] ] ]++;
+            }
+        } else {
+            for (i = from; i < to; i++) {
+                count[ data->key[n - 1 - i] ]++;
+            }
+        }
+        break;
+    case 2:
+        sum = 0;
+        for (b = bfrom; b < bto; b++) {
+            int start = 0;
+            for (t = 0; t < nthreads; t++) {
+                int c = data->count[buckets * t + b];
+                data->count[buckets * t + b] = start;
+                start += c;
+            }
+            total[b] = start;
+            sum += start;
+        }
+        data->part_sum[thread] = sum;
+        break;
+    case 3:
+        sum = 0;
+        for (t = 0; t < thread; t++) {
+            sum += data->part_sum[t];
+        }
+        for (b = bfrom; b < bto; b++) {
+            for (t = 0; t < nthreads; t++) {
+                data->count[buckets * t + b] += (int) sum;
+            }
+            sum += total[b];
+        }
+        break;
+    case 4:
+        if (data->src) {
+            for (i = from; i < to; i++) {
+                int idx = data->src[i];
+                data->dst[ count[ data->key[idx] ]++ ] = idx;
+            }
+        } else {
+            for (i = from; i < to; i++) {
+                int idx = (int) (n - 1 - i);
+                data->dst[ count[ data->key[idx] ]++ ] = idx;
+            }
+        }
+        break;
+    }
+}
+
+static int igraph_i_vector_int_order_parallel(const igraph_vector_int_t* v,
+        const igraph_vector_int_t *v2,
+        igraph_vector_int_t* res,
+        igraph_integer_t nodes, int nthreads) {
+    long int edges = igraph_vector_int_size(v);
+    igraph_vector_int_t tmp, count;
+    long int part_sum[IGRAPH_I_MAX_ORDER_THREADS];
+    igraph_i_order_data_t data;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&tmp, edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&count, ((long int) nodes + 1) * (nthreads + 1));
+    IGRAPH_CHECK(igraph_vector_int_resize(res, edges));
+
+    data.count = VECTOR(count);
+    data.part_sum = part_sum;
+    data.n = edges;
+    data.buckets = (long int) nodes + 1;
+
+    data.src = 0;
+    data.key = VECTOR(*v2);
+    data.dst = VECTOR(tmp);
+    for (data.phase = 1; data.phase <= 4; data.phase++) {
+        igraph_i_parallel_run(igraph_i_vector_int_order_thread, &data, nthreads);
+    }
+
+    data.src = VECTOR(tmp);
+    data.key = VECTOR(*v);
+    data.dst = VECTOR(*res);
+    for (data.phase = 1; data.phase <= 4; data.phase++) {
+        igraph_i_parallel_run(igraph_i_vector_int_order_thread, &data, nthreads);
+    }
+
+    igraph_vector_int_destroy(&count);
+    igraph_vector_int_destroy(&tmp);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \ingroup vector
+ * \function igraph_vector_int_order
+ * \brief Calculate the order of the elements in an integer vector.
+ *
+ * </para><para>
+ * This is the same two-pass radix sort as \ref igraph_vector_order(),
+ * but it works on integer vectors, so no floating point conversion is
+ * needed for the keys or the result. It is used to build the indices
+ * of \type igraph_t objects. Vectors with more than about a million
+ * elements are sorted on all processors, with a stable parallel
+ * counting sort; the result is the same as with a single thread.
+ * \param v The primary key, an \type igraph_vector_int_t object.
+ * \param v2 The secondary key, another \type igraph_vector_int_t
+ *    object of the same length.
+ * \param res An initialized \type igraph_vector_int_t object, it will
+ *    be resized to match the size of \p v. The result of the
+ *    computation will be stored here.
+ * \param nodes The largest element in \p v and \p v2.
+ * \return Error code:
+ *         \c IGRAPH_ENOMEM: out of memory
+ *
+ * Time complexity: O(n+nodes), n is the length of \p v.
+ */
+
+int igraph_vector_int_order(const igraph_vector_int_t* v,
+                            const igraph_vector_int_t *v2,
+                            igraph_vector_int_t* res, igraph_integer_t nodes) {
+    long int edges = igraph_vector_int_size(v);
+    igraph_vector_int_t ptr;
+    igraph_vector_int_t rad;
+    long int i, j;
+    int nthreads;
+
+    assert(v != NULL);
+    assert(v->stor_begin != NULL);
+
+    if (edges >= IGRAPH_I_ORDER_PARALLEL_MIN) {
+        /* Every thread needs a counter for each key, use fewer threads
+           if there are much more keys than elements */
+        nthreads = igraph_get_num_threads();
+        if (nthreads > IGRAPH_I_MAX_ORDER_THREADS) {
+            nthreads = IGRAPH_I_MAX_ORDER_THREADS;
+        }
+        if (nthreads > edges / IGRAPH_I_ORDER_PER_THREAD_MIN) {
+            nthreads = (int) (edges / IGRAPH_I_ORDER_PER_THREAD_MIN);
+        }
+        if (nthreads > 2 * edges / ((long int) nodes + 1)) {
+            nthreads = (int) (2 * edges / ((long int) nodes + 1));
+        }
+        if (nthreads > 1) {
+            return igraph_i_vector_int_order_parallel(v, v2, res, nodes, nthreads);
+        }
+    }
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&ptr, (long int) nodes + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&rad, edges);
+    IGRAPH_CHECK(igraph_vector_int_resize(res, edges));
+
+    for (i = 0; i < edges; i++) {
+        long int radix = v2->stor_begin[i];
+        if (VECTOR(ptr)[radix] != 0) {
+            VECTOR(rad)[i] = VECTOR(ptr)[radix];
+        }
+        VECTOR(ptr)[radix] = (int) i + 1;
+    }
+
+    j = 0;
+    for (i = 0; i < nodes + 1; i++) {
+        if (VECTOR(ptr)[i] != 0) {
+            long int next = VECTOR(ptr)[i] - 1;
+            res->stor_begin[j++] = (int) next;
+            while (VECTOR(rad)[next] != 0) {
+                next = VECTOR(rad)[next] - 1;
+                res->stor_begin[j++] = (int) next;
+            }
+        }
+    }
+
+    igraph_vector_int_null(&ptr);
+    igraph_vector_int_null(&rad);
+
+    for (i = 0; i < edges; i++) {
+        long int edge = VECTOR(*res)[edges - i - 1];
+        long int radix = VECTOR(*v)[edge];
+        if (VECTOR(ptr)[radix] != 0) {
+            VECTOR(rad)[edge] = VECTOR(ptr)[radix];
+        }
+        VECTOR(ptr)[radix] = (int) edge + 1;
+    }
+
+    j = 0;
+    for (i = 0; i < nodes + 1; i++) {
+        if (VECTOR(ptr)[i] != 0) {
+            long int next = VECTOR(ptr)[i] - 1;
+            res->stor_begin[j++] = (int) next;
+            while (VECTOR(rad)[next] != 0) {
+                next = VECTOR(rad)[next] - 1;
+                res->stor_begin[j++] = (int) next;
+            }
+        }
+    }
+
+    igraph_vector_int_destroy(&ptr);
+    igraph_vector_int_destroy(&rad);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
 int igraph_vector_order1(const igraph_vector_t* v,
                          igraph_vector_t* res, igraph_real_t nodes) {
     long int edges = igraph_vector_size(v);
@@ -24,6 +24,7 @@
 #include "igraph_types.h"
 #include "igraph_vector_ptr.h"
 #include "igraph_memory.h"
+#include "igraph_memory_internal.h"
 #include "igraph_random.h"
 #include "igraph_error.h"
 #include "config.h"
@@ -94,7 +95,7 @@ int igraph_vector_ptr_init      (igraph_vector_ptr_t* v, int long size) {
     if (size < 0) {
         size = 0;
     }
-    v->stor_begin = igraph_Calloc(alloc_size, void*);
+    v->stor_begin = igraph_i_Calloc(alloc_size, void*);
     if (v->stor_begin == 0) {
         IGRAPH_ERROR("vector ptr init failed", IGRAPH_ENOMEM);
     }
@@ -136,7 +137,7 @@ const igraph_vector_ptr_t *igraph_vector_ptr_view (const igraph_vector_ptr_t *v,
 void igraph_vector_ptr_destroy   (igraph_vector_ptr_t* v) {
     assert(v != 0);
     if (v->stor_begin != 0) {
-        igraph_Free(v->stor_begin);
+        igraph_i_Free(v->stor_begin);
         v->stor_begin = NULL;
     }
 }
@@ -226,7 +227,7 @@ int igraph_vector_ptr_reserve   (igraph_vector_ptr_t* v, long int size) {
         return 0;
     }
 
-    tmp = igraph_Realloc(v->stor_begin, (size_t) size, void*);
+    tmp = igraph_i_Realloc(v->stor_begin, (size_t) size, void*);
     if (tmp == 0) {
         IGRAPH_ERROR("vector ptr reserve failed", IGRAPH_ENOMEM);
     }
@@ -447,7 +448,7 @@ int igraph_vector_ptr_resize(igraph_vector_ptr_t* v, long int newsize) {
  */
 
 int igraph_vector_ptr_init_copy(igraph_vector_ptr_t *v, void * *data, long int length) {
-    v->stor_begin = igraph_Calloc(length, void*);
+    v->stor_begin = igraph_i_Calloc(length, void*);
     if (v->stor_begin == 0) {
         IGRAPH_ERROR("cannot init ptr vector from array", IGRAPH_ENOMEM);
     }
@@ -502,7 +503,7 @@ void igraph_vector_ptr_copy_to(const igraph_vector_ptr_t *v, void** to) {
 int igraph_vector_ptr_copy(igraph_vector_ptr_t *to, const igraph_vector_ptr_t *from) {
     assert(from != NULL);
     /*   assert(from->stor_begin != NULL); */ /* TODO */
-    to->stor_begin = igraph_Calloc(igraph_vector_ptr_size(from), void*);
+    to->stor_begin = igraph_i_Calloc(igraph_vector_ptr_size(from), void*);
     if (to->stor_begin == 0) {
         IGRAPH_ERROR("cannot copy ptr vector", IGRAPH_ENOMEM);
     }
@@ -554,7 +555,7 @@ int igraph_vector_ptr_index_int(igraph_vector_ptr_t *v,
     void **tmp;
     int i, n = igraph_vector_int_size(idx);
 
-    tmp = igraph_Calloc(n, void*);
+    tmp = igraph_i_Calloc(n, void*);
     if (!tmp) {
         IGRAPH_ERROR("Cannot index pointer vector", IGRAPH_ENOMEM);
     }
@@ -563,7 +564,7 @@ int igraph_vector_ptr_index_int(igraph_vector_ptr_t *v,
         tmp[i] = VECTOR(*v)[ VECTOR(*idx)[i] ];
     }
 
-    igraph_Free(v->stor_begin);
+    igraph_i_Free(v->stor_begin);
     v->stor_begin = tmp;
     v->stor_end = v->end = tmp + n;
 
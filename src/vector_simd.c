@@ -0,0 +1,616 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_simd_internal.h"
+#include "config.h"
+
+#if defined(__SSE2__) || defined(HAVE_AVX2_TARGET)
+#include <immintrin.h>
+#endif
+
+/* ---------------------------------------------------------------- */
+/* Selecting the implementation                                     */
+/* ---------------------------------------------------------------- */
+
+/* -1 until the processor is queried. Several threads may query it at
+   the same time, they all store the same value. */
+
+static int igraph_i_simd_level = -1;
+
+static int igraph_i_simd_max_level(void) {
+#if defined(HAVE_AVX2_TARGET)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return 2;
+    }
+#endif
+#if defined(__SSE2__)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+#define IGRAPH_I_SIMD_LEVEL() \
+    (igraph_i_simd_level >= 0 ? igraph_i_simd_level : \
+     (igraph_i_simd_level = igraph_i_simd_max_level()))
+
+int igraph_i_simd_set_level(int level) {
+    int max = igraph_i_simd_max_level();
+    igraph_i_simd_level = level < max ? level : max;
+    return igraph_i_simd_level;
+}
+
+/* ---------------------------------------------------------------- */
+/* Plain C                                                          */
+/* ---------------------------------------------------------------- */
+
+/* The eight partial sums s[0..7] are combined as
+   ((s0 + s4) + (s2 + s6)) + ((s1 + s5) + (s3 + s7)), then the
+   remaining elements are added one by one. The vectorized versions
+   below do exactly the same. */
+
+#define IGRAPH_I_COMBINE8(s) \
+    (((s)[0] + (s)[4]) + ((s)[2] + (s)[6])) + (((s)[1] + (s)[5]) + ((s)[3] + (s)[7]))
+
+static igraph_real_t igraph_i_sum_real_c(const igraph_real_t *x, long int n) {
+    igraph_real_t s[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }, res;
+    long int i;
+    int k;
+    for (i = 0; i + 8 <= n; i += 8) {
+        for (k = 0; k < 8; k++) {
+            s[k] += x[i + k];
+        }
+    }
+    res = IGRAPH_I_COMBINE8(s);
+    for (; i < n; i++) {
+        res += x[i];
+    }
+    return res;
+}
+
+static igraph_real_t igraph_i_sumsq_real_c(const igraph_real_t *x, long int n) {
+    igraph_real_t s[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }, res;
+    long int i;
+    int k;
+    for (i = 0; i + 8 <= n; i += 8) {
+        for (k = 0; k < 8; k++) {
+            igraph_real_t sq = x[i + k] * x[i + k];
+            s[k] += sq;
+        }
+    }
+    res = IGRAPH_I_COMBINE8(s);
+    for (; i < n; i++) {
+        igraph_real_t sq = x[i] * x[i];
+        res += sq;
+    }
+    return res;
+}
+
+static igraph_real_t igraph_i_max_real_c(const igraph_real_t *x, long int n) {
+    igraph_real_t max = x[0];
+    long int i;
+    for (i = 1; i < n; i++) {
+        if (x[i] > max) {
+            max = x[i];
+        }
+    }
+    return max;
+}
+
+static igraph_real_t igraph_i_min_real_c(const igraph_real_t *x, long int n) {
+    igraph_real_t min = x[0];
+    long int i;
+    for (i = 1; i < n; i++) {
+        if (x[i] < min) {
+            min = x[i];
+        }
+    }
+    return min;
+}
+
+static int igraph_i_sum_int_c(const int *x, long int n) {
+    unsigned int res = 0;
+    long int i;
+    for (i = 0; i < n; i++) {
+        res += (unsigned int) x[i];
+    }
+    return (int) res;
+}
+
+static int igraph_i_max_int_c(const int *x, long int n) {
+    int max = x[0];
+    long int i;
+    for (i = 1; i < n; i++) {
+        if (x[i] > max) {
+            max = x[i];
+        }
+    }
+    return max;
+}
+
+static int igraph_i_min_int_c(const int *x, long int n) {
+    int min = x[0];
+    long int i;
+    for (i = 1; i < n; i++) {
+        if (x[i] < min) {
+            min = x[i];
+        }
+    }
+    return min;
+}
+
+/* ---------------------------------------------------------------- */
+/* SSE2                                                             */
+/* ---------------------------------------------------------------- */
+
+#if defined(__SSE2__)
+
+static igraph_real_t igraph_i_sum_real_sse2(const igraph_real_t *x, long int n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    igraph_real_t t[2], res;
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(x + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(x + i + 2));
+        a2 = _mm_add_pd(a2, _mm_loadu_pd(x + i + 4));
+        a3 = _mm_add_pd(a3, _mm_loadu_pd(x + i + 6));
+    }
+    a0 = _mm_add_pd(_mm_add_pd(a0, a2), _mm_add_pd(a1, a3));
+    _mm_storeu_pd(t, a0);
+    res = t[0] + t[1];
+    for (; i < n; i++) {
+        res += x[i];
+    }
+    return res;
+}
+
+static igraph_real_t igraph_i_sumsq_real_sse2(const igraph_real_t *x, long int n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0, v;
+    igraph_real_t t[2], res;
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        v = _mm_loadu_pd(x + i);     a0 = _mm_add_pd(a0, _mm_mul_pd(v, v));
+        v = _mm_loadu_pd(x + i + 2); a1 = _mm_add_pd(a1, _mm_mul_pd(v, v));
+        v = _mm_loadu_pd(x + i + 4); a2 = _mm_add_pd(a2, _mm_mul_pd(v, v));
+        v = _mm_loadu_pd(x + i + 6); a3 = _mm_add_pd(a3, _mm_mul_pd(v, v));
+    }
+    a0 = _mm_add_pd(_mm_add_pd(a0, a2), _mm_add_pd(a1, a3));
+    _mm_storeu_pd(t, a0);
+    res = t[0] + t[1];
+    for (; i < n; i++) {
+        igraph_real_t sq = x[i] * x[i];
+        res += sq;
+    }
+    return res;
+}
+
+/* maxpd(a, b) is 'a > b ? a : b', just like the scalar loop */
+
+static igraph_real_t igraph_i_max_real_sse2(const igraph_real_t *x, long int n) {
+    __m128d a0 = _mm_set1_pd(x[0]), a1 = a0;
+    igraph_real_t t[2], max;
+    long int i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        a0 = _mm_max_pd(_mm_loadu_pd(x + i), a0);
+        a1 = _mm_max_pd(_mm_loadu_pd(x + i + 2), a1);
+    }
+    _mm_storeu_pd(t, _mm_max_pd(a1, a0));
+    max = t[1] > t[0] ? t[1] : t[0];
+    for (; i < n; i++) {
+        if (x[i] > max) {
+            max = x[i];
+        }
+    }
+    return max;
+}
+
+static igraph_real_t igraph_i_min_real_sse2(const igraph_real_t *x, long int n) {
+    __m128d a0 = _mm_set1_pd(x[0]), a1 = a0;
+    igraph_real_t t[2], min;
+    long int i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        a0 = _mm_min_pd(_mm_loadu_pd(x + i), a0);
+        a1 = _mm_min_pd(_mm_loadu_pd(x + i + 2), a1);
+    }
+    _mm_storeu_pd(t, _mm_min_pd(a1, a0));
+    min = t[1] < t[0] ? t[1] : t[0];
+    for (; i < n; i++) {
+        if (x[i] < min) {
+            min = x[i];
+        }
+    }
+    return min;
+}
+
+static int igraph_i_sum_int_sse2(const int *x, long int n) {
+    __m128i a0 = _mm_setzero_si128(), a1 = a0;
+    int t[4];
+    unsigned int res;
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        a0 = _mm_add_epi32(a0, _mm_loadu_si128((const __m128i *) (x + i)));
+        a1 = _mm_add_epi32(a1, _mm_loadu_si128((const __m128i *) (x + i + 4)));
+    }
+    _mm_storeu_si128((__m128i *) t, _mm_add_epi32(a0, a1));
+    res = (unsigned int) t[0] + (unsigned int) t[1] +
+          (unsigned int) t[2] + (unsigned int) t[3];
+    for (; i < n; i++) {
+        res += (unsigned int) x[i];
+    }
+    return (int) res;
+}
+
+/* SSE2 has no integer maximum and minimum, select with a mask */
+
+#define IGRAPH_I_SELECT_SSE2(mask, a, b) \
+    _mm_or_si128(_mm_and_si128((mask), (a)), _mm_andnot_si128((mask), (b)))
+
+static int igraph_i_max_int_sse2(const int *x, long int n) {
+    __m128i a = _mm_set1_epi32(x[0]), v;
+    int t[4], max;
+    long int i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        v = _mm_loadu_si128((const __m128i *) (x + i));
+        a = IGRAPH_I_SELECT_SSE2(_mm_cmpgt_epi32(v, a), v, a);
+    }
+    _mm_storeu_si128((__m128i *) t, a);
+    max = igraph_i_max_int_c(t, 4);
+    for (; i < n; i++) {
+        if (x[i] > max) {
+            max = x[i];
+        }
+    }
+    return max;
+}
+
+static int igraph_i_min_int_sse2(const int *x, long int n) {
+    __m128i a = _mm_set1_epi32(x[0]), v;
+    int t[4], min;
+    long int i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        v = _mm_loadu_si128((const __m128i *) (x + i));
+        a = IGRAPH_I_SELECT_SSE2(_mm_cmplt_epi32(v, a), v, a);
+    }
+    _mm_storeu_si128((__m128i *) t, a);
+    min = igraph_i_min_int_c(t, 4);
+    for (; i < n; i++) {
+        if (x[i] < min) {
+            min = x[i];
+        }
+    }
+    return min;
+}
+
+#endif /* __SSE2__ */
+
+/* ---------------------------------------------------------------- */
+/* AVX2                                                             */
+/* ---------------------------------------------------------------- */
+
+#if defined(HAVE_AVX2_TARGET)
+
+#define IGRAPH_I_AVX2 __attribute__((target("avx2")))
+
+IGRAPH_I_AVX2
+static igraph_real_t igraph_i_sum_real_avx2(const igraph_real_t *x, long int n) {
+    __m256d b0 = _mm256_setzero_pd(), b1 = b0;
+    __m128d c;
+    igraph_real_t t[2], res;
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        b0 = _mm256_add_pd(b0, _mm256_loadu_pd(x + i));
+        b1 = _mm256_add_pd(b1, _mm256_loadu_pd(x + i + 4));
+    }
+    b0 = _mm256_add_pd(b0, b1);
+    c = _mm_add_pd(_mm256_castpd256_pd128(b0), _mm256_extractf128_pd(b0, 1));
+    _mm_storeu_pd(t, c);
+    res = t[0] + t[1];
+    for (; i < n; i++) {
+        res += x[i];
+    }
+    return res;
+}
+
+IGRAPH_I_AVX2
+static igraph_real_t igraph_i_sumsq_real_avx2(const igraph_real_t *x, long int n) {
+    __m256d b0 = _mm256_setzero_pd(), b1 = b0, v;
+    __m128d c;
+    igraph_real_t t[2], res;
+    long int i;
+    /* No fused multiply-add, to get the same result as the others */
+    for (i = 0; i + 8 <= n; i += 8) {
+        v = _mm256_loadu_pd(x + i);     b0 = _mm256_add_pd(b0, _mm256_mul_pd(v, v));
+        v = _mm256_loadu_pd(x + i + 4); b1 = _mm256_add_pd(b1, _mm256_mul_pd(v, v));
+    }
+    b0 = _mm256_add_pd(b0, b1);
+    c = _mm_add_pd(_mm256_castpd256_pd128(b0), _mm256_extractf128_pd(b0, 1));
+    _mm_storeu_pd(t, c);
+    res = t[0] + t[1];
+    for (; i < n; i++) {
+        igraph_real_t sq = x[i] * x[i];
+        res += sq;
+    }
+    return res;
+}
+
+IGRAPH_I_AVX2
+static igraph_real_t igraph_i_max_real_avx2(const igraph_real_t *x, long int n) {
+    __m256d b0 = _mm256_set1_pd(x[0]), b1 = b0;
+    igraph_real_t t[4];
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        b0 = _mm256_max_pd(_mm256_loadu_pd(x + i), b0);
+        b1 = _mm256_max_pd(_mm256_loadu_pd(x + i + 4), b1);
+    }
+    _mm256_storeu_pd(t, _mm256_max_pd(b1, b0));
+    for (; i < n; i++) {
+        if (x[i] > t[0]) {
+            t[0] = x[i];
+        }
+    }
+    return igraph_i_max_real_c(t, 4);
+}
+
+IGRAPH_I_AVX2
+static igraph_real_t igraph_i_min_real_avx2(const igraph_real_t *x, long int n) {
+    __m256d b0 = _mm256_set1_pd(x[0]), b1 = b0;
+    igraph_real_t t[4];
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        b0 = _mm256_min_pd(_mm256_loadu_pd(x + i), b0);
+        b1 = _mm256_min_pd(_mm256_loadu_pd(x + i + 4), b1);
+    }
+    _mm256_storeu_pd(t, _mm256_min_pd(b1, b0));
+    for (; i < n; i++) {
+        if (x[i] < t[0]) {
+            t[0] = x[i];
+        }
+    }
+    return igraph_i_min_real_c(t, 4);
+}
+
+IGRAPH_I_AVX2
+static int igraph_i_sum_int_avx2(const int *x, long int n) {
+    __m256i b0 = _mm256_setzero_si256(), b1 = b0;
+    int t[8];
+    long int i;
+    for (i = 0; i + 16 <= n; i += 16) {
+        b0 = _mm256_add_epi32(b0, _mm256_loadu_si256((const __m256i *) (x + i)));
+        b1 = _mm256_add_epi32(b1, _mm256_loadu_si256((const __m256i *) (x + i + 8)));
+    }
+    _mm256_storeu_si256((__m256i *) t, _mm256_add_epi32(b0, b1));
+    return (int) ((unsigned int) igraph_i_sum_int_c(t, 8) +
+                  (unsigned int) igraph_i_sum_int_c(x + i, n - i));
+}
+
+IGRAPH_I_AVX2
+static int igraph_i_max_int_avx2(const int *x, long int n) {
+    __m256i b = _mm256_set1_epi32(x[0]);
+    int t[8];
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        b = _mm256_max_epi32(b, _mm256_loadu_si256((const __m256i *) (x + i)));
+    }
+    _mm256_storeu_si256((__m256i *) t, b);
+    for (; i < n; i++) {
+        if (x[i] > t[0]) {
+            t[0] = x[i];
+        }
+    }
+    return igraph_i_max_int_c(t, 8);
+}
+
+IGRAPH_I_AVX2
+static int igraph_i_min_int_avx2(const int *x, long int n) {
+    __m256i b = _mm256_set1_epi32(x[0]);
+    int t[8];
+    long int i;
+    for (i = 0; i + 8 <= n; i += 8) {
+        b = _mm256_min_epi32(b, _mm256_loadu_si256((const __m256i *) (x + i)));
+    }
+    _mm256_storeu_si256((__m256i *) t, b);
+    for (; i < n; i++) {
+        if (x[i] < t[0]) {
+            t[0] = x[i];
+        }
+    }
+    return igraph_i_min_int_c(t, 8);
+}
+
+#endif /* HAVE_AVX2_TARGET */
+
+/* ---------------------------------------------------------------- */
+/* Element-wise operations                                          */
+/* ---------------------------------------------------------------- */
+
+/* These are exact, the order of the operations does not matter. The
+   plain C loop is left to the compiler, which vectorizes it for the
+   baseline instruction set, i.e. SSE2 on x86-64. The AVX2 versions
+   process four doubles or eight integers at a time. */
+
+#define IGRAPH_I_ELEMENTWISE_C(name, type, op) \
+    static void igraph_i_ ## name ## _c(type *x, const type *y, long int n) { \
+        long int i; \
+        for (i = 0; i < n; i++) { \
+            x[i] = x[i] op y[i]; \
+        } \
+    }
+
+#define IGRAPH_I_CONSTANT_C(name, type, op) \
+    static void igraph_i_ ## name ## _c(type *x, type c, long int n) { \
+        long int i; \
+        for (i = 0; i < n; i++) { \
+            x[i] = x[i] op c; \
+        } \
+    }
+
+IGRAPH_I_ELEMENTWISE_C(add_real, igraph_real_t, +)
+IGRAPH_I_ELEMENTWISE_C(sub_real, igraph_real_t, -)
+IGRAPH_I_ELEMENTWISE_C(mul_real, igraph_real_t, *)
+IGRAPH_I_ELEMENTWISE_C(div_real, igraph_real_t, /)
+IGRAPH_I_CONSTANT_C(scale_real, igraph_real_t, *)
+IGRAPH_I_CONSTANT_C(add_constant_real, igraph_real_t, +)
+
+/* Integer overflow wraps around, like in the vectorized versions */
+
+#define IGRAPH_I_ELEMENTWISE_INT_C(name, op) \
+    static void igraph_i_ ## name ## _c(int *x, const int *y, long int n) { \
+        long int i; \
+        for (i = 0; i < n; i++) { \
+            x[i] = (int) ((unsigned int) x[i] op (unsigned int) y[i]); \
+        } \
+    }
+
+#define IGRAPH_I_CONSTANT_INT_C(name, op) \
+    static void igraph_i_ ## name ## _c(int *x, int c, long int n) { \
+        long int i; \
+        for (i = 0; i < n; i++) { \
+            x[i] = (int) ((unsigned int) x[i] op (unsigned int) c); \
+        } \
+    }
+
+IGRAPH_I_ELEMENTWISE_INT_C(add_int, +)
+IGRAPH_I_ELEMENTWISE_INT_C(sub_int, -)
+IGRAPH_I_ELEMENTWISE_INT_C(mul_int, *)
+IGRAPH_I_CONSTANT_INT_C(scale_int, *)
+IGRAPH_I_CONSTANT_INT_C(add_constant_int, +)
+
+#if defined(HAVE_AVX2_TARGET)
+
+#define IGRAPH_I_ELEMENTWISE_AVX2(name, type, vtype, width, load, store, vop, cname) \
+    IGRAPH_I_AVX2 \
+    static void igraph_i_ ## name ## _avx2(type *x, const type *y, long int n) { \
+        long int i; \
+        for (i = 0; i + width <= n; i += width) { \
+            vtype a = load(x + i), b = load(y + i); \
+            store(x + i, vop(a, b)); \
+        } \
+        igraph_i_ ## cname ## _c(x + i, y + i, n - i); \
+    }
+
+#define IGRAPH_I_CONSTANT_AVX2(name, type, vtype, width, load, store, vop, set1, cname) \
+    IGRAPH_I_AVX2 \
+    static void igraph_i_ ## name ## _avx2(type *x, type c, long int n) { \
+        long int i; \
+        vtype b = set1(c); \
+        for (i = 0; i + width <= n; i += width) { \
+            store(x + i, vop(load(x + i), b)); \
+        } \
+        igraph_i_ ## cname ## _c(x + i, c, n - i); \
+    }
+
+#define IGRAPH_I_LOADI(p)     _mm256_loadu_si256((const __m256i *) (p))
+#define IGRAPH_I_STOREI(p, v) _mm256_storeu_si256((__m256i *) (p), (v))
+
+IGRAPH_I_ELEMENTWISE_AVX2(add_real, igraph_real_t, __m256d, 4, _mm256_loadu_pd,
+                          _mm256_storeu_pd, _mm256_add_pd, add_real)
+IGRAPH_I_ELEMENTWISE_AVX2(sub_real, igraph_real_t, __m256d, 4, _mm256_loadu_pd,
+                          _mm256_storeu_pd, _mm256_sub_pd, sub_real)
+IGRAPH_I_ELEMENTWISE_AVX2(mul_real, igraph_real_t, __m256d, 4, _mm256_loadu_pd,
+                          _mm256_storeu_pd, _mm256_mul_pd, mul_real)
+IGRAPH_I_ELEMENTWISE_AVX2(div_real, igraph_real_t, __m256d, 4, _mm256_loadu_pd,
+                          _mm256_storeu_pd, _mm256_div_pd, div_real)
+IGRAPH_I_CONSTANT_AVX2(scale_real, igraph_real_t, __m256d, 4, _mm256_loadu_pd,
+                       _mm256_storeu_pd, _mm256_mul_pd, _mm256_set1_pd, scale_real)
+IGRAPH_I_CONSTANT_AVX2(add_constant_real, igraph_real_t, __m256d, 4, _mm256_loadu_pd,
+                       _mm256_storeu_pd, _mm256_add_pd, _mm256_set1_pd, add_constant_real)
+
+IGRAPH_I_ELEMENTWISE_AVX2(add_int, int, __m256i, 8, IGRAPH_I_LOADI,
+                          IGRAPH_I_STOREI, _mm256_add_epi32, add_int)
+IGRAPH_I_ELEMENTWISE_AVX2(sub_int, int, __m256i, 8, IGRAPH_I_LOADI,
+                          IGRAPH_I_STOREI, _mm256_sub_epi32, sub_int)
+IGRAPH_I_ELEMENTWISE_AVX2(mul_int, int, __m256i, 8, IGRAPH_I_LOADI,
+                          IGRAPH_I_STOREI, _mm256_mullo_epi32, mul_int)
+IGRAPH_I_CONSTANT_AVX2(scale_int, int, __m256i, 8, IGRAPH_I_LOADI,
+                       IGRAPH_I_STOREI, _mm256_mullo_epi32, _mm256_set1_epi32, scale_int)
+IGRAPH_I_CONSTANT_AVX2(add_constant_int, int, __m256i, 8, IGRAPH_I_LOADI,
+                       IGRAPH_I_STOREI, _mm256_add_epi32, _mm256_set1_epi32, add_constant_int)
+
+#endif /* HAVE_AVX2_TARGET */
+
+/* ---------------------------------------------------------------- */
+/* Dispatch                                                         */
+/* ---------------------------------------------------------------- */
+
+#if defined(HAVE_AVX2_TARGET)
+#define IGRAPH_I_TRY_AVX2(call) \
+    if (IGRAPH_I_SIMD_LEVEL() >= 2) { \
+        return call; \
+    }
+#define IGRAPH_I_TRY_AVX2_VOID(call) \
+    if (IGRAPH_I_SIMD_LEVEL() >= 2) { \
+        call; \
+        return; \
+    }
+#else
+#define IGRAPH_I_TRY_AVX2(call)
+#define IGRAPH_I_TRY_AVX2_VOID(call)
+#endif
+
+#if defined(__SSE2__)
+#define IGRAPH_I_TRY_SSE2(call) \
+    if (IGRAPH_I_SIMD_LEVEL() >= 1) { \
+        return call; \
+    }
+#else
+#define IGRAPH_I_TRY_SSE2(call)
+#endif
+
+#define IGRAPH_I_REDUCTION(name, type, rtype) \
+    rtype igraph_i_simd_ ## name(const type *x, long int n) { \
+        IGRAPH_I_TRY_AVX2(igraph_i_ ## name ## _avx2(x, n)) \
+        IGRAPH_I_TRY_SSE2(igraph_i_ ## name ## _sse2(x, n)) \
+        return igraph_i_ ## name ## _c(x, n); \
+    }
+
+IGRAPH_I_REDUCTION(sum_real, igraph_real_t, igraph_real_t)
+IGRAPH_I_REDUCTION(sumsq_real, igraph_real_t, igraph_real_t)
+IGRAPH_I_REDUCTION(max_real, igraph_real_t, igraph_real_t)
+IGRAPH_I_REDUCTION(min_real, igraph_real_t, igraph_real_t)
+IGRAPH_I_REDUCTION(sum_int, int, int)
+IGRAPH_I_REDUCTION(max_int, int, int)
+IGRAPH_I_REDUCTION(min_int, int, int)
+
+#define IGRAPH_I_ELEMENTWISE(name, type) \
+    void igraph_i_simd_ ## name(type *x, const type *y, long int n) { \
+        IGRAPH_I_TRY_AVX2_VOID(igraph_i_ ## name ## _avx2(x, y, n)) \
+        igraph_i_ ## name ## _c(x, y, n); \
+    }
+
+#define IGRAPH_I_CONSTANT(name, type) \
+    void igraph_i_simd_ ## name(type *x, type c, long int n) { \
+        IGRAPH_I_TRY_AVX2_VOID(igraph_i_ ## name ## _avx2(x, c, n)) \
+        igraph_i_ ## name ## _c(x, c, n); \
+    }
+
+IGRAPH_I_ELEMENTWISE(add_real, igraph_real_t)
+IGRAPH_I_ELEMENTWISE(sub_real, igraph_real_t)
+IGRAPH_I_ELEMENTWISE(mul_real, igraph_real_t)
+IGRAPH_I_ELEMENTWISE(div_real, igraph_real_t)
+IGRAPH_I_CONSTANT(scale_real, igraph_real_t)
+IGRAPH_I_CONSTANT(add_constant_real, igraph_real_t)
+IGRAPH_I_ELEMENTWISE(add_int, int)
+IGRAPH_I_ELEMENTWISE(sub_int, int)
+IGRAPH_I_ELEMENTWISE(mul_int, int)
+IGRAPH_I_CONSTANT(scale_int, int)
+IGRAPH_I_CONSTANT(add_constant_int, int)
@@ -23,10 +23,12 @@
 
 #include "igraph_visitor.h"
 #include "igraph_memory.h"
-#include "igraph_adjlist.h"
 #include "igraph_interface.h"
 #include "igraph_dqueue.h"
 #include "igraph_stack.h"
+#include "igraph_trace_internal.h"
+#include "igraph_msbfs_internal.h"
+#include "igraph_interrupt_internal.h"
 #include "config.h"
 
 /**
@@ -107,8 +109,6 @@ int igraph_bfs(const igraph_t *graph,
     long int actroot = 0;
     igraph_vector_char_t added;
 
-    igraph_lazy_adjlist_t adjlist;
-
     long int act_rank = 0;
     long int pred_vec = -1;
 
@@ -149,9 +149,6 @@ int igraph_bfs(const igraph_t *graph,
     IGRAPH_CHECK(igraph_dqueue_init(&Q, 100));
     IGRAPH_FINALLY(igraph_dqueue_destroy, &Q);
 
-    IGRAPH_CHECK(igraph_lazy_adjlist_init(graph, &adjlist, mode, /*simplify=*/ 0));
-    IGRAPH_FINALLY(igraph_lazy_adjlist_destroy, &adjlist);
-
     /* Mark the vertices that are not in the restricted set, as already
        found. Special care must be taken for vertices that are not in
        the restricted set, but are to be used as 'root' vertices. */
@@ -219,9 +216,12 @@ int igraph_bfs(const igraph_t *graph,
             long int actvect = (long int) igraph_dqueue_pop(&Q);
             long int actdist = (long int) igraph_dqueue_pop(&Q);
             long int succ_vec;
-            igraph_vector_t *neis = igraph_lazy_adjlist_get(&adjlist,
-                                    (igraph_integer_t) actvect);
-            long int i, n = igraph_vector_size(neis);
+            igraph_csr_view_t view;
+
+            IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actvect,
+                                         mode));
+            IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+            IGRAPH_I_TRACE_ADD(scanned_edges, IGRAPH_CSR_VIEW_SIZE(view));
 
             if (pred) {
                 VECTOR(*pred)[actvect] = pred_vec;
@@ -236,8 +236,8 @@ int igraph_bfs(const igraph_t *graph,
                 VECTOR(*dist)[actvect] = actdist;
             }
 
-            for (i = 0; i < n; i++) {
-                long int nei = (long int) VECTOR(*neis)[i];
+            for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                 if (! VECTOR(added)[nei]) {
                     VECTOR(added)[nei] = 1;
                     IGRAPH_CHECK(igraph_dqueue_push(&Q, nei));
@@ -257,10 +257,10 @@ int igraph_bfs(const igraph_t *graph,
                              (igraph_integer_t) act_rank - 1, (igraph_integer_t) actdist,
                              extra);
                 if (terminate) {
-                    igraph_lazy_adjlist_destroy(&adjlist);
                     igraph_dqueue_destroy(&Q);
                     igraph_vector_char_destroy(&added);
-                    IGRAPH_FINALLY_CLEAN(3);
+                    IGRAPH_FINALLY_CLEAN(2);
+                    IGRAPH_I_TRACE_REPORT("igraph_bfs");
                     return 0;
                 }
             }
@@ -274,10 +274,282 @@ int igraph_bfs(const igraph_t *graph,
 
     } /* for actroot < no_of_nodes */
 
-    igraph_lazy_adjlist_destroy(&adjlist);
     igraph_dqueue_destroy(&Q);
     igraph_vector_char_destroy(&added);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    IGRAPH_I_TRACE_REPORT("igraph_bfs");
+
+    return 0;
+}
+
+/* Direction-optimizing BFS, after S. Beamer, K. Asanovic and D.
+   Patterson: Direction-optimizing breadth-first search, SC 2012.
+
+   A top-down step scans the edges of the frontier vertices. A
+   bottom-up step instead looks for a frontier vertex among the
+   reverse neighbors of every unvisited vertex, and stops at the first
+   one. When the frontier is large, as in the middle levels of small
+   world graphs, most unvisited vertices find a frontier neighbor
+   quickly, and the bottom-up step checks far fewer edges. The
+   frontier is a vertex list in the top-down steps and a bitmap in the
+   bottom-up steps. The search switches to bottom-up when the frontier
+   has more than 1/ALPHA of the edges of the unvisited vertices, and
+   back to top-down when the frontier is shrinking and has fewer than
+   1/BETA of the vertices. */
+
+#define IGRAPH_I_BFS_ALPHA 14
+#define IGRAPH_I_BFS_BETA  24
+
+#define IGRAPH_I_BFS_GET(bitmap, i) \
+    (((bitmap)[(i) / IGRAPH_I_MSBFS_WIDTH] >> ((i) % IGRAPH_I_MSBFS_WIDTH)) & 1)
+#define IGRAPH_I_BFS_SET(bitmap, i) \
+    ((bitmap)[(i) / IGRAPH_I_MSBFS_WIDTH] |= \
+     ((igraph_i_msbfs_mask_t) 1) << ((i) % IGRAPH_I_MSBFS_WIDTH))
+
+typedef struct {
+    igraph_i_msbfs_mask_t *visited, *frontier, *next;
+    long int *list, *next_list;
+} igraph_i_bfs_work_t;
+
+static void igraph_i_bfs_work_destroy(igraph_i_bfs_work_t *work) {
+    igraph_Free(work->visited);
+    igraph_Free(work->frontier);
+    igraph_Free(work->next);
+    igraph_Free(work->list);
+    igraph_Free(work->next_list);
+}
+
+/**
+ * \function igraph_bfs_distances
+ * Distances from a vertex, with a direction-optimizing search
+ *
+ * Computes the number of steps from the root vertex to every other
+ * vertex with a breadth-first search. This is the same as the result
+ * of \ref igraph_shortest_paths() with a single source vertex, but the
+ * search can be considerably faster on large graphs with small
+ * diameter.
+ *
+ * </para><para>
+ * The direction-optimizing search of S. Beamer, K. Asanovic and D.
+ * Patterson (Direction-optimizing breadth-first search, SC 2012)
+ * switches between two kinds of steps. The usual top-down steps
+ * check all edges of the vertices in the current frontier. The
+ * bottom-up steps check the unvisited vertices instead, and stop
+ * scanning the edges of a vertex when a neighbor in the frontier is
+ * found. When the frontier contains a large part of the graph, as in
+ * the middle levels of social networks, bottom-up steps avoid most of
+ * the edge checks.
+ * \param graph The input graph.
+ * \param dist Pointer to an initialized vector, the distances from the
+ *        root are stored here. The distance of the vertices that are
+ *        not reachable from the root is \c IGRAPH_INFINITY.
+ * \param father Pointer to an initialized vector, or a null pointer.
+ *        If not a null pointer, then the id of the father of each
+ *        vertex in a breadth-first search tree is stored here. It is
+ *        -1 for the root and for the unreachable vertices.
+ * \param root The id of the root vertex.
+ * \param mode For directed graphs, it defines which edges to follow.
+ *        \c IGRAPH_OUT means following the direction of the edges,
+ *        \c IGRAPH_IN means the opposite, and
+ *        \c IGRAPH_ALL ignores the direction of the edges.
+ *        This parameter is ignored for undirected graphs.
+ * \param algo The kind of search, possible values:
+ *        \clist
+ *        \cli IGRAPH_BFS_TOPDOWN
+ *          only top-down steps, this is the classic breadth-first
+ *          search.
+ *        \cli IGRAPH_BFS_DIRECTION_OPTIMIZING
+ *          top-down and bottom-up steps, whichever is expected to
+ *          be cheaper at each level.
+ *        \endclist
+ * \return Error code:
+ *        \c IGRAPH_EINVVID, invalid root vertex,
+ *        \c IGRAPH_EINVMODE, invalid mode argument,
+ *        \c IGRAPH_EINVAL, invalid search algorithm,
+ *        \c IGRAPH_ENOMEM, not enough memory for temporary data.
+ *
+ * Time complexity: O(|V|+|E|) for the top-down search. The
+ * direction-optimizing search has the same worst case, but it often
+ * checks only a fraction of the edges on small world graphs.
+ *
+ * \sa \ref igraph_bfs() for a search with more results and callbacks,
+ * \ref igraph_shortest_paths() for the distances from several
+ * vertices.
+ */
+
+int igraph_bfs_distances(const igraph_t *graph, igraph_vector_t *dist,
+                         igraph_vector_t *father, igraph_integer_t root,
+                         igraph_neimode_t mode, igraph_bfs_algorithm_t algo) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_words = (no_of_nodes + IGRAPH_I_MSBFS_WIDTH - 1) /
+                           IGRAPH_I_MSBFS_WIDTH;
+    igraph_neimode_t revmode;
+    igraph_i_bfs_work_t work;
+    igraph_i_msbfs_mask_t *tmp_mask;
+    igraph_csr_view_t view;
+    long int *tmp_list;
+    long int no_of_frontier, prev_frontier, frontier_edges, unvisited_edges;
+    long int actdist = 0, i, w;
+    igraph_bool_t topdown = 1;
+
+    if (root < 0 || root >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid root vertex in BFS", IGRAPH_EINVVID);
+    }
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN &&
+        mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+    if (algo != IGRAPH_BFS_TOPDOWN && algo != IGRAPH_BFS_DIRECTION_OPTIMIZING) {
+        IGRAPH_ERROR("Invalid BFS algorithm", IGRAPH_EINVAL);
+    }
+    revmode = mode == IGRAPH_OUT ? IGRAPH_IN :
+              mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
+
+    work.visited = igraph_Calloc(no_of_words, igraph_i_msbfs_mask_t);
+    work.frontier = igraph_Calloc(no_of_words, igraph_i_msbfs_mask_t);
+    work.next = igraph_Calloc(no_of_words, igraph_i_msbfs_mask_t);
+    work.list = igraph_Calloc(no_of_nodes, long int);
+    work.next_list = igraph_Calloc(no_of_nodes, long int);
+    IGRAPH_FINALLY(igraph_i_bfs_work_destroy, &work);
+    if (!work.visited || !work.frontier || !work.next || !work.list ||
+        !work.next_list) {
+        IGRAPH_ERROR("Cannot calculate BFS", IGRAPH_ENOMEM);
+    }
+
+    IGRAPH_CHECK(igraph_vector_resize(dist, no_of_nodes));
+    igraph_vector_fill(dist, IGRAPH_INFINITY);
+    if (father) {
+        IGRAPH_CHECK(igraph_vector_resize(father, no_of_nodes));
+        igraph_vector_fill(father, -1);
+    }
+
+    /* The bits after the last vertex are never visited */
+    for (i = no_of_nodes; i < no_of_words * IGRAPH_I_MSBFS_WIDTH; i++) {
+        IGRAPH_I_BFS_SET(work.visited, i);
+    }
+
+    IGRAPH_CHECK(igraph_csr_view(graph, &view, root, mode));
+    frontier_edges = IGRAPH_CSR_VIEW_SIZE(view);
+    unvisited_edges = (mode == IGRAPH_ALL ? 2 : 1) * igraph_ecount(graph) -
+                      frontier_edges;
+    IGRAPH_I_BFS_SET(work.visited, (long int) root);
+    VECTOR(*dist)[(long int) root] = 0;
+    work.list[0] = root;
+    no_of_frontier = 1;
+    prev_frontier = 0;
+
+    while (no_of_frontier > 0) {
+        long int no_of_next = 0, next_edges = 0;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        if (algo == IGRAPH_BFS_DIRECTION_OPTIMIZING) {
+            if (topdown && no_of_frontier > prev_frontier &&
+                frontier_edges > unvisited_edges / IGRAPH_I_BFS_ALPHA) {
+                /* Switch to bottom-up, the frontier becomes a bitmap */
+                for (i = 0; i < no_of_frontier; i++) {
+                    IGRAPH_I_BFS_SET(work.frontier, work.list[i]);
+                }
+                topdown = 0;
+            } else if (!topdown && no_of_frontier < prev_frontier &&
+                       no_of_frontier < no_of_nodes / IGRAPH_I_BFS_BETA) {
+                /* Switch to top-down, the frontier becomes a list */
+                for (w = 0; w < no_of_words; w++) {
+                    igraph_i_msbfs_mask_t bits = work.frontier[w];
+                    while (bits) {
+                        work.list[no_of_next++] = w * IGRAPH_I_MSBFS_WIDTH +
+                                                  IGRAPH_I_MSBFS_LOWEST(bits);
+                        bits &= bits - 1;
+                    }
+                    work.frontier[w] = 0;
+                }
+                no_of_next = 0;
+                topdown = 1;
+            }
+        }
+
+        if (topdown) {
+            for (i = 0; i < no_of_frontier; i++) {
+                long int actvect = work.list[i];
+                IGRAPH_CHECK(igraph_csr_view(graph, &view,
+                                             (igraph_integer_t) actvect, mode));
+                IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+                IGRAPH_I_TRACE_ADD(scanned_edges, IGRAPH_CSR_VIEW_SIZE(view));
+                for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                    long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+                    igraph_csr_view_t neiview;
+                    if (IGRAPH_I_BFS_GET(work.visited, nei)) {
+                        continue;
+                    }
+                    IGRAPH_I_BFS_SET(work.visited, nei);
+                    VECTOR(*dist)[nei] = actdist + 1;
+                    if (father) {
+                        VECTOR(*father)[nei] = actvect;
+                    }
+                    work.next_list[no_of_next++] = nei;
+                    IGRAPH_CHECK(igraph_csr_view(graph, &neiview,
+                                                 (igraph_integer_t) nei, mode));
+                    next_edges += IGRAPH_CSR_VIEW_SIZE(neiview);
+                }
+            }
+            tmp_list = work.list;
+            work.list = work.next_list;
+            work.next_list = tmp_list;
+        } else {
+            for (w = 0; w < no_of_words; w++) {
+                igraph_i_msbfs_mask_t bits = ~work.visited[w];
+                while (bits) {
+                    long int actvect = w * IGRAPH_I_MSBFS_WIDTH +
+                                       IGRAPH_I_MSBFS_LOWEST(bits);
+                    bits &= bits - 1;
+                    IGRAPH_CHECK(igraph_csr_view(graph, &view,
+                                                 (igraph_integer_t) actvect,
+                                                 revmode));
+                    IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+                    for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+                        long int nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
+                        IGRAPH_I_TRACE_ADD(scanned_edges, 1);
+                        if (IGRAPH_I_BFS_GET(work.frontier, nei)) {
+                            IGRAPH_I_BFS_SET(work.next, actvect);
+                            VECTOR(*dist)[actvect] = actdist + 1;
+                            if (father) {
+                                VECTOR(*father)[actvect] = nei;
+                            }
+                            no_of_next++;
+                            IGRAPH_CHECK(igraph_csr_view(graph, &view,
+                                                         (igraph_integer_t) actvect,
+                                                         mode));
+                            next_edges += IGRAPH_CSR_VIEW_SIZE(view);
+                            break;
+                        }
+                    }
+                }
+            }
+            for (w = 0; w < no_of_words; w++) {
+                work.visited[w] |= work.next[w];
+                work.frontier[w] = 0;
+            }
+            tmp_mask = work.frontier;
+            work.frontier = work.next;
+            work.next = tmp_mask;
+        }
+
+        prev_frontier = no_of_frontier;
+        no_of_frontier = no_of_next;
+        frontier_edges = next_edges;
+        unvisited_edges -= next_edges;
+        actdist++;
+    }
+
+    igraph_i_bfs_work_destroy(&work);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    IGRAPH_I_TRACE_REPORT("igraph_bfs_distances");
 
     return 0;
 }
@@ -297,9 +569,8 @@ int igraph_i_bfs(igraph_t *graph, igraph_integer_t vid, igraph_neimode_t mode,
 
     igraph_dqueue_t q;
     long int vidspos = 0;
-    igraph_vector_t neis;
+    igraph_csr_view_t view;
     long int no_of_nodes = igraph_vcount(graph);
-    long int i;
     char *added;
     long int lastlayer = -1;
 
@@ -318,7 +589,6 @@ int igraph_i_bfs(igraph_t *graph, igraph_integer_t vid, igraph_neimode_t mode,
         IGRAPH_ERROR("Cannot calculate BFS", IGRAPH_ENOMEM);
     }
     IGRAPH_FINALLY(igraph_free, added);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_dqueue_init(&q, 100));
     IGRAPH_FINALLY(igraph_dqueue_destroy, &q);
 
@@ -338,10 +608,12 @@ int igraph_i_bfs(igraph_t *graph, igraph_integer_t vid, igraph_neimode_t mode,
     while (!igraph_dqueue_empty(&q)) {
         long int actvect = (long int) igraph_dqueue_pop(&q);
         long int actdist = (long int) igraph_dqueue_pop(&q);
-        IGRAPH_CHECK(igraph_neighbors(graph, &neis, (igraph_integer_t) actvect,
-                                      mode));
-        for (i = 0; i < igraph_vector_size(&neis); i++) {
-            long int neighbor = (long int) VECTOR(neis)[i];
+        IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actvect,
+                                     mode));
+        IGRAPH_I_TRACE_ADD(visited_vertices, 1);
+        IGRAPH_I_TRACE_ADD(scanned_edges, IGRAPH_CSR_VIEW_SIZE(view));
+        for (; !IGRAPH_CSR_VIEW_END(view); IGRAPH_CSR_VIEW_NEXT(view)) {
+            long int neighbor = IGRAPH_CSR_VIEW_NEIGHBOR(view);
             if (added[neighbor] == 0) {
                 added[neighbor] = 1;
                 VECTOR(*parents)[neighbor] = actvect;
@@ -353,14 +625,13 @@ int igraph_i_bfs(igraph_t *graph, igraph_integer_t vid, igraph_neimode_t mode,
                 VECTOR(*vids)[vidspos++] = neighbor;
                 lastlayer = actdist + 1;
             }
-        } /* for i in neis */
+        } /* for the neighbors */
     } /* while ! dqueue_empty */
     IGRAPH_CHECK(igraph_vector_push_back(layers, vidspos));
 
-    igraph_vector_destroy(&neis);
     igraph_dqueue_destroy(&q);
     igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -421,7 +692,6 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
                void *extra) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_lazy_adjlist_t adjlist;
     igraph_stack_t stack;
     igraph_vector_char_t added;
     igraph_vector_long_t nptr;
@@ -447,17 +717,15 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
     IGRAPH_FINALLY(igraph_vector_char_destroy, &added);
     IGRAPH_CHECK(igraph_stack_init(&stack, 100));
     IGRAPH_FINALLY(igraph_stack_destroy, &stack);
-    IGRAPH_CHECK(igraph_lazy_adjlist_init(graph, &adjlist, mode, /*simplify=*/ 0));
-    IGRAPH_FINALLY(igraph_lazy_adjlist_destroy, &adjlist);
-    IGRAPH_CHECK(igraph_vector_long_init(&nptr, no_of_nodes));
+    /* Two positions for each vertex, in its out- and in-list */
+    IGRAPH_CHECK(igraph_vector_long_init(&nptr, 2 * no_of_nodes));
     IGRAPH_FINALLY(igraph_vector_long_destroy, &nptr);
 
 # define FREE_ALL() do {            \
         igraph_vector_long_destroy(&nptr);            \
-        igraph_lazy_adjlist_destroy(&adjlist);        \
         igraph_stack_destroy(&stack);                 \
         igraph_vector_char_destroy(&added);           \
-        IGRAPH_FINALLY_CLEAN(4); } while (0)
+        IGRAPH_FINALLY_CLEAN(3); } while (0)
 
     /* Resize result vectors and fill them with IGRAPH_NAN */
 
@@ -487,6 +755,7 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
         igraph_bool_t terminate = in_callback(graph, root, 0, extra);
         if (terminate) {
             FREE_ALL();
+            IGRAPH_I_TRACE_REPORT("igraph_dfs");
             return 0;
         }
     }
@@ -519,6 +788,7 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
                                                       0, extra);
                 if (terminate) {
                     FREE_ALL();
+                    IGRAPH_I_TRACE_REPORT("igraph_dfs");
                     return 0;
                 }
             }
@@ -527,19 +797,26 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
 
         while (!igraph_stack_empty(&stack)) {
             long int actvect = (long int) igraph_stack_top(&stack);
-            igraph_vector_t *neis = igraph_lazy_adjlist_get(&adjlist,
-                                    (igraph_integer_t) actvect);
-            long int n = igraph_vector_size(neis);
-            long int *ptr = igraph_vector_long_e_ptr(&nptr, actvect);
+            long int *ptr = igraph_vector_long_e_ptr(&nptr, 2 * actvect);
+            igraph_csr_view_t view;
+            const int *out, *in;
 
-            /* Search for a neighbor that was not yet visited */
+            /* Search for a neighbor that was not yet visited, continue
+               where we stopped the last time */
             igraph_bool_t any = 0;
             long int nei;
-            while (!any && (*ptr) < n) {
-                nei = (long int) VECTOR(*neis)[(*ptr)];
+            IGRAPH_CHECK(igraph_csr_view(graph, &view, (igraph_integer_t) actvect,
+                                         mode));
+            out = view.out += ptr[0];
+            in = view.in += ptr[1];
+            while (!any && !IGRAPH_CSR_VIEW_END(view)) {
+                nei = IGRAPH_CSR_VIEW_NEIGHBOR(view);
                 any = !VECTOR(added)[nei];
-                (*ptr) ++;
+                IGRAPH_CSR_VIEW_NEXT(view);
             }
+            ptr[0] += view.out - out;
+            ptr[1] += view.in - in;
+            IGRAPH_I_TRACE_ADD(scanned_edges, (view.out - out) + (view.in - in));
             if (any) {
                 /* There is such a neighbor, add it */
                 IGRAPH_CHECK(igraph_stack_push(&stack, nei));
@@ -561,6 +838,7 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
                                                           extra);
                     if (terminate) {
                         FREE_ALL();
+                        IGRAPH_I_TRACE_REPORT("igraph_dfs");
                         return 0;
                     }
                 }
@@ -568,6 +846,7 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
             } else {
                 /* There is no such neighbor, finished with the subtree */
                 igraph_stack_pop(&stack);
+                IGRAPH_I_TRACE_ADD(visited_vertices, 1);
                 if (order_out) {
                     VECTOR(*order_out)[rank_out++] = actvect;
                 }
@@ -579,6 +858,7 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
                                                            act_dist, extra);
                     if (terminate) {
                         FREE_ALL();
+                        IGRAPH_I_TRACE_REPORT("igraph_dfs");
                         return 0;
                     }
                 }
@@ -589,5 +869,7 @@ int igraph_dfs(const igraph_t *graph, igraph_integer_t root,
     FREE_ALL();
 # undef FREE_ALL
 
+    IGRAPH_I_TRACE_REPORT("igraph_dfs");
+
     return 0;
 }